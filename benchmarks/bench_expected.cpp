@@ -0,0 +1,105 @@
+#include <backport/expected.hpp>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+// What backport::expected resolves to in this build, recorded in the JSON context
+static const char *implementation() {
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202211L && !defined(EXPECTED_CUSTOM_IMPL)
+    return "std";
+#else
+    return "tl";
+#endif
+}
+
+// Keep the producers out of line so the benchmark measures returning the expected, not a folded constant
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+enum class parse_error : std::uint8_t { empty, negative };
+
+BENCH_NOINLINE static backport::expected<int, parse_error> parse(int input) {
+    if (input < 0) return backport::unexpected(parse_error::negative);
+    if (input == 0) return backport::unexpected(parse_error::empty);
+    return input * 2;
+}
+
+// Error type with a heap-allocated message, the common "rich error" case
+BENCH_NOINLINE static backport::expected<int, std::string> parse_verbose(int input) {
+    if (input < 0) return backport::unexpected(std::string("negative input is not allowed here"));
+    return input * 2;
+}
+
+static void BM_SuccessPath(benchmark::State &state) {
+    int input = 21;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input);
+        auto result = parse(input);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_ErrorPath(benchmark::State &state) {
+    int input = -1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input);
+        auto result = parse(input);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_StringErrorSuccessPath(benchmark::State &state) {
+    int input = 21;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input);
+        auto result = parse_verbose(input);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_StringErrorPath(benchmark::State &state) {
+    int input = -1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input);
+        auto result = parse_verbose(input);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+// Three chained steps through the monadic interface, on the success and the error path
+static void BM_AndThenChain(benchmark::State &state) {
+    int input = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input);
+        auto result = parse(input).and_then(parse).and_then(parse).transform([](int v) { return v + 1; });
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_ValueOr(benchmark::State &state) {
+    int input = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input);
+        int value = parse(input).value_or(-1);
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+BENCHMARK(BM_SuccessPath);
+BENCHMARK(BM_ErrorPath);
+BENCHMARK(BM_StringErrorSuccessPath);
+BENCHMARK(BM_StringErrorPath);
+BENCHMARK(BM_AndThenChain)->ArgName("input")->Arg(21)->Arg(-1);
+BENCHMARK(BM_ValueOr)->ArgName("input")->Arg(21)->Arg(-1);
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("expected", implementation());
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <backport/flat_map.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// What backport::flat_map resolves to in this build, recorded in the JSON context
+static const char *implementation() {
+#if defined(__cpp_lib_flat_map) && __cpp_lib_flat_map >= 202207L && !defined(FLAT_MAP_CUSTOM_IMPL)
+    return "std";
+#else
+    return "backport";
+#endif
+}
+
+// A routing table: a few thousand distinct keys, looked up far more often than it changes
+static std::vector<std::pair<std::uint32_t, std::uint32_t>> make_entries(std::size_t n) {
+    std::mt19937                                         rng(42);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> entries;
+    std::vector<std::uint32_t>                           keys;
+    while (keys.size() < n) {
+        keys.push_back(static_cast<std::uint32_t>(rng()));
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (auto k : keys) entries.emplace_back(k, k ^ 0x9e3779b9u);
+    return entries;
+}
+
+// Probes hit and miss in a random order, so neither the branch predictor nor the prefetcher learns the pattern
+static std::vector<std::uint32_t> make_probes(const std::vector<std::pair<std::uint32_t, std::uint32_t>> &entries) {
+    std::mt19937               rng(7);
+    std::vector<std::uint32_t> probes;
+    for (std::size_t i = 0; i < 4096; ++i) {
+        probes.push_back(i % 2 == 0 ? entries[rng() % entries.size()].first : static_cast<std::uint32_t>(rng()));
+    }
+    return probes;
+}
+
+template <typename Map> static void BM_Lookup(benchmark::State &state) {
+    const auto entries = make_entries(static_cast<std::size_t>(state.range(0)));
+    const auto probes  = make_probes(entries);
+    const Map  map(entries.begin(), entries.end());
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto it = map.find(probes[i++ & (probes.size() - 1)]);
+        benchmark::DoNotOptimize(it != map.end() ? it->second : 0u);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Bulk construction from entries that are already sorted, the usual shape of a table loaded from a config file
+template <typename Map> static void BM_BuildSorted(benchmark::State &state) {
+    auto entries = make_entries(static_cast<std::size_t>(state.range(0)));
+    std::sort(entries.begin(), entries.end());
+    std::vector<std::uint32_t> keys, values;
+    for (auto &[k, v] : entries) {
+        keys.push_back(k);
+        values.push_back(v);
+    }
+
+    for (auto _ : state) {
+        if constexpr (requires { Map(backport::sorted_unique, keys, values); }) {
+            Map map(backport::sorted_unique, keys, values);
+            benchmark::DoNotOptimize(map);
+        } else {
+            Map map(entries.begin(), entries.end());
+            benchmark::DoNotOptimize(map);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Iterating the whole table, e.g. to dump it
+template <typename Map> static void BM_Iterate(benchmark::State &state) {
+    const auto    entries = make_entries(static_cast<std::size_t>(state.range(0)));
+    const Map     map(entries.begin(), entries.end());
+    std::uint64_t sum = 0;
+    for (auto _ : state) {
+        for (const auto &[k, v] : map) sum += v;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using flat_table = backport::flat_map<std::uint32_t, std::uint32_t>;
+using tree_table = std::map<std::uint32_t, std::uint32_t>;
+using hash_table = std::unordered_map<std::uint32_t, std::uint32_t>;
+
+BENCHMARK(BM_Lookup<flat_table>)->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK(BM_Lookup<tree_table>)->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK(BM_Lookup<hash_table>)->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK(BM_BuildSorted<flat_table>)->Arg(4096);
+BENCHMARK(BM_BuildSorted<tree_table>)->Arg(4096);
+BENCHMARK(BM_BuildSorted<hash_table>)->Arg(4096);
+BENCHMARK(BM_Iterate<flat_table>)->Arg(4096);
+BENCHMARK(BM_Iterate<tree_table>)->Arg(4096);
+BENCHMARK(BM_Iterate<hash_table>)->Arg(4096);
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("flat_map", implementation());
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
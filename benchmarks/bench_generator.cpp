@@ -0,0 +1,169 @@
+#include <backport/generator.hpp>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <vector>
+
+// What backport::generator resolves to in this build, recorded in the JSON context
+static const char *implementation() {
+#if defined(__cpp_lib_generator) && __cpp_lib_generator >= 202207L && !defined(GENERATOR_CUSTOM_IMPL)
+    return "std";
+#else
+    return "backport";
+#endif
+}
+
+// A buffer of length-prefixed records, as read from a socket or a log file
+static std::vector<std::byte> make_records(std::size_t n) {
+    std::mt19937           rng(42);
+    std::vector<std::byte> buffer;
+    for (std::size_t i = 0; i < n; ++i) {
+        auto length = static_cast<std::uint8_t>(1 + rng() % 64);
+        buffer.push_back(std::byte{length});
+        for (std::uint8_t j = 0; j < length; ++j) buffer.push_back(static_cast<std::byte>(rng()));
+    }
+    return buffer;
+}
+
+static backport::generator<std::span<const std::byte>> records(std::span<const std::byte> buffer) {
+    while (!buffer.empty()) {
+        auto length = static_cast<std::size_t>(buffer[0]);
+        co_yield buffer.subspan(1, length);
+        buffer = buffer.subspan(1 + length);
+    }
+}
+
+// The same walk written by hand
+class record_iterator {
+    std::span<const std::byte> rest;
+
+  public:
+    using value_type      = std::span<const std::byte>;
+    using difference_type = std::ptrdiff_t;
+
+    record_iterator() = default;
+    explicit record_iterator(std::span<const std::byte> buffer) : rest(buffer) {}
+
+    value_type       operator*() const { return rest.subspan(1, static_cast<std::size_t>(rest[0])); }
+    record_iterator &operator++() {
+        rest = rest.subspan(1 + static_cast<std::size_t>(rest[0]));
+        return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const record_iterator &it, std::default_sentinel_t) { return it.rest.empty(); }
+};
+
+static void BM_RecordsGenerator(benchmark::State &state) {
+    const auto buffer = make_records(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::size_t total = 0;
+        for (auto record : records(buffer)) total += record.size();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_RecordsIterator(benchmark::State &state) {
+    const auto buffer = make_records(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::size_t total = 0;
+        for (record_iterator it(buffer); it != std::default_sentinel; ++it) total += (*it).size();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// A complete binary tree, walked depth first
+struct node {
+    int                   value;
+    std::unique_ptr<node> left, right;
+};
+
+static std::unique_ptr<node> make_tree(int depth, int &next) {
+    if (depth == 0) return nullptr;
+    auto n   = std::make_unique<node>();
+    n->value = next++;
+    n->left  = make_tree(depth - 1, next);
+    n->right = make_tree(depth - 1, next);
+    return n;
+}
+
+using frame_allocator = std::pmr::polymorphic_allocator<std::byte>;
+
+static backport::generator<const int &> walk(const node *n) {
+    co_yield n->value;
+    if (n->left) co_yield backport::ranges::elements_of(walk(n->left.get()));
+    if (n->right) co_yield backport::ranges::elements_of(walk(n->right.get()));
+}
+
+// Frames from a monotonic arena, reset between walks
+static backport::generator<const int &, void, frame_allocator> walk(std::allocator_arg_t, frame_allocator alloc, const node *n) {
+    co_yield n->value;
+    if (n->left) co_yield backport::ranges::elements_of(walk(std::allocator_arg, alloc, n->left.get()));
+    if (n->right) co_yield backport::ranges::elements_of(walk(std::allocator_arg, alloc, n->right.get()));
+}
+
+static void BM_TreeGenerator(benchmark::State &state) {
+    int  count = 0;
+    auto root  = make_tree(static_cast<int>(state.range(0)), count);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (int v : walk(root.get())) sum += v;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_TreeGeneratorArena(benchmark::State &state) {
+    int                                 count = 0;
+    auto                                root  = make_tree(static_cast<int>(state.range(0)), count);
+    std::vector<std::byte>              storage(std::size_t{1} << 22);
+    std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(), std::pmr::null_memory_resource());
+    for (auto _ : state) {
+        long long sum = 0;
+        for (int v : walk(std::allocator_arg, frame_allocator(&arena), root.get())) sum += v;
+        benchmark::DoNotOptimize(sum);
+        arena.release();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_TreeIterator(benchmark::State &state) {
+    int                       count = 0;
+    auto                      root  = make_tree(static_cast<int>(state.range(0)), count);
+    std::vector<const node *> stack;
+    for (auto _ : state) {
+        long long sum = 0;
+        stack.assign(1, root.get());
+        while (!stack.empty()) {
+            const node *n = stack.back();
+            stack.pop_back();
+            sum += n->value;
+            if (n->right) stack.push_back(n->right.get());
+            if (n->left) stack.push_back(n->left.get());
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_RecordsGenerator)->Arg(4096);
+BENCHMARK(BM_RecordsIterator)->Arg(4096);
+BENCHMARK(BM_TreeGenerator)->Arg(12);
+BENCHMARK(BM_TreeGeneratorArena)->Arg(12);
+BENCHMARK(BM_TreeIterator)->Arg(12);
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("generator", implementation());
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
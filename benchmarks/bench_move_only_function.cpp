@@ -0,0 +1,111 @@
+#include <backport/move_only_function.hpp>
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// What backport::move_only_function resolves to in this build, recorded in the JSON context
+static const char *implementation() {
+#if defined(__cpp_lib_move_only_function) && __cpp_lib_move_only_function >= 202110L && !defined(MOVE_ONLY_FUNCTION_CUSTOM_IMPL)
+    return "std";
+#else
+    return "backport";
+#endif
+}
+
+using function = backport::move_only_function<int(int)>;
+
+// Trivially copyable callable of exactly Bytes bytes: 8 and 24 fit the default buffer, 48 and 128 do not
+template <std::size_t Bytes> struct payload {
+    std::array<unsigned char, Bytes> data{};
+
+    int operator()(int x) const noexcept { return x + data[0]; }
+};
+
+// Callable with a non-trivial move and destructor, like a networking callback holding its session
+struct shared_payload {
+    std::shared_ptr<int> session = std::make_shared<int>(1);
+
+    int operator()(int x) const noexcept { return x + *session; }
+};
+
+template <typename Callable> static void BM_ConstructDestroy(benchmark::State &state) {
+    Callable callable{};
+    for (auto _ : state) {
+        function f(callable);
+        benchmark::DoNotOptimize(f);
+    }
+}
+
+template <typename Callable> static void BM_Move(benchmark::State &state) {
+    function a(Callable{});
+    for (auto _ : state) {
+        function b(std::move(a));
+        benchmark::DoNotOptimize(b);
+        a = std::move(b);
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <typename Callable> static void BM_Invoke(benchmark::State &state) {
+    function f(Callable{});
+    int      x = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f);
+        x = f(x);
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+// Round-robin over a queue of different callables, so the indirect branch is not perfectly predicted
+static void BM_InvokeMixed(benchmark::State &state) {
+    std::vector<function> queue;
+    for (int i = 0; i < 64; ++i) {
+        switch (i % 4) {
+        case 0: queue.emplace_back(payload<8>{}); break;
+        case 1: queue.emplace_back(payload<24>{}); break;
+        case 2: queue.emplace_back(payload<48>{}); break;
+        default: queue.emplace_back(shared_payload{}); break;
+        }
+    }
+
+    int x = 0;
+    for (auto _ : state) {
+        for (auto &f : queue) {
+            x = f(x);
+        }
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queue.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_ConstructDestroy, payload<8>);
+BENCHMARK_TEMPLATE(BM_ConstructDestroy, payload<24>);
+BENCHMARK_TEMPLATE(BM_ConstructDestroy, payload<48>);
+BENCHMARK_TEMPLATE(BM_ConstructDestroy, payload<128>);
+BENCHMARK_TEMPLATE(BM_ConstructDestroy, shared_payload);
+
+BENCHMARK_TEMPLATE(BM_Move, payload<8>);
+BENCHMARK_TEMPLATE(BM_Move, payload<24>);
+BENCHMARK_TEMPLATE(BM_Move, payload<48>);
+BENCHMARK_TEMPLATE(BM_Move, payload<128>);
+BENCHMARK_TEMPLATE(BM_Move, shared_payload);
+
+BENCHMARK_TEMPLATE(BM_Invoke, payload<8>);
+BENCHMARK_TEMPLATE(BM_Invoke, payload<24>);
+BENCHMARK_TEMPLATE(BM_Invoke, payload<48>);
+BENCHMARK_TEMPLATE(BM_Invoke, payload<128>);
+BENCHMARK_TEMPLATE(BM_Invoke, shared_payload);
+
+BENCHMARK(BM_InvokeMixed);
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("move_only_function", implementation());
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
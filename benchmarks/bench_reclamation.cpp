@@ -0,0 +1,124 @@
+#include <backport/hazard_pointer.hpp>
+#include <backport/rcu.hpp>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+// What backport::hazard_pointer and backport::rcu_domain resolve to in this build, recorded in the JSON context
+static const char *hazard_pointer_implementation() {
+#if defined(__cpp_lib_hazard_pointer) && __cpp_lib_hazard_pointer >= 202306L && !defined(HAZARD_POINTER_CUSTOM_IMPL)
+    return "std";
+#else
+    return "backport";
+#endif
+}
+
+static const char *rcu_implementation() {
+#if defined(__cpp_lib_rcu) && __cpp_lib_rcu >= 202306L && !defined(RCU_CUSTOM_IMPL)
+    return "std";
+#else
+    return "backport";
+#endif
+}
+
+// Read-mostly shared data: every thread reads the current value, thread 0 replaces it every write_interval reads
+constexpr int write_interval = 1024;
+
+struct shared_config {
+    std::uint64_t a;
+    std::uint64_t b;
+};
+
+// libc++ has no std::atomic<std::shared_ptr>, the deprecated free functions are the same lock-based operations there
+class atomic_config_ptr {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const shared_config>> ptr;
+
+  public:
+    explicit atomic_config_ptr(std::shared_ptr<const shared_config> p) : ptr(std::move(p)) {}
+
+    std::shared_ptr<const shared_config> load() const { return ptr.load(std::memory_order_acquire); }
+    void store(std::shared_ptr<const shared_config> p) { ptr.store(std::move(p), std::memory_order_release); }
+#else
+    std::shared_ptr<const shared_config> ptr;
+
+  public:
+    explicit atomic_config_ptr(std::shared_ptr<const shared_config> p) : ptr(std::move(p)) {}
+
+    std::shared_ptr<const shared_config> load() const { return std::atomic_load_explicit(&ptr, std::memory_order_acquire); }
+    void store(std::shared_ptr<const shared_config> p) { std::atomic_store_explicit(&ptr, std::move(p), std::memory_order_release); }
+#endif
+};
+
+static void BM_ReadAtomicSharedPtr(benchmark::State &state) {
+    static atomic_config_ptr config(std::make_shared<const shared_config>(shared_config{1, 2}));
+    std::uint64_t            n = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0 && ++n % write_interval == 0) {
+            config.store(std::make_shared<const shared_config>(shared_config{n, n + 1}));
+        } else {
+            std::shared_ptr<const shared_config> c = config.load();
+            benchmark::DoNotOptimize(c->a + c->b);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+struct hazard_config : backport::hazard_pointer_obj_base<hazard_config>, shared_config {
+    explicit hazard_config(shared_config c) : shared_config(c) {}
+};
+
+static void BM_ReadHazardPointer(benchmark::State &state) {
+    static std::atomic<hazard_config *> config{new hazard_config({1, 2})};
+    backport::hazard_pointer            hp = backport::make_hazard_pointer();
+    std::uint64_t                       n  = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0 && ++n % write_interval == 0) {
+            config.exchange(new hazard_config({n, n + 1}), std::memory_order_acq_rel)->retire();
+        } else {
+            const hazard_config *c = hp.protect(config);
+            benchmark::DoNotOptimize(c->a + c->b);
+            hp.reset_protection();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+struct rcu_config : backport::rcu_obj_base<rcu_config>, shared_config {
+    explicit rcu_config(shared_config c) : shared_config(c) {}
+};
+
+static void BM_ReadRcu(benchmark::State &state) {
+    static std::atomic<rcu_config *> config{new rcu_config({1, 2})};
+    std::uint64_t                    n = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0 && ++n % write_interval == 0) {
+            config.exchange(new rcu_config({n, n + 1}), std::memory_order_acq_rel)->retire();
+        } else {
+            backport::rcu_reader guard;
+            const rcu_config    *c = config.load(std::memory_order_acquire);
+            benchmark::DoNotOptimize(c->a + c->b);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Reader scalability: the per-read cost should stay flat as threads are added, up to one per core
+BENCHMARK(BM_ReadAtomicSharedPtr)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ReadHazardPointer)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ReadRcu)->ThreadRange(1, 64)->UseRealTime();
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("hazard_pointer", hazard_pointer_implementation());
+    benchmark::AddCustomContext("rcu", rcu_implementation());
+    benchmark::AddCustomContext("hardware_concurrency", std::to_string(std::thread::hardware_concurrency()));
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <backport/simd.hpp>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// What backport::simd resolves to in this build, recorded in the JSON context
+static const char *implementation() {
+#if defined(__cpp_lib_experimental_parallel_simd) && __cpp_lib_experimental_parallel_simd >= 201803L && !defined(SIMD_CUSTOM_IMPL)
+    return "std::experimental";
+#else
+    return "backport";
+#endif
+}
+
+template <typename T> static std::vector<T> make_values(std::size_t n) {
+    std::mt19937     rng(42);
+    std::vector<T>   values(n);
+    for (auto &v : values) v = static_cast<T>(rng() % 1000) / T(10);
+    return values;
+}
+
+static std::vector<std::uint32_t> make_words(std::size_t n) {
+    std::mt19937               rng(42);
+    std::vector<std::uint32_t> words(n);
+    for (auto &w : words) w = rng();
+    return words;
+}
+
+// A rotate-and-add checksum over 32-bit words
+static std::uint32_t checksum_scalar(const std::vector<std::uint32_t> &words) {
+    std::uint32_t sum = 0;
+    for (std::uint32_t w : words) sum += w ^ (w >> 7);
+    return sum;
+}
+
+static std::uint32_t checksum_simd(const std::vector<std::uint32_t> &words) {
+    using V         = backport::native_simd<std::uint32_t>;
+    std::size_t i   = 0;
+    V           acc = 0u;
+    for (; i + V::size() <= words.size(); i += V::size()) {
+        V w(words.data() + i, backport::element_aligned);
+        acc += w ^ (w >> 7);
+    }
+    std::uint32_t sum = backport::reduce(acc);
+    for (; i < words.size(); ++i) sum += words[i] ^ (words[i] >> 7);
+    return sum;
+}
+
+// The scalar loop is not vectorized without -ffast-math, it may not reorder the additions
+static float dot_scalar(const std::vector<float> &a, const std::vector<float> &b) {
+    float sum = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+static float dot_simd(const std::vector<float> &a, const std::vector<float> &b) {
+    using V         = backport::native_simd<float>;
+    std::size_t i   = 0;
+    V           acc = 0.0f;
+    for (; i + V::size() <= a.size(); i += V::size()) {
+        acc += V(a.data() + i, backport::element_aligned) * V(b.data() + i, backport::element_aligned);
+    }
+    float sum = backport::reduce(acc);
+    for (; i < a.size(); ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+// Clamp into [lo, hi] in place and count the values that were out of range
+static std::size_t clamp_scalar(std::vector<float> &values, float lo, float hi) {
+    std::size_t clamped = 0;
+    for (float &v : values) {
+        if (v < lo || v > hi) {
+            ++clamped;
+            v = v < lo ? lo : hi;
+        }
+    }
+    return clamped;
+}
+
+static std::size_t clamp_simd(std::vector<float> &values, float lo, float hi) {
+    using V             = backport::native_simd<float>;
+    std::size_t i       = 0;
+    std::size_t clamped = 0;
+    for (; i + V::size() <= values.size(); i += V::size()) {
+        V v(values.data() + i, backport::element_aligned);
+        clamped += static_cast<std::size_t>(backport::popcount(v < lo || v > hi));
+        backport::clamp(v, V(lo), V(hi)).copy_to(values.data() + i, backport::element_aligned);
+    }
+    // The tail is one masked load and store, the lanes past the end are not touched
+    const V lanes([](auto lane) { return static_cast<float>(lane); });
+    const auto tail = lanes < static_cast<float>(values.size() - i);
+    V          v(lo);
+    backport::where(tail, v).copy_from(values.data() + i, backport::element_aligned);
+    clamped += static_cast<std::size_t>(backport::popcount(tail && (v < lo || v > hi)));
+    backport::where(tail, backport::clamp(v, V(lo), V(hi))).copy_to(values.data() + i, backport::element_aligned);
+    return clamped;
+}
+
+static void BM_ChecksumScalar(benchmark::State &state) {
+    const auto words = make_words(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) benchmark::DoNotOptimize(checksum_scalar(words));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 4);
+}
+
+static void BM_ChecksumSimd(benchmark::State &state) {
+    const auto words = make_words(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) benchmark::DoNotOptimize(checksum_simd(words));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 4);
+}
+
+static void BM_DotScalar(benchmark::State &state) {
+    const auto a = make_values<float>(static_cast<std::size_t>(state.range(0)));
+    const auto b = make_values<float>(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) benchmark::DoNotOptimize(dot_scalar(a, b));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_DotSimd(benchmark::State &state) {
+    const auto a = make_values<float>(static_cast<std::size_t>(state.range(0)));
+    const auto b = make_values<float>(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) benchmark::DoNotOptimize(dot_simd(a, b));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ClampScalar(benchmark::State &state) {
+    const auto input = make_values<float>(static_cast<std::size_t>(state.range(0)));
+    auto       values = input;
+    for (auto _ : state) {
+        state.PauseTiming();
+        values = input;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(clamp_scalar(values, 10.0f, 90.0f));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ClampSimd(benchmark::State &state) {
+    const auto input = make_values<float>(static_cast<std::size_t>(state.range(0)));
+    auto       values = input;
+    for (auto _ : state) {
+        state.PauseTiming();
+        values = input;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(clamp_simd(values, 10.0f, 90.0f));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ChecksumScalar)->Arg(4099);
+BENCHMARK(BM_ChecksumSimd)->Arg(4099);
+BENCHMARK(BM_DotScalar)->Arg(4099);
+BENCHMARK(BM_DotSimd)->Arg(4099);
+BENCHMARK(BM_ClampScalar)->Arg(4099);
+BENCHMARK(BM_ClampSimd)->Arg(4099);
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("simd", implementation());
+    benchmark::AddCustomContext("simd_float_lanes", std::to_string(backport::native_simd<float>::size()));
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <backport/move_only_function.hpp>
+#include <backport/task_queue.hpp>
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// What backport::move_only_function (used by the mutex baseline) resolves to in this build, recorded in the JSON context
+static const char *implementation() {
+#if defined(__cpp_lib_move_only_function) && __cpp_lib_move_only_function >= 202110L && !defined(MOVE_ONLY_FUNCTION_CUSTOM_IMPL)
+    return "std";
+#else
+    return "backport";
+#endif
+}
+
+// Every thread pushes a small closure and pops one, so the queue stays near empty and all threads contend on both ends
+constexpr std::size_t queue_capacity = 1024;
+constexpr std::size_t batch_size     = 16;
+
+// Tasks often run on another thread than the one that pushed them, so they only touch thread-local state
+static thread_local int executed = 0;
+
+// A closure of two pointers plus an int, fits the default inline buffer of both queues
+struct small_task {
+    void *session;
+    void *context;
+    int   increment;
+
+    void operator()() const noexcept { executed += increment; }
+};
+
+// Baseline: a mutex around a deque of move_only_function
+class locked_queue {
+    std::mutex                                       mutex;
+    std::deque<backport::move_only_function<void()>> tasks;
+
+  public:
+    template <typename F> bool try_push(F &&f) {
+        std::lock_guard lock(mutex);
+        if (tasks.size() >= queue_capacity) return false;
+        tasks.emplace_back(std::forward<F>(f));
+        return true;
+    }
+
+    bool try_pop(backport::move_only_function<void()> &out) {
+        std::lock_guard lock(mutex);
+        if (tasks.empty()) return false;
+        out = std::move(tasks.front());
+        tasks.pop_front();
+        return true;
+    }
+};
+
+// Shared between the threads of one benchmark run, created and destroyed by thread 0 outside the timed loop
+template <typename Queue> static Queue *shared_queue = nullptr;
+
+template <typename Queue> static Queue *make_queue() {
+    if constexpr (std::is_constructible_v<Queue, std::size_t>) {
+        return new Queue(queue_capacity);
+    } else {
+        return new Queue();
+    }
+}
+
+template <typename Queue, typename Task> static void BM_PushPop(benchmark::State &state) {
+    if (state.thread_index() == 0) shared_queue<Queue> = make_queue<Queue>();
+
+    Task task;
+    for (auto _ : state) {
+        while (!shared_queue<Queue>->try_push(small_task{nullptr, nullptr, 1})) std::this_thread::yield();
+        while (!shared_queue<Queue>->try_pop(task)) std::this_thread::yield();
+        task();
+    }
+    benchmark::DoNotOptimize(executed);
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        delete shared_queue<Queue>;
+        shared_queue<Queue> = nullptr;
+    }
+}
+
+// Each iteration pushes a batch one by one and drains it with as few claims as the contention allows
+static void BM_PushPopBatch(benchmark::State &state) {
+    using queue = backport::task_queue<>;
+    if (state.thread_index() == 0) shared_queue<queue> = new queue(queue_capacity);
+
+    std::array<backport::task_queue_function, batch_size> batch;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            while (!shared_queue<queue>->try_push(small_task{nullptr, nullptr, 1})) std::this_thread::yield();
+        }
+        for (std::size_t popped = 0; popped < batch_size;) {
+            std::size_t n = shared_queue<queue>->try_pop_batch(std::span(batch).first(batch_size - popped));
+            for (std::size_t i = 0; i < n; ++i) batch[i]();
+            if (n == 0) std::this_thread::yield();
+            popped += n;
+        }
+    }
+    benchmark::DoNotOptimize(executed);
+    state.SetItemsProcessed(state.iterations() * batch_size);
+
+    if (state.thread_index() == 0) {
+        delete shared_queue<queue>;
+        shared_queue<queue> = nullptr;
+    }
+}
+
+BENCHMARK(BM_PushPop<backport::task_queue<>, backport::task_queue_function>)
+    ->Name("BM_PushPop/task_queue")
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_PushPop<locked_queue, backport::move_only_function<void()>>)
+    ->Name("BM_PushPop/mutex_deque")
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_PushPopBatch)->ThreadRange(1, 64)->UseRealTime();
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("move_only_function", implementation());
+    benchmark::AddCustomContext("hardware_concurrency", std::to_string(std::thread::hardware_concurrency()));
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <backport/thread_pool.hpp>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// What backport::move_only_function resolves to in this build, recorded in the JSON context
+static const char *implementation() {
+#if defined(__cpp_lib_move_only_function) && __cpp_lib_move_only_function >= 202110L && !defined(MOVE_ONLY_FUNCTION_CUSTOM_IMPL)
+    return "std";
+#else
+    return "backport";
+#endif
+}
+
+// Baseline: the ad-hoc pool every service ends up writing, one mutex and condition variable around a queue of std::function
+class function_pool {
+    std::mutex                        mutex;
+    std::condition_variable           ready;
+    std::queue<std::function<void()>> tasks;
+    bool                              stopping = false;
+    std::vector<std::thread>          workers;
+
+  public:
+    explicit function_pool(std::size_t threads) {
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this]() {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock lock(mutex);
+                        ready.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~function_pool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto &t : workers) t.join();
+    }
+
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard lock(mutex);
+            tasks.push(std::move(task));
+        }
+        ready.notify_one();
+    }
+};
+
+static std::size_t pool_threads() { return backport::thread_pool::default_concurrency(); }
+
+// Post a batch of small tasks from outside the pool and wait until all of them ran
+static void BM_PostBatch_thread_pool(benchmark::State &state) {
+    backport::thread_pool pool(pool_threads());
+    const auto            batch = static_cast<int>(state.range(0));
+    std::atomic<int>      done{0};
+    for (auto _ : state) {
+        done.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < batch; ++i) {
+            pool.post([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+        while (done.load(std::memory_order_acquire) != batch) std::this_thread::yield();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+static void BM_PostBatch_function_pool(benchmark::State &state) {
+    function_pool    pool(pool_threads());
+    const auto       batch = static_cast<int>(state.range(0));
+    std::atomic<int> done{0};
+    for (auto _ : state) {
+        done.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < batch; ++i) {
+            pool.post([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+        while (done.load(std::memory_order_acquire) != batch) std::this_thread::yield();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+// Submit one task and wait for its result, the scheduling round trip
+static void BM_SubmitGet_thread_pool(benchmark::State &state) {
+    backport::thread_pool pool(pool_threads());
+    int                   x = 0;
+    for (auto _ : state) {
+        x = pool.submit([x]() { return x + 1; }).get().value();
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+// Fork-join from inside the pool: tasks spawned by workers go to their own deque and are stolen by idle workers
+static long fib(backport::thread_pool &pool, int n) {
+    if (n < 16) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    auto left  = pool.submit([&pool, n]() { return fib(pool, n - 1); });
+    long right = fib(pool, n - 2);
+    return left.get().value() + right;
+}
+
+static void BM_ForkJoin_thread_pool(benchmark::State &state) {
+    backport::thread_pool pool(pool_threads());
+    const auto            n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        long result = pool.submit([&pool, n]() { return fib(pool, n); }).get().value();
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK(BM_PostBatch_thread_pool)->Arg(64)->Arg(1024)->UseRealTime();
+BENCHMARK(BM_PostBatch_function_pool)->Arg(64)->Arg(1024)->UseRealTime();
+BENCHMARK(BM_SubmitGet_thread_pool)->UseRealTime();
+BENCHMARK(BM_ForkJoin_thread_pool)->Arg(24)->UseRealTime();
+
+int main(int argc, char **argv) {
+    benchmark::AddCustomContext("move_only_function", implementation());
+    benchmark::AddCustomContext("pool_threads", std::to_string(pool_threads()));
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
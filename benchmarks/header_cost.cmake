@@ -0,0 +1,92 @@
+# Measures what including each header costs a translation unit, run by the header_cost_report target as
+#   cmake -DCOMPILER=<c++> -DCOMPILER_ID=GNU|Clang -DSTD_FLAG=-std=c++20 -DINCLUDES=<dir>|<dir> -DHEADERS=backport/x.hpp|...
+#         -DOUTPUT=<report.json> [-DREPEAT=5] -P header_cost.cmake
+#
+# Every header is compiled on its own (-fsyntax-only) REPEAT times and the fastest wall time is kept, the preprocessed
+# line count says how much of it is text. GCC's -ftime-report adds the parse and template instantiation phases from a
+# separate run (the report slows the compiler down, compare the phases with each other rather than with the wall time),
+# Clang writes a -ftime-trace JSON per header next to the report, to be opened in chrome://tracing or Perfetto.
+cmake_minimum_required(VERSION 3.23)
+
+string(REPLACE "|" ";" INCLUDES "${INCLUDES}")
+string(REPLACE "|" ";" HEADERS "${HEADERS}")
+if(NOT REPEAT)
+  set(REPEAT 5)
+endif()
+
+get_filename_component(output_dir "${OUTPUT}" DIRECTORY)
+set(work_dir ${output_dir}/header_cost)
+file(MAKE_DIRECTORY ${work_dir})
+
+set(flags ${STD_FLAG})
+foreach(dir IN LISTS INCLUDES)
+  list(APPEND flags -I${dir})
+endforeach()
+
+# Microseconds since the epoch: the seconds followed by the six digits of the fraction
+function(now_us out_var)
+  string(TIMESTAMP us "%s%f" UTC)
+  set(${out_var}
+      ${us}
+      PARENT_SCOPE)
+endfunction()
+
+# Wall seconds of one -ftime-report row, the last time column before the GGC memory column
+function(report_wall report row out_var)
+  set(wall "")
+  if(report MATCHES "${row} *:[^\n]* ([0-9]+\\.[0-9]+) *\\( *[0-9]+%\\) +[0-9]+[kMG]? *\\( *[0-9]+%\\)")
+    set(wall ${CMAKE_MATCH_1})
+  endif()
+  set(${out_var}
+      "${wall}"
+      PARENT_SCOPE)
+endfunction()
+
+set(entries)
+foreach(header IN LISTS HEADERS)
+  string(REGEX REPLACE "[/.]" "_" name "${header}")
+  set(source ${work_dir}/${name}.cpp)
+  file(WRITE ${source} "#include <${header}>\n")
+
+  execute_process(
+    COMMAND ${COMPILER} ${flags} -E -P ${source}
+    OUTPUT_VARIABLE preprocessed
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(SEND_ERROR "${header}: does not compile on its own")
+    continue()
+  endif()
+  string(REGEX REPLACE "[^\n]" "" newlines "${preprocessed}")
+  string(LENGTH "${newlines}" lines)
+
+  set(best "")
+  foreach(run RANGE 1 ${REPEAT})
+    now_us(start)
+    execute_process(COMMAND ${COMPILER} ${flags} -fsyntax-only ${source} RESULT_VARIABLE result)
+    now_us(stop)
+    math(EXPR elapsed "${stop} - ${start}")
+    if(best STREQUAL "" OR elapsed LESS best)
+      set(best ${elapsed})
+    endif()
+  endforeach()
+  math(EXPR wall_ms "${best} / 1000")
+
+  set(phases "")
+  if(COMPILER_ID STREQUAL "GNU")
+    execute_process(COMMAND ${COMPILER} ${flags} -fsyntax-only -ftime-report ${source} ERROR_VARIABLE report)
+    report_wall("${report}" "phase parsing" parse)
+    report_wall("${report}" "template instantiation" instantiation)
+    set(phases ", \"parse_s\": \"${parse}\", \"instantiation_s\": \"${instantiation}\"")
+  elseif(COMPILER_ID MATCHES "Clang")
+    execute_process(COMMAND ${COMPILER} ${flags} -fsyntax-only -ftime-trace=${work_dir}/${name}.json ${source})
+    set(phases ", \"trace\": \"${work_dir}/${name}.json\"")
+  endif()
+
+  message(STATUS "${header}: ${wall_ms} ms, ${lines} lines")
+  list(APPEND entries "    {\"header\": \"${header}\", \"wall_ms\": ${wall_ms}, \"lines\": ${lines}${phases}}")
+endforeach()
+
+list(JOIN entries ",\n" entries)
+set(context "\"compiler\": \"${COMPILER}\", \"standard\": \"${STD_FLAG}\"")
+file(WRITE ${OUTPUT} "{\n  \"context\": {${context}},\n  \"headers\": [\n${entries}\n  ]\n}\n")
+message(STATUS "Header cost report written to ${OUTPUT}")
@@ -0,0 +1,397 @@
+#pragma once
+
+#include "expected.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace backport {
+
+// Customization point describing representations of T that are never valid values ("niches"), which compact_expected
+// uses to encode its error without a separate discriminant. A specialization provides:
+//
+//   static constexpr std::uintmax_t niche_count;               number of distinct niche representations
+//   static T              make_niche(std::uintmax_t i) noexcept; the i-th niche, i < niche_count
+//   static bool           is_niche(const T &) noexcept;
+//   static std::uintmax_t niche_index(const T &) noexcept;       inverse of make_niche, only called on niches
+//
+// The primary template is empty: the type has no niche.
+template <typename T> struct niche_traits {};
+
+// Object pointers with alignment of at least 2 never have the low bit set, every odd address is a niche
+template <typename T>
+    requires(std::is_object_v<T> && alignof(T) >= 2)
+struct niche_traits<T *> {
+    static constexpr std::uintmax_t niche_count = (std::numeric_limits<std::uintptr_t>::max() >> 1) + 1;
+
+    static T *make_niche(std::uintmax_t i) noexcept { return reinterpret_cast<T *>((static_cast<std::uintptr_t>(i) << 1) | 1u); }
+    static bool           is_niche(T *const &p) noexcept { return (reinterpret_cast<std::uintptr_t>(p) & 1u) != 0; }
+    static std::uintmax_t niche_index(T *const &p) noexcept { return reinterpret_cast<std::uintptr_t>(p) >> 1; }
+};
+
+// Every std::errc enumerator is a non-zero errno value, so errc{} is free
+template <> struct niche_traits<std::errc> {
+    static constexpr std::uintmax_t niche_count = 1;
+
+    static constexpr std::errc      make_niche(std::uintmax_t) noexcept { return std::errc{}; }
+    static constexpr bool           is_niche(const std::errc &e) noexcept { return e == std::errc{}; }
+    static constexpr std::uintmax_t niche_index(const std::errc &) noexcept { return 0; }
+};
+
+namespace detail {
+
+template <typename T, typename E> class niche_expected;
+
+template <typename T>
+concept has_niche = requires {
+    { niche_traits<T>::niche_count } -> std::convertible_to<std::uintmax_t>;
+};
+
+// Errors folded into a value niche are stored as their object representation, so they must not have padding or
+// several representations of one value. Eight bytes would need every value of a 64-bit niche, which nothing provides.
+template <typename E>
+inline constexpr bool niche_encodable =
+    std::is_trivially_copyable_v<E> &&
+    (std::is_empty_v<E> || (std::has_unique_object_representations_v<E> && (sizeof(E) == 1 || sizeof(E) == 2 || sizeof(E) == 4)));
+
+template <std::size_t Size>
+using niche_uint = std::conditional_t<Size == 1, std::uint8_t, std::conditional_t<Size == 2, std::uint16_t, std::uint32_t>>;
+
+// Number of niches needed to encode every E
+template <typename E> constexpr std::uintmax_t niche_states() noexcept {
+    if constexpr (std::is_empty_v<E>) {
+        return 1;
+    } else {
+        return std::uintmax_t{1} << (8 * sizeof(E));
+    }
+}
+
+template <typename E> constexpr std::uintmax_t niche_encode(const E &e) noexcept {
+    if constexpr (std::is_empty_v<E>) {
+        return 0;
+    } else {
+        return std::bit_cast<niche_uint<sizeof(E)>>(e);
+    }
+}
+
+template <typename E> constexpr E niche_decode(std::uintmax_t i) noexcept {
+    if constexpr (std::is_empty_v<E>) {
+        return E{};
+    } else {
+        return std::bit_cast<E>(static_cast<niche_uint<sizeof(E)>>(i));
+    }
+}
+
+// Two layouts fold the discriminant away: a trivially copyable T whose niches can hold every E, or void with a
+// niche in E standing for "has a value"
+template <typename T, typename E> constexpr bool use_niche_layout() noexcept {
+    if constexpr (!std::is_trivially_copyable_v<E> || std::is_const_v<E> || std::is_volatile_v<E>) {
+        return false;
+    } else if constexpr (std::is_void_v<T>) {
+        if constexpr (has_niche<E>) {
+            return niche_traits<E>::niche_count >= 1;
+        } else {
+            return false;
+        }
+    } else if constexpr (!std::is_trivially_copyable_v<T> || std::is_const_v<T> || std::is_volatile_v<T> || !niche_encodable<E> ||
+                         !has_niche<T>) {
+        return false;
+    } else {
+        return niche_traits<T>::niche_count >= niche_states<E>();
+    }
+}
+
+template <typename T, typename E> struct compact_expected_select {
+    using type = expected<T, E>;
+};
+
+template <typename T, typename E>
+    requires(use_niche_layout<T, E>())
+struct compact_expected_select<T, E> {
+    using type = niche_expected<T, E>;
+};
+
+// std::unexpected has error(), tl::unexpected has value()
+template <typename U> constexpr decltype(auto) unexpected_error(U &&u) {
+    if constexpr (requires { std::forward<U>(u).error(); }) {
+        return std::forward<U>(u).error();
+    } else {
+        return std::forward<U>(u).value();
+    }
+}
+
+// Forward a member with the value category and constness of Self
+template <typename Self, typename U> constexpr decltype(auto) forward_member(U &member) noexcept {
+    using base = std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>, const U, U>;
+    if constexpr (std::is_lvalue_reference_v<Self>) {
+        return static_cast<base &>(member);
+    } else {
+        return static_cast<base &&>(member);
+    }
+}
+
+} // namespace detail
+
+// Opt-in expected<T, E> that stores the discriminant in a niche of T (e.g. the low bit of an aligned pointer) or, for
+// expected<void, E>, in a niche of E (e.g. errc{}), so it is exactly as large as the payload. Pairs that have no suitable
+// niche, e.g. expected<std::uint32_t, std::errc>, are plain backport::expected.
+template <typename T, typename E> using compact_expected = typename detail::compact_expected_select<T, E>::type;
+
+namespace detail {
+
+// The compact layout. The API follows expected, except that error() returns the error by value since it is decoded from
+// the niche. T (unless void) and E are trivially copyable, and so is niche_expected.
+template <typename T, typename E> class niche_expected {
+    static constexpr bool is_void = std::is_void_v<T>;
+
+    using storage_t = std::conditional_t<is_void, E, T>;
+    using traits    = niche_traits<storage_t>;
+
+    storage_t storage;
+
+    template <typename, typename> friend class niche_expected;
+
+    constexpr void set_error(const E &e) noexcept {
+        if constexpr (is_void) {
+            assert(!traits::is_niche(e) && "this error value is the niche that means success");
+            storage = e;
+        } else {
+            storage = traits::make_niche(niche_encode(e));
+        }
+    }
+
+    template <typename Self, typename F> static constexpr auto and_then_impl(Self &&self, F &&f) {
+        if constexpr (is_void) {
+            using result = std::remove_cvref_t<std::invoke_result_t<F>>;
+            static_assert(std::is_same_v<typename result::error_type, E>, "and_then must return an expected with the same error type");
+            if (self.has_value()) return result(std::invoke(std::forward<F>(f)));
+            return result(unexpected<E>(self.error()));
+        } else {
+            using result = std::remove_cvref_t<std::invoke_result_t<F, decltype(forward_member<Self>(self.storage))>>;
+            static_assert(std::is_same_v<typename result::error_type, E>, "and_then must return an expected with the same error type");
+            if (self.has_value()) return result(std::invoke(std::forward<F>(f), forward_member<Self>(self.storage)));
+            return result(unexpected<E>(self.error()));
+        }
+    }
+
+    template <typename Self, typename F> static constexpr auto or_else_impl(Self &&self, F &&f) {
+        using result = std::remove_cvref_t<std::invoke_result_t<F, E>>;
+        static_assert(std::is_same_v<typename result::value_type, T>, "or_else must return an expected with the same value type");
+        if (self.has_value()) {
+            if constexpr (is_void) {
+                return result();
+            } else {
+                return result(forward_member<Self>(self.storage));
+            }
+        }
+        return result(std::invoke(std::forward<F>(f), self.error()));
+    }
+
+    template <typename Self, typename F> static constexpr auto transform_impl(Self &&self, F &&f) {
+        if constexpr (is_void) {
+            using U      = std::remove_cv_t<std::invoke_result_t<F>>;
+            using result = compact_expected<U, E>;
+            if (!self.has_value()) return result(unexpected<E>(self.error()));
+            if constexpr (std::is_void_v<U>) {
+                std::invoke(std::forward<F>(f));
+                return result();
+            } else {
+                return result(std::invoke(std::forward<F>(f)));
+            }
+        } else {
+            using U      = std::remove_cv_t<std::invoke_result_t<F, decltype(forward_member<Self>(self.storage))>>;
+            using result = compact_expected<U, E>;
+            if (!self.has_value()) return result(unexpected<E>(self.error()));
+            if constexpr (std::is_void_v<U>) {
+                std::invoke(std::forward<F>(f), forward_member<Self>(self.storage));
+                return result();
+            } else {
+                return result(std::invoke(std::forward<F>(f), forward_member<Self>(self.storage)));
+            }
+        }
+    }
+
+    template <typename Self, typename F> static constexpr auto transform_error_impl(Self &&self, F &&f) {
+        using G      = std::remove_cv_t<std::invoke_result_t<F, E>>;
+        using result = compact_expected<T, G>;
+        if (self.has_value()) {
+            if constexpr (is_void) {
+                return result();
+            } else {
+                return result(forward_member<Self>(self.storage));
+            }
+        }
+        return result(unexpected<G>(std::invoke(std::forward<F>(f), self.error())));
+    }
+
+  public:
+    using value_type      = T;
+    using error_type      = E;
+    using unexpected_type = unexpected<E>;
+
+    template <typename U> using rebind = compact_expected<U, E>;
+
+    // Holds a value-initialized T, or for void a value
+    constexpr niche_expected() noexcept : storage() {
+        if constexpr (is_void) storage = traits::make_niche(0);
+    }
+
+    template <typename U = T>
+        requires(!is_void && !std::is_same_v<std::remove_cvref_t<U>, niche_expected> && std::is_constructible_v<T, U>)
+    constexpr explicit(!std::is_convertible_v<U, T>) niche_expected(U &&v) noexcept(std::is_nothrow_constructible_v<T, U>)
+        : storage(std::forward<U>(v)) {
+        assert(!traits::is_niche(storage) && "this value is a niche of the type and cannot be stored");
+    }
+
+    template <typename G>
+        requires std::is_constructible_v<E, const G &>
+    constexpr explicit(!std::is_convertible_v<const G &, E>) niche_expected(const unexpected<G> &u) : storage() {
+        set_error(E(unexpected_error(u)));
+    }
+
+    template <typename G>
+        requires std::is_constructible_v<E, G>
+    constexpr explicit(!std::is_convertible_v<G, E>) niche_expected(unexpected<G> &&u) : storage() {
+        set_error(E(unexpected_error(std::move(u))));
+    }
+
+    constexpr bool has_value() const noexcept {
+        if constexpr (is_void) {
+            return traits::is_niche(storage);
+        } else {
+            return !traits::is_niche(storage);
+        }
+    }
+
+    constexpr explicit operator bool() const noexcept { return has_value(); }
+
+    // Decoded from the niche, hence by value
+    constexpr E error() const noexcept {
+        assert(!has_value() && "error() called on an expected holding a value");
+        if constexpr (is_void) {
+            return storage;
+        } else {
+            return niche_decode<E>(traits::niche_index(storage));
+        }
+    }
+
+    template <typename U = T>
+        requires(!is_void && std::is_same_v<U, T>)
+    constexpr U &operator*() noexcept {
+        assert(has_value() && "operator* called on an expected holding an error");
+        return storage;
+    }
+
+    template <typename U = T>
+        requires(!is_void && std::is_same_v<U, T>)
+    constexpr const U &operator*() const noexcept {
+        assert(has_value() && "operator* called on an expected holding an error");
+        return storage;
+    }
+
+    template <typename U = T>
+        requires(!is_void && std::is_same_v<U, T>)
+    constexpr U *operator->() noexcept {
+        return std::addressof(**this);
+    }
+
+    template <typename U = T>
+        requires(!is_void && std::is_same_v<U, T>)
+    constexpr const U *operator->() const noexcept {
+        return std::addressof(**this);
+    }
+
+    template <typename U = T>
+        requires(!is_void && std::is_same_v<U, T>)
+    constexpr U &value() & {
+        if (!has_value()) throw bad_expected_access<E>(error());
+        return storage;
+    }
+
+    template <typename U = T>
+        requires(!is_void && std::is_same_v<U, T>)
+    constexpr const U &value() const & {
+        if (!has_value()) throw bad_expected_access<E>(error());
+        return storage;
+    }
+
+    template <typename U = T>
+        requires(!is_void && std::is_same_v<U, T>)
+    constexpr U &&value() && {
+        if (!has_value()) throw bad_expected_access<E>(error());
+        return std::move(storage);
+    }
+
+    // Throws if an error is held, for expected<void, E>
+    constexpr void value() const
+        requires(is_void)
+    {
+        if (!has_value()) throw bad_expected_access<E>(error());
+    }
+
+    template <typename U>
+        requires(!is_void)
+    constexpr storage_t value_or(U &&fallback) const {
+        return has_value() ? storage : static_cast<storage_t>(std::forward<U>(fallback));
+    }
+
+    template <typename G> constexpr E error_or(G &&fallback) const {
+        return has_value() ? static_cast<E>(std::forward<G>(fallback)) : error();
+    }
+
+    template <typename F> constexpr auto and_then(F &&f) & { return and_then_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto and_then(F &&f) const & { return and_then_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto and_then(F &&f) && { return and_then_impl(std::move(*this), std::forward<F>(f)); }
+    template <typename F> constexpr auto and_then(F &&f) const && { return and_then_impl(std::move(*this), std::forward<F>(f)); }
+
+    template <typename F> constexpr auto or_else(F &&f) & { return or_else_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto or_else(F &&f) const & { return or_else_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto or_else(F &&f) && { return or_else_impl(std::move(*this), std::forward<F>(f)); }
+    template <typename F> constexpr auto or_else(F &&f) const && { return or_else_impl(std::move(*this), std::forward<F>(f)); }
+
+    template <typename F> constexpr auto transform(F &&f) & { return transform_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto transform(F &&f) const & { return transform_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto transform(F &&f) && { return transform_impl(std::move(*this), std::forward<F>(f)); }
+    template <typename F> constexpr auto transform(F &&f) const && { return transform_impl(std::move(*this), std::forward<F>(f)); }
+
+    template <typename F> constexpr auto transform_error(F &&f) & { return transform_error_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto transform_error(F &&f) const & { return transform_error_impl(*this, std::forward<F>(f)); }
+    template <typename F> constexpr auto transform_error(F &&f) && { return transform_error_impl(std::move(*this), std::forward<F>(f)); }
+    template <typename F> constexpr auto transform_error(F &&f) const && {
+        return transform_error_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    constexpr void swap(niche_expected &other) noexcept { std::swap(storage, other.storage); }
+    friend constexpr void swap(niche_expected &a, niche_expected &b) noexcept { a.swap(b); }
+
+    friend constexpr bool operator==(const niche_expected &a, const niche_expected &b) {
+        if (a.has_value() != b.has_value()) return false;
+        if (!a.has_value()) return a.error() == b.error();
+        if constexpr (is_void) {
+            return true;
+        } else {
+            return a.storage == b.storage;
+        }
+    }
+
+    template <typename U>
+        requires(!is_void && !std::is_same_v<U, niche_expected>)
+    friend constexpr bool operator==(const niche_expected &a, const U &v) {
+        return a.has_value() && *a == v;
+    }
+
+    template <typename G> friend constexpr bool operator==(const niche_expected &a, const unexpected<G> &u) {
+        return !a.has_value() && a.error() == unexpected_error(u);
+    }
+};
+
+} // namespace detail
+
+} // namespace backport
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "move_only_function.hpp"
+
+#include <version>
+// <functional> is only needed to alias std::copyable_function
+#if defined(__cpp_lib_copyable_function) && __cpp_lib_copyable_function >= 202306L
+#include <functional>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_copyable_function is specifically designed to detect the availability of the std::copyable_function
+// feature in the standard library, which was introduced in C++26. The value 202306L represents the date when the feature was added to the
+// standard (June 2023).
+#if defined(__cpp_lib_copyable_function) && __cpp_lib_copyable_function >= 202306L && !defined(COPYABLE_FUNCTION_CUSTOM_IMPL)
+
+// Use std::copyable_function if available
+template <typename Signature> using copyable_function = std::copyable_function<Signature>;
+
+#else
+
+// Custom implementation for pre-C++26, with the default inline buffer. basic_copyable_function<Signature, InlineBytes, Align> from
+// move_only_function.hpp is the sized variant, copies of callables that fit the buffer never allocate.
+template <typename Signature> using copyable_function = basic_copyable_function<Signature>;
+
+#endif
+
+#if defined(__cpp_lib_copyable_function) && __cpp_lib_copyable_function >= 202306L
+// Best guess at the inline buffer of std::copyable_function, the standard libraries share it with move_only_function
+template <typename Signature>
+struct function_inline_storage<std::copyable_function<Signature>> : function_inline_storage<std::move_only_function<Signature>> {};
+#endif
+
+} // namespace backport
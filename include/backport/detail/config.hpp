@@ -0,0 +1,8 @@
+#pragma once
+
+// MSVC accepts [[no_unique_address]] but ignores it, only its own spelling lets an empty member take no space there
+#if defined(_MSC_VER)
+#define BACKPORT_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define BACKPORT_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
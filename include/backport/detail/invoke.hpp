@@ -0,0 +1,54 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+// std::invoke lives in <functional>, which brings in the searchers and with them much of the containers library. The
+// function wrappers only need INVOKE itself, so this is the part they include instead (C++20).
+
+namespace backport {
+namespace detail {
+
+// std::reference_wrapper, recognized by its interface so that <functional> need not be included to name it
+template <typename T>
+inline constexpr bool is_reference_wrapper_like = requires(const T &t) {
+    typename T::type;
+    requires std::is_same_v<decltype(t.get()), typename T::type &>;
+};
+
+// INVOKE(f, t, args...) for a pointer to member: the object is t itself (or derived from the class), a reference_wrapper
+// to it, or something that dereferences to it
+template <typename C, typename M, typename T, typename... Args> constexpr decltype(auto) invoke_member(M C::*pm, T &&t, Args &&...args) {
+    using object = std::remove_cvref_t<T>;
+    if constexpr (std::is_function_v<M>) {
+        if constexpr (std::is_base_of_v<C, object>) {
+            return (std::forward<T>(t).*pm)(std::forward<Args>(args)...);
+        } else if constexpr (is_reference_wrapper_like<object>) {
+            return (t.get().*pm)(std::forward<Args>(args)...);
+        } else {
+            return ((*std::forward<T>(t)).*pm)(std::forward<Args>(args)...);
+        }
+    } else {
+        static_assert(sizeof...(Args) == 0, "a pointer to data member is invoked with the object only");
+        if constexpr (std::is_base_of_v<C, object>) {
+            return std::forward<T>(t).*pm;
+        } else if constexpr (is_reference_wrapper_like<object>) {
+            return t.get().*pm;
+        } else {
+            return (*std::forward<T>(t)).*pm;
+        }
+    }
+}
+
+// std::invoke, the result type and noexcept-ness agree with std::invoke_result and std::is_nothrow_invocable
+template <typename F, typename... Args>
+constexpr decltype(auto) invoke(F &&f, Args &&...args) noexcept(std::is_nothrow_invocable_v<F, Args...>) {
+    if constexpr (std::is_member_pointer_v<std::remove_cvref_t<F>>) {
+        return detail::invoke_member(f, std::forward<Args>(args)...);
+    } else {
+        return std::forward<F>(f)(std::forward<Args>(args)...);
+    }
+}
+
+} // namespace detail
+} // namespace backport
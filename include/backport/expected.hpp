@@ -1,16 +1,27 @@
 #pragma once
 
+// The feature test macros live in <version>, which has to be included before they are tested. C++11 and C++14 standard
+// libraries may not have it, it is a C++20 header.
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
 // The feature test macro __cpp_lib_expected is specifically designed to detect the availability of the std::expected
-// feature in the standard library, which was introduced in C++23. The value 202202L represents the date when the
-// feature was added to the standard (February 2022).
-#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L && !defined(EXPECTED_CUSTOM_IMPL)
+// feature in the standard library, which was introduced in C++23. The value 202211L represents the date when the
+// monadic operations (and_then, or_else, transform, transform_error) were added to the standard (November 2022).
+// libstdc++ 12 has std::expected at 202202L but without them, it keeps using the TartanLlama implementation.
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202211L && !defined(EXPECTED_CUSTOM_IMPL)
 #include <expected>
 #else
 #include <tl/expected.hpp>
 #endif
 
+#include <type_traits>
+
 namespace backport {
-#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L && !defined(EXPECTED_CUSTOM_IMPL)
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202211L && !defined(EXPECTED_CUSTOM_IMPL)
 
 template <typename T, typename E> using expected = std::expected<T, E>;
 template <typename E> using unexpected           = std::unexpected<E>;
@@ -18,7 +29,7 @@ template <typename E> using unexpected           = std::unexpected<E>;
 template <typename E> using bad_expected_access = std::bad_expected_access<E>;
 
 inline constexpr std::unexpect_t unexpect{};
-inline constexpr in_place_t      in_place{};
+inline constexpr std::in_place_t in_place{};
 
 #else
 
@@ -27,6 +38,27 @@ template <typename E> using unexpected           = tl::unexpected<E>;
 
 template <typename E> using bad_expected_access = tl::bad_expected_access<E>;
 
+namespace detail {
+// Every special member trivial, the guarantee std::expected gives when T and E have it
+template <typename T>
+struct is_trivially_copyable_and_destructible
+    : std::integral_constant<bool, std::is_trivially_copy_constructible<T>::value && std::is_trivially_move_constructible<T>::value &&
+                                       std::is_trivially_copy_assignable<T>::value && std::is_trivially_move_assignable<T>::value &&
+                                       std::is_trivially_destructible<T>::value> {};
+} // namespace detail
+
+// Trivial special members are what let the ABI pass and return expected<int, int> in registers and containers relocate it
+// with memcpy. tl::expected propagates them like std::expected does, except on GCC 4.9 where it approximates the traits.
+// Checked here so that a different tl version cannot silently lose it.
+#if !defined(TL_EXPECTED_GCC49)
+static_assert(detail::is_trivially_copyable_and_destructible<expected<int, int>>::value,
+              "backport::expected<int, int> must be trivially copyable and destructible");
+static_assert(detail::is_trivially_copyable_and_destructible<expected<void, int>>::value,
+              "backport::expected<void, int> must be trivially copyable and destructible");
+static_assert(detail::is_trivially_copyable_and_destructible<expected<int *, unsigned char>>::value,
+              "backport::expected<int *, unsigned char> must be trivially copyable and destructible");
+#endif
+
 #if __cplusplus >= 201703L
 // C++17 and later: use inline explicitly
 inline constexpr tl::unexpect_t unexpect{};
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "expected.hpp"
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Coroutine support for expected, opt in by including this header:
+//
+//   backport::co_expected<frame, error> decode(span input) {
+//       auto header = co_await read_header(input); // value, or the error becomes the result of decode
+//       co_await check_crc(header);
+//       if (header.size == 0) co_await backport::unexpected<error>(error::empty);
+//       co_return frame{header, co_await read_body(input)};
+//   }
+//
+//   backport::expected<frame, error> result = decode(input);
+//
+// The coroutine runs to completion inside the call, a failed co_await destroys the frame and stores the error, so the
+// frames of nested calls are strictly LIFO. They are allocated from a thread-local arena of BACKPORT_COROUTINE_ARENA_BYTES
+// (frames that do not fit fall back to operator new), nothing is heap-allocated on the common path even where the
+// compiler does not elide the allocation. co_expected only carries the result back to the caller: convert it to expected
+// (or call get()) right away, an exception that escaped the body is rethrown there.
+
+#ifndef BACKPORT_COROUTINE_ARENA_BYTES
+#define BACKPORT_COROUTINE_ARENA_BYTES 16384
+#endif
+
+namespace backport {
+
+template <typename T, typename E> class co_expected;
+
+namespace detail {
+
+// Bump allocator for frames that are released in reverse order of allocation
+class coroutine_arena {
+    static constexpr std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    alignas(alignment) unsigned char buffer[BACKPORT_COROUTINE_ARENA_BYTES];
+    unsigned char *top = buffer;
+
+    static constexpr std::size_t round_up(std::size_t n) noexcept { return (n + alignment - 1) & ~(alignment - 1); }
+
+  public:
+    void *allocate(std::size_t n) {
+        n = round_up(n);
+        if (n > static_cast<std::size_t>(buffer + sizeof(buffer) - top)) return ::operator new(n);
+        void *p = top;
+        top += n;
+        return p;
+    }
+
+    void deallocate(void *p, std::size_t n) noexcept {
+        auto *bytes = static_cast<unsigned char *>(p);
+        if (bytes < buffer || bytes >= buffer + sizeof(buffer)) {
+            ::operator delete(p, round_up(n));
+            return;
+        }
+        assert(bytes + round_up(n) == top && "coroutine frames must be released in LIFO order");
+        top = bytes;
+    }
+
+    std::size_t used() const noexcept { return static_cast<std::size_t>(top - buffer); }
+
+    static coroutine_arena &local() noexcept {
+        static thread_local coroutine_arena arena;
+        return arena;
+    }
+};
+
+template <typename T> struct is_co_expected : std::false_type {};
+template <typename T, typename E> struct is_co_expected<co_expected<T, E>> : std::true_type {};
+
+template <typename T> struct unexpected_traits : std::false_type {};
+template <typename E> struct unexpected_traits<unexpected<E>> : std::true_type {
+    using error_type = E;
+};
+
+template <typename Promise, typename Expected> class co_expected_awaiter {
+    Promise  &promise;
+    Expected &&result;
+
+  public:
+    co_expected_awaiter(Promise &p, Expected &&r) noexcept : promise(p), result(static_cast<Expected &&>(r)) {}
+
+    bool await_ready() const noexcept { return result.has_value(); }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        promise.fail(static_cast<Expected &&>(result).error());
+        h.destroy(); // Never resumed, control goes straight back to the caller
+    }
+
+    decltype(auto) await_resume() {
+        if constexpr (std::is_void_v<typename std::remove_cvref_t<Expected>::value_type>) {
+            return;
+        } else {
+            return *static_cast<Expected &&>(result);
+        }
+    }
+};
+
+// Holds the result of a finished co_expected for the duration of the co_await
+template <typename Promise, typename Expected> class co_expected_owning_awaiter : public co_expected_awaiter<Promise, Expected> {
+    Expected storage;
+
+  public:
+    co_expected_owning_awaiter(Promise &p, Expected &&r)
+        : co_expected_awaiter<Promise, Expected>(p, std::move(storage)), storage(std::move(r)) {}
+    co_expected_owning_awaiter(const co_expected_owning_awaiter &) = delete;
+};
+
+template <typename Promise, typename E> class co_unexpected_awaiter {
+    Promise        &promise;
+    unexpected<E> &&failure;
+
+  public:
+    co_unexpected_awaiter(Promise &p, unexpected<E> &&u) noexcept : promise(p), failure(std::move(u)) {}
+
+    static constexpr bool await_ready() noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        promise.fail(std::move(failure));
+        h.destroy();
+    }
+
+    [[noreturn]] void await_resume() const noexcept { std::terminate(); }
+};
+
+template <typename T, typename E> class co_expected_promise_base {
+  protected:
+    co_expected<T, E> *target = nullptr;
+
+    template <typename... Args> void emplace(Args &&...args) { target->result.emplace(std::forward<Args>(args)...); }
+
+  public:
+    co_expected_promise_base()                                            = default;
+    co_expected_promise_base(const co_expected_promise_base &)            = delete;
+    co_expected_promise_base &operator=(const co_expected_promise_base &) = delete;
+    ~co_expected_promise_base() {
+        if (target) target->promise = nullptr;
+    }
+
+    static void *operator new(std::size_t n) { return coroutine_arena::local().allocate(n); }
+    static void  operator delete(void *p, std::size_t n) noexcept { coroutine_arena::local().deallocate(p, n); }
+
+    co_expected<T, E> get_return_object() noexcept;
+
+    static std::suspend_never initial_suspend() noexcept { return {}; }
+    static std::suspend_never final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { target->exception = std::current_exception(); }
+
+    // Any expected-like operand, the result of another co_expected call, or an unexpected to fail right away
+    template <typename X> auto await_transform(X &&x) {
+        using type = std::remove_cvref_t<X>;
+        if constexpr (is_co_expected<type>::value) {
+            using result_type = decltype(std::move(x).get());
+            return co_expected_owning_awaiter<co_expected_promise_base, result_type>(*this, std::move(x).get());
+        } else if constexpr (unexpected_traits<type>::value) {
+            static_assert(!std::is_lvalue_reference_v<X>, "co_await an unexpected temporary");
+            return co_unexpected_awaiter<co_expected_promise_base, typename unexpected_traits<type>::error_type>(*this, std::move(x));
+        } else {
+            return co_expected_awaiter<co_expected_promise_base, X>(*this, std::forward<X>(x));
+        }
+    }
+
+    template <typename G> void fail(G &&error) { emplace(unexpect, std::forward<G>(error)); }
+    template <typename G> void fail(unexpected<G> &&failure) { emplace(std::move(failure)); }
+
+    void attach(co_expected<T, E> *result) noexcept { target = result; }
+};
+
+template <typename T, typename E> class co_expected_promise : public co_expected_promise_base<T, E> {
+  public:
+    template <typename U = T>
+        requires std::is_constructible_v<expected<T, E>, U &&>
+    void return_value(U &&v) {
+        this->emplace(std::forward<U>(v));
+    }
+};
+
+template <typename E> class co_expected_promise<void, E> : public co_expected_promise_base<void, E> {
+  public:
+    void return_void() { this->emplace(); }
+};
+
+} // namespace detail
+
+// Return type of an expected coroutine, converts to expected<T, E> once the call has returned
+template <typename T, typename E> class co_expected {
+    friend class detail::co_expected_promise_base<T, E>;
+
+    std::optional<expected<T, E>>           result;
+    std::exception_ptr                      exception;
+    detail::co_expected_promise_base<T, E> *promise = nullptr; // Only while the body runs
+
+    explicit co_expected(detail::co_expected_promise_base<T, E> &p) noexcept : promise(&p) { p.attach(this); }
+
+  public:
+    using promise_type = detail::co_expected_promise<T, E>;
+    using value_type   = T;
+    using error_type   = E;
+
+    // Only needed where the compiler materializes the return object before moving it to the caller
+    co_expected(co_expected &&other) noexcept(std::is_nothrow_move_constructible_v<expected<T, E>>)
+        : result(std::move(other.result)), exception(std::move(other.exception)), promise(std::exchange(other.promise, nullptr)) {
+        if (promise) promise->attach(this);
+    }
+    co_expected &operator=(co_expected &&) = delete;
+    ~co_expected() {
+        if (promise) promise->attach(nullptr);
+    }
+
+    expected<T, E> get() && {
+        if (exception) std::rethrow_exception(std::move(exception));
+        assert(result.has_value() && "co_expected read before its coroutine finished");
+        return std::move(*result);
+    }
+
+    operator expected<T, E>() && { return std::move(*this).get(); }
+};
+
+template <typename T, typename E> co_expected<T, E> detail::co_expected_promise_base<T, E>::get_return_object() noexcept {
+    return co_expected<T, E>(*this);
+}
+
+} // namespace backport
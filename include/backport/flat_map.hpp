@@ -0,0 +1,602 @@
+#pragma once
+
+#include "detail/config.hpp"
+#include "flat_set.hpp" // sorted_unique and the branchless search
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_flat_map) && __cpp_lib_flat_map >= 202207L
+#include <flat_map>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_flat_map is specifically designed to detect the availability of the std::flat_map feature in the
+// standard library, which was introduced in C++23. The value 202207L represents the date when the feature was added to the standard
+// (July 2022).
+#if defined(__cpp_lib_flat_map) && __cpp_lib_flat_map >= 202207L && !defined(FLAT_MAP_CUSTOM_IMPL)
+
+// Use std::flat_map if available
+template <typename Key, typename T, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>,
+          typename MappedContainer = std::vector<T>>
+using flat_map = std::flat_map<Key, T, Compare, KeyContainer, MappedContainer>;
+
+#else
+
+namespace detail {
+
+template <typename Container>
+concept reservable = requires(Container &c, typename Container::size_type n) { c.reserve(n); };
+
+// operator-> of an iterator whose reference is a prvalue pair of references
+template <typename Reference> struct arrow_proxy {
+    Reference        reference;
+    const Reference *operator->() const noexcept { return &reference; }
+};
+
+} // namespace detail
+
+// Custom implementation for pre-C++23: keys and mapped values live in two separate random-access containers, so a lookup
+// is a branchless binary search over nothing but keys and only the hit touches the values. A bulk construction from
+// sorted_unique input is a move of both containers.
+template <typename Key, typename T, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>,
+          typename MappedContainer = std::vector<T>>
+class flat_map {
+    static_assert(std::is_same_v<Key, typename KeyContainer::value_type>, "KeyContainer::value_type must be Key");
+    static_assert(std::is_same_v<T, typename MappedContainer::value_type>, "MappedContainer::value_type must be T");
+    static_assert(std::random_access_iterator<typename KeyContainer::iterator>, "KeyContainer must be a random-access container");
+    static_assert(std::random_access_iterator<typename MappedContainer::iterator>, "MappedContainer must be a random-access container");
+
+    template <bool Const> class iterator_impl;
+
+  public:
+    using key_type               = Key;
+    using mapped_type            = T;
+    using value_type             = std::pair<key_type, mapped_type>;
+    using key_compare            = Compare;
+    using reference              = std::pair<const key_type &, mapped_type &>;
+    using const_reference        = std::pair<const key_type &, const mapped_type &>;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = iterator_impl<false>;
+    using const_iterator         = iterator_impl<true>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using key_container_type     = KeyContainer;
+    using mapped_container_type  = MappedContainer;
+
+    class value_compare {
+        friend flat_map;
+        BACKPORT_NO_UNIQUE_ADDRESS key_compare compare;
+        explicit value_compare(key_compare c) : compare(std::move(c)) {}
+
+      public:
+        bool operator()(const_reference a, const_reference b) const { return compare(a.first, b.first); }
+    };
+
+    struct containers {
+        key_container_type    keys;
+        mapped_container_type values;
+    };
+
+  private:
+    template <bool Const> class iterator_impl {
+        friend flat_map;
+        friend iterator_impl<!Const>;
+
+        using key_iterator    = typename KeyContainer::const_iterator;
+        using mapped_iterator = std::conditional_t<Const, typename MappedContainer::const_iterator, typename MappedContainer::iterator>;
+
+        key_iterator    key;
+        mapped_iterator mapped;
+
+        iterator_impl(key_iterator k, mapped_iterator m) : key(k), mapped(m) {}
+
+      public:
+        // Like std::flat_map, a random-access iterator whose reference is a proxy, so only an input iterator to legacy code
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = flat_map::value_type;
+        using reference         = std::conditional_t<Const, flat_map::const_reference, flat_map::reference>;
+        using pointer           = detail::arrow_proxy<reference>;
+        using difference_type   = flat_map::difference_type;
+
+        iterator_impl() = default;
+        iterator_impl(iterator_impl<!Const> other)
+            requires Const
+            : key(other.key), mapped(other.mapped) {}
+
+        reference operator*() const { return reference(*key, *mapped); }
+        pointer   operator->() const { return pointer{**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        iterator_impl &operator++() {
+            ++key;
+            ++mapped;
+            return *this;
+        }
+        iterator_impl operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        iterator_impl &operator--() {
+            --key;
+            --mapped;
+            return *this;
+        }
+        iterator_impl operator--(int) {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+        iterator_impl &operator+=(difference_type n) {
+            key += n;
+            mapped += n;
+            return *this;
+        }
+        iterator_impl &operator-=(difference_type n) { return *this += -n; }
+
+        friend iterator_impl   operator+(iterator_impl it, difference_type n) { return it += n; }
+        friend iterator_impl   operator+(difference_type n, iterator_impl it) { return it += n; }
+        friend iterator_impl   operator-(iterator_impl it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator_impl &a, const iterator_impl &b) { return a.key - b.key; }
+
+        friend bool operator==(const iterator_impl &a, const iterator_impl &b) { return a.key == b.key; }
+        friend auto operator<=>(const iterator_impl &a, const iterator_impl &b) { return a.key <=> b.key; }
+    };
+
+  public:
+    flat_map() : flat_map(key_compare()) {}
+    explicit flat_map(const key_compare &comp) : c(), compare(comp) {}
+
+    flat_map(key_container_type key_cont, mapped_container_type mapped_cont, const key_compare &comp = key_compare())
+        : c{std::move(key_cont), std::move(mapped_cont)}, compare(comp) {
+        assert(c.keys.size() == c.values.size() && "keys and values must have the same size");
+        sort_unique(0);
+    }
+
+    flat_map(sorted_unique_t, key_container_type key_cont, mapped_container_type mapped_cont, const key_compare &comp = key_compare())
+        : c{std::move(key_cont), std::move(mapped_cont)}, compare(comp) {
+        assert(c.keys.size() == c.values.size() && "keys and values must have the same size");
+        assert(is_sorted_unique() && "sorted_unique input must be sorted and free of duplicates");
+    }
+
+    template <std::input_iterator It> flat_map(It first, It last, const key_compare &comp = key_compare()) : c(), compare(comp) {
+        insert(first, last);
+    }
+
+    template <std::input_iterator It>
+    flat_map(sorted_unique_t, It first, It last, const key_compare &comp = key_compare()) : c(), compare(comp) {
+        append(first, last);
+        assert(is_sorted_unique() && "sorted_unique input must be sorted and free of duplicates");
+    }
+
+    flat_map(std::initializer_list<value_type> il, const key_compare &comp = key_compare()) : flat_map(il.begin(), il.end(), comp) {}
+    flat_map(sorted_unique_t s, std::initializer_list<value_type> il, const key_compare &comp = key_compare())
+        : flat_map(s, il.begin(), il.end(), comp) {}
+
+    flat_map &operator=(std::initializer_list<value_type> il) {
+        clear();
+        insert(il);
+        return *this;
+    }
+
+    // Iterators
+    iterator               begin() noexcept { return {c.keys.cbegin(), c.values.begin()}; }
+    const_iterator         begin() const noexcept { return {c.keys.cbegin(), c.values.cbegin()}; }
+    iterator               end() noexcept { return {c.keys.cend(), c.values.end()}; }
+    const_iterator         end() const noexcept { return {c.keys.cend(), c.values.cend()}; }
+    const_iterator         cbegin() const noexcept { return begin(); }
+    const_iterator         cend() const noexcept { return end(); }
+    reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    [[nodiscard]] bool empty() const noexcept { return c.keys.empty(); }
+    size_type          size() const noexcept { return c.keys.size(); }
+    size_type          max_size() const noexcept { return std::min<size_type>(c.keys.max_size(), c.values.max_size()); }
+
+    // Element access
+    mapped_type &operator[](const key_type &x) { return try_emplace(x).first->second; }
+    mapped_type &operator[](key_type &&x) { return try_emplace(std::move(x)).first->second; }
+
+    mapped_type &at(const key_type &x) { return at_impl(*this, x); }
+    const mapped_type &at(const key_type &x) const { return at_impl(*this, x); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    mapped_type &at(const K &x) {
+        return at_impl(*this, x);
+    }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const mapped_type &at(const K &x) const {
+        return at_impl(*this, x);
+    }
+
+    // Modifiers
+    template <typename... Args>
+        requires std::is_constructible_v<value_type, Args...>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        value_type v(std::forward<Args>(args)...);
+        return try_emplace(std::move(v.first), std::move(v.second));
+    }
+
+    template <typename... Args> iterator emplace_hint(const_iterator, Args &&...args) { return emplace(std::forward<Args>(args)...).first; }
+
+    std::pair<iterator, bool> insert(const value_type &x) { return try_emplace(x.first, x.second); }
+    std::pair<iterator, bool> insert(value_type &&x) { return try_emplace(std::move(x.first), std::move(x.second)); }
+    iterator                  insert(const_iterator, const value_type &x) { return insert(x).first; }
+    iterator                  insert(const_iterator, value_type &&x) { return insert(std::move(x)).first; }
+
+    template <typename P>
+        requires std::is_constructible_v<value_type, P>
+    std::pair<iterator, bool> insert(P &&x) {
+        return emplace(std::forward<P>(x));
+    }
+
+    // Appends, then sorts keys and values together, existing keys win over equal new ones. If appending throws the map is
+    // left as it was, if sorting throws it is left empty, as std::flat_map does.
+    template <std::input_iterator It> void insert(It first, It last) {
+        const auto old_size = size();
+        append(first, last);
+        clear_on_failure([&] { sort_unique(old_size); });
+    }
+
+    // The new entries are already sorted, they are merged in linear time
+    template <std::input_iterator It> void insert(sorted_unique_t, It first, It last) {
+        const auto old_size = size();
+        append(first, last);
+        clear_on_failure([&] { merge_unique(old_size); });
+    }
+
+    void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+    void insert(sorted_unique_t s, std::initializer_list<value_type> il) { insert(s, il.begin(), il.end()); }
+
+    containers extract() && {
+        containers result = std::move(c);
+        c.keys.clear();
+        c.values.clear();
+        return result;
+    }
+
+    void replace(key_container_type &&key_cont, mapped_container_type &&mapped_cont) {
+        assert(key_cont.size() == mapped_cont.size() && "keys and values must have the same size");
+        c.keys   = std::move(key_cont);
+        c.values = std::move(mapped_cont);
+        assert(is_sorted_unique() && "replace expects sorted and unique keys");
+    }
+
+    template <typename... Args> std::pair<iterator, bool> try_emplace(const key_type &k, Args &&...args) {
+        return try_emplace_impl(k, std::forward<Args>(args)...);
+    }
+    template <typename... Args> std::pair<iterator, bool> try_emplace(key_type &&k, Args &&...args) {
+        return try_emplace_impl(std::move(k), std::forward<Args>(args)...);
+    }
+    template <typename... Args> iterator try_emplace(const_iterator, const key_type &k, Args &&...args) {
+        return try_emplace(k, std::forward<Args>(args)...).first;
+    }
+    template <typename... Args> iterator try_emplace(const_iterator, key_type &&k, Args &&...args) {
+        return try_emplace(std::move(k), std::forward<Args>(args)...).first;
+    }
+
+    template <typename M> std::pair<iterator, bool> insert_or_assign(const key_type &k, M &&obj) {
+        auto result = try_emplace(k, std::forward<M>(obj));
+        if (!result.second) result.first->second = std::forward<M>(obj);
+        return result;
+    }
+    template <typename M> std::pair<iterator, bool> insert_or_assign(key_type &&k, M &&obj) {
+        auto result = try_emplace(std::move(k), std::forward<M>(obj));
+        if (!result.second) result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    iterator erase(iterator position) { return erase(const_iterator(position)); }
+    iterator erase(const_iterator position) {
+        auto k = c.keys.erase(position.key);
+        auto m = c.values.erase(position.mapped);
+        return {k, m};
+    }
+    size_type erase(const key_type &x) { return erase_range(equal_range(x)); }
+    template <typename K>
+        requires detail::transparent_compare<Compare> && (!std::is_convertible_v<K, iterator>) &&
+                 (!std::is_convertible_v<K, const_iterator>)
+    size_type erase(K &&x) {
+        return erase_range(equal_range(x));
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        auto k = c.keys.erase(first.key, last.key);
+        auto m = c.values.erase(first.mapped, last.mapped);
+        return {k, m};
+    }
+
+    void swap(flat_map &other) noexcept(std::is_nothrow_swappable_v<key_container_type> &&
+                                        std::is_nothrow_swappable_v<mapped_container_type> && std::is_nothrow_swappable_v<key_compare>) {
+        using std::swap;
+        swap(c.keys, other.c.keys);
+        swap(c.values, other.c.values);
+        swap(compare, other.compare);
+    }
+
+    void clear() noexcept {
+        c.keys.clear();
+        c.values.clear();
+    }
+
+    // Observers
+    key_compare                  key_comp() const { return compare; }
+    value_compare                value_comp() const { return value_compare(compare); }
+    const key_container_type    &keys() const noexcept { return c.keys; }
+    const mapped_container_type &values() const noexcept { return c.values; }
+
+    // Lookup
+    iterator       find(const key_type &x) { return find_impl(*this, x); }
+    const_iterator find(const key_type &x) const { return find_impl(*this, x); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator find(const K &x) {
+        return find_impl(*this, x);
+    }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator find(const K &x) const {
+        return find_impl(*this, x);
+    }
+
+    size_type count(const key_type &x) const { return contains(x) ? 1 : 0; }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    size_type count(const K &x) const {
+        auto [first, last] = equal_range(x);
+        return static_cast<size_type>(last - first);
+    }
+
+    bool contains(const key_type &x) const { return find(x) != end(); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    bool contains(const K &x) const {
+        return find(x) != end();
+    }
+
+    iterator       lower_bound(const key_type &x) { return bound_at(*this, key_lower_bound(x)); }
+    const_iterator lower_bound(const key_type &x) const { return bound_at(*this, key_lower_bound(x)); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator lower_bound(const K &x) {
+        return bound_at(*this, key_lower_bound(x));
+    }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator lower_bound(const K &x) const {
+        return bound_at(*this, key_lower_bound(x));
+    }
+
+    iterator       upper_bound(const key_type &x) { return bound_at(*this, key_upper_bound(x)); }
+    const_iterator upper_bound(const key_type &x) const { return bound_at(*this, key_upper_bound(x)); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator upper_bound(const K &x) {
+        return bound_at(*this, key_upper_bound(x));
+    }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator upper_bound(const K &x) const {
+        return bound_at(*this, key_upper_bound(x));
+    }
+
+    std::pair<iterator, iterator>             equal_range(const key_type &x) { return {lower_bound(x), upper_bound(x)}; }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type &x) const { return {lower_bound(x), upper_bound(x)}; }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    std::pair<iterator, iterator> equal_range(const K &x) {
+        return {lower_bound(x), upper_bound(x)};
+    }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    std::pair<const_iterator, const_iterator> equal_range(const K &x) const {
+        return {lower_bound(x), upper_bound(x)};
+    }
+
+    friend bool operator==(const flat_map &a, const flat_map &b) { return a.c.keys == b.c.keys && a.c.values == b.c.values; }
+
+    friend auto operator<=>(const flat_map &a, const flat_map &b) {
+        using ordering =
+            std::common_comparison_category_t<detail::synth_three_way_result<key_type>, detail::synth_three_way_result<mapped_type>>;
+        auto by_entry = [](const_reference x, const_reference y) -> ordering {
+            if (auto order = detail::synth_three_way(x.first, y.first); order != 0) return order;
+            return detail::synth_three_way(x.second, y.second);
+        };
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), by_entry);
+    }
+
+    friend void swap(flat_map &a, flat_map &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+  private:
+    containers                        c;
+    BACKPORT_NO_UNIQUE_ADDRESS key_compare compare;
+
+    template <typename K> difference_type key_lower_bound(const K &x) const {
+        return detail::branchless_lower_bound(c.keys.begin(), c.keys.end(), x, compare) - c.keys.begin();
+    }
+
+    template <typename K> difference_type key_upper_bound(const K &x) const {
+        return detail::branchless_upper_bound(c.keys.begin(), c.keys.end(), x, compare) - c.keys.begin();
+    }
+
+    // One body for the const and non-const overloads
+    template <typename Self> static auto bound_at(Self &self, difference_type i) { return self.begin() + i; }
+
+    template <typename Self, typename K> static auto find_impl(Self &self, const K &x) {
+        const auto i = self.key_lower_bound(x);
+        if (static_cast<size_type>(i) == self.size() || self.compare(x, self.c.keys[static_cast<size_type>(i)])) return self.end();
+        return self.begin() + i;
+    }
+
+    template <typename Self, typename K> static auto &at_impl(Self &self, const K &x) {
+        auto it = find_impl(self, x);
+        if (it == self.end()) throw std::out_of_range("backport::flat_map::at");
+        return it->second;
+    }
+
+    template <typename K, typename... Args> std::pair<iterator, bool> try_emplace_impl(K &&k, Args &&...args) {
+        const auto i = key_lower_bound(k);
+        if (static_cast<size_type>(i) != size() && !compare(k, c.keys[static_cast<size_type>(i)])) return {begin() + i, false};
+
+        auto key = c.keys.insert(c.keys.begin() + i, std::forward<K>(k));
+        try {
+            c.values.emplace(c.values.begin() + i, std::forward<Args>(args)...);
+        } catch (...) {
+            c.keys.erase(key);
+            throw;
+        }
+        return {begin() + i, true};
+    }
+
+    size_type erase_range(std::pair<iterator, iterator> range) {
+        const auto n = static_cast<size_type>(range.second - range.first);
+        erase(range.first, range.second);
+        return n;
+    }
+
+    template <typename It> void append(It first, It last) {
+        if constexpr (std::forward_iterator<It>) {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            if constexpr (detail::reservable<KeyContainer>) c.keys.reserve(size() + n);
+            if constexpr (detail::reservable<MappedContainer>) c.values.reserve(size() + n);
+        }
+        const auto old_size = size();
+        try {
+            for (; first != last; ++first) {
+                value_type v(*first);
+                c.keys.insert(c.keys.end(), std::move(v.first));
+                c.values.insert(c.values.end(), std::move(v.second));
+            }
+        } catch (...) {
+            // Also drops a key whose value failed to follow it
+            c.keys.erase(c.keys.begin() + static_cast<difference_type>(old_size), c.keys.end());
+            c.values.erase(c.values.begin() + static_cast<difference_type>(old_size), c.values.end());
+            throw;
+        }
+    }
+
+    // Sorting moves entries between and out of the containers, once it has started there is no order to go back to. An
+    // empty map is left behind instead of one whose lookups would silently miss.
+    template <typename F> void clear_on_failure(F f) {
+        try {
+            f();
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    bool is_sorted_unique() const {
+        return std::adjacent_find(c.keys.begin(), c.keys.end(), [this](const key_type &a, const key_type &b) { return !compare(a, b); }) ==
+               c.keys.end();
+    }
+
+    // Entries before `sorted` are already sorted and unique. Keys and values are sorted through one permutation, after which
+    // duplicates are compacted away in the same pass that applies it.
+    void sort_unique(size_type sorted) {
+        const auto n = size();
+        if (std::is_sorted(c.keys.begin() + static_cast<difference_type>(sorted), c.keys.end(), compare) &&
+            (sorted == 0 || sorted == n || compare(c.keys[sorted - 1], c.keys[sorted]))) {
+            unique_sorted();
+            return;
+        }
+
+        std::vector<size_type> order(n);
+        std::iota(order.begin(), order.end(), size_type(0));
+        auto by_key = [this](size_type a, size_type b) { return compare(c.keys[a], c.keys[b]); };
+        std::stable_sort(order.begin() + static_cast<difference_type>(sorted), order.end(), by_key);
+        std::inplace_merge(order.begin(), order.begin() + static_cast<difference_type>(sorted), order.end(), by_key);
+
+        containers result;
+        if constexpr (detail::reservable<KeyContainer>) result.keys.reserve(n);
+        if constexpr (detail::reservable<MappedContainer>) result.values.reserve(n);
+        for (size_type i : order) {
+            if (!result.keys.empty() && !compare(result.keys.back(), c.keys[i])) continue;
+            result.keys.insert(result.keys.end(), std::move(c.keys[i]));
+            result.values.insert(result.values.end(), std::move(c.values[i]));
+        }
+        c = std::move(result);
+    }
+
+    // Entries before `sorted` and from `sorted` on are each sorted, one linear merge puts them together
+    void merge_unique(size_type sorted) {
+        const auto n = size();
+        if (sorted == 0 || sorted == n || compare(c.keys[sorted - 1], c.keys[sorted])) {
+            unique_sorted();
+            return;
+        }
+
+        containers result;
+        if constexpr (detail::reservable<KeyContainer>) result.keys.reserve(n);
+        if constexpr (detail::reservable<MappedContainer>) result.values.reserve(n);
+        auto take = [&](size_type i) {
+            if (!result.keys.empty() && !compare(result.keys.back(), c.keys[i])) return;
+            result.keys.insert(result.keys.end(), std::move(c.keys[i]));
+            result.values.insert(result.values.end(), std::move(c.values[i]));
+        };
+        size_type i = 0;
+        size_type j = sorted;
+        // On equal keys the existing entry is taken first and the new one dropped
+        while (i < sorted && j < n) take(compare(c.keys[j], c.keys[i]) ? j++ : i++);
+        while (i < sorted) take(i++);
+        while (j < n) take(j++);
+        c = std::move(result);
+    }
+
+    void unique_sorted() {
+        size_type out = 0;
+        for (size_type i = 0; i < size(); ++i) {
+            if (out != 0 && !compare(c.keys[out - 1], c.keys[i])) continue;
+            if (out != i) {
+                c.keys[out]   = std::move(c.keys[i]);
+                c.values[out] = std::move(c.values[i]);
+            }
+            ++out;
+        }
+        c.keys.erase(c.keys.begin() + static_cast<difference_type>(out), c.keys.end());
+        c.values.erase(c.values.begin() + static_cast<difference_type>(out), c.values.end());
+    }
+};
+
+template <typename Key, typename T, typename Compare, typename KeyContainer, typename MappedContainer, typename Predicate>
+typename flat_map<Key, T, Compare, KeyContainer, MappedContainer>::size_type
+erase_if(flat_map<Key, T, Compare, KeyContainer, MappedContainer> &m, Predicate pred) {
+    auto [keys, values] = std::move(m).extract();
+    std::size_t out     = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (pred(std::pair<const Key &, T &>(keys[i], values[i]))) continue;
+        if (out != i) {
+            keys[out]   = std::move(keys[i]);
+            values[out] = std::move(values[i]);
+        }
+        ++out;
+    }
+    const auto erased = keys.size() - out;
+    keys.erase(keys.begin() + static_cast<std::ptrdiff_t>(out), keys.end());
+    values.erase(values.begin() + static_cast<std::ptrdiff_t>(out), values.end());
+    m.replace(std::move(keys), std::move(values));
+    return erased;
+}
+
+#endif
+
+} // namespace backport
@@ -0,0 +1,367 @@
+#pragma once
+
+#include "detail/config.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+
+// Both standard headers declare sorted_unique, include the one that exists
+#if defined(__cpp_lib_flat_set) && __cpp_lib_flat_set >= 202207L
+#include <flat_set>
+#elif defined(__cpp_lib_flat_map) && __cpp_lib_flat_map >= 202207L
+#include <flat_map>
+#endif
+
+namespace backport {
+
+// The sorted_unique tag is shared with the standard library when it has one, so either spelling works for both the std and
+// the custom containers
+#if (defined(__cpp_lib_flat_set) && __cpp_lib_flat_set >= 202207L) || (defined(__cpp_lib_flat_map) && __cpp_lib_flat_map >= 202207L)
+using std::sorted_unique;
+using std::sorted_unique_t;
+#else
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+#endif
+
+namespace detail {
+
+// Lower bound without a data-dependent branch: the comparison only selects the next base (a conditional move), so the
+// loop runs exactly log2(n) + 1 times and the branch predictor has nothing to miss
+template <typename It, typename K, typename Compare> It branchless_lower_bound(It first, It last, const K &key, Compare &compare) {
+    auto n = last - first;
+    if (n == 0) return first;
+    while (n > 1) {
+        const auto half = n / 2;
+        first += compare(first[half], key) ? half : 0;
+        n -= half;
+    }
+    return first + (compare(*first, key) ? 1 : 0);
+}
+
+template <typename It, typename K, typename Compare> It branchless_upper_bound(It first, It last, const K &key, Compare &compare) {
+    auto n = last - first;
+    if (n == 0) return first;
+    while (n > 1) {
+        const auto half = n / 2;
+        first += compare(key, first[half]) ? 0 : half;
+        n -= half;
+    }
+    return first + (compare(key, *first) ? 0 : 1);
+}
+
+// Heterogeneous lookup, as for the associative containers
+template <typename Compare>
+concept transparent_compare = requires { typename Compare::is_transparent; };
+
+template <typename T>
+constexpr auto synth_three_way(const T &a, const T &b) {
+    if constexpr (std::three_way_comparable<T>) {
+        return a <=> b;
+    } else {
+        if (a < b) return std::weak_ordering::less;
+        if (b < a) return std::weak_ordering::greater;
+        return std::weak_ordering::equivalent;
+    }
+}
+
+template <typename T> using synth_three_way_result = decltype(synth_three_way(std::declval<const T &>(), std::declval<const T &>()));
+
+} // namespace detail
+
+// The feature test macro __cpp_lib_flat_set is specifically designed to detect the availability of the std::flat_set feature in the
+// standard library, which was introduced in C++23. The value 202207L represents the date when the feature was added to the standard
+// (July 2022).
+#if defined(__cpp_lib_flat_set) && __cpp_lib_flat_set >= 202207L && !defined(FLAT_SET_CUSTOM_IMPL)
+
+// Use std::flat_set if available
+template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>>
+using flat_set = std::flat_set<Key, Compare, KeyContainer>;
+
+#else
+
+// Custom implementation for pre-C++23: the keys live sorted in one random-access container, lookups are a branchless
+// binary search over contiguous memory and a bulk construction from sorted_unique input is a move of the container
+template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>> class flat_set {
+    static_assert(std::is_same_v<Key, typename KeyContainer::value_type>, "KeyContainer::value_type must be Key");
+    static_assert(std::random_access_iterator<typename KeyContainer::iterator>, "KeyContainer must be a random-access container");
+
+  public:
+    using key_type               = Key;
+    using value_type             = Key;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using reference              = value_type &;
+    using const_reference        = const value_type &;
+    using size_type              = typename KeyContainer::size_type;
+    using difference_type        = typename KeyContainer::difference_type;
+    using iterator               = typename KeyContainer::const_iterator;
+    using const_iterator         = typename KeyContainer::const_iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using container_type         = KeyContainer;
+
+    flat_set() : flat_set(key_compare()) {}
+    explicit flat_set(const key_compare &comp) : keys(), compare(comp) {}
+
+    explicit flat_set(container_type cont, const key_compare &comp = key_compare()) : keys(std::move(cont)), compare(comp) {
+        sort_unique(0);
+    }
+
+    flat_set(sorted_unique_t, container_type cont, const key_compare &comp = key_compare()) : keys(std::move(cont)), compare(comp) {
+        assert(is_sorted_unique() && "sorted_unique input must be sorted and free of duplicates");
+    }
+
+    template <std::input_iterator It> flat_set(It first, It last, const key_compare &comp = key_compare()) : keys(), compare(comp) {
+        insert(first, last);
+    }
+
+    template <std::input_iterator It>
+    flat_set(sorted_unique_t, It first, It last, const key_compare &comp = key_compare()) : keys(first, last), compare(comp) {
+        assert(is_sorted_unique() && "sorted_unique input must be sorted and free of duplicates");
+    }
+
+    flat_set(std::initializer_list<value_type> il, const key_compare &comp = key_compare()) : flat_set(il.begin(), il.end(), comp) {}
+    flat_set(sorted_unique_t s, std::initializer_list<value_type> il, const key_compare &comp = key_compare())
+        : flat_set(s, il.begin(), il.end(), comp) {}
+
+    flat_set &operator=(std::initializer_list<value_type> il) {
+        clear();
+        insert(il);
+        return *this;
+    }
+
+    // Iterators, all of them const: modifying a key in place would break the order
+    iterator               begin() const noexcept { return keys.begin(); }
+    iterator               end() const noexcept { return keys.end(); }
+    const_iterator         cbegin() const noexcept { return keys.begin(); }
+    const_iterator         cend() const noexcept { return keys.end(); }
+    reverse_iterator       rbegin() const noexcept { return reverse_iterator(end()); }
+    reverse_iterator       rend() const noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    [[nodiscard]] bool empty() const noexcept { return keys.empty(); }
+    size_type          size() const noexcept { return keys.size(); }
+    size_type          max_size() const noexcept { return keys.max_size(); }
+
+    // Modifiers
+    template <typename... Args> std::pair<iterator, bool> emplace(Args &&...args) {
+        if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, key_type> && ...)) {
+            return insert_unique(std::forward<Args>(args)...);
+        } else {
+            return insert_unique(key_type(std::forward<Args>(args)...));
+        }
+    }
+
+    template <typename... Args> iterator emplace_hint(const_iterator, Args &&...args) { return emplace(std::forward<Args>(args)...).first; }
+
+    std::pair<iterator, bool> insert(const value_type &x) { return emplace(x); }
+    std::pair<iterator, bool> insert(value_type &&x) { return emplace(std::move(x)); }
+    iterator                  insert(const_iterator hint, const value_type &x) { return emplace_hint(hint, x); }
+    iterator                  insert(const_iterator hint, value_type &&x) { return emplace_hint(hint, std::move(x)); }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare> && std::is_constructible_v<value_type, K>
+    std::pair<iterator, bool> insert(K &&x) {
+        auto it = detail::branchless_lower_bound(keys.begin(), keys.end(), x, compare);
+        if (it != keys.end() && !compare(x, *it)) return {it, false};
+        return {keys.emplace(it, std::forward<K>(x)), true};
+    }
+
+    // Appends, then sorts only the new tail and merges it in, existing keys win over equal new ones. If appending throws
+    // the set is left as it was, if sorting throws it is left empty, as std::flat_set does.
+    template <std::input_iterator It> void insert(It first, It last) {
+        const auto old_size = keys.size();
+        append(first, last);
+        clear_on_failure([&] { sort_unique(old_size); });
+    }
+
+    template <std::input_iterator It> void insert(sorted_unique_t, It first, It last) {
+        const auto old_size = keys.size();
+        append(first, last);
+        clear_on_failure([&] { merge_unique(old_size); });
+    }
+
+    void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+    void insert(sorted_unique_t s, std::initializer_list<value_type> il) { insert(s, il.begin(), il.end()); }
+
+    container_type extract() && {
+        container_type result = std::move(keys);
+        keys.clear();
+        return result;
+    }
+
+    void replace(container_type &&cont) {
+        keys = std::move(cont);
+        assert(is_sorted_unique() && "replace expects sorted and unique keys");
+    }
+
+    iterator  erase(const_iterator position) { return keys.erase(position); }
+    size_type erase(const key_type &x) {
+        auto [first, last] = equal_range(x);
+        const auto n       = static_cast<size_type>(last - first);
+        keys.erase(first, last);
+        return n;
+    }
+    template <typename K>
+        requires detail::transparent_compare<Compare> && (!std::is_convertible_v<K, const_iterator>)
+    size_type erase(K &&x) {
+        auto [first, last] = equal_range(x);
+        const auto n       = static_cast<size_type>(last - first);
+        keys.erase(first, last);
+        return n;
+    }
+    iterator erase(const_iterator first, const_iterator last) { return keys.erase(first, last); }
+
+    void swap(flat_set &other) noexcept(std::is_nothrow_swappable_v<container_type> && std::is_nothrow_swappable_v<key_compare>) {
+        using std::swap;
+        swap(keys, other.keys);
+        swap(compare, other.compare);
+    }
+
+    void clear() noexcept { keys.clear(); }
+
+    // Observers
+    key_compare   key_comp() const { return compare; }
+    value_compare value_comp() const { return compare; }
+
+    // Lookup
+    iterator find(const key_type &x) const { return find_impl(x); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator find(const K &x) const {
+        return find_impl(x);
+    }
+
+    size_type count(const key_type &x) const { return contains(x) ? 1 : 0; }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    size_type count(const K &x) const {
+        auto [first, last] = equal_range(x);
+        return static_cast<size_type>(last - first);
+    }
+
+    bool contains(const key_type &x) const { return find(x) != end(); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    bool contains(const K &x) const {
+        return find(x) != end();
+    }
+
+    iterator lower_bound(const key_type &x) const { return detail::branchless_lower_bound(keys.begin(), keys.end(), x, compare); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator lower_bound(const K &x) const {
+        return detail::branchless_lower_bound(keys.begin(), keys.end(), x, compare);
+    }
+
+    iterator upper_bound(const key_type &x) const { return detail::branchless_upper_bound(keys.begin(), keys.end(), x, compare); }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator upper_bound(const K &x) const {
+        return detail::branchless_upper_bound(keys.begin(), keys.end(), x, compare);
+    }
+
+    std::pair<iterator, iterator> equal_range(const key_type &x) const { return {lower_bound(x), upper_bound(x)}; }
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    std::pair<iterator, iterator> equal_range(const K &x) const {
+        return {lower_bound(x), upper_bound(x)};
+    }
+
+    friend bool operator==(const flat_set &a, const flat_set &b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+
+    friend auto operator<=>(const flat_set &a, const flat_set &b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), detail::synth_three_way<key_type>);
+    }
+
+    friend void swap(flat_set &a, flat_set &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+  private:
+    KeyContainer                      keys;
+    BACKPORT_NO_UNIQUE_ADDRESS key_compare compare;
+
+    template <typename K> iterator find_impl(const K &x) const {
+        auto it = detail::branchless_lower_bound(keys.begin(), keys.end(), x, compare);
+        return it != keys.end() && !compare(x, *it) ? it : keys.end();
+    }
+
+    std::pair<iterator, bool> insert_unique(key_type &&x) {
+        auto it = detail::branchless_lower_bound(keys.begin(), keys.end(), x, compare);
+        if (it != keys.end() && !compare(x, *it)) return {it, false};
+        return {keys.insert(it, std::move(x)), true};
+    }
+
+    std::pair<iterator, bool> insert_unique(const key_type &x) {
+        auto it = detail::branchless_lower_bound(keys.begin(), keys.end(), x, compare);
+        if (it != keys.end() && !compare(x, *it)) return {it, false};
+        return {keys.insert(it, x), true};
+    }
+
+    bool is_sorted_unique() const {
+        return std::adjacent_find(keys.begin(), keys.end(), [this](const key_type &a, const key_type &b) { return !compare(a, b); }) ==
+               keys.end();
+    }
+
+    template <typename It> void append(It first, It last) {
+        const auto old_size = keys.size();
+        try {
+            keys.insert(keys.end(), first, last);
+        } catch (...) {
+            keys.erase(keys.begin() + static_cast<difference_type>(old_size), keys.end());
+            throw;
+        }
+    }
+
+    // Sorting moves keys around, once it has started there is no order to go back to. An empty set is left behind
+    // instead of one whose lookups would silently miss.
+    template <typename F> void clear_on_failure(F f) {
+        try {
+            f();
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    // Keys before `sorted` are already sorted and unique
+    void sort_unique(size_type sorted) {
+        auto middle = keys.begin() + static_cast<difference_type>(sorted);
+        std::stable_sort(middle, keys.end(), compare);
+        merge_unique(sorted);
+    }
+
+    void merge_unique(size_type sorted) {
+        auto middle = keys.begin() + static_cast<difference_type>(sorted);
+        std::inplace_merge(keys.begin(), middle, keys.end(), compare);
+        auto equivalent = [this](const key_type &a, const key_type &b) { return !compare(a, b); };
+        keys.erase(std::unique(keys.begin(), keys.end(), equivalent), keys.end());
+    }
+};
+
+template <typename Key, typename Compare, typename KeyContainer, typename Predicate>
+typename flat_set<Key, Compare, KeyContainer>::size_type erase_if(flat_set<Key, Compare, KeyContainer> &c, Predicate pred) {
+    auto keys       = std::move(c).extract();
+    const auto size = keys.size();
+    keys.erase(std::remove_if(keys.begin(), keys.end(), pred), keys.end());
+    const auto erased = size - keys.size();
+    c.replace(std::move(keys));
+    return erased;
+}
+
+#endif
+
+} // namespace backport
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "detail/invoke.hpp"
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <version>
+// <functional> is only needed to alias std::function_ref
+#if defined(__cpp_lib_function_ref) && __cpp_lib_function_ref >= 202306L
+#include <functional>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_function_ref is specifically designed to detect the availability of the std::function_ref feature in
+// the standard library, which was introduced in C++26. The value 202306L represents the date when the feature was added to the
+// standard (June 2023).
+#if defined(__cpp_lib_function_ref) && __cpp_lib_function_ref >= 202306L && !defined(FUNCTION_REF_CUSTOM_IMPL)
+
+// Use std::function_ref if available
+template <typename Signature> using function_ref = std::function_ref<Signature>;
+
+template <auto f> using nontype_t = std::nontype_t<f>;
+template <auto f> inline constexpr nontype_t<f> nontype{};
+
+#else
+
+// Custom implementation for pre-C++26: a non-owning, non-allocating, trivially copyable reference to a callable,
+// two pointers wide (the bound entity and the thunk that calls it)
+
+// Tag for binding a callable known at compile time, so calling it needs no stored pointer at all
+template <auto f> struct nontype_t {
+    explicit nontype_t() = default;
+};
+template <auto f> inline constexpr nontype_t<f> nontype{};
+
+// Primary template
+template <typename Signature> class function_ref;
+
+namespace detail {
+
+template <typename T> struct is_nontype : std::false_type {};
+template <auto f> struct is_nontype<nontype_t<f>> : std::true_type {};
+
+// Helper for invoking with void vs non-void return types
+template <typename R, typename F, typename... Args> constexpr R function_ref_invoke(F &&f, Args &&...args) {
+    if constexpr (std::is_void_v<R>) {
+        detail::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    } else {
+        return detail::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+}
+
+// Shared implementation of the const and non-const specializations, Derived is the function_ref itself
+template <typename Derived, bool Const, bool Noex, typename R, typename... Args> class function_ref_impl {
+  protected:
+    template <typename T> using cv = std::conditional_t<Const, const T, T>;
+
+    // is-invocable-using from [func.wrap.ref.class]
+    template <typename... T>
+    static constexpr bool is_invocable_using =
+        Noex ? std::is_nothrow_invocable_r_v<R, T..., Args...> : std::is_invocable_r_v<R, T..., Args...>;
+
+    // Small trivially copyable arguments are passed by value to the thunk, everything else by reference
+    template <typename T>
+    using param_t =
+        std::conditional_t<!std::is_reference_v<T> && std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void *) * 2, T, T &&>;
+
+    // Either an object pointer or a function pointer, depending on what was bound
+    union bound_entity {
+        void *obj;
+        void (*fn)();
+
+        constexpr bound_entity() noexcept : obj(nullptr) {}
+        constexpr explicit bound_entity(void *p) noexcept : obj(p) {}
+        constexpr explicit bound_entity(void (*f)()) noexcept : fn(f) {}
+    };
+
+    using thunk_t = R (*)(bound_entity, param_t<Args>...) noexcept(Noex);
+
+    template <typename F> static R call_function(bound_entity e, param_t<Args>... args) noexcept(Noex) {
+        return function_ref_invoke<R>(reinterpret_cast<F *>(e.fn), std::forward<param_t<Args>>(args)...);
+    }
+
+    template <typename T> static R call_object(bound_entity e, param_t<Args>... args) noexcept(Noex) {
+        return function_ref_invoke<R>(static_cast<cv<T> &>(*static_cast<T *>(e.obj)), std::forward<param_t<Args>>(args)...);
+    }
+
+    template <auto f> static R call_constant(bound_entity, param_t<Args>... args) noexcept(Noex) {
+        return function_ref_invoke<R>(f, std::forward<param_t<Args>>(args)...);
+    }
+
+    template <auto f, typename T> static R call_bound_object(bound_entity e, param_t<Args>... args) noexcept(Noex) {
+        return function_ref_invoke<R>(f, static_cast<cv<T> &>(*static_cast<T *>(e.obj)), std::forward<param_t<Args>>(args)...);
+    }
+
+    template <auto f, typename T> static R call_bound_pointer(bound_entity e, param_t<Args>... args) noexcept(Noex) {
+        return function_ref_invoke<R>(f, static_cast<cv<T> *>(static_cast<T *>(e.obj)), std::forward<param_t<Args>>(args)...);
+    }
+
+    template <auto f> static constexpr void check_constant() noexcept {
+        if constexpr (std::is_pointer_v<decltype(f)> || std::is_member_pointer_v<decltype(f)>) {
+            assert(f != nullptr && "function_ref cannot bind a null function or member pointer");
+        }
+    }
+
+    bound_entity bound;
+    thunk_t      thunk;
+
+  public:
+    // Reference a function through its pointer
+    template <typename F>
+    function_ref_impl(F *f) noexcept
+        requires(std::is_function_v<F> && is_invocable_using<F>)
+        : bound(reinterpret_cast<void (*)()>(f)), thunk(&call_function<F>) {
+        assert(f != nullptr && "function_ref cannot bind a null function pointer");
+    }
+
+    // Reference any other callable object (or function) without taking ownership, it must outlive the function_ref
+    template <typename F>
+    constexpr function_ref_impl(F &&f) noexcept
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Derived> && !std::is_member_pointer_v<std::remove_reference_t<F>> &&
+                 is_invocable_using<cv<std::remove_reference_t<F>> &>)
+    {
+        using T = std::remove_reference_t<F>;
+        if constexpr (std::is_function_v<T>) {
+            bound = bound_entity(reinterpret_cast<void (*)()>(&f));
+            thunk = &call_function<T>;
+        } else {
+            // std::addressof without <memory>, GCC, Clang and MSVC all implement it with this builtin
+            bound = bound_entity(const_cast<void *>(static_cast<const void *>(__builtin_addressof(f))));
+            thunk = &call_object<T>;
+        }
+    }
+
+    // Call a constant: nothing is bound, the thunk calls f directly
+    template <auto f>
+    constexpr function_ref_impl(nontype_t<f>) noexcept
+        requires(is_invocable_using<const decltype(f) &>)
+        : thunk(&call_constant<f>) {
+        check_constant<f>();
+    }
+
+    // Call a constant with obj as its first argument, e.g. a member function bound to an object
+    template <auto f, typename U>
+    constexpr function_ref_impl(nontype_t<f>, U &&obj) noexcept
+        requires(!std::is_rvalue_reference_v<U &&> && is_invocable_using<const decltype(f) &, cv<std::remove_reference_t<U>> &>)
+        : bound(const_cast<void *>(static_cast<const void *>(__builtin_addressof(obj)))),
+          thunk(&call_bound_object<f, std::remove_reference_t<U>>) {
+        check_constant<f>();
+    }
+
+    // Call a constant with a pointer obj as its first argument
+    template <auto f, typename T>
+    constexpr function_ref_impl(nontype_t<f>, T *obj) noexcept
+        requires(is_invocable_using<const decltype(f) &, cv<T> *>)
+        : bound(const_cast<void *>(static_cast<const void *>(obj))), thunk(&call_bound_pointer<f, T>) {
+        check_constant<f>();
+        if constexpr (std::is_member_pointer_v<decltype(f)>) {
+            assert(obj != nullptr && "function_ref cannot bind a member pointer to a null object");
+        }
+    }
+
+    constexpr function_ref_impl(const function_ref_impl &) noexcept            = default;
+    constexpr function_ref_impl &operator=(const function_ref_impl &) noexcept = default;
+
+    // Rebinding to anything but another function_ref or a constant would leave a dangling reference to a temporary
+    template <typename T>
+        requires(!std::is_same_v<T, Derived> && !std::is_pointer_v<T> && !is_nontype<T>::value)
+    function_ref_impl &operator=(T) = delete;
+
+    R operator()(Args... args) const noexcept(Noex) { return thunk(bound, std::forward<Args>(args)...); }
+};
+
+} // namespace detail
+
+// Specialization for R(Args...) and R(Args...) noexcept
+template <typename R, typename... Args, bool Noex>
+class function_ref<R(Args...) noexcept(Noex)>
+    : public detail::function_ref_impl<function_ref<R(Args...) noexcept(Noex)>, false, Noex, R, Args...> {
+    using base = detail::function_ref_impl<function_ref, false, Noex, R, Args...>;
+
+  public:
+    using base::base;
+    using base::operator=;
+};
+
+// Specialization for R(Args...) const and R(Args...) const noexcept
+template <typename R, typename... Args, bool Noex>
+class function_ref<R(Args...) const noexcept(Noex)>
+    : public detail::function_ref_impl<function_ref<R(Args...) const noexcept(Noex)>, true, Noex, R, Args...> {
+    using base = detail::function_ref_impl<function_ref, true, Noex, R, Args...>;
+
+  public:
+    using base::base;
+    using base::operator=;
+};
+
+// Deduction guides
+template <typename F>
+    requires std::is_function_v<F>
+function_ref(F *) -> function_ref<F>;
+
+template <auto f>
+    requires std::is_function_v<std::remove_pointer_t<decltype(f)>>
+function_ref(nontype_t<f>) -> function_ref<std::remove_pointer_t<decltype(f)>>;
+
+#endif
+
+} // namespace backport
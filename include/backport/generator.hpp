@@ -0,0 +1,407 @@
+#pragma once
+
+#include "detail/config.hpp"
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_generator) && __cpp_lib_generator >= 202207L
+#include <generator>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_generator is specifically designed to detect the availability of the std::generator feature in the
+// standard library, which was introduced in C++23. The value 202207L represents the date when the feature was added to the standard
+// (July 2022).
+#if defined(__cpp_lib_generator) && __cpp_lib_generator >= 202207L && !defined(GENERATOR_CUSTOM_IMPL)
+
+// Use std::generator if available
+template <typename Ref, typename V = void, typename Allocator = void> using generator = std::generator<Ref, V, Allocator>;
+
+namespace ranges {
+using std::ranges::elements_of;
+} // namespace ranges
+
+#else
+
+namespace ranges {
+
+// co_yield ranges::elements_of(r) yields every element of r, a nested generator is resumed directly
+template <typename R, typename Allocator = std::allocator<std::byte>> struct elements_of {
+    BACKPORT_NO_UNIQUE_ADDRESS R         range;
+    BACKPORT_NO_UNIQUE_ADDRESS Allocator allocator = Allocator();
+};
+
+template <typename R, typename Allocator = std::allocator<std::byte>>
+elements_of(R &&, Allocator = Allocator()) -> elements_of<R &&, Allocator>;
+
+} // namespace ranges
+
+template <typename Ref, typename V = void, typename Allocator = void> class generator;
+
+namespace detail {
+
+// Frame allocation. The frame is followed by what operator delete needs to free it: the deallocation function when the
+// allocator is type-erased (generator<Ref, V, void>), then the allocator itself unless it is stateless.
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) generator_frame_block {
+    unsigned char bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+};
+
+template <typename Allocator>
+using generator_block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<generator_frame_block>;
+
+using generator_deallocate_fn = void (*)(void *, std::size_t) noexcept;
+
+constexpr std::size_t generator_round_up(std::size_t n, std::size_t alignment) noexcept { return (n + alignment - 1) & ~(alignment - 1); }
+
+constexpr std::size_t generator_deallocate_offset(std::size_t frame) noexcept {
+    return generator_round_up(frame, alignof(generator_deallocate_fn));
+}
+
+template <typename BlockAllocator, bool Erased> struct generator_frame_layout {
+    using traits = std::allocator_traits<BlockAllocator>;
+
+    static constexpr bool stateless = std::default_initializable<BlockAllocator> && traits::is_always_equal::value;
+
+    static constexpr std::size_t allocator_offset(std::size_t frame) noexcept {
+        return generator_round_up(Erased ? generator_deallocate_offset(frame) + sizeof(generator_deallocate_fn) : frame,
+                                  alignof(BlockAllocator));
+    }
+
+    static constexpr std::size_t blocks(std::size_t frame) noexcept {
+        std::size_t total = frame;
+        if constexpr (!stateless) {
+            total = allocator_offset(frame) + sizeof(BlockAllocator);
+        } else if constexpr (Erased) {
+            total = generator_deallocate_offset(frame) + sizeof(generator_deallocate_fn);
+        }
+        return (total + sizeof(generator_frame_block) - 1) / sizeof(generator_frame_block);
+    }
+
+    static void *allocate(BlockAllocator allocator, std::size_t frame) {
+        void *p     = std::to_address(traits::allocate(allocator, blocks(frame)));
+        auto *bytes = static_cast<unsigned char *>(p);
+        if constexpr (Erased) ::new (bytes + generator_deallocate_offset(frame)) generator_deallocate_fn(&deallocate);
+        if constexpr (!stateless) ::new (bytes + allocator_offset(frame)) BlockAllocator(std::move(allocator));
+        return p;
+    }
+
+    static void deallocate(void *p, std::size_t frame) noexcept {
+        auto *block = static_cast<generator_frame_block *>(p);
+        if constexpr (stateless) {
+            BlockAllocator allocator;
+            traits::deallocate(allocator, block, blocks(frame));
+        } else {
+            auto *bytes  = static_cast<unsigned char *>(p);
+            auto *stored = std::launder(reinterpret_cast<BlockAllocator *>(bytes + allocator_offset(frame)));
+
+            BlockAllocator allocator(std::move(*stored));
+            stored->~BlockAllocator();
+            traits::deallocate(allocator, block, blocks(frame));
+        }
+    }
+};
+
+// The allocator-argument protocol: a coroutine whose parameters start with (std::allocator_arg_t, const Alloc &), after
+// the object parameter for member functions, allocates its frame through that allocator
+template <typename Allocator> class generator_promise_allocator {
+    using block_allocator = generator_block_allocator<Allocator>;
+    using layout          = generator_frame_layout<block_allocator, false>;
+
+  public:
+    static void *operator new(std::size_t frame)
+        requires std::default_initializable<block_allocator>
+    {
+        return layout::allocate(block_allocator(), frame);
+    }
+
+    template <typename Alloc, typename... Args>
+        requires std::convertible_to<const Alloc &, Allocator>
+    static void *operator new(std::size_t frame, std::allocator_arg_t, const Alloc &allocator, const Args &...) {
+        return layout::allocate(block_allocator(static_cast<Allocator>(allocator)), frame);
+    }
+
+    template <typename This, typename Alloc, typename... Args>
+        requires std::convertible_to<const Alloc &, Allocator>
+    static void *operator new(std::size_t frame, const This &, std::allocator_arg_t, const Alloc &allocator, const Args &...) {
+        return layout::allocate(block_allocator(static_cast<Allocator>(allocator)), frame);
+    }
+
+    static void operator delete(void *p, std::size_t frame) noexcept { layout::deallocate(p, frame); }
+};
+
+template <> class generator_promise_allocator<void> {
+    template <typename Alloc> static void *allocate(const Alloc &allocator, std::size_t frame) {
+        using block_allocator = generator_block_allocator<Alloc>;
+        return generator_frame_layout<block_allocator, true>::allocate(block_allocator(allocator), frame);
+    }
+
+  public:
+    static void *operator new(std::size_t frame) { return allocate(std::allocator<void>(), frame); }
+
+    template <typename Alloc, typename... Args>
+    static void *operator new(std::size_t frame, std::allocator_arg_t, const Alloc &allocator, const Args &...) {
+        return allocate(allocator, frame);
+    }
+
+    template <typename This, typename Alloc, typename... Args>
+    static void *operator new(std::size_t frame, const This &, std::allocator_arg_t, const Alloc &allocator, const Args &...) {
+        return allocate(allocator, frame);
+    }
+
+    static void operator delete(void *p, std::size_t frame) noexcept {
+        auto deallocate = *std::launder(reinterpret_cast<generator_deallocate_fn *>(static_cast<unsigned char *>(p) +
+                                                                                   generator_deallocate_offset(frame)));
+        deallocate(p, frame);
+    }
+};
+
+// Shared by the promises of all generators with the same yielded type, so they can nest. The root promise (the generator
+// the consumer iterates) tracks the innermost active coroutine: the iterator resumes it directly and reads the value it
+// yielded, and a finished nested generator transfers control straight back to its parent, so resuming and reading are
+// O(1) at any depth. Destroying a nest has to visit every level, it does so in a loop from the innermost frame out.
+template <typename Yielded> class generator_promise_base {
+    template <typename, typename, typename> friend class backport::generator;
+
+    struct nest_info {
+        std::exception_ptr      exception;
+        std::coroutine_handle<> self; // The nested frame, owned by its parent's nested_awaiter
+        std::coroutine_handle<> parent;
+        generator_promise_base *parent_promise;
+        generator_promise_base *root;
+    };
+
+    std::add_pointer_t<Yielded> value = nullptr;
+    nest_info                  *nest  = nullptr; // Null for the root
+
+    // Only used by the root
+    generator_promise_base *top = this;
+    std::coroutine_handle<> top_handle;
+
+    struct final_awaiter {
+        static constexpr bool await_ready() noexcept { return false; }
+
+        template <typename Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            nest_info *info = h.promise().nest;
+            if (!info) return std::noop_coroutine();
+            info->root->top        = info->parent_promise;
+            info->root->top_handle = info->parent;
+            return info->parent;
+        }
+
+        static constexpr void await_resume() noexcept {}
+    };
+
+    // Holds a copy of an lvalue yielded by a generator of rvalue references until it is resumed
+    struct element_awaiter {
+        std::remove_cvref_t<Yielded> element;
+
+        static constexpr bool await_ready() noexcept { return false; }
+
+        template <typename Promise> void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            h.promise().value = std::addressof(element);
+        }
+
+        static constexpr void await_resume() noexcept {}
+    };
+
+    class nested_awaiter {
+        nest_info               info{};
+        generator_promise_base *child = nullptr;
+
+      public:
+        template <typename Generator> explicit nested_awaiter(Generator &&nested) noexcept {
+            if (!nested.coro) return;
+            child     = &nested.coro.promise();
+            info.self = std::exchange(nested.coro, {});
+        }
+
+        nested_awaiter(const nested_awaiter &)            = delete;
+        nested_awaiter &operator=(const nested_awaiter &) = delete;
+
+        ~nested_awaiter() {
+            if (info.self) info.self.destroy();
+        }
+
+        bool await_ready() const noexcept { return !info.self; }
+
+        template <typename Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            generator_promise_base &parent = h.promise();
+
+            info.parent           = h;
+            info.parent_promise   = &parent;
+            info.root             = parent.nest ? parent.nest->root : &parent;
+            info.root->top        = child;
+            info.root->top_handle = info.self;
+            child->nest           = &info;
+            return info.self;
+        }
+
+        void await_resume() {
+            if (info.exception) std::rethrow_exception(std::move(info.exception));
+        }
+    };
+
+  public:
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter       final_suspend() noexcept { return {}; }
+
+    // References are yielded without a copy, the operand lives until the generator is resumed
+    std::suspend_always yield_value(Yielded v) noexcept {
+        value = std::addressof(v);
+        return {};
+    }
+
+    auto yield_value(const std::remove_reference_t<Yielded> &v)
+        requires std::is_rvalue_reference_v<Yielded> &&
+                 std::constructible_from<std::remove_cvref_t<Yielded>, const std::remove_reference_t<Yielded> &>
+    {
+        return element_awaiter{v};
+    }
+
+    template <typename R2, typename V2, typename A2, typename Unused>
+        requires std::same_as<typename generator<R2, V2, A2>::yielded, Yielded>
+    auto yield_value(ranges::elements_of<generator<R2, V2, A2> &&, Unused> g) noexcept {
+        return nested_awaiter(std::move(g.range));
+    }
+
+    template <std::ranges::input_range R, typename Alloc>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, Yielded>
+    auto yield_value(ranges::elements_of<R, Alloc> r) {
+// GCC 12 without optimization flags the frame allocated by a templated placement operator new and freed by the usual
+// operator delete as a mismatch (-Wmismatched-new-delete), which is what the allocator-argument protocol requires
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+        auto elements = [](std::allocator_arg_t, Alloc, std::ranges::iterator_t<R> it,
+                           std::ranges::sentinel_t<R> last) -> generator<Yielded, std::ranges::range_value_t<R>, Alloc> {
+            for (; it != last; ++it) co_yield static_cast<Yielded>(*it);
+        };
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+        return yield_value(
+            ranges::elements_of(elements(std::allocator_arg, r.allocator, std::ranges::begin(r.range), std::ranges::end(r.range))));
+    }
+
+    void await_transform() = delete;
+
+    // Called on the root before its own frame goes. Each frame owns the one it delegates to, destroying the root alone
+    // would tear the nest down recursively and take a stack frame per level.
+    void destroy_nested() noexcept {
+        for (generator_promise_base *p = top; p != this;) {
+            nest_info *info = p->nest;
+            p               = info->parent_promise;
+            std::exchange(info->self, {}).destroy();
+        }
+        top        = this;
+        top_handle = {};
+    }
+
+    void return_void() const noexcept {}
+
+    // A nested generator hands the exception to its parent, the root rethrows it to the consumer
+    void unhandled_exception() {
+        if (!nest) throw;
+        nest->exception = std::current_exception();
+    }
+};
+
+} // namespace detail
+
+// Custom implementation for pre-C++23, the std::generator design: a move-only input view over the values a coroutine
+// yields, with ranges::elements_of for recursion and the allocator-argument protocol for the frames
+template <typename Ref, typename V, typename Allocator> class generator : public std::ranges::view_interface<generator<Ref, V, Allocator>> {
+    using value     = std::conditional_t<std::is_void_v<V>, std::remove_cvref_t<Ref>, V>;
+    using reference = std::conditional_t<std::is_void_v<V>, Ref &&, Ref>;
+
+    static_assert(std::is_same_v<std::remove_cvref_t<value>, value> && std::is_object_v<value>,
+                  "the value type must be a cv-unqualified object type");
+    static_assert(std::is_reference_v<reference> || (std::is_object_v<reference> && std::copy_constructible<reference>),
+                  "the reference type must be a reference or a copyable object type");
+
+  public:
+    using yielded = std::conditional_t<std::is_reference_v<reference>, reference, const reference &>;
+
+    class promise_type : public detail::generator_promise_base<yielded>, public detail::generator_promise_allocator<Allocator> {
+      public:
+        generator get_return_object() noexcept {
+            auto h           = std::coroutine_handle<promise_type>::from_promise(*this);
+            this->top_handle = h;
+            return generator(h);
+        }
+    };
+
+    class iterator {
+        friend generator;
+
+        std::coroutine_handle<promise_type> coro;
+
+        explicit iterator(std::coroutine_handle<promise_type> h) noexcept : coro(h) {}
+
+      public:
+        using value_type      = generator::value;
+        using difference_type = std::ptrdiff_t;
+
+        iterator(iterator &&other) noexcept : coro(std::exchange(other.coro, {})) {}
+        iterator &operator=(iterator &&other) noexcept {
+            coro = std::exchange(other.coro, {});
+            return *this;
+        }
+
+        reference operator*() const noexcept(std::is_nothrow_copy_constructible_v<reference>) {
+            return static_cast<reference>(*coro.promise().top->value);
+        }
+
+        iterator &operator++() {
+            coro.promise().top_handle.resume();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator &it, std::default_sentinel_t) noexcept { return it.coro.done(); }
+    };
+
+    generator(const generator &) = delete;
+    generator(generator &&other) noexcept : coro(std::exchange(other.coro, {})) {}
+    ~generator() {
+        if (!coro) return;
+        coro.promise().destroy_nested();
+        coro.destroy();
+    }
+
+    generator &operator=(generator other) noexcept {
+        std::swap(coro, other.coro);
+        return *this;
+    }
+
+    // Starts the coroutine, call once
+    iterator begin() {
+        coro.resume();
+        return iterator(coro);
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+  private:
+    template <typename> friend class detail::generator_promise_base;
+
+    std::coroutine_handle<promise_type> coro;
+
+    explicit generator(std::coroutine_handle<promise_type> h) noexcept : coro(h) {}
+};
+
+#endif
+
+} // namespace backport
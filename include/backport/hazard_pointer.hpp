@@ -0,0 +1,311 @@
+#pragma once
+
+#include "detail/config.hpp"
+#include "move_only_function.hpp"
+#include "task_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <version>
+#if __has_include(<hazard_pointer>)
+#include <hazard_pointer>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_hazard_pointer is specifically designed to detect the availability of std::hazard_pointer in the
+// standard library, which was introduced in C++26. The value 202306L represents the date when the feature was added to the standard
+// (June 2023).
+#if defined(__cpp_lib_hazard_pointer) && __cpp_lib_hazard_pointer >= 202306L && !defined(HAZARD_POINTER_CUSTOM_IMPL)
+
+// Use std::hazard_pointer if available
+using std::hazard_pointer;
+using std::hazard_pointer_obj_base;
+using std::make_hazard_pointer;
+
+#else
+
+// Custom implementation for pre-C++26 (P2530). A hazard pointer is a single-writer slot on its own cache line: protecting an
+// object writes only that slot, so readers on different cores never write to a shared line. Retired objects are kept on a
+// list until a scan finds no slot pointing at them.
+namespace detail {
+
+// The deleter and the object pointer are stored inline in the retired object, retire never allocates. A deleter larger than a
+// pointer fails to compile.
+using hazard_reclaim = basic_move_only_function<void() noexcept, 2 * sizeof(void *), alignof(void *),
+                                                function_options::compact | function_options::inplace>;
+
+template <typename T, typename D> struct hazard_retire_call {
+    BACKPORT_NO_UNIQUE_ADDRESS D deleter;
+    T                      *object;
+
+    void operator()() noexcept { deleter(object); }
+};
+
+struct hazard_retired {
+    hazard_retired *next   = nullptr;
+    const void     *object = nullptr;
+    hazard_reclaim  reclaim;
+};
+
+struct alignas(cache_line_size) hazard_record {
+    std::atomic<const void *> protected_object{nullptr};
+    std::atomic<bool>         in_use{false};
+    hazard_record            *next = nullptr;
+};
+
+class hazard_domain {
+    // Retired objects scanned at once: enough that a scan is amortized over many retirements, few enough that memory held
+    // by retired objects stays bounded. Scaled with the number of slots, each of which can keep one object alive.
+    static constexpr std::size_t retire_batch = 64;
+
+    std::atomic<hazard_record *>  records{nullptr};
+    std::atomic<std::size_t>      record_count{0};
+    std::atomic<hazard_retired *> retired{nullptr};
+    std::atomic<std::size_t>      retired_count{0};
+
+    void push(hazard_retired *first, hazard_retired *last) noexcept {
+        last->next = retired.load(std::memory_order_relaxed);
+        while (!retired.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool is_protected(const void *object) const noexcept {
+        for (hazard_record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            if (r->protected_object.load(std::memory_order_acquire) == object) return true;
+        }
+        return false;
+    }
+
+    // Set while this thread runs deleters, a deleter retiring another object must not start a nested scan
+    static bool &reclaiming() noexcept {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    hazard_domain() = default;
+
+  public:
+    hazard_domain(const hazard_domain &)            = delete;
+    hazard_domain &operator=(const hazard_domain &) = delete;
+
+    // Nothing can be protected once the program exits, everything still retired is reclaimed
+    ~hazard_domain() {
+        // A deleter may retire further objects, drain until nothing is left
+        while (hazard_retired *node = retired.exchange(nullptr, std::memory_order_acquire)) {
+            while (node != nullptr) {
+                hazard_retired *next    = node->next;
+                hazard_reclaim  reclaim = std::move(node->reclaim);
+                reclaim();
+                node = next;
+            }
+        }
+        for (hazard_record *r = records.load(std::memory_order_acquire); r != nullptr;) {
+            delete std::exchange(r, r->next);
+        }
+    }
+
+    static hazard_domain &instance() noexcept {
+        static hazard_domain domain;
+        return domain;
+    }
+
+    // Reuse a free slot, or add one
+    hazard_record *acquire() {
+        for (hazard_record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed) &&
+                r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return r;
+            }
+        }
+        auto *r = new hazard_record;
+        r->in_use.store(true, std::memory_order_relaxed);
+        r->next = records.load(std::memory_order_relaxed);
+        while (!records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        record_count.fetch_add(1, std::memory_order_relaxed);
+        return r;
+    }
+
+    void release(hazard_record *r) noexcept {
+        r->protected_object.store(nullptr, std::memory_order_release);
+        r->in_use.store(false, std::memory_order_release);
+    }
+
+    void retire(hazard_retired *node) noexcept {
+        push(node, node);
+        const std::size_t pending = retired_count.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (pending >= retire_batch + 2 * record_count.load(std::memory_order_relaxed) && !reclaiming()) reclaim();
+    }
+
+    // Reclaim every retired object no slot protects, the others go back on the list
+    void reclaim() noexcept {
+        hazard_retired *node = retired.exchange(nullptr, std::memory_order_acquire);
+        if (node == nullptr) return;
+        // Pairs with the exchange in try_protect: a reader either published its slot before this fence, or it reloads the
+        // source after it and sees that the object was unlinked
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // The protected pointers, collected once and searched per retired object
+        thread_local std::vector<const void *> hazards;
+        bool                                   collected = true;
+        hazards.clear();
+        try {
+            for (hazard_record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                if (const void *p = r->protected_object.load(std::memory_order_acquire)) hazards.push_back(p);
+            }
+            std::sort(hazards.begin(), hazards.end());
+        } catch (...) {
+            collected = false; // Out of memory, scan the slots for every object instead
+        }
+
+        reclaiming()              = true;
+        hazard_retired *kept      = nullptr;
+        hazard_retired *kept_last = nullptr;
+        std::size_t     reclaimed = 0;
+        while (node != nullptr) {
+            hazard_retired *next = node->next;
+            if (collected ? std::binary_search(hazards.begin(), hazards.end(), node->object) : is_protected(node->object)) {
+                node->next = kept;
+                if (kept == nullptr) kept_last = node;
+                kept = node;
+            } else {
+                // The deleter frees the node it is stored in, move it out first
+                hazard_reclaim reclaim = std::move(node->reclaim);
+                reclaim();
+                ++reclaimed;
+            }
+            node = next;
+        }
+        reclaiming() = false;
+        retired_count.fetch_sub(reclaimed, std::memory_order_relaxed);
+        if (kept != nullptr) push(kept, kept_last);
+    }
+};
+
+// One slot per thread is kept for reuse, so making a hazard pointer in a loop does not scan the slots each time
+struct hazard_cache {
+    hazard_record *record = nullptr;
+
+    ~hazard_cache() {
+        if (record != nullptr) hazard_domain::instance().release(record);
+    }
+
+    static hazard_cache &local() noexcept {
+        thread_local hazard_cache cache;
+        return cache;
+    }
+};
+
+} // namespace detail
+
+// Base class of objects protected by hazard pointers: T derives from hazard_pointer_obj_base<T, D> and is reclaimed with D
+// once no hazard pointer protects it
+template <typename T, typename D = std::default_delete<T>> class hazard_pointer_obj_base : private detail::hazard_retired {
+  public:
+    // Preconditions: the object is unreachable for new readers, e.g. unlinked from the atomic pointer they protect
+    void retire(D d = D()) noexcept {
+        T *self      = static_cast<T *>(this);
+        this->object = self;
+        this->reclaim = detail::hazard_retire_call<T, D>{std::move(d), self};
+        detail::hazard_domain::instance().retire(this);
+    }
+
+  protected:
+    hazard_pointer_obj_base() = default;
+    // Copies are separate objects, retired on their own
+    hazard_pointer_obj_base(const hazard_pointer_obj_base &) noexcept : detail::hazard_retired() {}
+    hazard_pointer_obj_base(hazard_pointer_obj_base &&) noexcept : detail::hazard_retired() {}
+    hazard_pointer_obj_base &operator=(const hazard_pointer_obj_base &) noexcept { return *this; }
+    hazard_pointer_obj_base &operator=(hazard_pointer_obj_base &&) noexcept { return *this; }
+    ~hazard_pointer_obj_base() = default;
+};
+
+class hazard_pointer {
+    detail::hazard_record *record = nullptr;
+
+    friend hazard_pointer make_hazard_pointer();
+
+    explicit hazard_pointer(detail::hazard_record *r) noexcept : record(r) {}
+
+    // The thread keeps one slot for its next hazard pointer, the others go back to the domain
+    void release() noexcept {
+        if (record == nullptr) return;
+        detail::hazard_cache &cache = detail::hazard_cache::local();
+        if (cache.record == nullptr) {
+            record->protected_object.store(nullptr, std::memory_order_release);
+            cache.record = record;
+        } else {
+            detail::hazard_domain::instance().release(record);
+        }
+        record = nullptr;
+    }
+
+  public:
+    // An empty hazard pointer, it cannot protect anything
+    hazard_pointer() noexcept = default;
+
+    hazard_pointer(hazard_pointer &&other) noexcept : record(std::exchange(other.record, nullptr)) {}
+
+    hazard_pointer &operator=(hazard_pointer &&other) noexcept {
+        if (this != &other) {
+            release();
+            record = std::exchange(other.record, nullptr);
+        }
+        return *this;
+    }
+
+    ~hazard_pointer() { release(); }
+
+    [[nodiscard]] bool empty() const noexcept { return record == nullptr; }
+
+    // Protect the object src points to, the returned pointer stays valid until the protection is reset
+    // Preconditions: !empty()
+    template <typename T> T *protect(const std::atomic<T *> &src) noexcept {
+        T *ptr = src.load(std::memory_order_relaxed);
+        while (!try_protect(ptr, src)) {
+        }
+        return ptr;
+    }
+
+    // Protect ptr if src still points to it, otherwise ptr is set to the current value of src and false is returned
+    // Preconditions: !empty()
+    template <typename T> bool try_protect(T *&ptr, const std::atomic<T *> &src) noexcept {
+        T *expected = ptr;
+        // A seq_cst exchange and a seq_cst reload: either a scan sees the slot, or the reload sees the object was replaced
+        record->protected_object.exchange(expected, std::memory_order_seq_cst);
+        ptr = src.load(std::memory_order_seq_cst);
+        if (ptr != expected) {
+            reset_protection();
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T> void reset_protection(const T *ptr) noexcept { record->protected_object.store(ptr, std::memory_order_release); }
+
+    void reset_protection(std::nullptr_t = nullptr) noexcept { record->protected_object.store(nullptr, std::memory_order_release); }
+
+    void swap(hazard_pointer &other) noexcept { std::swap(record, other.record); }
+};
+
+inline hazard_pointer make_hazard_pointer() {
+    detail::hazard_cache &cache = detail::hazard_cache::local();
+    if (cache.record != nullptr) return hazard_pointer(std::exchange(cache.record, nullptr));
+    return hazard_pointer(detail::hazard_domain::instance().acquire());
+}
+
+inline void swap(hazard_pointer &lhs, hazard_pointer &rhs) noexcept { lhs.swap(rhs); }
+
+// Reclaim every retired object that is no longer protected now, instead of at the next scan. Not part of P2530 (folly calls it
+// hazptr_cleanup), useful before checking for leaks and in tests.
+inline void hazard_pointer_clean_up() noexcept { detail::hazard_domain::instance().reclaim(); }
+
+#endif
+
+} // namespace backport
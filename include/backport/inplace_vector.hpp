@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_inplace_vector) && __cpp_lib_inplace_vector >= 202406L
+#include <inplace_vector>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_inplace_vector is specifically designed to detect the availability of the std::inplace_vector
+// feature in the standard library, which was introduced in C++26. The value 202406L represents the date when the feature was added to
+// the standard (June 2024).
+#if defined(__cpp_lib_inplace_vector) && __cpp_lib_inplace_vector >= 202406L && !defined(INPLACE_VECTOR_CUSTOM_IMPL)
+
+// Use std::inplace_vector if available
+template <typename T, std::size_t N> using inplace_vector = std::inplace_vector<T, N>;
+
+#else
+
+namespace detail {
+
+// Smallest unsigned type that can count to N, so inplace_vector<std::byte, 15> is 16 bytes
+template <std::size_t N>
+using inplace_size_t = std::conditional_t<N <= UINT8_MAX, std::uint8_t,
+                                          std::conditional_t<N <= UINT16_MAX, std::uint16_t,
+                                                             std::conditional_t<N <= UINT32_MAX, std::uint32_t, std::size_t>>>;
+
+// Elements live in an anonymous union so they are only constructed on demand. For trivially copyable T the union and with it
+// the whole container are trivially copyable: a copy is a memcpy of all N slots, which beats a loop for the small N this is
+// used with.
+template <typename T, std::size_t N, bool = std::is_trivially_copyable_v<T>> struct inplace_storage {
+    union {
+        T elems[N];
+    };
+    inplace_size_t<N> count = 0;
+
+    constexpr inplace_storage() noexcept {}
+
+    constexpr T       *data() noexcept { return elems; }
+    constexpr const T *data() const noexcept { return elems; }
+};
+
+template <typename T, std::size_t N>
+    requires(N != 0)
+struct inplace_storage<T, N, false> {
+    union {
+        T elems[N];
+    };
+    inplace_size_t<N> count = 0;
+
+    constexpr inplace_storage() noexcept {}
+
+    constexpr inplace_storage(const inplace_storage &other) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        construct_from(other.elems, other.elems + other.count);
+    }
+
+    constexpr inplace_storage(inplace_storage &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        construct_from(std::make_move_iterator(other.elems), std::make_move_iterator(other.elems + other.count));
+    }
+
+    constexpr inplace_storage &operator=(const inplace_storage &other) noexcept(std::is_nothrow_copy_constructible_v<T> &&
+                                                                               std::is_nothrow_copy_assignable_v<T>) {
+        if (this != &other) assign(other.elems, other.count);
+        return *this;
+    }
+
+    constexpr inplace_storage &operator=(inplace_storage &&other) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                                                          std::is_nothrow_move_assignable_v<T>) {
+        if (this != &other) assign(std::make_move_iterator(other.elems), other.count);
+        return *this;
+    }
+
+    constexpr ~inplace_storage() { std::destroy(elems, elems + count); }
+
+    constexpr T       *data() noexcept { return elems; }
+    constexpr const T *data() const noexcept { return elems; }
+
+  private:
+    // The destructor does not run for a constructor that throws
+    template <typename It> constexpr void construct_from(It first, It last) {
+        try {
+            append(first, last);
+        } catch (...) {
+            std::destroy(elems, elems + count);
+            throw;
+        }
+    }
+
+    template <typename It> constexpr void append(It first, It last) {
+        for (; first != last; ++first, ++count) std::construct_at(elems + count, *first);
+    }
+
+    // Assigns over the live prefix, then constructs or destroys the difference
+    template <typename It> constexpr void assign(It first, std::size_t n) {
+        const std::size_t common = std::min<std::size_t>(n, count);
+        std::copy(first, first + static_cast<std::ptrdiff_t>(common), elems);
+        if (n < count) {
+            std::destroy(elems + n, elems + count);
+            count = static_cast<inplace_size_t<N>>(n);
+        } else {
+            append(first + static_cast<std::ptrdiff_t>(common), first + static_cast<std::ptrdiff_t>(n));
+        }
+    }
+};
+
+// Zero capacity holds nothing at all
+template <typename T, bool Trivial> struct inplace_storage<T, 0, Trivial> {
+    std::uint8_t count = 0;
+
+    static constexpr T *data() noexcept { return nullptr; }
+};
+
+} // namespace detail
+
+// Custom implementation for pre-C++26: a vector with the capacity N fixed at compile time and the elements stored inline, so
+// it never allocates. Exceeding the capacity throws std::bad_alloc from the throwing members, try_push_back and friends
+// return nullptr instead and the unchecked_ members leave it as a precondition.
+template <typename T, std::size_t N> class inplace_vector {
+  public:
+    using value_type             = T;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = value_type &;
+    using const_reference        = const value_type &;
+    using pointer                = value_type *;
+    using const_pointer          = const value_type *;
+    using iterator               = pointer;
+    using const_iterator         = const_pointer;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr inplace_vector() noexcept = default;
+
+    constexpr explicit inplace_vector(size_type n) {
+        check_capacity(n);
+        while (size() < n) unchecked_emplace_back();
+    }
+
+    constexpr inplace_vector(size_type n, const T &value) { assign(n, value); }
+
+    template <std::input_iterator It> constexpr inplace_vector(It first, It last) { assign(first, last); }
+
+    constexpr inplace_vector(std::initializer_list<T> il) { assign(il); }
+
+    constexpr inplace_vector &operator=(std::initializer_list<T> il) {
+        assign(il);
+        return *this;
+    }
+
+    constexpr void assign(size_type n, const T &value) {
+        check_capacity(n);
+        clear();
+        while (size() < n) unchecked_push_back(value);
+    }
+
+    template <std::input_iterator It> constexpr void assign(It first, It last) {
+        if constexpr (std::forward_iterator<It>) check_capacity(static_cast<size_type>(std::distance(first, last)));
+        clear();
+        for (; first != last; ++first) emplace_back(*first);
+    }
+
+    constexpr void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+    // Iterators
+    constexpr iterator               begin() noexcept { return data(); }
+    constexpr const_iterator         begin() const noexcept { return data(); }
+    constexpr iterator               end() noexcept { return data() + size(); }
+    constexpr const_iterator         end() const noexcept { return data() + size(); }
+    constexpr reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr reverse_iterator       rend() noexcept { return reverse_iterator(begin()); }
+    constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    constexpr const_iterator         cbegin() const noexcept { return begin(); }
+    constexpr const_iterator         cend() const noexcept { return end(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // Size and capacity
+    [[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr size_type          size() const noexcept { return storage.count; }
+    static constexpr size_type   max_size() noexcept { return N; }
+    static constexpr size_type   capacity() noexcept { return N; }
+
+    constexpr void resize(size_type n) {
+        check_capacity(n);
+        if (n < size()) return truncate(n);
+        while (size() < n) unchecked_emplace_back();
+    }
+
+    constexpr void resize(size_type n, const T &value) {
+        check_capacity(n);
+        if (n < size()) return truncate(n);
+        while (size() < n) unchecked_push_back(value);
+    }
+
+    static constexpr void reserve(size_type n) { check_capacity(n); }
+    static constexpr void shrink_to_fit() noexcept {}
+
+    // Element access
+    constexpr reference       operator[](size_type i) { return data()[i]; }
+    constexpr const_reference operator[](size_type i) const { return data()[i]; }
+    constexpr reference       at(size_type i) { return i < size() ? data()[i] : throw std::out_of_range("backport::inplace_vector::at"); }
+    constexpr const_reference at(size_type i) const {
+        return i < size() ? data()[i] : throw std::out_of_range("backport::inplace_vector::at");
+    }
+    constexpr reference       front() { return data()[0]; }
+    constexpr const_reference front() const { return data()[0]; }
+    constexpr reference       back() { return data()[size() - 1]; }
+    constexpr const_reference back() const { return data()[size() - 1]; }
+
+    constexpr T       *data() noexcept { return storage.data(); }
+    constexpr const T *data() const noexcept { return storage.data(); }
+
+    // Modifiers
+    template <typename... Args> constexpr reference emplace_back(Args &&...args) {
+        if (size() == N) throw std::bad_alloc();
+        return unchecked_emplace_back(std::forward<Args>(args)...);
+    }
+    constexpr reference push_back(const T &value) { return emplace_back(value); }
+    constexpr reference push_back(T &&value) { return emplace_back(std::move(value)); }
+
+    // Never throws because of the capacity, the fast path for code that handles a full buffer itself
+    template <typename... Args> constexpr pointer try_emplace_back(Args &&...args) {
+        if (size() == N) return nullptr;
+        return std::addressof(unchecked_emplace_back(std::forward<Args>(args)...));
+    }
+    constexpr pointer try_push_back(const T &value) { return try_emplace_back(value); }
+    constexpr pointer try_push_back(T &&value) { return try_emplace_back(std::move(value)); }
+
+    template <typename... Args> constexpr reference unchecked_emplace_back(Args &&...args) {
+        T *slot = std::construct_at(data() + size(), std::forward<Args>(args)...);
+        ++storage.count;
+        return *slot;
+    }
+    constexpr reference unchecked_push_back(const T &value) { return unchecked_emplace_back(value); }
+    constexpr reference unchecked_push_back(T &&value) { return unchecked_emplace_back(std::move(value)); }
+
+    template <typename R>
+        requires requires(R &&r) {
+            { std::ranges::begin(r) } -> std::input_iterator;
+            std::ranges::end(r);
+        }
+    constexpr void append_range(R &&r) {
+        auto first = std::ranges::begin(r);
+        auto last  = std::ranges::end(r);
+        for (; first != last; ++first) emplace_back(*first);
+    }
+
+    // Appends until full, returns an iterator to the first element that did not fit
+    template <typename R>
+        requires requires(R &&r) {
+            { std::ranges::begin(r) } -> std::input_iterator;
+            std::ranges::end(r);
+        }
+    constexpr auto try_append_range(R &&r) {
+        auto first = std::ranges::begin(r);
+        auto last  = std::ranges::end(r);
+        for (; size() != N && first != last; ++first) unchecked_emplace_back(*first);
+        return first;
+    }
+
+    constexpr void pop_back() { std::destroy_at(data() + --storage.count); }
+
+    template <typename... Args> constexpr iterator emplace(const_iterator position, Args &&...args) {
+        const auto offset = position - begin();
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + offset, end() - 1, end());
+        return begin() + offset;
+    }
+
+    constexpr iterator insert(const_iterator position, const T &value) { return emplace(position, value); }
+    constexpr iterator insert(const_iterator position, T &&value) { return emplace(position, std::move(value)); }
+
+    constexpr iterator insert(const_iterator position, size_type n, const T &value) {
+        const auto offset = position - begin();
+        check_capacity(size() + n);
+        const auto old_size = size();
+        for (size_type i = 0; i < n; ++i) unchecked_push_back(value);
+        std::rotate(begin() + offset, begin() + old_size, end());
+        return begin() + offset;
+    }
+
+    template <std::input_iterator It> constexpr iterator insert(const_iterator position, It first, It last) {
+        const auto offset = position - begin();
+        if constexpr (std::forward_iterator<It>) check_capacity(size() + static_cast<size_type>(std::distance(first, last)));
+        const auto old_size = size();
+        try {
+            for (; first != last; ++first) emplace_back(*first);
+        } catch (...) {
+            truncate(old_size);
+            throw;
+        }
+        std::rotate(begin() + offset, begin() + old_size, end());
+        return begin() + offset;
+    }
+
+    constexpr iterator insert(const_iterator position, std::initializer_list<T> il) { return insert(position, il.begin(), il.end()); }
+
+    constexpr iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+    constexpr iterator erase(const_iterator first, const_iterator last) {
+        iterator out = begin() + (first - begin());
+        if (first != last) truncate(static_cast<size_type>(std::move(begin() + (last - begin()), end(), out) - begin()));
+        return out;
+    }
+
+    constexpr void clear() noexcept { truncate(0); }
+
+    constexpr void swap(inplace_vector &other) noexcept(std::is_nothrow_swappable_v<T> && std::is_nothrow_move_constructible_v<T>) {
+        inplace_vector &shorter = size() < other.size() ? *this : other;
+        inplace_vector &longer  = size() < other.size() ? other : *this;
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        const auto common = shorter.size();
+        for (size_type i = common; i < longer.size(); ++i) shorter.unchecked_emplace_back(std::move(longer[i]));
+        longer.truncate(common);
+    }
+
+    friend constexpr void swap(inplace_vector &a, inplace_vector &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+    friend constexpr bool operator==(const inplace_vector &a, const inplace_vector &b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend constexpr auto operator<=>(const inplace_vector &a, const inplace_vector &b)
+        requires requires(const T &x) { x < x; }
+    {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), [](const T &x, const T &y) {
+            if constexpr (std::three_way_comparable<T>) {
+                return x <=> y;
+            } else {
+                if (x < y) return std::weak_ordering::less;
+                if (y < x) return std::weak_ordering::greater;
+                return std::weak_ordering::equivalent;
+            }
+        });
+    }
+
+  private:
+    detail::inplace_storage<T, N> storage;
+
+    static constexpr void check_capacity(size_type n) {
+        if (n > N) throw std::bad_alloc();
+    }
+
+    constexpr void truncate(size_type n) noexcept {
+        std::destroy(begin() + n, end());
+        storage.count = static_cast<detail::inplace_size_t<N>>(n);
+    }
+};
+
+template <typename T, std::size_t N, typename U = T> constexpr std::size_t erase(inplace_vector<T, N> &c, const U &value) {
+    auto       it = std::remove(c.begin(), c.end(), value);
+    const auto n  = static_cast<std::size_t>(c.end() - it);
+    c.erase(it, c.end());
+    return n;
+}
+
+template <typename T, std::size_t N, typename Predicate> constexpr std::size_t erase_if(inplace_vector<T, N> &c, Predicate pred) {
+    auto       it = std::remove_if(c.begin(), c.end(), pred);
+    const auto n  = static_cast<std::size_t>(c.end() - it);
+    c.erase(it, c.end());
+    return n;
+}
+
+#endif
+
+} // namespace backport
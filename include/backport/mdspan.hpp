@@ -0,0 +1,833 @@
+#pragma once
+
+#include "detail/config.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_mdspan) && __cpp_lib_mdspan >= 202207L
+#include <mdspan>
+#endif
+
+namespace backport {
+
+using std::dynamic_extent;
+
+// The feature test macro __cpp_lib_mdspan is specifically designed to detect the availability of the std::mdspan feature in the
+// standard library, which was introduced in C++23. The value 202207L represents the date when the feature was added to the standard
+// (July 2022).
+#if defined(__cpp_lib_mdspan) && __cpp_lib_mdspan >= 202207L && !defined(MDSPAN_CUSTOM_IMPL)
+
+// Use std::mdspan if available
+using std::default_accessor;
+using std::dextents;
+using std::extents;
+using std::layout_left;
+using std::layout_right;
+using std::layout_stride;
+using std::mdspan;
+
+#if __cpp_lib_mdspan >= 202406L
+using std::dims;
+#else
+template <std::size_t Rank, typename IndexType = std::size_t> using dims = std::dextents<IndexType, Rank>;
+#endif
+
+#else
+
+namespace detail {
+
+template <typename From, typename IndexType>
+concept mdspan_index_like = std::is_convertible_v<const From &, IndexType> && std::is_nothrow_constructible_v<IndexType, const From &>;
+
+// Only the dynamic extents are stored, extents with none of them are empty
+template <typename IndexType, std::size_t N> struct dynamic_extents_storage {
+    std::array<IndexType, N> values{};
+
+    constexpr IndexType get(std::size_t i) const noexcept { return values[i]; }
+    constexpr void      set(std::size_t i, IndexType v) noexcept { values[i] = v; }
+};
+
+template <typename IndexType> struct dynamic_extents_storage<IndexType, 0> {
+    constexpr IndexType get(std::size_t) const noexcept { return 0; }
+    constexpr void      set(std::size_t, IndexType) noexcept {}
+};
+
+} // namespace detail
+
+// Custom implementation for pre-C++23
+template <typename IndexType, std::size_t... Extents> class extents {
+    static_assert(std::is_integral_v<IndexType> && !std::is_same_v<IndexType, bool>, "IndexType must be an integral type other than bool");
+    static_assert(((Extents == dynamic_extent || std::in_range<IndexType>(Extents)) && ...), "each static extent must fit in IndexType");
+
+  public:
+    using index_type = IndexType;
+    using size_type  = std::make_unsigned_t<index_type>;
+    using rank_type  = std::size_t;
+
+    static constexpr rank_type rank() noexcept { return sizeof...(Extents); }
+    static constexpr rank_type rank_dynamic() noexcept { return ((Extents == dynamic_extent ? 1 : 0) + ... + 0); }
+    static constexpr std::size_t static_extent(rank_type r) noexcept { return static_extents[r]; }
+
+    constexpr index_type extent(rank_type r) const noexcept {
+        if (static_extents[r] == dynamic_extent) return dynamic.get(dynamic_index[r]);
+        return static_cast<index_type>(static_extents[r]);
+    }
+
+    constexpr extents() noexcept = default;
+
+    // Either every extent or only the dynamic ones
+    template <typename... OtherIndexTypes>
+        requires((detail::mdspan_index_like<OtherIndexTypes, index_type> && ...) &&
+                 (sizeof...(OtherIndexTypes) == rank_dynamic() || sizeof...(OtherIndexTypes) == rank()))
+    constexpr explicit extents(OtherIndexTypes... exts) noexcept {
+        assign(std::array<index_type, sizeof...(OtherIndexTypes)>{static_cast<index_type>(exts)...});
+    }
+
+    template <typename OtherIndexType, std::size_t N>
+        requires detail::mdspan_index_like<OtherIndexType, index_type> && (N == rank_dynamic() || N == rank())
+    constexpr explicit(N != rank_dynamic()) extents(std::span<OtherIndexType, N> exts) noexcept {
+        assign(exts);
+    }
+
+    template <typename OtherIndexType, std::size_t N>
+        requires detail::mdspan_index_like<OtherIndexType, index_type> && (N == rank_dynamic() || N == rank())
+    constexpr explicit(N != rank_dynamic()) extents(const std::array<OtherIndexType, N> &exts) noexcept {
+        assign(exts);
+    }
+
+    template <typename OtherIndexType, std::size_t... OtherExtents>
+        requires(sizeof...(OtherExtents) == rank() &&
+                 ((OtherExtents == dynamic_extent || Extents == dynamic_extent || OtherExtents == Extents) && ...))
+    constexpr explicit(((Extents != dynamic_extent && OtherExtents == dynamic_extent) || ...) ||
+                       (std::numeric_limits<index_type>::max() < std::numeric_limits<OtherIndexType>::max()))
+        extents(const extents<OtherIndexType, OtherExtents...> &other) noexcept {
+        for (rank_type r = 0; r < rank(); ++r) {
+            if (static_extents[r] == dynamic_extent) dynamic.set(dynamic_index[r], static_cast<index_type>(other.extent(r)));
+        }
+    }
+
+    template <typename OtherIndexType, std::size_t... OtherExtents>
+    friend constexpr bool operator==(const extents &a, const extents<OtherIndexType, OtherExtents...> &b) noexcept {
+        if constexpr (sizeof...(OtherExtents) != rank()) {
+            return false;
+        } else {
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (static_cast<std::make_unsigned_t<std::common_type_t<index_type, OtherIndexType>>>(a.extent(r)) !=
+                    static_cast<std::make_unsigned_t<std::common_type_t<index_type, OtherIndexType>>>(b.extent(r)))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+  private:
+    static constexpr std::array<std::size_t, sizeof...(Extents)> static_extents{Extents...};
+
+    // Position of each extent among the dynamic ones
+    static constexpr std::array<rank_type, sizeof...(Extents) + 1> dynamic_index = [] {
+        std::array<rank_type, sizeof...(Extents) + 1> index{};
+        rank_type                                     d = 0;
+        for (rank_type r = 0; r < rank(); ++r) {
+            index[r] = d;
+            if (static_extents[r] == dynamic_extent) ++d;
+        }
+        index[rank()] = d;
+        return index;
+    }();
+
+    template <typename Values> constexpr void assign(const Values &values) noexcept {
+        if (values.size() == rank_dynamic()) {
+            for (rank_type d = 0; d < rank_dynamic(); ++d) dynamic.set(d, static_cast<index_type>(values[d]));
+        } else {
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (static_extents[r] == dynamic_extent) dynamic.set(dynamic_index[r], static_cast<index_type>(values[r]));
+            }
+        }
+    }
+
+    BACKPORT_NO_UNIQUE_ADDRESS detail::dynamic_extents_storage<index_type, ((Extents == dynamic_extent ? 1 : 0) + ... + 0)> dynamic;
+};
+
+namespace detail {
+
+template <typename IndexType, typename Sequence> struct make_dextents;
+
+template <typename IndexType, std::size_t... Is> struct make_dextents<IndexType, std::index_sequence<Is...>> {
+    using type = extents<IndexType, (static_cast<void>(Is), dynamic_extent)...>;
+};
+
+template <typename> struct is_extents : std::false_type {};
+template <typename IndexType, std::size_t... Extents> struct is_extents<extents<IndexType, Extents...>> : std::true_type {};
+
+// Product of the extents in [first, last)
+template <typename Extents>
+constexpr typename Extents::index_type extents_product(const Extents &e, std::size_t first, std::size_t last) noexcept {
+    typename Extents::index_type product = 1;
+    for (std::size_t r = first; r < last; ++r) product *= e.extent(r);
+    return product;
+}
+
+} // namespace detail
+
+template <typename... Integrals>
+    requires(std::is_convertible_v<Integrals, std::size_t> && ...)
+explicit extents(Integrals...) -> extents<std::size_t, (static_cast<void>(sizeof(Integrals)), dynamic_extent)...>;
+
+template <typename IndexType, std::size_t Rank>
+using dextents = typename detail::make_dextents<IndexType, std::make_index_sequence<Rank>>::type;
+
+template <std::size_t Rank, typename IndexType = std::size_t> using dims = dextents<IndexType, Rank>;
+
+// Column-major, the first index is contiguous
+struct layout_left {
+    template <typename Extents> class mapping;
+};
+
+// Row-major, the last index is contiguous
+struct layout_right {
+    template <typename Extents> class mapping;
+};
+
+// Arbitrary strides
+struct layout_stride {
+    template <typename Extents> class mapping;
+};
+
+template <typename Extents> class layout_right::mapping {
+    static_assert(detail::is_extents<Extents>::value, "Extents must be a specialization of extents");
+
+  public:
+    using extents_type = Extents;
+    using index_type   = typename extents_type::index_type;
+    using size_type    = typename extents_type::size_type;
+    using rank_type    = typename extents_type::rank_type;
+    using layout_type  = layout_right;
+
+    constexpr mapping() noexcept = default;
+    constexpr mapping(const extents_type &e) noexcept : ext(e) {}
+
+    template <typename OtherExtents>
+        requires std::is_constructible_v<extents_type, OtherExtents>
+    constexpr explicit(!std::is_convertible_v<OtherExtents, extents_type>) mapping(const mapping<OtherExtents> &other) noexcept
+        : ext(other.extents()) {}
+
+    template <typename OtherExtents>
+        requires(extents_type::rank() <= 1 && std::is_constructible_v<extents_type, OtherExtents>)
+    constexpr explicit(!std::is_convertible_v<OtherExtents, extents_type>)
+        mapping(const layout_left::mapping<OtherExtents> &other) noexcept
+        : ext(other.extents()) {}
+
+    template <typename OtherExtents>
+        requires std::is_constructible_v<extents_type, OtherExtents>
+    constexpr explicit(extents_type::rank() > 0) mapping(const layout_stride::mapping<OtherExtents> &other) noexcept
+        : ext(other.extents()) {}
+
+    constexpr const extents_type &extents() const noexcept { return ext; }
+
+    constexpr index_type required_span_size() const noexcept { return detail::extents_product(ext, 0, extents_type::rank()); }
+
+    template <typename... Indices>
+        requires(sizeof...(Indices) == extents_type::rank() && (detail::mdspan_index_like<Indices, index_type> && ...))
+    constexpr index_type operator()(Indices... indices) const noexcept {
+        return [&]<std::size_t... Rs>(std::index_sequence<Rs...>) {
+            index_type offset = 0;
+            ((offset = offset * ext.extent(Rs) + static_cast<index_type>(indices)), ...);
+            return offset;
+        }(std::index_sequence_for<Indices...>());
+    }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return true; }
+    static constexpr bool is_always_strided() noexcept { return true; }
+    static constexpr bool is_unique() noexcept { return true; }
+    static constexpr bool is_exhaustive() noexcept { return true; }
+    static constexpr bool is_strided() noexcept { return true; }
+
+    constexpr index_type stride(rank_type r) const noexcept
+        requires(extents_type::rank() > 0)
+    {
+        return detail::extents_product(ext, r + 1, extents_type::rank());
+    }
+
+    template <typename OtherExtents>
+        requires(OtherExtents::rank() == extents_type::rank())
+    friend constexpr bool operator==(const mapping &a, const mapping<OtherExtents> &b) noexcept {
+        return a.extents() == b.extents();
+    }
+
+  private:
+    BACKPORT_NO_UNIQUE_ADDRESS extents_type ext{};
+};
+
+template <typename Extents> class layout_left::mapping {
+    static_assert(detail::is_extents<Extents>::value, "Extents must be a specialization of extents");
+
+  public:
+    using extents_type = Extents;
+    using index_type   = typename extents_type::index_type;
+    using size_type    = typename extents_type::size_type;
+    using rank_type    = typename extents_type::rank_type;
+    using layout_type  = layout_left;
+
+    constexpr mapping() noexcept = default;
+    constexpr mapping(const extents_type &e) noexcept : ext(e) {}
+
+    template <typename OtherExtents>
+        requires std::is_constructible_v<extents_type, OtherExtents>
+    constexpr explicit(!std::is_convertible_v<OtherExtents, extents_type>) mapping(const mapping<OtherExtents> &other) noexcept
+        : ext(other.extents()) {}
+
+    template <typename OtherExtents>
+        requires(extents_type::rank() <= 1 && std::is_constructible_v<extents_type, OtherExtents>)
+    constexpr explicit(!std::is_convertible_v<OtherExtents, extents_type>)
+        mapping(const layout_right::mapping<OtherExtents> &other) noexcept
+        : ext(other.extents()) {}
+
+    template <typename OtherExtents>
+        requires std::is_constructible_v<extents_type, OtherExtents>
+    constexpr explicit(extents_type::rank() > 0) mapping(const layout_stride::mapping<OtherExtents> &other) noexcept
+        : ext(other.extents()) {}
+
+    constexpr const extents_type &extents() const noexcept { return ext; }
+
+    constexpr index_type required_span_size() const noexcept { return detail::extents_product(ext, 0, extents_type::rank()); }
+
+    template <typename... Indices>
+        requires(sizeof...(Indices) == extents_type::rank() && (detail::mdspan_index_like<Indices, index_type> && ...))
+    constexpr index_type operator()(Indices... indices) const noexcept {
+        return [&]<std::size_t... Rs>(std::index_sequence<Rs...>) {
+            index_type offset = 0;
+            index_type stride = 1;
+            ((offset += static_cast<index_type>(indices) * stride, stride *= ext.extent(Rs)), ...);
+            return offset;
+        }(std::index_sequence_for<Indices...>());
+    }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return true; }
+    static constexpr bool is_always_strided() noexcept { return true; }
+    static constexpr bool is_unique() noexcept { return true; }
+    static constexpr bool is_exhaustive() noexcept { return true; }
+    static constexpr bool is_strided() noexcept { return true; }
+
+    constexpr index_type stride(rank_type r) const noexcept
+        requires(extents_type::rank() > 0)
+    {
+        return detail::extents_product(ext, 0, r);
+    }
+
+    template <typename OtherExtents>
+        requires(OtherExtents::rank() == extents_type::rank())
+    friend constexpr bool operator==(const mapping &a, const mapping<OtherExtents> &b) noexcept {
+        return a.extents() == b.extents();
+    }
+
+  private:
+    BACKPORT_NO_UNIQUE_ADDRESS extents_type ext{};
+};
+
+template <typename Extents> class layout_stride::mapping {
+    static_assert(detail::is_extents<Extents>::value, "Extents must be a specialization of extents");
+
+  public:
+    using extents_type = Extents;
+    using index_type   = typename extents_type::index_type;
+    using size_type    = typename extents_type::size_type;
+    using rank_type    = typename extents_type::rank_type;
+    using layout_type  = layout_stride;
+
+    // Row-major strides, as layout_right
+    constexpr mapping() noexcept {
+        for (rank_type r = 0; r < extents_type::rank(); ++r) strides_[r] = detail::extents_product(ext, r + 1, extents_type::rank());
+    }
+
+    template <typename OtherIndexType>
+        requires detail::mdspan_index_like<OtherIndexType, index_type>
+    constexpr mapping(const extents_type &e, std::span<OtherIndexType, extents_type::rank()> s) noexcept : ext(e) {
+        for (rank_type r = 0; r < extents_type::rank(); ++r) strides_[r] = static_cast<index_type>(s[r]);
+    }
+
+    template <typename OtherIndexType>
+        requires detail::mdspan_index_like<OtherIndexType, index_type>
+    constexpr mapping(const extents_type &e, const std::array<OtherIndexType, extents_type::rank()> &s) noexcept : ext(e) {
+        for (rank_type r = 0; r < extents_type::rank(); ++r) strides_[r] = static_cast<index_type>(s[r]);
+    }
+
+    // From any unique strided mapping, e.g. layout_left or layout_right
+    template <typename StridedMapping>
+        requires(std::is_constructible_v<extents_type, typename StridedMapping::extents_type> && StridedMapping::is_always_unique() &&
+                 StridedMapping::is_always_strided())
+    constexpr explicit(!std::is_convertible_v<typename StridedMapping::extents_type, extents_type> ||
+                       !(std::is_same_v<typename StridedMapping::layout_type, layout_left> ||
+                         std::is_same_v<typename StridedMapping::layout_type, layout_right> ||
+                         std::is_same_v<typename StridedMapping::layout_type, layout_stride>))
+        mapping(const StridedMapping &other) noexcept
+        : ext(other.extents()) {
+        for (rank_type r = 0; r < extents_type::rank(); ++r) strides_[r] = static_cast<index_type>(other.stride(r));
+    }
+
+    constexpr const extents_type &extents() const noexcept { return ext; }
+
+    constexpr std::array<index_type, extents_type::rank()> strides() const noexcept { return strides_; }
+
+    constexpr index_type required_span_size() const noexcept {
+        index_type size = 1;
+        for (rank_type r = 0; r < extents_type::rank(); ++r) {
+            if (ext.extent(r) == 0) return 0;
+            size += (ext.extent(r) - 1) * strides_[r];
+        }
+        return size;
+    }
+
+    template <typename... Indices>
+        requires(sizeof...(Indices) == extents_type::rank() && (detail::mdspan_index_like<Indices, index_type> && ...))
+    constexpr index_type operator()(Indices... indices) const noexcept {
+        return [&]<std::size_t... Rs>(std::index_sequence<Rs...>) {
+            return static_cast<index_type>(((static_cast<index_type>(indices) * strides_[Rs]) + ... + index_type(0)));
+        }(std::index_sequence_for<Indices...>());
+    }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return false; }
+    static constexpr bool is_always_strided() noexcept { return true; }
+    static constexpr bool is_unique() noexcept { return true; }
+    static constexpr bool is_strided() noexcept { return true; }
+
+    constexpr bool is_exhaustive() const noexcept {
+        return required_span_size() == detail::extents_product(ext, 0, extents_type::rank());
+    }
+
+    constexpr index_type stride(rank_type r) const noexcept { return strides_[r]; }
+
+    template <typename OtherMapping>
+        requires(OtherMapping::extents_type::rank() == extents_type::rank() && OtherMapping::is_always_strided())
+    friend constexpr bool operator==(const mapping &a, const OtherMapping &b) noexcept {
+        if (!(a.extents() == b.extents())) return false;
+        for (rank_type r = 0; r < extents_type::rank(); ++r) {
+            if (a.stride(r) != static_cast<index_type>(b.stride(r))) return false;
+        }
+        return true;
+    }
+
+  private:
+    BACKPORT_NO_UNIQUE_ADDRESS extents_type               ext{};
+    std::array<index_type, extents_type::rank()> strides_{};
+};
+
+template <typename ElementType> struct default_accessor {
+    using offset_policy    = default_accessor;
+    using element_type     = ElementType;
+    using reference        = ElementType &;
+    using data_handle_type = ElementType *;
+
+    constexpr default_accessor() noexcept = default;
+
+    template <typename OtherElementType>
+        requires std::is_convertible_v<OtherElementType (*)[], element_type (*)[]>
+    constexpr default_accessor(default_accessor<OtherElementType>) noexcept {}
+
+    constexpr reference        access(data_handle_type p, std::size_t i) const noexcept { return p[i]; }
+    constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept { return p + i; }
+};
+
+// A non-owning view of a multidimensional array. With only static extents it is a single pointer and every stride is a
+// constant. Without C++23 multidimensional subscripts, m(i, j) stands in for m[i, j]; m[std::array{i, j}] works everywhere.
+template <typename ElementType, typename Extents, typename LayoutPolicy = layout_right,
+          typename AccessorPolicy = default_accessor<ElementType>>
+class mdspan {
+    static_assert(detail::is_extents<Extents>::value, "Extents must be a specialization of extents");
+
+  public:
+    using extents_type     = Extents;
+    using layout_type      = LayoutPolicy;
+    using accessor_type    = AccessorPolicy;
+    using mapping_type     = typename layout_type::template mapping<extents_type>;
+    using element_type     = ElementType;
+    using value_type       = std::remove_cv_t<element_type>;
+    using index_type       = typename extents_type::index_type;
+    using size_type        = typename extents_type::size_type;
+    using rank_type        = typename extents_type::rank_type;
+    using data_handle_type = typename accessor_type::data_handle_type;
+    using reference        = typename accessor_type::reference;
+
+    static constexpr rank_type   rank() noexcept { return extents_type::rank(); }
+    static constexpr rank_type   rank_dynamic() noexcept { return extents_type::rank_dynamic(); }
+    static constexpr std::size_t static_extent(rank_type r) noexcept { return extents_type::static_extent(r); }
+    constexpr index_type         extent(rank_type r) const noexcept { return extents().extent(r); }
+
+    constexpr mdspan()
+        requires(rank_dynamic() > 0 && std::is_default_constructible_v<data_handle_type> && std::is_default_constructible_v<mapping_type> &&
+                 std::is_default_constructible_v<accessor_type>)
+    = default;
+    constexpr mdspan(const mdspan &) = default;
+    constexpr mdspan(mdspan &&)      = default;
+
+    template <typename... OtherIndexTypes>
+        requires((detail::mdspan_index_like<OtherIndexTypes, index_type> && ...) &&
+                 (sizeof...(OtherIndexTypes) == rank() || sizeof...(OtherIndexTypes) == rank_dynamic()) &&
+                 std::is_constructible_v<mapping_type, extents_type> && std::is_default_constructible_v<accessor_type>)
+    constexpr explicit mdspan(data_handle_type p, OtherIndexTypes... exts)
+        : ptr(std::move(p)), map(extents_type(static_cast<index_type>(std::move(exts))...)) {}
+
+    template <typename OtherIndexType, std::size_t N>
+        requires(detail::mdspan_index_like<OtherIndexType, index_type> && (N == rank() || N == rank_dynamic()) &&
+                 std::is_constructible_v<mapping_type, extents_type> && std::is_default_constructible_v<accessor_type>)
+    constexpr explicit(N != rank_dynamic()) mdspan(data_handle_type p, std::span<OtherIndexType, N> exts)
+        : ptr(std::move(p)), map(extents_type(exts)) {}
+
+    template <typename OtherIndexType, std::size_t N>
+        requires(detail::mdspan_index_like<OtherIndexType, index_type> && (N == rank() || N == rank_dynamic()) &&
+                 std::is_constructible_v<mapping_type, extents_type> && std::is_default_constructible_v<accessor_type>)
+    constexpr explicit(N != rank_dynamic()) mdspan(data_handle_type p, const std::array<OtherIndexType, N> &exts)
+        : ptr(std::move(p)), map(extents_type(exts)) {}
+
+    constexpr mdspan(data_handle_type p, const extents_type &e)
+        requires(std::is_constructible_v<mapping_type, const extents_type &> && std::is_default_constructible_v<accessor_type>)
+        : ptr(std::move(p)), map(e) {}
+
+    constexpr mdspan(data_handle_type p, const mapping_type &m)
+        requires std::is_default_constructible_v<accessor_type>
+        : ptr(std::move(p)), map(m) {}
+
+    constexpr mdspan(data_handle_type p, const mapping_type &m, const accessor_type &a) : ptr(std::move(p)), map(m), acc(a) {}
+
+    template <typename OtherElementType, typename OtherExtents, typename OtherLayoutPolicy, typename OtherAccessor>
+        requires(std::is_constructible_v<mapping_type, const typename OtherLayoutPolicy::template mapping<OtherExtents> &> &&
+                 std::is_constructible_v<accessor_type, const OtherAccessor &>)
+    constexpr explicit(!std::is_convertible_v<const typename OtherLayoutPolicy::template mapping<OtherExtents> &, mapping_type> ||
+                       !std::is_convertible_v<const OtherAccessor &, accessor_type>)
+        mdspan(const mdspan<OtherElementType, OtherExtents, OtherLayoutPolicy, OtherAccessor> &other)
+        : ptr(other.data_handle()), map(other.mapping()), acc(other.accessor()) {}
+
+    constexpr mdspan &operator=(const mdspan &) = default;
+    constexpr mdspan &operator=(mdspan &&)      = default;
+
+#if defined(__cpp_multidimensional_subscript)
+    template <typename... OtherIndexTypes>
+        requires(sizeof...(OtherIndexTypes) == rank() && (detail::mdspan_index_like<OtherIndexTypes, index_type> && ...))
+    constexpr reference operator[](OtherIndexTypes... indices) const {
+        return acc.access(ptr, static_cast<std::size_t>(map(static_cast<index_type>(std::move(indices))...)));
+    }
+#else
+    template <typename OtherIndexType>
+        requires(rank() == 1 && detail::mdspan_index_like<OtherIndexType, index_type>)
+    constexpr reference operator[](OtherIndexType index) const {
+        return acc.access(ptr, static_cast<std::size_t>(map(static_cast<index_type>(std::move(index)))));
+    }
+
+    template <typename... OtherIndexTypes>
+        requires(sizeof...(OtherIndexTypes) == rank() && (detail::mdspan_index_like<OtherIndexTypes, index_type> && ...))
+    constexpr reference operator()(OtherIndexTypes... indices) const {
+        return acc.access(ptr, static_cast<std::size_t>(map(static_cast<index_type>(std::move(indices))...)));
+    }
+#endif
+
+    template <typename OtherIndexType>
+        requires detail::mdspan_index_like<const OtherIndexType &, index_type>
+    constexpr reference operator[](std::span<OtherIndexType, rank()> indices) const {
+        return index_with(indices, std::make_index_sequence<rank()>());
+    }
+
+    template <typename OtherIndexType>
+        requires detail::mdspan_index_like<const OtherIndexType &, index_type>
+    constexpr reference operator[](const std::array<OtherIndexType, rank()> &indices) const {
+        return index_with(indices, std::make_index_sequence<rank()>());
+    }
+
+    constexpr size_type size() const noexcept { return static_cast<size_type>(detail::extents_product(extents(), 0, rank())); }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        for (rank_type r = 0; r < rank(); ++r) {
+            if (extent(r) == 0) return true;
+        }
+        return false;
+    }
+
+    friend constexpr void swap(mdspan &a, mdspan &b) noexcept {
+        using std::swap;
+        swap(a.ptr, b.ptr);
+        swap(a.map, b.map);
+        swap(a.acc, b.acc);
+    }
+
+    constexpr const extents_type     &extents() const noexcept { return map.extents(); }
+    constexpr const data_handle_type &data_handle() const noexcept { return ptr; }
+    constexpr const mapping_type     &mapping() const noexcept { return map; }
+    constexpr const accessor_type    &accessor() const noexcept { return acc; }
+
+    static constexpr bool is_always_unique() { return mapping_type::is_always_unique(); }
+    static constexpr bool is_always_exhaustive() { return mapping_type::is_always_exhaustive(); }
+    static constexpr bool is_always_strided() { return mapping_type::is_always_strided(); }
+
+    constexpr bool       is_unique() const { return map.is_unique(); }
+    constexpr bool       is_exhaustive() const { return map.is_exhaustive(); }
+    constexpr bool       is_strided() const { return map.is_strided(); }
+    constexpr index_type stride(rank_type r) const { return map.stride(r); }
+
+  private:
+    template <typename Indices, std::size_t... Is>
+    constexpr reference index_with(const Indices &indices, std::index_sequence<Is...>) const {
+        return acc.access(ptr, static_cast<std::size_t>(map(static_cast<index_type>(std::as_const(indices[Is]))...)));
+    }
+
+    data_handle_type                    ptr{};
+    BACKPORT_NO_UNIQUE_ADDRESS mapping_type  map{};
+    BACKPORT_NO_UNIQUE_ADDRESS accessor_type acc{};
+};
+
+template <typename CArray>
+    requires(std::is_array_v<CArray> && std::rank_v<CArray> == 1)
+mdspan(CArray &) -> mdspan<std::remove_all_extents_t<CArray>, extents<std::size_t, std::extent_v<CArray, 0>>>;
+
+template <typename Pointer>
+    requires(std::is_pointer_v<std::remove_reference_t<Pointer>>)
+mdspan(Pointer &&) -> mdspan<std::remove_pointer_t<std::remove_reference_t<Pointer>>, extents<std::size_t>>;
+
+template <typename ElementType, typename... Integrals>
+    requires((std::is_convertible_v<Integrals, std::size_t> && ...) && sizeof...(Integrals) > 0)
+explicit mdspan(ElementType *, Integrals...) -> mdspan<ElementType, dextents<std::size_t, sizeof...(Integrals)>>;
+
+template <typename ElementType, typename OtherIndexType, std::size_t N>
+mdspan(ElementType *, std::span<OtherIndexType, N>) -> mdspan<ElementType, dextents<std::size_t, N>>;
+
+template <typename ElementType, typename OtherIndexType, std::size_t N>
+mdspan(ElementType *, const std::array<OtherIndexType, N> &) -> mdspan<ElementType, dextents<std::size_t, N>>;
+
+template <typename ElementType, typename IndexType, std::size_t... Extents>
+mdspan(ElementType *, const extents<IndexType, Extents...> &) -> mdspan<ElementType, extents<IndexType, Extents...>>;
+
+template <typename ElementType, typename Mapping>
+mdspan(ElementType *, const Mapping &) -> mdspan<ElementType, typename Mapping::extents_type, typename Mapping::layout_type>;
+
+template <typename Mapping, typename Accessor>
+mdspan(const typename Accessor::data_handle_type &, const Mapping &, const Accessor &)
+    -> mdspan<typename Accessor::element_type, typename Mapping::extents_type, typename Mapping::layout_type, Accessor>;
+
+#endif
+
+// The feature test macro __cpp_lib_submdspan is specifically designed to detect the availability of the std::submdspan feature in
+// the standard library, which was introduced in C++26. The value 202306L represents the date when the feature was added to the
+// standard (June 2023).
+#if defined(__cpp_lib_submdspan) && __cpp_lib_submdspan >= 202306L && !defined(MDSPAN_CUSTOM_IMPL)
+
+// Use std::submdspan if available
+using std::full_extent;
+using std::full_extent_t;
+using std::strided_slice;
+using std::submdspan;
+using std::submdspan_extents;
+
+#else
+
+// Custom implementation for pre-C++26, written against the public mdspan interface so it works with std::mdspan as well.
+// A slice is an index (the dimension is dropped), full_extent, a pair-like [begin, end) or a strided_slice.
+// std::integral_constant bounds keep the resulting extent static.
+struct full_extent_t {
+    explicit full_extent_t() = default;
+};
+inline constexpr full_extent_t full_extent{};
+
+template <typename OffsetType, typename ExtentType, typename StrideType> struct strided_slice {
+    using offset_type = OffsetType;
+    using extent_type = ExtentType;
+    using stride_type = StrideType;
+
+    BACKPORT_NO_UNIQUE_ADDRESS OffsetType offset{};
+    BACKPORT_NO_UNIQUE_ADDRESS ExtentType extent{};
+    BACKPORT_NO_UNIQUE_ADDRESS StrideType stride{};
+};
+
+namespace detail {
+
+template <typename> struct is_strided_slice : std::false_type {};
+template <typename O, typename E, typename S> struct is_strided_slice<strided_slice<O, E, S>> : std::true_type {};
+
+template <typename T>
+concept integral_constant_like = std::is_integral_v<std::remove_cvref_t<decltype(T::value)>> &&
+                                 std::convertible_to<T, decltype(T::value)> && std::equality_comparable_with<T, decltype(T::value)> &&
+                                 std::bool_constant<T() == T::value>::value;
+
+template <typename Slice, typename IndexType>
+concept collapsing_slice = std::is_convertible_v<Slice, IndexType>;
+
+template <typename Slice>
+concept pair_like_slice =
+    !is_strided_slice<Slice>::value && requires { std::tuple_size<Slice>::value; } && std::tuple_size<Slice>::value == 2;
+
+template <typename T> constexpr std::size_t static_value() noexcept {
+    if constexpr (integral_constant_like<T>) {
+        return static_cast<std::size_t>(T::value);
+    } else {
+        return dynamic_extent;
+    }
+}
+
+// The static extent a slice leaves for a dimension with static extent `extent`
+template <typename Slice> constexpr std::size_t static_sub_extent(std::size_t extent) noexcept {
+    if constexpr (std::is_convertible_v<Slice, full_extent_t>) {
+        return extent;
+    } else if constexpr (is_strided_slice<Slice>::value) {
+        constexpr std::size_t count  = static_value<typename Slice::extent_type>();
+        constexpr std::size_t stride = static_value<typename Slice::stride_type>();
+        if constexpr (count == 0) {
+            return 0;
+        } else if constexpr (count != dynamic_extent && stride != dynamic_extent) {
+            return 1 + (count - 1) / stride;
+        } else {
+            return dynamic_extent;
+        }
+    } else if constexpr (pair_like_slice<Slice>) {
+        constexpr std::size_t first = static_value<std::tuple_element_t<0, Slice>>();
+        constexpr std::size_t last  = static_value<std::tuple_element_t<1, Slice>>();
+        return first != dynamic_extent && last != dynamic_extent ? last - first : dynamic_extent;
+    } else {
+        return dynamic_extent; // An index, the dimension is dropped
+    }
+}
+
+template <typename IndexType, typename Slice> constexpr IndexType first_of(const Slice &slice) noexcept {
+    if constexpr (std::is_convertible_v<Slice, full_extent_t>) {
+        return 0;
+    } else if constexpr (collapsing_slice<Slice, IndexType>) {
+        return static_cast<IndexType>(slice);
+    } else if constexpr (is_strided_slice<Slice>::value) {
+        return static_cast<IndexType>(slice.offset);
+    } else {
+        return static_cast<IndexType>(std::get<0>(slice));
+    }
+}
+
+template <typename IndexType, typename Slice> constexpr IndexType sub_extent(const Slice &slice, IndexType extent) noexcept {
+    if constexpr (collapsing_slice<Slice, IndexType>) {
+        return 0;
+    } else if constexpr (std::is_convertible_v<Slice, full_extent_t>) {
+        return extent;
+    } else if constexpr (is_strided_slice<Slice>::value) {
+        auto count = static_cast<IndexType>(slice.extent);
+        return count == 0 ? 0 : static_cast<IndexType>(1 + (count - 1) / static_cast<IndexType>(slice.stride));
+    } else {
+        return static_cast<IndexType>(static_cast<IndexType>(std::get<1>(slice)) - static_cast<IndexType>(std::get<0>(slice)));
+    }
+}
+
+template <typename IndexType, typename Slice> constexpr IndexType stride_factor(const Slice &slice) noexcept {
+    if constexpr (is_strided_slice<Slice>::value) {
+        return static_cast<IndexType>(slice.extent) == 0 ? 1 : static_cast<IndexType>(slice.stride);
+    } else {
+        return 1;
+    }
+}
+
+template <typename Extents, typename... Slices> struct submdspan_traits {
+    using index_type = typename Extents::index_type;
+
+    static constexpr std::size_t                         rank = Extents::rank();
+    static constexpr std::array<bool, sizeof...(Slices)> kept{!collapsing_slice<Slices, index_type>...};
+    static constexpr std::array<bool, sizeof...(Slices)> full{std::is_convertible_v<Slices, full_extent_t>...};
+    static constexpr std::array<bool, sizeof...(Slices)> unit_range{
+        (std::is_convertible_v<Slices, full_extent_t> || pair_like_slice<Slices>)...};
+    static constexpr std::size_t                         sub_rank = ((collapsing_slice<Slices, index_type> ? 0 : 1) + ... + 0);
+
+    static constexpr std::array<std::size_t, sub_rank> static_extents = [] {
+        return []<std::size_t... Is>(std::index_sequence<Is...>) {
+            std::array<std::size_t, sub_rank> out{};
+            std::size_t                       k = 0;
+            ((kept[Is] ? static_cast<void>(out[k++] = static_sub_extent<Slices>(Extents::static_extent(Is))) : static_cast<void>(0)), ...);
+            return out;
+        }(std::index_sequence_for<Slices...>());
+    }();
+
+    template <std::size_t... Ks> static auto make_extents(std::index_sequence<Ks...>) -> extents<index_type, static_extents[Ks]...>;
+    using extents_type = decltype(make_extents(std::make_index_sequence<sub_rank>()));
+
+    // The kept dimensions are the last sub_rank ones, all but the first of them full and that one a contiguous range
+    static constexpr bool preserves_right = [] {
+        if constexpr (sub_rank == 0) {
+            return true;
+        } else {
+            for (std::size_t r = rank - sub_rank + 1; r < rank; ++r) {
+                if (!full[r]) return false;
+            }
+            return unit_range[rank - sub_rank];
+        }
+    }();
+
+    // The mirror image: the first sub_rank dimensions
+    static constexpr bool preserves_left = [] {
+        if constexpr (sub_rank == 0) {
+            return true;
+        } else {
+            for (std::size_t r = 0; r + 1 < sub_rank; ++r) {
+                if (!full[r]) return false;
+            }
+            return unit_range[sub_rank - 1];
+        }
+    }();
+};
+
+template <typename IndexType, std::size_t N, typename Slice>
+constexpr void push_kept(std::array<IndexType, N> &out, std::size_t &k, const Slice &, IndexType value) noexcept {
+    if constexpr (!collapsing_slice<Slice, IndexType>) out[k++] = value;
+}
+
+} // namespace detail
+
+template <typename IndexType, std::size_t... Extents, typename... Slices>
+    requires(sizeof...(Slices) == sizeof...(Extents))
+constexpr auto submdspan_extents(const extents<IndexType, Extents...> &src, Slices... slices) {
+    using traits = detail::submdspan_traits<extents<IndexType, Extents...>, Slices...>;
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        std::array<IndexType, traits::sub_rank> exts{};
+        std::size_t                             k = 0;
+        (detail::push_kept(exts, k, slices, detail::sub_extent<IndexType>(slices, src.extent(Is))), ...);
+        return typename traits::extents_type(exts);
+    }(std::index_sequence_for<Slices...>());
+}
+
+// A view of part of src. layout_left and layout_right are kept when the slices leave a contiguous block of them,
+// anything else becomes layout_stride.
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename AccessorPolicy, typename... Slices>
+    requires(sizeof...(Slices) == Extents::rank())
+constexpr auto submdspan(const mdspan<ElementType, Extents, LayoutPolicy, AccessorPolicy> &src, Slices... slices) {
+    using index_type       = typename Extents::index_type;
+    using traits           = detail::submdspan_traits<Extents, Slices...>;
+    using sub_extents_type = typename traits::extents_type;
+    static_assert(LayoutPolicy::template mapping<Extents>::is_always_strided(), "submdspan needs a strided layout");
+
+    auto sub_extents = submdspan_extents(src.extents(), slices...);
+
+    std::size_t offset = 0;
+    if constexpr (Extents::rank() > 0) offset = static_cast<std::size_t>(src.mapping()(detail::first_of<index_type>(slices)...));
+
+    auto sub_mapping = [&] {
+        if constexpr (std::is_same_v<LayoutPolicy, layout_right> && traits::preserves_right) {
+            return typename layout_right::template mapping<sub_extents_type>(sub_extents);
+        } else if constexpr (std::is_same_v<LayoutPolicy, layout_left> && traits::preserves_left) {
+            return typename layout_left::template mapping<sub_extents_type>(sub_extents);
+        } else {
+            return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                std::array<index_type, traits::sub_rank> strides{};
+                std::size_t                              k = 0;
+                (detail::push_kept(strides, k, slices, static_cast<index_type>(src.stride(Is) * detail::stride_factor<index_type>(slices))),
+                 ...);
+                return typename layout_stride::template mapping<sub_extents_type>(sub_extents, strides);
+            }(std::index_sequence_for<Slices...>());
+        }
+    }();
+
+    using sub_accessor_type = typename AccessorPolicy::offset_policy;
+    return mdspan<ElementType, sub_extents_type, typename decltype(sub_mapping)::layout_type, sub_accessor_type>(
+        src.accessor().offset(src.data_handle(), offset), sub_mapping, sub_accessor_type(src.accessor()));
+}
+
+#endif
+
+} // namespace backport
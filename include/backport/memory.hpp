@@ -0,0 +1,153 @@
+#pragma once
+
+#include "expected.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_start_lifetime_as is specifically designed to detect the availability of std::start_lifetime_as
+// in the standard library, which was introduced in C++23. The value 202207L represents the date when the feature was added to the
+// standard (July 2022).
+#if defined(__cpp_lib_start_lifetime_as) && __cpp_lib_start_lifetime_as >= 202207L && !defined(START_LIFETIME_AS_CUSTOM_IMPL)
+
+// Use std::start_lifetime_as if available
+using std::start_lifetime_as;
+using std::start_lifetime_as_array;
+
+#else
+
+// Custom implementation for pre-C++23 (P2590)
+namespace detail {
+
+// Implicit-lifetime types (std::is_implicit_lifetime is C++23): scalars, arrays, aggregates with a trivial destructor, and
+// classes with a trivial destructor and at least one trivial constructor
+template <typename T>
+inline constexpr bool is_implicit_lifetime_v =
+    std::is_scalar_v<T> || std::is_array_v<T> || (std::is_aggregate_v<T> && std::is_trivially_destructible_v<T>) ||
+    (std::is_trivially_destructible_v<T> && (std::is_trivially_default_constructible_v<T> || std::is_trivially_copy_constructible_v<T> ||
+                                             std::is_trivially_move_constructible_v<T>));
+
+// memmove implicitly creates objects in its destination (P0593, a defect report against C++20), and a move onto itself keeps
+// the bytes, the object representation, as they are. Compilers know it is a no-op and remove it from -O1 on.
+inline void *create_objects(void *p, std::size_t size) noexcept { return std::memmove(p, p, size); }
+
+// Storage that may be mapped read-only cannot be written by the memmove at -O0. The barrier makes the compiler forget what
+// it knew about the bytes instead, which is what the memmove achieves once it has been optimized away.
+inline const void *create_objects(const void *p, std::size_t) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+#endif
+    return p;
+}
+
+} // namespace detail
+
+// Start the lifetime of a T at p that takes its value from the bytes already there, without running a constructor
+// Preconditions: [p, p + sizeof(T)) is storage suitably aligned for T
+template <typename T> T *start_lifetime_as(void *p) noexcept {
+    static_assert(detail::is_implicit_lifetime_v<T>, "start_lifetime_as requires an implicit-lifetime type");
+    return std::launder(static_cast<T *>(detail::create_objects(p, sizeof(T))));
+}
+
+template <typename T> const T *start_lifetime_as(const void *p) noexcept {
+    static_assert(detail::is_implicit_lifetime_v<T>, "start_lifetime_as requires an implicit-lifetime type");
+    return std::launder(static_cast<const T *>(detail::create_objects(p, sizeof(T))));
+}
+
+template <typename T> volatile T *start_lifetime_as(volatile void *p) noexcept {
+    return start_lifetime_as<volatile T>(const_cast<void *>(p));
+}
+
+template <typename T> const volatile T *start_lifetime_as(const volatile void *p) noexcept {
+    return start_lifetime_as<const volatile T>(const_cast<const void *>(p));
+}
+
+// The same for an array of n Ts starting at p, n may be 0
+template <typename T> T *start_lifetime_as_array(void *p, std::size_t n) noexcept {
+    static_assert(detail::is_implicit_lifetime_v<T>, "start_lifetime_as_array requires an implicit-lifetime type");
+    if (n == 0) return static_cast<T *>(p);
+    return std::launder(static_cast<T *>(detail::create_objects(p, sizeof(T) * n)));
+}
+
+template <typename T> const T *start_lifetime_as_array(const void *p, std::size_t n) noexcept {
+    static_assert(detail::is_implicit_lifetime_v<T>, "start_lifetime_as_array requires an implicit-lifetime type");
+    if (n == 0) return static_cast<const T *>(p);
+    return std::launder(static_cast<const T *>(detail::create_objects(p, sizeof(T) * n)));
+}
+
+template <typename T> volatile T *start_lifetime_as_array(volatile void *p, std::size_t n) noexcept {
+    return start_lifetime_as_array<volatile T>(const_cast<void *>(p), n);
+}
+
+template <typename T> const volatile T *start_lifetime_as_array(const volatile void *p, std::size_t n) noexcept {
+    return start_lifetime_as_array<const volatile T>(const_cast<const void *>(p), n);
+}
+
+#endif
+
+// Typed views of raw bytes, e.g. a memory-mapped file or a received packet, decoded in place:
+//
+//   backport::expected<const header *, backport::view_error> h = backport::view_as<header>(bytes);
+//   if (!h) return h.error();
+//
+// The checks are a compare and a mask, the view itself is start_lifetime_as and costs nothing. Not part of the standard.
+enum class view_error : unsigned char {
+    too_small  = 1, // Fewer bytes than the view needs
+    misaligned = 2, // The first byte is not aligned for the type
+};
+
+namespace detail {
+
+template <typename T> view_error check_view(const void *data, std::size_t available, std::size_t count) noexcept {
+    if (count > available / sizeof(T)) return view_error::too_small;
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0) return view_error::misaligned;
+    return view_error{};
+}
+
+// Mutable bytes when R converts to them, otherwise read-only bytes
+template <typename R>
+using view_bytes_t = std::conditional_t<std::is_convertible_v<R, std::span<std::byte>>, std::span<std::byte>, std::span<const std::byte>>;
+
+template <typename T, typename R>
+using view_element_t = std::conditional_t<std::is_convertible_v<R, std::span<std::byte>>, T, const T>;
+
+} // namespace detail
+
+// A T over the first sizeof(T) bytes. Anything that converts to a span of bytes is accepted, a whole std::vector or
+// std::array included, and the view is writable when the bytes are.
+template <typename T, typename R>
+    requires std::convertible_to<R &&, std::span<const std::byte>>
+expected<detail::view_element_t<T, R &&> *, view_error> view_as(R &&range) noexcept {
+    const detail::view_bytes_t<R &&> bytes = std::forward<R>(range);
+    if (const view_error e = detail::check_view<T>(bytes.data(), bytes.size(), 1); e != view_error{}) return unexpected<view_error>(e);
+    return start_lifetime_as<T>(bytes.data());
+}
+
+// count Ts over the first count * sizeof(T) bytes
+template <typename T, typename R>
+    requires std::convertible_to<R &&, std::span<const std::byte>>
+expected<std::span<detail::view_element_t<T, R &&>>, view_error> view_as_array(R &&range, std::size_t count) noexcept {
+    const detail::view_bytes_t<R &&> bytes = std::forward<R>(range);
+    if (const view_error e = detail::check_view<T>(bytes.data(), bytes.size(), count); e != view_error{}) {
+        return unexpected<view_error>(e);
+    }
+    return std::span<detail::view_element_t<T, R &&>>(start_lifetime_as_array<T>(bytes.data(), count), count);
+}
+
+} // namespace backport
@@ -1,285 +1,756 @@
 #pragma once
 
+#include "detail/config.hpp"
+#include "detail/invoke.hpp"
+
 #include <cassert>
-#include <functional>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
 #include <memory>
+#include <new>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #include <type_traits>
 #include <utility>
+#include <version>
+// <functional> is only needed to alias std::move_only_function
+#if defined(__cpp_lib_move_only_function) && __cpp_lib_move_only_function >= 202110L
+#include <functional>
+#endif
+#if defined(BACKPORT_INSTRUMENT)
+#include <atomic>
+#include <string_view>
+#endif
 
 namespace backport {
 
-// The feature test macro __cpp_lib_move_only_function is specifically designed to detect the availability of the std::move_only_function
-// feature in the standard library, which was introduced in C++23. The value 202110L represents the date when the feature was added to the
-// standard (October 2021).
-#if defined(__cpp_lib_move_only_function) && __cpp_lib_move_only_function >= 202110L && !defined(MOVE_ONLY_FUNCTION_CUSTOM_IMPL)
+// Helper for invoking with void vs non-void return types
+template <typename R, typename F, typename... Args>
+R invoke_and_return(F &&f, Args &&...args) noexcept(std::is_nothrow_invocable_r_v<R, F, Args...>) {
+    if constexpr (std::is_void_v<R>) {
+        detail::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    } else {
+        return detail::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+}
 
-// Use std::move_only_function if available
-template <typename Signature> using move_only_function = std::move_only_function<Signature>;
+// Customization point for callables that can be moved with a plain memcpy of their bytes, leaving nothing to destroy at the
+// source (e.g. a type that only holds a std::unique_ptr). Specialize to std::true_type to skip the move constructor on
+// relocation. Trivially copyable types are always relocatable.
+template <typename T> struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+template <typename T> inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Default SOO buffer size - typically 2-3 pointers worth of space
+// Chosen to fit common callables: function pointers, small lambdas, reference_wrapper
+inline constexpr std::size_t move_only_function_default_inline_bytes = sizeof(void *) * 3;
+inline constexpr std::size_t move_only_function_default_align        = alignof(std::max_align_t);
+
+// Layout/storage options for basic_move_only_function, combine with |
+enum class function_options : unsigned {
+    none = 0,
+    // Keep a single table pointer next to the buffer instead of the invoker plus a manager pointer.
+    // Saves a pointer per object at the price of one more dependent load per call.
+    compact = 1u << 0,
+    // Never allocate: callables that do not fit the buffer are rejected at compile time instead of going to the heap,
+    // and every operation is noexcept (construction as long as the callable's own constructor is)
+    inplace = 1u << 1,
+};
+
+constexpr function_options operator|(function_options lhs, function_options rhs) noexcept {
+    return static_cast<function_options>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+constexpr bool has_option(function_options set, function_options option) noexcept {
+    return (static_cast<unsigned>(set) & static_cast<unsigned>(option)) != 0;
+}
+
+#if defined(BACKPORT_INSTRUMENT)
+// Opt-in construction statistics, one set per function type (signature, buffer size and options). Define BACKPORT_INSTRUMENT
+// consistently for the whole program, without it none of this exists and constructing a function records nothing.
+struct function_stats {
+    std::size_t inline_constructions = 0; // Callables stored in the inline buffer
+    std::size_t heap_constructions   = 0; // Callables that did not fit and went to the heap (global new or an allocator)
+    std::size_t heap_bytes           = 0; // Bytes requested for those heap blocks
+    std::size_t largest_callable     = 0; // sizeof the largest callable stored, inline or not
+};
+
+namespace detail {
+
+struct function_counters {
+    std::atomic<std::size_t> inline_constructions{0};
+    std::atomic<std::size_t> heap_constructions{0};
+    std::atomic<std::size_t> heap_bytes{0};
+    std::atomic<std::size_t> largest_callable{0};
 
+    // Intrusive list of every function type that recorded something, pushed on first use
+    std::string_view                name;
+    std::atomic<bool>               registered{false};
+    function_counters              *next = nullptr;
+    static inline std::atomic<function_counters *> head{nullptr};
+
+    explicit constexpr function_counters(std::string_view n) noexcept : name(n) {}
+
+    void record(std::size_t callable_size, std::size_t heap_block_bytes) noexcept {
+        if (heap_block_bytes == 0) {
+            inline_constructions.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            heap_constructions.fetch_add(1, std::memory_order_relaxed);
+            heap_bytes.fetch_add(heap_block_bytes, std::memory_order_relaxed);
+        }
+
+        std::size_t largest = largest_callable.load(std::memory_order_relaxed);
+        while (largest < callable_size && !largest_callable.compare_exchange_weak(largest, callable_size, std::memory_order_relaxed)) {
+        }
+
+        if (!registered.load(std::memory_order_relaxed) && !registered.exchange(true, std::memory_order_acq_rel)) {
+            next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    function_stats snapshot() const noexcept {
+        return {inline_constructions.load(std::memory_order_relaxed), heap_constructions.load(std::memory_order_relaxed),
+                heap_bytes.load(std::memory_order_relaxed), largest_callable.load(std::memory_order_relaxed)};
+    }
+
+    void reset() noexcept {
+        inline_constructions.store(0, std::memory_order_relaxed);
+        heap_constructions.store(0, std::memory_order_relaxed);
+        heap_bytes.store(0, std::memory_order_relaxed);
+        largest_callable.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Readable name of T from the compiler's function signature, e.g. "backport::basic_move_only_function<void(), 24, 16, ...>"
+template <typename T> constexpr std::string_view instrument_type_name() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::string_view name = __FUNCSIG__;
+    std::size_t      from = name.find("instrument_type_name<") + 21;
+    return name.substr(from, name.rfind(">(void)") - from);
 #else
+    std::string_view name = __PRETTY_FUNCTION__;
+    std::size_t      from = name.find("T = ") + 4;
+    std::size_t      to   = name.find_first_of(";]", from);
+    return name.substr(from, to - from);
+#endif
+}
 
-// Custom implementation for pre-C++23
+template <typename Function> inline function_counters counters_for{instrument_type_name<Function>()};
 
-// Primary template
-template <typename Signature> class move_only_function;
+} // namespace detail
 
-// Helper for invoking with void vs non-void return types
-template <typename R, typename F, typename... Args> R invoke_and_return(F &&f, Args &&...args) {
-    if constexpr (std::is_void_v<R>) {
-        std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
-    } else {
-        return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+// Statistics for one function type, e.g. get_function_stats<backport::move_only_function<void()>>()
+template <typename Function> function_stats get_function_stats() noexcept { return detail::counters_for<Function>.snapshot(); }
+
+template <typename Function> void reset_function_stats() noexcept { detail::counters_for<Function>.reset(); }
+
+// Calls visitor(std::string_view type_name, const function_stats &) for every function type that has been constructed
+template <typename Visitor> void for_each_function_stats(Visitor &&visitor) {
+    for (auto *c = detail::function_counters::head.load(std::memory_order_acquire); c != nullptr; c = c->next) {
+        const function_stats stats = c->snapshot();
+        visitor(c->name, stats);
     }
 }
+#endif
+
+namespace detail {
+
+// Fails to instantiate when a callable cannot be stored inline, the template arguments in the diagnostic show the callable
+// size and alignment next to the buffer capacity and alignment
+template <std::size_t CallableSize, std::size_t CallableAlign, bool NothrowMove, std::size_t Capacity, std::size_t BufferAlign>
+struct inline_storage_check {
+    static_assert(CallableSize <= Capacity, "callable is larger than the inline buffer (CallableSize > Capacity)");
+    static_assert(CallableAlign <= BufferAlign, "callable alignment exceeds the inline buffer alignment (CallableAlign > BufferAlign)");
+    static_assert(NothrowMove, "callables stored inline must be nothrow move constructible");
+    static constexpr bool value = true;
+};
+
+enum class ref_qualifier { none, lvalue, rvalue };
+
+template <typename T> struct is_in_place_type : std::false_type {};
+template <typename T> struct is_in_place_type<std::in_place_type_t<T>> : std::true_type {};
+
+} // namespace detail
+
+// Sized variant of the custom implementation, for hot paths that need a larger (or smaller) inline buffer than the default.
+// There is no standard equivalent, so this is always the custom implementation regardless of MOVE_ONLY_FUNCTION_CUSTOM_IMPL.
+template <typename Signature, std::size_t InlineBytes = move_only_function_default_inline_bytes,
+          std::size_t Align = move_only_function_default_align, function_options Options = function_options::none>
+class basic_move_only_function;
+
+// Copyable counterpart on the same storage and dispatch, the public alias lives in copyable_function.hpp
+template <typename Signature, std::size_t InlineBytes = move_only_function_default_inline_bytes,
+          std::size_t Align = move_only_function_default_align, function_options Options = function_options::none>
+class basic_copyable_function;
+
+namespace detail {
+
+// Shared implementation of every cv/ref/noexcept-qualified specialization of basic_move_only_function and
+// basic_copyable_function, Derived is the specialization itself
+template <typename Derived, bool Copyable, bool Const, ref_qualifier Ref, bool Noex, std::size_t InlineBytes, std::size_t Align,
+          function_options Options, typename R, typename... Args>
+class function_impl {
+    static_assert(InlineBytes > 0, "inline buffer must not be empty");
+    static_assert(Align > 0 && (Align & (Align - 1)) == 0, "alignment must be a power of two");
 
-// Specialization for any function signature R(Args...)
-template <typename R, typename... Args> class move_only_function<R(Args...)> {
   private:
-    // SOO buffer size - typically 2-3 pointers worth of space
-    // Chosen to fit common callables: function pointers, small lambdas, reference_wrapper
-    static constexpr std::size_t buffer_size = sizeof(void*) * 3;
-    static constexpr std::size_t buffer_align = alignof(std::max_align_t);
-    
-    // Type-erased interface for callable objects
-    struct callable_base {
-        virtual R invoke(Args...) = 0;
-        virtual void move_to(void* dst) = 0;  // Move construct into destination
-        virtual void destroy() noexcept = 0;  // Destroy the callable
-        virtual ~callable_base() = default;
+    static constexpr bool is_inplace = has_option(Options, function_options::inplace);
+
+    // The signature's cv qualifier applied to the stored callable
+    template <typename T> using cv = std::conditional_t<Const, const T, T>;
+
+    // "cv T ref" and "cv T inv-quals" from [func.wrap.move.class]: how the callable is invoked, an unqualified
+    // signature calls it as an lvalue
+    template <typename T>
+    using cv_ref =
+        std::conditional_t<Ref == ref_qualifier::none, cv<T>, std::conditional_t<Ref == ref_qualifier::lvalue, cv<T> &, cv<T> &&>>;
+    template <typename T> using inv_quals = std::conditional_t<Ref == ref_qualifier::rvalue, cv<T> &&, cv<T> &>;
+
+    template <typename T>
+    static constexpr bool is_invocable_as = Noex ? std::is_nothrow_invocable_r_v<R, T, Args...> : std::is_invocable_r_v<R, T, Args...>;
+
+    template <typename VT> static constexpr bool is_callable_from = is_invocable_as<cv_ref<VT>> && is_invocable_as<inv_quals<VT>>;
+
+    // What a stored callable type must satisfy, a copyable function also needs to copy it
+    template <typename VT> static constexpr bool is_storable = is_callable_from<VT> && (!Copyable || std::is_copy_constructible_v<VT>);
+
+    // The buffer holds either the callable itself or the pointer to a heap-allocated one
+    static constexpr std::size_t buffer_size  = InlineBytes < sizeof(void *) ? sizeof(void *) : InlineBytes;
+    static constexpr std::size_t buffer_align = Align < alignof(void *) ? alignof(void *) : Align;
+
+    // Small trivially copyable arguments are passed by value to the invoker, everything else by reference
+    template <typename T>
+    using param_t =
+        std::conditional_t<!std::is_reference_v<T> && std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void *) * 2, T, T &&>;
+
+    // "Manual vtable": the invoker is stored directly in the object so a call is a single indirect jump,
+    // while the rarely used move/destroy operations live in one constexpr table per stored type.
+    // A noexcept signature makes the invoker noexcept too, so call sites need no unwinding path.
+    using invoker_t = R (*)(std::byte *, param_t<Args>...) noexcept(Noex);
+
+    // A nullptr manager, or nullptr entries, mean the operation is trivial: moves and copies are a memcpy of the buffer
+    // and there is nothing to destroy
+    struct manager_t {
+        void (*move)(std::byte *dst, std::byte *src) noexcept; // Move construct into dst and end the lifetime of src
+        void (*destroy)(std::byte *self) noexcept;             // Destroy the callable (and free it, if on the heap)
+        void (*copy)(std::byte *dst, const std::byte *src);    // Copy construct into dst, only set for copyable functions
+    };
+
+    // Picks the copy entry of a table, Impl::copy is never instantiated for move-only functions
+    template <typename Impl, bool Trivial> static constexpr auto copy_entry() noexcept {
+        if constexpr (Copyable && !Trivial) {
+            return &Impl::copy;
+        } else {
+            return static_cast<decltype(manager_t::copy)>(nullptr);
+        }
+    }
+
+    // Everything in one table, for the compact layout
+    struct vtable_t {
+        invoker_t invoke;
+        manager_t manager;
     };
 
-    // Implementation for heap-allocated callables
-    template <typename Callable> struct heap_callable_impl : callable_base {
-        Callable func;
+    // Operations for callables constructed directly in the buffer
+    template <typename Callable> struct inline_callable_impl {
+        static Callable &get(std::byte *self) noexcept { return *std::launder(reinterpret_cast<Callable *>(self)); }
 
-        template <typename F> explicit heap_callable_impl(F &&f) : func(std::forward<F>(f)) {}
+        static R invoke(std::byte *self, param_t<Args>... args) noexcept(Noex) {
+            return invoke_and_return<R>(static_cast<inv_quals<Callable>>(get(self)), std::forward<param_t<Args>>(args)...);
+        }
 
-        R invoke(Args... args) override { 
-            return invoke_and_return<R>(func, std::forward<Args>(args)...); 
+        static void move(std::byte *dst, std::byte *src) noexcept {
+            Callable &from = get(src);
+            ::new (static_cast<void *>(dst)) Callable(std::move(from));
+            from.~Callable();
         }
-        
-        void move_to(void* dst) override {
-            // For heap callables, we just move the pointer, not the object
-            new (dst) heap_callable_impl(std::move(*this));
+
+        static void destroy(std::byte *self) noexcept { get(self).~Callable(); }
+
+        static void copy(std::byte *dst, const std::byte *src) {
+            ::new (static_cast<void *>(dst)) Callable(std::as_const(get(const_cast<std::byte *>(src))));
+        }
+
+        static constexpr manager_t manager{is_trivially_relocatable_v<Callable> ? nullptr : &move,
+                                           std::is_trivially_destructible_v<Callable> ? nullptr : &destroy,
+                                           copy_entry<inline_callable_impl, std::is_trivially_copyable_v<Callable>>()};
+        static constexpr const manager_t *table = std::is_trivially_copyable_v<Callable> ? nullptr : &manager;
+        static constexpr vtable_t         vtable{&invoke, manager};
+    };
+
+    // Operations for heap-allocated callables, only the pointer is ever moved (by memcpy)
+    template <typename Callable> struct heap_callable_impl {
+        static Callable &get(std::byte *self) noexcept { return *static_cast<Callable *>(*std::launder(reinterpret_cast<void **>(self))); }
+
+        static R invoke(std::byte *self, param_t<Args>... args) noexcept(Noex) {
+            return invoke_and_return<R>(static_cast<inv_quals<Callable>>(get(self)), std::forward<param_t<Args>>(args)...);
         }
-        
-        void destroy() noexcept override {
-            // Heap callables are destroyed via delete
+
+        static void destroy(std::byte *self) noexcept { delete &get(self); }
+
+        static void copy(std::byte *dst, const std::byte *src) {
+            ::new (static_cast<void *>(dst)) void *(new Callable(std::as_const(get(const_cast<std::byte *>(src)))));
         }
+
+        static constexpr manager_t        manager{nullptr, &destroy, copy_entry<heap_callable_impl, false>()};
+        static constexpr const manager_t *table = &manager;
+        static constexpr vtable_t         vtable{&invoke, manager};
     };
-    
-    // Implementation for inline-stored callables  
-    template <typename Callable> struct inline_callable_impl : callable_base {
-        Callable func;
 
-        template <typename F> explicit inline_callable_impl(F &&f) : func(std::forward<F>(f)) {}
+    // Operations for callables allocated through a user-supplied allocator. The allocator is stored next to the callable
+    // in the heap block, so the deallocation path is type-erased like everything else.
+    template <typename Callable, typename Alloc> struct allocated_callable_impl {
+        struct block;
+        using block_alloc  = typename std::allocator_traits<Alloc>::template rebind_alloc<block>;
+        using block_traits = std::allocator_traits<block_alloc>;
+
+        struct block {
+            template <typename... CArgs>
+            block(const block_alloc &a, CArgs &&...args) : alloc(a), callable(std::forward<CArgs>(args)...) {}
+
+            BACKPORT_NO_UNIQUE_ADDRESS block_alloc alloc;
+            Callable                          callable;
+        };
+
+        static block &get_block(std::byte *self) noexcept { return *static_cast<block *>(*std::launder(reinterpret_cast<void **>(self))); }
+
+        static Callable &get(std::byte *self) noexcept { return get_block(self).callable; }
+
+        static R invoke(std::byte *self, param_t<Args>... args) noexcept(Noex) {
+            return invoke_and_return<R>(static_cast<inv_quals<Callable>>(get(self)), std::forward<param_t<Args>>(args)...);
+        }
+
+        template <typename A, typename... CArgs> static void create(std::byte *self, const A &a, CArgs &&...args) {
+            block_alloc alloc(a);
+            block      *b = block_traits::allocate(alloc, 1);
+            try {
+                block_traits::construct(alloc, b, alloc, std::forward<CArgs>(args)...);
+            } catch (...) {
+                block_traits::deallocate(alloc, b, 1);
+                throw;
+            }
+            ::new (static_cast<void *>(self)) void *(b);
+        }
 
-        R invoke(Args... args) override { 
-            return invoke_and_return<R>(func, std::forward<Args>(args)...); 
+        static void destroy(std::byte *self) noexcept {
+            block      &b = get_block(self);
+            block_alloc alloc(b.alloc); // The block owns the allocator, take a copy before destroying it
+            block_traits::destroy(alloc, &b);
+            block_traits::deallocate(alloc, &b, 1);
         }
-        
-        void move_to(void* dst) override {
-            // Move construct into the destination buffer
-            new (dst) inline_callable_impl(std::move(*this));
+
+        // The copy gets its own block from a copy of the allocator
+        static void copy(std::byte *dst, const std::byte *src) {
+            const block &b = get_block(const_cast<std::byte *>(src));
+            create(dst, b.alloc, std::as_const(b.callable));
         }
-        
-        void destroy() noexcept override {
-            // Explicitly destroy the callable
-            this->~inline_callable_impl();
+
+        static constexpr manager_t        manager{nullptr, &destroy, copy_entry<allocated_callable_impl, false>()};
+        static constexpr const manager_t *table = &manager;
+        static constexpr vtable_t         vtable{&invoke, manager};
+    };
+
+    // Invoker and manager side by side, a nullptr invoker means empty
+    struct split_dispatch {
+        invoker_t        invoker = nullptr;
+        const manager_t *manager = nullptr;
+
+        bool             empty() const noexcept { return invoker == nullptr; }
+        invoker_t        get_invoker() const noexcept { return invoker; }
+        const manager_t *get_manager() const noexcept { return manager; }
+
+        template <typename Impl> void set() noexcept {
+            invoker = &Impl::invoke;
+            manager = Impl::table;
         }
     };
 
-    // Storage for the callable - either inline buffer or heap pointer
-    union storage_t {
-        // Aligned buffer for small object optimization
-        alignas(buffer_align) std::byte buffer[buffer_size];
-        // Pointer for heap-allocated objects (not used directly, just for size)
-        void* ptr;
-        
-        storage_t() noexcept : ptr(nullptr) {}
-        ~storage_t() noexcept {}
-    } storage;
-    
-    // Pointer to the vtable - nullptr means empty
-    // Points to storage.buffer for inline objects, or heap for large objects  
-    callable_base* callable = nullptr;
-    
-    // Helper to check if object is stored inline
-    bool is_inline() const noexcept {
-        return callable && 
-               reinterpret_cast<const std::byte*>(callable) >= storage.buffer &&
-               reinterpret_cast<const std::byte*>(callable) < storage.buffer + buffer_size;
-    }
-    
+    // A single pointer to the combined table, a nullptr table means empty
+    struct compact_dispatch {
+        const vtable_t *vtable = nullptr;
+
+        bool             empty() const noexcept { return vtable == nullptr; }
+        invoker_t        get_invoker() const noexcept { return vtable->invoke; }
+        const manager_t *get_manager() const noexcept { return vtable ? &vtable->manager : nullptr; }
+
+        template <typename Impl> void set() noexcept { vtable = &Impl::vtable; }
+    };
+
+    using dispatch_t = std::conditional_t<has_option(Options, function_options::compact), compact_dispatch, split_dispatch>;
+
+    // The dispatch pointers follow the buffer directly, so the compact one can use what would be tail padding. The buffer
+    // is left uninitialized, zeroing it would cost buffer_size bytes of stores on every construction.
+    alignas(buffer_align) std::byte storage[buffer_size];
+    dispatch_t                      dispatch;
+
     // Helper to determine if a type can use SOO
-    template <typename Callable>
-    static constexpr bool can_use_soo() {
-        return sizeof(inline_callable_impl<Callable>) <= buffer_size &&
-               alignof(inline_callable_impl<Callable>) <= buffer_align &&
-               std::is_nothrow_move_constructible_v<Callable>;
+    template <typename Callable> static constexpr bool can_use_soo() {
+        return sizeof(Callable) <= buffer_size && alignof(Callable) <= buffer_align && std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+// The fast paths copy the whole buffer, including the bytes a smaller callable leaves indeterminate. That is well-defined
+// for std::byte, but GCC reports it as a use of uninitialized storage.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+    // Move the callable managed by m from src to dst, the fast path is a plain copy of the buffer
+    static void relocate(const manager_t *m, std::byte *dst, std::byte *src) noexcept {
+        if (m && m->move) {
+            m->move(dst, src);
+        } else {
+            std::memcpy(dst, src, buffer_size);
+        }
+    }
+
+    // Take over the callable of other, leaving it empty
+    void take(function_impl &other) noexcept {
+        relocate(other.dispatch.get_manager(), storage, other.storage);
+        dispatch       = other.dispatch;
+        other.dispatch = dispatch_t{};
     }
-    
+
+    // Copy the callable of other into this empty function, which stays empty if the copy throws
+    void copy_from(const function_impl &other) {
+        if (const manager_t *m = other.dispatch.get_manager(); m && m->copy) {
+            m->copy(storage, other.storage);
+        } else {
+            std::memcpy(storage, other.storage, buffer_size);
+        }
+        dispatch = other.dispatch;
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
     // Clean up current callable
     void reset() noexcept {
-        if (callable) {
-            if (is_inline()) {
-                callable->destroy();
-            } else {
-                delete callable;
-            }
-            callable = nullptr;
+        if (const manager_t *m = dispatch.get_manager(); m && m->destroy) {
+            m->destroy(storage);
         }
+        dispatch = dispatch_t{};
     }
 
-  public:
-    move_only_function() noexcept = default;
-
-    move_only_function(std::nullptr_t) noexcept : move_only_function() {}
-
-    move_only_function(move_only_function &&other) noexcept : storage{} {
-        if (other.callable) {
-            if (other.is_inline()) {
-                // Move inline object to our buffer
-                other.callable->move_to(storage.buffer);
-                callable = reinterpret_cast<callable_base*>(storage.buffer);
-                // Clear the source
-                other.callable->destroy();
-                other.callable = nullptr;
-            } else {
-                // Transfer heap pointer ownership
-                callable = other.callable;
-                other.callable = nullptr;
-            }
+    // Construct the callable directly in its final place: the buffer, or a heap block when it does not fit
+    template <typename Callable, typename... CArgs> void emplace(CArgs &&...args) {
+        if constexpr (can_use_soo<Callable>()) {
+            ::new (static_cast<void *>(storage)) Callable(std::forward<CArgs>(args)...);
+            dispatch.template set<inline_callable_impl<Callable>>();
+#if defined(BACKPORT_INSTRUMENT)
+            counters_for<Derived>.record(sizeof(Callable), 0);
+#endif
+        } else if constexpr (is_inplace) {
+            static_assert(detail::inline_storage_check<sizeof(Callable), alignof(Callable), std::is_nothrow_move_constructible_v<Callable>,
+                                                       buffer_size, buffer_align>::value);
+        } else {
+            ::new (static_cast<void *>(storage)) void *(new Callable(std::forward<CArgs>(args)...));
+            dispatch.template set<heap_callable_impl<Callable>>();
+#if defined(BACKPORT_INSTRUMENT)
+            counters_for<Derived>.record(sizeof(Callable), sizeof(Callable));
+#endif
+        }
+    }
+
+    // Same, but the heap block comes from alloc
+    template <typename Callable, typename Alloc, typename... CArgs> void emplace_with(const Alloc &alloc, CArgs &&...args) {
+        if constexpr (can_use_soo<Callable>()) {
+            ::new (static_cast<void *>(storage)) Callable(std::forward<CArgs>(args)...);
+            dispatch.template set<inline_callable_impl<Callable>>();
+#if defined(BACKPORT_INSTRUMENT)
+            counters_for<Derived>.record(sizeof(Callable), 0);
+#endif
+        } else {
+            allocated_callable_impl<Callable, Alloc>::create(storage, alloc, std::forward<CArgs>(args)...);
+            dispatch.template set<allocated_callable_impl<Callable, Alloc>>();
+#if defined(BACKPORT_INSTRUMENT)
+            counters_for<Derived>.record(sizeof(Callable), sizeof(typename allocated_callable_impl<Callable, Alloc>::block));
+#endif
         }
     }
 
-    move_only_function(const move_only_function &) = delete;
+    // Forward the call to the stored invoker
+    R call(Args &&...args) const noexcept(Noex) {
+        assert(!dispatch.empty() && "callable is nullptr");
+        return dispatch.get_invoker()(const_cast<std::byte *>(storage), std::forward<Args>(args)...);
+    }
+
+  public:
+    // Inline buffer size and alignment, see also backport::stores_inline_v
+    static constexpr std::size_t inline_capacity  = buffer_size;
+    static constexpr std::size_t inline_alignment = buffer_align;
+
+    // Whether a callable F would be stored in the inline buffer rather than on the heap
+    template <typename F> static constexpr bool stores_inline = can_use_soo<std::decay_t<F>>();
+
+    function_impl() noexcept = default;
+
+    function_impl(std::nullptr_t) noexcept : function_impl() {}
+
+    function_impl(function_impl &&other) noexcept { take(other); }
+
+    function_impl(const function_impl &other)
+        requires(Copyable)
+    {
+        copy_from(other);
+    }
+
+    function_impl(const function_impl &)
+        requires(!Copyable)
+    = delete;
 
     template <typename F>
-    move_only_function(F &&f)
-        requires(!std::is_same_v<std::decay_t<F>, move_only_function> && std::is_invocable_r_v<R, F, Args...>)
+    function_impl(F &&f) noexcept(is_inplace && std::is_nothrow_constructible_v<std::decay_t<F>, F>)
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Derived> && !is_in_place_type<std::remove_cvref_t<F>>::value &&
+                 std::is_constructible_v<std::decay_t<F>, F> && is_storable<std::decay_t<F>>)
     {
-        using decayed_type = std::decay_t<F>;
-        
-        if constexpr (can_use_soo<decayed_type>()) {
-            // Use small object optimization - construct directly in buffer
-            auto* ptr = new (storage.buffer) inline_callable_impl<decayed_type>(std::forward<F>(f));
-            callable = ptr;
-        } else {
-            // Allocate on heap for large objects
-            callable = new heap_callable_impl<decayed_type>(std::forward<F>(f));
-        }
+        emplace<std::decay_t<F>>(std::forward<F>(f));
+    }
+
+    // In-place construction: T is built from args right in the buffer (or heap block), with no temporary to move from.
+    // T does not need to be movable at all if it ends up on the heap.
+    template <typename T, typename... CArgs>
+    explicit function_impl(std::in_place_type_t<T>, CArgs &&...args) noexcept(
+        is_inplace && std::is_nothrow_constructible_v<T, CArgs...>)
+        requires(std::is_constructible_v<T, CArgs...> && is_storable<T>)
+    {
+        static_assert(std::is_same_v<std::decay_t<T>, T>, "in_place_type_t<T> requires a non-reference, cv-unqualified object type");
+        emplace<T>(std::forward<CArgs>(args)...);
     }
 
+    template <typename T, typename U, typename... CArgs>
+    explicit function_impl(std::in_place_type_t<T>, std::initializer_list<U> ilist, CArgs &&...args) noexcept(
+        is_inplace && std::is_nothrow_constructible_v<T, std::initializer_list<U> &, CArgs...>)
+        requires(std::is_constructible_v<T, std::initializer_list<U> &, CArgs...> && is_storable<T>)
+    {
+        static_assert(std::is_same_v<std::decay_t<T>, T>, "in_place_type_t<T> requires a non-reference, cv-unqualified object type");
+        emplace<T>(ilist, std::forward<CArgs>(args)...);
+    }
+
+    // Allocator-aware construction: callables that do not fit the buffer are allocated through alloc instead of global new.
+    // Callables that fit are still stored inline and the allocator is not used.
+    template <typename Alloc, typename F>
+    function_impl(std::allocator_arg_t, const Alloc &alloc, F &&f)
+        requires(!is_inplace && !std::is_pointer_v<Alloc> && !std::is_same_v<std::remove_cvref_t<F>, Derived> &&
+                 std::is_constructible_v<std::decay_t<F>, F> && is_storable<std::decay_t<F>>)
+    {
+        emplace_with<std::decay_t<F>>(alloc, std::forward<F>(f));
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    // Heap fallback from a memory resource, e.g. a per-thread std::pmr::monotonic_buffer_resource or pool
+    template <typename F>
+    function_impl(std::allocator_arg_t, std::pmr::memory_resource *resource, F &&f)
+        requires(!is_inplace && !std::is_same_v<std::remove_cvref_t<F>, Derived> && std::is_constructible_v<std::decay_t<F>, F> &&
+                 is_storable<std::decay_t<F>>)
+        : function_impl(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(resource), std::forward<F>(f)) {}
+#endif
+
     // Destructor
-    ~move_only_function() noexcept {
-        reset();
+    ~function_impl() noexcept { reset(); }
+
+    function_impl &operator=(function_impl &&other) noexcept {
+        if (this != &other) {
+            reset(); // Clean up current state
+            take(other);
+        }
+        return *this;
     }
 
-    move_only_function &operator=(move_only_function &&other) noexcept {
+    function_impl &operator=(const function_impl &other)
+        requires(Copyable)
+    {
+        // Copy-and-swap, the old callable is kept if the copy throws
         if (this != &other) {
-            reset();  // Clean up current state
-            
-            if (other.callable) {
-                if (other.is_inline()) {
-                    // Move inline object to our buffer
-                    other.callable->move_to(storage.buffer);
-                    callable = reinterpret_cast<callable_base*>(storage.buffer);
-                    // Clear the source
-                    other.callable->destroy();
-                    other.callable = nullptr;
-                } else {
-                    // Transfer heap pointer ownership
-                    callable = other.callable;
-                    other.callable = nullptr;
-                }
-            }
+            Derived tmp(static_cast<const Derived &>(other));
+            swap(tmp);
         }
         return *this;
     }
 
-    move_only_function &operator=(const move_only_function &) = delete;
+    function_impl &operator=(const function_impl &)
+        requires(!Copyable)
+    = delete;
 
     // Assignment from nullptr
-    move_only_function &operator=(std::nullptr_t) noexcept {
+    Derived &operator=(std::nullptr_t) noexcept {
         reset();
-        return *this;
+        return static_cast<Derived &>(*this);
     }
 
     template <typename F>
-    move_only_function &operator=(F &&f)
-        requires(!std::is_same_v<std::decay_t<F>, move_only_function> && std::is_invocable_r_v<R, F, Args...>)
+    Derived &operator=(F &&f) noexcept(std::is_nothrow_constructible_v<Derived, F>)
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Derived> && std::is_constructible_v<Derived, F>)
     {
         // Use move-and-swap idiom for exception safety
-        move_only_function tmp(std::forward<F>(f));
+        Derived tmp(std::forward<F>(f));
         swap(tmp);
-        return *this;
+        return static_cast<Derived &>(*this);
+    }
+
+    // One operator() per qualified signature, it carries the signature's cv, ref and noexcept qualifiers. An unqualified
+    // signature is callable on non-const lvalues and rvalues, a const one on anything.
+    R operator()(Args... args) & noexcept(Noex)
+        requires(!Const && Ref != ref_qualifier::rvalue)
+    {
+        return call(std::forward<Args>(args)...);
     }
 
-    R operator()(Args... args) const {
-        assert(callable && "callable is nullptr");
-        return callable->invoke(std::forward<Args>(args)...);
+    R operator()(Args... args) && noexcept(Noex)
+        requires(!Const && Ref != ref_qualifier::lvalue)
+    {
+        return call(std::forward<Args>(args)...);
+    }
+
+    R operator()(Args... args) const & noexcept(Noex)
+        requires(Const && Ref != ref_qualifier::rvalue)
+    {
+        return call(std::forward<Args>(args)...);
+    }
+
+    R operator()(Args... args) const && noexcept(Noex)
+        requires(Const && Ref == ref_qualifier::rvalue)
+    {
+        return call(std::forward<Args>(args)...);
     }
 
-    explicit operator bool() const noexcept { return callable != nullptr; }
+    explicit operator bool() const noexcept { return !dispatch.empty(); }
 
     // Member swap
-    void swap(move_only_function &other) noexcept {
+    void swap(Derived &other) noexcept {
         if (this == &other) return;
-        
-        // Both inline: swap via temporary buffer
-        if (is_inline() && other.is_inline()) {
-            alignas(buffer_align) std::byte temp_buffer[buffer_size];
-            
-            // Move this to temp
-            callable->move_to(temp_buffer);
-            callable->destroy();
-            
-            // Move other to this
-            other.callable->move_to(storage.buffer);
-            callable = reinterpret_cast<callable_base*>(storage.buffer);
-            other.callable->destroy();
-            
-            // Move temp to other
-            auto* temp_callable = reinterpret_cast<callable_base*>(temp_buffer);
-            temp_callable->move_to(other.storage.buffer);
-            other.callable = reinterpret_cast<callable_base*>(other.storage.buffer);
-            temp_callable->destroy();
-        }
-        // One inline, one heap: need careful swap
-        else if (is_inline() && !other.is_inline()) {
-            // Save heap pointer
-            auto* heap_ptr = other.callable;
-            
-            // Move inline to other's buffer  
-            callable->move_to(other.storage.buffer);
-            other.callable = reinterpret_cast<callable_base*>(other.storage.buffer);
-            callable->destroy();
-            
-            // Set our pointer to heap
-            callable = heap_ptr;
-        }
-        else if (!is_inline() && other.is_inline()) {
-            // Save our heap pointer
-            auto* heap_ptr = callable;
-            
-            // Move other's inline to our buffer
-            other.callable->move_to(storage.buffer);
-            callable = reinterpret_cast<callable_base*>(storage.buffer);
-            other.callable->destroy();
-            
-            // Set other's pointer to heap
-            other.callable = heap_ptr;
-        }
-        // Both heap: simple pointer swap
-        else {
-            std::swap(callable, other.callable);
-        }
+
+        // Rotate through a temporary buffer, relocatable callables and heap pointers are just copied
+        alignas(buffer_align) std::byte tmp[buffer_size];
+        relocate(dispatch.get_manager(), tmp, storage);
+        relocate(other.dispatch.get_manager(), storage, other.storage);
+        relocate(dispatch.get_manager(), other.storage, tmp);
+
+        std::swap(dispatch, other.dispatch);
     }
 };
 
+} // namespace detail
+
+// Specializations for R(Args...) cv ref noexcept(Noex), everything but the signature lives in function_impl
+#define BACKPORT_FUNCTION_SPECIALIZATION(CLASS, COPYABLE, CV_REF, IS_CONST, REF)                                                        \
+    template <typename R, typename... Args, bool Noex, std::size_t InlineBytes, std::size_t Align, function_options Options>            \
+    class CLASS<R(Args...) CV_REF noexcept(Noex), InlineBytes, Align, Options>                                                          \
+        : public detail::function_impl<CLASS<R(Args...) CV_REF noexcept(Noex), InlineBytes, Align, Options>, COPYABLE, IS_CONST,        \
+                                       detail::ref_qualifier::REF, Noex, InlineBytes, Align, Options, R, Args...> {                     \
+        using base = detail::function_impl<CLASS, COPYABLE, IS_CONST, detail::ref_qualifier::REF, Noex, InlineBytes, Align, Options, R, \
+                                           Args...>;                                                                                    \
+                                                                                                                                        \
+      public:                                                                                                                           \
+        using base::base;                                                                                                               \
+        using base::operator=;                                                                                                          \
+    };
+
+#define BACKPORT_FUNCTION_SPECIALIZATIONS(CLASS, COPYABLE)                                                                              \
+    BACKPORT_FUNCTION_SPECIALIZATION(CLASS, COPYABLE, , false, none)                                                                    \
+    BACKPORT_FUNCTION_SPECIALIZATION(CLASS, COPYABLE, const, true, none)                                                                \
+    BACKPORT_FUNCTION_SPECIALIZATION(CLASS, COPYABLE, &, false, lvalue)                                                                 \
+    BACKPORT_FUNCTION_SPECIALIZATION(CLASS, COPYABLE, const &, true, lvalue)                                                            \
+    BACKPORT_FUNCTION_SPECIALIZATION(CLASS, COPYABLE, &&, false, rvalue)                                                                \
+    BACKPORT_FUNCTION_SPECIALIZATION(CLASS, COPYABLE, const &&, true, rvalue)
+
+BACKPORT_FUNCTION_SPECIALIZATIONS(basic_move_only_function, false)
+BACKPORT_FUNCTION_SPECIALIZATIONS(basic_copyable_function, true)
+
+#undef BACKPORT_FUNCTION_SPECIALIZATIONS
+#undef BACKPORT_FUNCTION_SPECIALIZATION
+
 // Non-member swap
-template <typename Signature> void swap(move_only_function<Signature> &lhs, move_only_function<Signature> &rhs) noexcept { lhs.swap(rhs); }
+template <typename Signature, std::size_t InlineBytes, std::size_t Align, function_options Options>
+void swap(basic_move_only_function<Signature, InlineBytes, Align, Options> &lhs,
+          basic_move_only_function<Signature, InlineBytes, Align, Options> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename Signature, std::size_t InlineBytes, std::size_t Align, function_options Options>
+void swap(basic_copyable_function<Signature, InlineBytes, Align, Options> &lhs,
+          basic_copyable_function<Signature, InlineBytes, Align, Options> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+// Compact layout: the buffer plus a single pointer, e.g. 32 bytes on 64-bit targets with the default buffer
+template <typename Signature, std::size_t InlineBytes = move_only_function_default_inline_bytes,
+          std::size_t Align = move_only_function_default_align>
+using compact_move_only_function = basic_move_only_function<Signature, InlineBytes, Align, function_options::compact>;
+
+// Never-allocating variant for threads that must not touch the heap, a callable that does not fit Capacity fails to compile
+template <typename Signature, std::size_t Capacity = move_only_function_default_inline_bytes,
+          std::size_t Align = move_only_function_default_align>
+using inplace_move_only_function = basic_move_only_function<Signature, Capacity, Align, function_options::inplace>;
+
+// Inline buffer of a function type: the custom implementations report their own, std::move_only_function reports a best guess for the
+// standard library in use
+template <typename Function> struct function_inline_storage {};
+
+template <typename Function>
+    requires requires {
+        Function::inline_capacity;
+        Function::inline_alignment;
+    }
+struct function_inline_storage<Function> {
+    static constexpr std::size_t capacity  = Function::inline_capacity;
+    static constexpr std::size_t alignment = Function::inline_alignment;
+};
+
+#if defined(__cpp_lib_move_only_function) && __cpp_lib_move_only_function >= 202110L
+template <typename Signature> struct function_inline_storage<std::move_only_function<Signature>> {
+#if defined(__GLIBCXX__)
+    // libstdc++ stores locally what fits _Storage: a pointer to member function plus an object pointer, at pointer alignment
+    struct delegate {
+        void (delegate::*member)();
+        void *object;
+    };
+    static constexpr std::size_t capacity  = sizeof(delegate);
+    static constexpr std::size_t alignment = alignof(delegate);
+#else
+    // Implementation-defined, assume a buffer like the default of the custom implementation
+    static constexpr std::size_t capacity  = move_only_function_default_inline_bytes;
+    static constexpr std::size_t alignment = alignof(void *);
+#endif
+};
+#endif
+
+// Whether Function stores the callable F inline: it fits the buffer, is not over-aligned and is nothrow move constructible
+// (every implementation heap-allocates callables that could throw on move). E.g. at a hot call site:
+//   static_assert(backport::stores_inline_v<backport::move_only_function<void()>, decltype(task)>);
+template <typename Function, typename F>
+inline constexpr bool stores_inline_v = sizeof(std::decay_t<F>) <= function_inline_storage<Function>::capacity &&
+                                        alignof(std::decay_t<F>) <= function_inline_storage<Function>::alignment &&
+                                        std::is_nothrow_move_constructible_v<std::decay_t<F>>;
+
+template <typename Function, typename F> struct stores_inline : std::bool_constant<stores_inline_v<Function, F>> {};
+
+// Like stores_inline_v, but a callable that would be heap-allocated fails to compile with its sizeof and alignof next to the
+// buffer's in the diagnostic:
+//   static_assert(backport::assert_stores_inline<backport::move_only_function<void()>, decltype(task)>());
+template <typename Function, typename F> constexpr bool assert_stores_inline() noexcept {
+    using VT = std::decay_t<F>;
+    return detail::inline_storage_check<sizeof(VT), alignof(VT), std::is_nothrow_move_constructible_v<VT>,
+                                        function_inline_storage<Function>::capacity, function_inline_storage<Function>::alignment>::value;
+}
+
+// The feature test macro __cpp_lib_move_only_function is specifically designed to detect the availability of the std::move_only_function
+// feature in the standard library, which was introduced in C++23. The value 202110L represents the date when the feature was added to the
+// standard (October 2021).
+#if defined(__cpp_lib_move_only_function) && __cpp_lib_move_only_function >= 202110L && !defined(MOVE_ONLY_FUNCTION_CUSTOM_IMPL)
+
+// Use std::move_only_function if available
+template <typename Signature> using move_only_function = std::move_only_function<Signature>;
+
+#else
+
+// Custom implementation for pre-C++23, with the default inline buffer
+template <typename Signature> using move_only_function = basic_move_only_function<Signature>;
 
 #endif
 
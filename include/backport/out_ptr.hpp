@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+namespace backport {
+
+// The feature test macro __cpp_lib_out_ptr is specifically designed to detect the availability of std::out_ptr and std::inout_ptr
+// in the standard library, which were introduced in C++23. The value 202106L represents the date when the feature was added to the
+// standard (June 2021).
+#if defined(__cpp_lib_out_ptr) && __cpp_lib_out_ptr >= 202106L && !defined(OUT_PTR_CUSTOM_IMPL)
+
+// Use std::out_ptr and std::inout_ptr if available
+using std::inout_ptr;
+using std::inout_ptr_t;
+using std::out_ptr;
+using std::out_ptr_t;
+
+#else
+
+// Custom implementation for pre-C++23 (P1132)
+namespace detail {
+
+// POINTER_OF(Smart) of the standard: Smart::pointer, Smart::element_type * or, for raw pointers, Smart itself
+template <typename Smart> struct pointer_of {};
+
+template <typename Smart>
+    requires std::is_pointer_v<Smart>
+struct pointer_of<Smart> {
+    using type = Smart;
+};
+
+template <typename Smart>
+    requires requires { typename Smart::pointer; }
+struct pointer_of<Smart> {
+    using type = typename Smart::pointer;
+};
+
+template <typename Smart>
+    requires(!requires { typename Smart::pointer; } && requires { typename Smart::element_type; })
+struct pointer_of<Smart> {
+    using type = typename Smart::element_type *;
+};
+
+// POINTER_OF_OR(Smart, Pointer) of the standard: the smart pointer's pointer type, or Pointer when it has none
+template <typename Smart, typename Pointer> struct pointer_of_or {
+    using type = Pointer;
+};
+
+template <typename Smart, typename Pointer>
+    requires requires { typename pointer_of<Smart>::type; }
+struct pointer_of_or<Smart, Pointer> {
+    using type = typename pointer_of<Smart>::type;
+};
+
+template <typename T> struct is_shared_ptr : std::false_type {};
+template <typename T> struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {};
+
+// A unique_ptr with a stateless deleter is exactly its pointer, so the C function can write straight into it instead of
+// into a temporary that the destructor then hands to reset(). The call site becomes the same as the raw-pointer version:
+// one store by the callee, no reload, no second null check (tests/codegen/out_ptr_lowering.cpp checks this).
+//
+// The standard does not promise that layout, equal sizes only rule out a stored deleter. libstdc++ (a tuple of the pointer
+// and the deleter as an empty base), libc++ and the MSVC STL (compressed pairs with the deleter as an empty base) all keep
+// the pointer at offset 0, so in-place writes are limited to them. Other standard libraries take the generic path.
+#ifndef BACKPORT_UNIQUE_PTR_IS_ITS_POINTER
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION) || defined(_MSVC_STL_VERSION)
+#define BACKPORT_UNIQUE_PTR_IS_ITS_POINTER 1
+#else
+#define BACKPORT_UNIQUE_PTR_IS_ITS_POINTER 0
+#endif
+#endif
+
+template <typename Smart, typename Pointer> inline constexpr bool writes_in_place = false;
+
+template <typename T, typename D, typename Pointer>
+inline constexpr bool writes_in_place<std::unique_ptr<T, D>, Pointer> =
+    BACKPORT_UNIQUE_PTR_IS_ITS_POINTER && std::is_same_v<Pointer, typename std::unique_ptr<T, D>::pointer> &&
+    std::is_pointer_v<Pointer> && std::is_empty_v<D> && sizeof(std::unique_ptr<T, D>) == sizeof(Pointer);
+
+} // namespace detail
+
+// Adapts a smart pointer s for a C function that returns a new resource through T **. s is reset on construction, and takes
+// ownership of whatever the function wrote when out_ptr_t is destroyed, i.e. at the end of the full expression.
+template <typename Smart, typename Pointer, typename... Args> class out_ptr_t {
+    static_assert(!detail::is_shared_ptr<Smart>::value || sizeof...(Args) > 0,
+                  "out_ptr with a shared_ptr needs the deleter, otherwise the resource would be deleted with delete");
+
+    using smart_pointer = typename detail::pointer_of_or<Smart, Pointer>::type;
+
+    Smart              &s;
+    std::tuple<Args...> args;
+    mutable Pointer     p{};
+
+  public:
+    explicit out_ptr_t(Smart &smart, Args... a) noexcept(std::is_nothrow_move_constructible_v<std::tuple<Args...>>)
+        : s(smart), args(std::forward<Args>(a)...) {
+        if constexpr (requires { s.reset(); }) {
+            s.reset();
+        } else {
+            s = Smart();
+        }
+    }
+
+    out_ptr_t(const out_ptr_t &)            = delete;
+    out_ptr_t &operator=(const out_ptr_t &) = delete;
+
+    ~out_ptr_t() {
+        if (p == nullptr) return;
+        std::apply(
+            [this](auto &&...a) {
+                if constexpr (requires { s.reset(static_cast<smart_pointer>(p), std::forward<Args>(a)...); }) {
+                    s.reset(static_cast<smart_pointer>(p), std::forward<Args>(a)...);
+                } else {
+                    static_assert(std::is_constructible_v<Smart, smart_pointer, Args...>, "Smart cannot adopt the pointer");
+                    s = Smart(static_cast<smart_pointer>(p), std::forward<Args>(a)...);
+                }
+            },
+            std::move(args));
+    }
+
+    operator Pointer *() const noexcept { return std::addressof(p); }
+
+    // For APIs that return the resource through void **, the object representation of p is written
+    operator void **() const noexcept
+        requires(!std::is_same_v<Pointer, void *>)
+    {
+        static_assert(std::is_pointer_v<Pointer>, "only raw pointers can be written through void **");
+        return reinterpret_cast<void **>(std::addressof(p));
+    }
+};
+
+template <typename T, typename D, typename Pointer>
+    requires detail::writes_in_place<std::unique_ptr<T, D>, Pointer>
+class out_ptr_t<std::unique_ptr<T, D>, Pointer> {
+    Pointer *target;
+
+  public:
+    explicit out_ptr_t(std::unique_ptr<T, D> &smart) noexcept : target(reinterpret_cast<Pointer *>(std::addressof(smart))) {
+        smart.reset();
+    }
+
+    out_ptr_t(const out_ptr_t &)            = delete;
+    out_ptr_t &operator=(const out_ptr_t &) = delete;
+
+    operator Pointer *() const noexcept { return target; }
+
+    operator void **() const noexcept
+        requires(!std::is_same_v<Pointer, void *>)
+    {
+        return reinterpret_cast<void **>(target);
+    }
+};
+
+// Adapts a smart pointer s for a C function that takes the current resource through T ** and may replace it, e.g. a realloc
+// style API. Ownership of the current resource passes to the function, s adopts whatever it wrote back.
+template <typename Smart, typename Pointer, typename... Args> class inout_ptr_t {
+    static_assert(!detail::is_shared_ptr<Smart>::value, "inout_ptr cannot take the resource back from a shared_ptr");
+
+    using smart_pointer = typename detail::pointer_of_or<Smart, Pointer>::type;
+
+    Smart              &s;
+    std::tuple<Args...> args;
+    mutable Pointer     p;
+
+    static Pointer current(Smart &smart) noexcept {
+        if constexpr (std::is_pointer_v<Smart>) {
+            return static_cast<Pointer>(smart);
+        } else {
+            return static_cast<Pointer>(smart.get());
+        }
+    }
+
+  public:
+    explicit inout_ptr_t(Smart &smart, Args... a) noexcept(std::is_nothrow_move_constructible_v<std::tuple<Args...>>)
+        : s(smart), args(std::forward<Args>(a)...), p(current(smart)) {}
+
+    inout_ptr_t(const inout_ptr_t &)            = delete;
+    inout_ptr_t &operator=(const inout_ptr_t &) = delete;
+
+    ~inout_ptr_t() {
+        std::apply(
+            [this](auto &&...a) {
+                if constexpr (std::is_pointer_v<Smart>) {
+                    s = Smart(static_cast<smart_pointer>(p), std::forward<Args>(a)...);
+                } else {
+                    // The function owns (and may already have freed) the old resource
+                    (void)s.release();
+                    if (p == nullptr) return;
+                    if constexpr (requires { s.reset(static_cast<smart_pointer>(p), std::forward<Args>(a)...); }) {
+                        s.reset(static_cast<smart_pointer>(p), std::forward<Args>(a)...);
+                    } else {
+                        static_assert(std::is_constructible_v<Smart, smart_pointer, Args...>, "Smart cannot adopt the pointer");
+                        s = Smart(static_cast<smart_pointer>(p), std::forward<Args>(a)...);
+                    }
+                }
+            },
+            std::move(args));
+    }
+
+    operator Pointer *() const noexcept { return std::addressof(p); }
+
+    operator void **() const noexcept
+        requires(!std::is_same_v<Pointer, void *>)
+    {
+        static_assert(std::is_pointer_v<Pointer>, "only raw pointers can be written through void **");
+        return reinterpret_cast<void **>(std::addressof(p));
+    }
+};
+
+// The current resource is already in the unique_ptr, the function reads and replaces it there
+template <typename T, typename D, typename Pointer>
+    requires detail::writes_in_place<std::unique_ptr<T, D>, Pointer>
+class inout_ptr_t<std::unique_ptr<T, D>, Pointer> {
+    Pointer *target;
+
+  public:
+    explicit inout_ptr_t(std::unique_ptr<T, D> &smart) noexcept : target(reinterpret_cast<Pointer *>(std::addressof(smart))) {}
+
+    inout_ptr_t(const inout_ptr_t &)            = delete;
+    inout_ptr_t &operator=(const inout_ptr_t &) = delete;
+
+    operator Pointer *() const noexcept { return target; }
+
+    operator void **() const noexcept
+        requires(!std::is_same_v<Pointer, void *>)
+    {
+        return reinterpret_cast<void **>(target);
+    }
+};
+
+// f(backport::out_ptr(p)) where f creates a resource through T **. Pointer defaults to the smart pointer's pointer type,
+// the extra arguments are passed to reset(), e.g. the deleter a shared_ptr needs.
+template <typename Pointer = void, typename Smart, typename... Args> auto out_ptr(Smart &s, Args &&...args) {
+    using P = std::conditional_t<std::is_void_v<Pointer>, typename detail::pointer_of<Smart>::type, Pointer>;
+    return out_ptr_t<Smart, P, Args &&...>(s, std::forward<Args>(args)...);
+}
+
+// f(backport::inout_ptr(p)) where f takes the resource p owns through T ** and may replace it
+template <typename Pointer = void, typename Smart, typename... Args> auto inout_ptr(Smart &s, Args &&...args) {
+    using P = std::conditional_t<std::is_void_v<Pointer>, typename detail::pointer_of<Smart>::type, Pointer>;
+    return inout_ptr_t<Smart, P, Args &&...>(s, std::forward<Args>(args)...);
+}
+
+#endif
+
+} // namespace backport
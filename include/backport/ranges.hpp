@@ -0,0 +1,840 @@
+#pragma once
+
+#include "detail/config.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+namespace backport {
+
+// Each view is aliased on its own: a standard library may ship some of the C++23 range additions before the others (libstdc++
+// 13 has zip, chunk, slide, stride and enumerate, ranges::to only arrived in 14). RANGES_CUSTOM_IMPL forces all of them.
+namespace detail {
+
+template <bool Const, typename T> using ranges_maybe_const = std::conditional_t<Const, const T, T>;
+
+// What views::chunk(n) and ranges::to<C>() return: applied to a range with r | closure or closure(r), and composed with
+// closure | closure. Pre-C++23 there is no std::ranges::range_adaptor_closure to derive from, so std adaptors cannot be
+// composed with these, but r | std::views::filter(f) | backport::views::chunk(n) works.
+template <typename F> struct range_closure {
+    BACKPORT_NO_UNIQUE_ADDRESS F fn;
+
+    template <typename R>
+        requires std::invocable<const F &, R>
+    constexpr auto operator()(R &&r) const {
+        return fn(std::forward<R>(r));
+    }
+};
+
+template <typename F> range_closure(F) -> range_closure<F>;
+
+template <std::ranges::range R, typename F>
+    requires std::invocable<const F &, R>
+constexpr auto operator|(R &&r, const range_closure<F> &closure) {
+    return closure.fn(std::forward<R>(r));
+}
+
+template <typename F, typename G> constexpr auto operator|(range_closure<F> first, range_closure<G> second) {
+    return range_closure{[first = std::move(first), second = std::move(second)]<typename R>(R &&r) {
+        return second(first(std::forward<R>(r)));
+    }};
+}
+
+// The iterator category of a C++17 algorithm's view of I, if it has one
+template <typename I> struct ranges_legacy_category {};
+
+template <typename I>
+    requires requires { typename std::iterator_traits<I>::iterator_category; }
+struct ranges_legacy_category<I> {
+    using type = typename std::iterator_traits<I>::iterator_category;
+};
+
+template <typename I>
+concept legacy_forward_iterator = std::derived_from<typename ranges_legacy_category<I>::type, std::forward_iterator_tag>;
+
+template <typename I>
+concept legacy_input_iterator = std::derived_from<typename ranges_legacy_category<I>::type, std::input_iterator_tag>;
+
+// iterator_category of a view's iterator over Base: forward when the base iterator is, nothing for input-only bases
+template <typename Base, bool = std::ranges::forward_range<Base>> struct view_iterator_category {};
+
+template <typename Base> struct view_iterator_category<Base, true> {
+    using iterator_category = std::conditional_t<legacy_forward_iterator<std::ranges::iterator_t<Base>>, std::forward_iterator_tag,
+                                                 std::input_iterator_tag>;
+};
+
+// The references of zip and enumerate. An input_iterator's reference needs a common reference with its value type, which
+// pre-C++23 std::tuple does not have (P2321 added it): the specializations after the namespace supply it, and the lvalue
+// constructor converts tuple<int, int> & to tuple<int &, int &> as a C++23 tuple does.
+template <typename... Ts> struct reference_tuple : std::tuple<Ts...> {
+    using std::tuple<Ts...>::tuple;
+
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts) && (std::is_constructible_v<Ts, Us &> && ...))
+    constexpr reference_tuple(std::tuple<Us...> &other) : reference_tuple(other, std::index_sequence_for<Ts...>()) {}
+
+  private:
+    template <typename... Us, std::size_t... I>
+    constexpr reference_tuple(std::tuple<Us...> &other, std::index_sequence<I...>) : std::tuple<Ts...>(std::get<I>(other)...) {}
+};
+
+// Helpers of ranges::to
+// C++23's container-insertable: emplace forms are left out, map::emplace(end, x) would construct a pair from the iterator
+template <typename C, typename Ref>
+concept container_appendable = requires(C &c, Ref &&ref) {
+    requires(requires { c.push_back(std::forward<Ref>(ref)); } || requires { c.insert(c.end(), std::forward<Ref>(ref)); });
+};
+
+template <typename C>
+concept reservable_container = std::ranges::sized_range<C> && requires(C &c, std::ranges::range_size_t<C> n) {
+    c.reserve(n);
+    { c.capacity() } -> std::same_as<decltype(n)>;
+    { c.max_size() } -> std::same_as<decltype(n)>;
+};
+
+template <typename C, typename Ref> constexpr void container_append(C &c, Ref &&ref) {
+    if constexpr (requires { c.push_back(std::forward<Ref>(ref)); }) {
+        c.push_back(std::forward<Ref>(ref));
+    } else {
+        c.insert(c.end(), std::forward<Ref>(ref));
+    }
+}
+
+// Stands in for the range's iterators when deducing to<std::vector>(r): a C++17 input iterator over its elements, the
+// standard containers' deduction guides accept it
+template <typename R> struct deduction_input_iterator {
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = std::ranges::range_value_t<R>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = std::add_pointer_t<std::ranges::range_reference_t<R>>;
+    using reference         = std::ranges::range_reference_t<R>;
+
+    reference                 operator*() const;
+    pointer                   operator->() const;
+    deduction_input_iterator &operator++();
+    deduction_input_iterator  operator++(int);
+    bool                      operator==(const deduction_input_iterator &) const;
+};
+
+template <template <typename...> typename C, typename R, typename... Args> auto deduce_container() {
+    if constexpr (requires { C(std::declval<R>(), std::declval<Args>()...); }) {
+        return std::type_identity<decltype(C(std::declval<R>(), std::declval<Args>()...))>();
+    } else {
+        using It = deduction_input_iterator<R>;
+        return std::type_identity<decltype(C(std::declval<It>(), std::declval<It>(), std::declval<Args>()...))>();
+    }
+}
+
+} // namespace detail
+
+} // namespace backport
+
+template <typename... Ts>
+struct std::tuple_size<backport::detail::reference_tuple<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template <std::size_t I, typename... Ts>
+struct std::tuple_element<I, backport::detail::reference_tuple<Ts...>> : std::tuple_element<I, std::tuple<Ts...>> {};
+
+template <typename... Ts, typename... Us, template <typename> typename TQual, template <typename> typename UQual>
+    requires(sizeof...(Ts) == sizeof...(Us)) && requires { typename std::tuple<std::common_reference_t<TQual<Ts>, UQual<Us>>...>; }
+struct std::basic_common_reference<backport::detail::reference_tuple<Ts...>, std::tuple<Us...>, TQual, UQual> {
+    using type = backport::detail::reference_tuple<std::common_reference_t<TQual<Ts>, UQual<Us>>...>;
+};
+
+template <typename... Ts, typename... Us, template <typename> typename TQual, template <typename> typename UQual>
+    requires(sizeof...(Ts) == sizeof...(Us)) && requires { typename std::tuple<std::common_reference_t<TQual<Ts>, UQual<Us>>...>; }
+struct std::basic_common_reference<std::tuple<Ts...>, backport::detail::reference_tuple<Us...>, TQual, UQual> {
+    using type = backport::detail::reference_tuple<std::common_reference_t<TQual<Ts>, UQual<Us>>...>;
+};
+
+namespace backport {
+
+namespace ranges {
+
+// The feature test macro __cpp_lib_ranges_chunk is specifically designed to detect the availability of std::ranges::chunk_view in
+// the standard library, which was introduced in C++23. The value 202202L represents the date when the feature was added to the
+// standard (February 2022).
+#if defined(__cpp_lib_ranges_chunk) && __cpp_lib_ranges_chunk >= 202202L && !defined(RANGES_CUSTOM_IMPL)
+
+// Use std::ranges::chunk_view if available
+using std::ranges::chunk_view;
+namespace views {
+using std::ranges::views::chunk;
+} // namespace views
+
+#else
+
+// Custom implementation for pre-C++23: non-overlapping subranges of n elements, the last one shorter if n does not divide the
+// size. Forward ranges only, chunking an input range needs a shared cursor.
+template <std::ranges::view V>
+    requires std::ranges::forward_range<V>
+class chunk_view : public std::ranges::view_interface<chunk_view<V>> {
+    V                                  base_ = V();
+    std::ranges::range_difference_t<V> n_    = 1;
+
+    template <bool Const> class iterator {
+        using Base = detail::ranges_maybe_const<Const, V>;
+
+        std::ranges::iterator_t<Base>         current_ = std::ranges::iterator_t<Base>();
+        std::ranges::iterator_t<Base>         next_    = std::ranges::iterator_t<Base>();
+        std::ranges::sentinel_t<Base>         end_     = std::ranges::sentinel_t<Base>();
+        std::ranges::range_difference_t<Base> n_       = 0;
+
+      public:
+        using iterator_concept  = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag; // References are prvalues
+        using value_type        = std::ranges::subrange<std::ranges::iterator_t<Base>>;
+        using difference_type   = std::ranges::range_difference_t<Base>;
+
+        iterator() = default;
+        constexpr iterator(Base &base, difference_type n)
+            : current_(std::ranges::begin(base)), end_(std::ranges::end(base)), n_(n) {
+            next_ = std::ranges::next(current_, n_, end_);
+        }
+
+        constexpr value_type operator*() const { return value_type(current_, next_); }
+
+        constexpr iterator &operator++() {
+            current_ = next_;
+            next_    = std::ranges::next(next_, n_, end_);
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator &lhs, const iterator &rhs) { return lhs.current_ == rhs.current_; }
+        friend constexpr bool operator==(const iterator &it, std::default_sentinel_t) { return it.current_ == it.end_; }
+    };
+
+  public:
+    chunk_view()
+        requires std::default_initializable<V>
+    = default;
+    constexpr chunk_view(V base, std::ranges::range_difference_t<V> n) : base_(std::move(base)), n_(n) {}
+
+    constexpr V base() const &
+        requires std::copy_constructible<V>
+    {
+        return base_;
+    }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr auto begin() { return iterator<false>(base_, n_); }
+    constexpr auto begin() const
+        requires std::ranges::forward_range<const V>
+    {
+        return iterator<true>(base_, n_);
+    }
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    constexpr auto size()
+        requires std::ranges::sized_range<V>
+    {
+        const auto n = static_cast<std::ranges::range_size_t<V>>(n_);
+        return (std::ranges::size(base_) + n - 1) / n;
+    }
+    constexpr auto size() const
+        requires std::ranges::sized_range<const V>
+    {
+        const auto n = static_cast<std::ranges::range_size_t<const V>>(n_);
+        return (std::ranges::size(base_) + n - 1) / n;
+    }
+};
+
+template <typename R> chunk_view(R &&, std::ranges::range_difference_t<R>) -> chunk_view<std::views::all_t<R>>;
+
+namespace views {
+namespace detail {
+struct chunk_fn {
+    template <std::ranges::viewable_range R> constexpr auto operator()(R &&r, std::ranges::range_difference_t<R> n) const {
+        return chunk_view(std::forward<R>(r), n);
+    }
+
+    template <std::integral D> constexpr auto operator()(D n) const {
+        return backport::detail::range_closure{[n]<typename R>(R &&r) { return chunk_view(std::forward<R>(r), n); }};
+    }
+};
+} // namespace detail
+
+// views::chunk(r, n), r | views::chunk(n)
+// Preconditions: n > 0
+inline constexpr detail::chunk_fn chunk{};
+} // namespace views
+
+#endif
+
+// The feature test macro __cpp_lib_ranges_slide is specifically designed to detect the availability of std::ranges::slide_view in
+// the standard library, which was introduced in C++23. The value 202202L represents the date when the feature was added to the
+// standard (February 2022).
+#if defined(__cpp_lib_ranges_slide) && __cpp_lib_ranges_slide >= 202202L && !defined(RANGES_CUSTOM_IMPL)
+
+// Use std::ranges::slide_view if available
+using std::ranges::slide_view;
+namespace views {
+using std::ranges::views::slide;
+} // namespace views
+
+#else
+
+// Custom implementation for pre-C++23: every window of n consecutive elements, none if the range is shorter than n
+template <std::ranges::view V>
+    requires std::ranges::forward_range<V>
+class slide_view : public std::ranges::view_interface<slide_view<V>> {
+    V                                  base_ = V();
+    std::ranges::range_difference_t<V> n_    = 1;
+
+    template <bool Const> class iterator {
+        using Base = detail::ranges_maybe_const<Const, V>;
+
+        // current_ is the first element of the window, last_ its last one: the window is done when last_ reaches the end
+        std::ranges::iterator_t<Base> current_ = std::ranges::iterator_t<Base>();
+        std::ranges::iterator_t<Base> last_    = std::ranges::iterator_t<Base>();
+        std::ranges::sentinel_t<Base> end_     = std::ranges::sentinel_t<Base>();
+
+      public:
+        using iterator_concept  = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag; // References are prvalues
+        using value_type        = std::ranges::subrange<std::ranges::iterator_t<Base>>;
+        using difference_type   = std::ranges::range_difference_t<Base>;
+
+        iterator() = default;
+        constexpr iterator(Base &base, difference_type n) : current_(std::ranges::begin(base)), end_(std::ranges::end(base)) {
+            last_ = std::ranges::next(current_, n - 1, end_);
+        }
+
+        constexpr value_type operator*() const { return value_type(current_, std::ranges::next(last_)); }
+
+        constexpr iterator &operator++() {
+            ++current_;
+            ++last_;
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator &lhs, const iterator &rhs) { return lhs.current_ == rhs.current_; }
+        friend constexpr bool operator==(const iterator &it, std::default_sentinel_t) { return it.last_ == it.end_; }
+    };
+
+    template <typename Base> constexpr auto window_count(Base &base) const {
+        const auto size = std::ranges::size(base);
+        const auto n    = static_cast<decltype(size)>(n_);
+        return size >= n ? size - n + 1 : decltype(size)(0);
+    }
+
+  public:
+    slide_view()
+        requires std::default_initializable<V>
+    = default;
+    constexpr slide_view(V base, std::ranges::range_difference_t<V> n) : base_(std::move(base)), n_(n) {}
+
+    constexpr V base() const &
+        requires std::copy_constructible<V>
+    {
+        return base_;
+    }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr auto begin() { return iterator<false>(base_, n_); }
+    constexpr auto begin() const
+        requires std::ranges::forward_range<const V>
+    {
+        return iterator<true>(base_, n_);
+    }
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    constexpr auto size()
+        requires std::ranges::sized_range<V>
+    {
+        return window_count(base_);
+    }
+    constexpr auto size() const
+        requires std::ranges::sized_range<const V>
+    {
+        return window_count(base_);
+    }
+};
+
+template <typename R> slide_view(R &&, std::ranges::range_difference_t<R>) -> slide_view<std::views::all_t<R>>;
+
+namespace views {
+namespace detail {
+struct slide_fn {
+    template <std::ranges::viewable_range R> constexpr auto operator()(R &&r, std::ranges::range_difference_t<R> n) const {
+        return slide_view(std::forward<R>(r), n);
+    }
+
+    template <std::integral D> constexpr auto operator()(D n) const {
+        return backport::detail::range_closure{[n]<typename R>(R &&r) { return slide_view(std::forward<R>(r), n); }};
+    }
+};
+} // namespace detail
+
+// views::slide(r, n), r | views::slide(n)
+// Preconditions: n > 0
+inline constexpr detail::slide_fn slide{};
+} // namespace views
+
+#endif
+
+// The feature test macro __cpp_lib_ranges_stride is specifically designed to detect the availability of std::ranges::stride_view in
+// the standard library, which was introduced in C++23. The value 202207L represents the date when the feature was added to the
+// standard (July 2022).
+#if defined(__cpp_lib_ranges_stride) && __cpp_lib_ranges_stride >= 202207L && !defined(RANGES_CUSTOM_IMPL)
+
+// Use std::ranges::stride_view if available
+using std::ranges::stride_view;
+namespace views {
+using std::ranges::views::stride;
+} // namespace views
+
+#else
+
+// Custom implementation for pre-C++23: every n-th element, starting with the first
+template <std::ranges::view V>
+    requires std::ranges::input_range<V>
+class stride_view : public std::ranges::view_interface<stride_view<V>> {
+    V                                  base_   = V();
+    std::ranges::range_difference_t<V> stride_ = 1;
+
+    template <bool Const> class iterator : public backport::detail::view_iterator_category<detail::ranges_maybe_const<Const, V>> {
+        using Base = detail::ranges_maybe_const<Const, V>;
+
+        std::ranges::iterator_t<Base>         current_ = std::ranges::iterator_t<Base>();
+        std::ranges::sentinel_t<Base>         end_     = std::ranges::sentinel_t<Base>();
+        std::ranges::range_difference_t<Base> stride_  = 0;
+
+      public:
+        using iterator_concept =
+            std::conditional_t<std::ranges::forward_range<Base>, std::forward_iterator_tag, std::input_iterator_tag>;
+        using value_type      = std::ranges::range_value_t<Base>;
+        using difference_type = std::ranges::range_difference_t<Base>;
+
+        iterator()
+            requires std::default_initializable<std::ranges::iterator_t<Base>>
+        = default;
+        constexpr iterator(Base &base, difference_type stride)
+            : current_(std::ranges::begin(base)), end_(std::ranges::end(base)), stride_(stride) {}
+
+        constexpr decltype(auto) operator*() const { return *current_; }
+
+        constexpr iterator &operator++() {
+            std::ranges::advance(current_, stride_, end_);
+            return *this;
+        }
+
+        constexpr void operator++(int) { ++*this; }
+        constexpr iterator operator++(int)
+            requires std::ranges::forward_range<Base>
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator &lhs, const iterator &rhs)
+            requires std::equality_comparable<std::ranges::iterator_t<Base>>
+        {
+            return lhs.current_ == rhs.current_;
+        }
+        friend constexpr bool operator==(const iterator &it, std::default_sentinel_t) { return it.current_ == it.end_; }
+    };
+
+    template <typename Base> constexpr auto element_count(Base &base) const {
+        const auto size   = std::ranges::size(base);
+        const auto stride = static_cast<decltype(size)>(stride_);
+        return (size + stride - 1) / stride;
+    }
+
+  public:
+    stride_view()
+        requires std::default_initializable<V>
+    = default;
+    constexpr stride_view(V base, std::ranges::range_difference_t<V> stride) : base_(std::move(base)), stride_(stride) {}
+
+    constexpr V base() const &
+        requires std::copy_constructible<V>
+    {
+        return base_;
+    }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr std::ranges::range_difference_t<V> stride() const noexcept { return stride_; }
+
+    constexpr auto begin() { return iterator<false>(base_, stride_); }
+    constexpr auto begin() const
+        requires std::ranges::input_range<const V>
+    {
+        return iterator<true>(base_, stride_);
+    }
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    constexpr auto size()
+        requires std::ranges::sized_range<V>
+    {
+        return element_count(base_);
+    }
+    constexpr auto size() const
+        requires std::ranges::sized_range<const V>
+    {
+        return element_count(base_);
+    }
+};
+
+template <typename R> stride_view(R &&, std::ranges::range_difference_t<R>) -> stride_view<std::views::all_t<R>>;
+
+namespace views {
+namespace detail {
+struct stride_fn {
+    template <std::ranges::viewable_range R> constexpr auto operator()(R &&r, std::ranges::range_difference_t<R> n) const {
+        return stride_view(std::forward<R>(r), n);
+    }
+
+    template <std::integral D> constexpr auto operator()(D n) const {
+        return backport::detail::range_closure{[n]<typename R>(R &&r) { return stride_view(std::forward<R>(r), n); }};
+    }
+};
+} // namespace detail
+
+// views::stride(r, n), r | views::stride(n)
+// Preconditions: n > 0
+inline constexpr detail::stride_fn stride{};
+} // namespace views
+
+#endif
+
+// The feature test macro __cpp_lib_ranges_zip is specifically designed to detect the availability of std::ranges::zip_view in the
+// standard library, which was introduced in C++23. The value 202110L represents the date when the feature was added to the standard
+// (October 2021).
+#if defined(__cpp_lib_ranges_zip) && __cpp_lib_ranges_zip >= 202110L && !defined(RANGES_CUSTOM_IMPL)
+
+// Use std::ranges::zip_view if available
+using std::ranges::zip_view;
+namespace views {
+using std::ranges::views::zip;
+} // namespace views
+
+#else
+
+// Custom implementation for pre-C++23: tuples of the i-th elements of every range, as long as the shortest one. The tuples hold
+// the ranges' references, so assigning through std::get writes to the ranges, but pre-C++23 std::tuple cannot be swapped
+// through a prvalue, so zipped ranges cannot be sorted.
+template <std::ranges::input_range... Vs>
+    requires(sizeof...(Vs) > 0 && (std::ranges::view<Vs> && ...))
+class zip_view : public std::ranges::view_interface<zip_view<Vs...>> {
+    std::tuple<Vs...> views_;
+
+    template <bool Const> class iterator {
+        std::tuple<std::ranges::iterator_t<detail::ranges_maybe_const<Const, Vs>>...> current_;
+        std::tuple<std::ranges::sentinel_t<detail::ranges_maybe_const<Const, Vs>>...> end_;
+
+        static constexpr bool all_forward = (std::ranges::forward_range<detail::ranges_maybe_const<Const, Vs>> && ...);
+
+        // Done as soon as one of the ranges is
+        template <std::size_t... I> constexpr bool at_end(std::index_sequence<I...>) const {
+            return ((std::get<I>(current_) == std::get<I>(end_)) || ...);
+        }
+
+        template <std::size_t... I> constexpr bool any_equal(const iterator &other, std::index_sequence<I...>) const {
+            return ((std::get<I>(current_) == std::get<I>(other.current_)) || ...);
+        }
+
+      public:
+        using iterator_concept = std::conditional_t<all_forward, std::forward_iterator_tag, std::input_iterator_tag>;
+        using value_type       = std::tuple<std::ranges::range_value_t<detail::ranges_maybe_const<Const, Vs>>...>;
+        using difference_type  = std::common_type_t<std::ranges::range_difference_t<detail::ranges_maybe_const<Const, Vs>>...>;
+
+        iterator() = default;
+        constexpr iterator(std::tuple<std::ranges::iterator_t<detail::ranges_maybe_const<Const, Vs>>...> current,
+                           std::tuple<std::ranges::sentinel_t<detail::ranges_maybe_const<Const, Vs>>...>  end)
+            : current_(std::move(current)), end_(std::move(end)) {}
+
+        constexpr auto operator*() const {
+            return std::apply(
+                [](const auto &...it) {
+                    return backport::detail::reference_tuple<std::iter_reference_t<std::remove_cvref_t<decltype(it)>>...>(*it...);
+                },
+                current_);
+        }
+
+        constexpr iterator &operator++() {
+            std::apply([](auto &...it) { (++it, ...); }, current_);
+            return *this;
+        }
+
+        constexpr void operator++(int) { ++*this; }
+        constexpr iterator operator++(int)
+            requires all_forward
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator &lhs, const iterator &rhs)
+            requires all_forward
+        {
+            return lhs.any_equal(rhs, std::index_sequence_for<Vs...>());
+        }
+        friend constexpr bool operator==(const iterator &it, std::default_sentinel_t) {
+            return it.at_end(std::index_sequence_for<Vs...>());
+        }
+    };
+
+    template <bool Const, typename Views> static constexpr auto make_begin(Views &views) {
+        return iterator<Const>(std::apply([](auto &...v) { return std::tuple(std::ranges::begin(v)...); }, views),
+                               std::apply([](auto &...v) { return std::tuple(std::ranges::end(v)...); }, views));
+    }
+
+    template <typename Views> static constexpr auto min_size(Views &views) {
+        return std::apply(
+            [](auto &...v) {
+                using size_type = std::make_unsigned_t<std::common_type_t<decltype(std::ranges::size(v))...>>;
+                size_type sizes[] = {static_cast<size_type>(std::ranges::size(v))...};
+                size_type result  = sizes[0];
+                for (size_type s : sizes) result = s < result ? s : result;
+                return result;
+            },
+            views);
+    }
+
+  public:
+    zip_view() = default;
+    constexpr explicit zip_view(Vs... views) : views_(std::move(views)...) {}
+
+    constexpr auto begin() { return make_begin<false>(views_); }
+    constexpr auto begin() const
+        requires(std::ranges::input_range<const Vs> && ...)
+    {
+        return make_begin<true>(views_);
+    }
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    constexpr auto size()
+        requires(std::ranges::sized_range<Vs> && ...)
+    {
+        return min_size(views_);
+    }
+    constexpr auto size() const
+        requires(std::ranges::sized_range<const Vs> && ...)
+    {
+        return min_size(views_);
+    }
+};
+
+template <typename... Rs> zip_view(Rs &&...) -> zip_view<std::views::all_t<Rs>...>;
+
+namespace views {
+namespace detail {
+struct zip_fn {
+    constexpr auto operator()() const noexcept { return std::views::empty<std::tuple<>>; }
+
+    template <std::ranges::viewable_range... Rs>
+        requires(sizeof...(Rs) > 0)
+    constexpr auto operator()(Rs &&...rs) const {
+        return zip_view<std::views::all_t<Rs>...>(std::forward<Rs>(rs)...);
+    }
+};
+} // namespace detail
+
+// views::zip(a, b, ...)
+inline constexpr detail::zip_fn zip{};
+} // namespace views
+
+#endif
+
+// The feature test macro __cpp_lib_ranges_enumerate is specifically designed to detect the availability of
+// std::ranges::enumerate_view in the standard library, which was introduced in C++23. The value 202302L represents the date when the
+// feature was added to the standard (February 2023).
+#if defined(__cpp_lib_ranges_enumerate) && __cpp_lib_ranges_enumerate >= 202302L && !defined(RANGES_CUSTOM_IMPL)
+
+// Use std::ranges::enumerate_view if available
+using std::ranges::enumerate_view;
+namespace views {
+using std::ranges::views::enumerate;
+} // namespace views
+
+#else
+
+// Custom implementation for pre-C++23: tuples of the index and the element, for (auto [i, x] : r | views::enumerate)
+template <std::ranges::view V>
+    requires std::ranges::input_range<V>
+class enumerate_view : public std::ranges::view_interface<enumerate_view<V>> {
+    V base_ = V();
+
+    template <bool Const> class iterator {
+        using Base = detail::ranges_maybe_const<Const, V>;
+
+        std::ranges::iterator_t<Base>         current_ = std::ranges::iterator_t<Base>();
+        std::ranges::sentinel_t<Base>         end_     = std::ranges::sentinel_t<Base>();
+        std::ranges::range_difference_t<Base> pos_     = 0;
+
+      public:
+        using iterator_concept =
+            std::conditional_t<std::ranges::forward_range<Base>, std::forward_iterator_tag, std::input_iterator_tag>;
+        using iterator_category = std::input_iterator_tag; // References are prvalues
+        using difference_type   = std::ranges::range_difference_t<Base>;
+        using value_type        = std::tuple<difference_type, std::ranges::range_value_t<Base>>;
+
+        iterator()
+            requires std::default_initializable<std::ranges::iterator_t<Base>>
+        = default;
+        constexpr explicit iterator(Base &base) : current_(std::ranges::begin(base)), end_(std::ranges::end(base)) {}
+
+        constexpr auto operator*() const {
+            return backport::detail::reference_tuple<difference_type, std::ranges::range_reference_t<Base>>(pos_, *current_);
+        }
+
+        constexpr difference_type index() const noexcept { return pos_; }
+
+        constexpr iterator &operator++() {
+            ++current_;
+            ++pos_;
+            return *this;
+        }
+
+        constexpr void operator++(int) { ++*this; }
+        constexpr iterator operator++(int)
+            requires std::ranges::forward_range<Base>
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator &lhs, const iterator &rhs) noexcept { return lhs.pos_ == rhs.pos_; }
+        friend constexpr bool operator==(const iterator &it, std::default_sentinel_t) { return it.current_ == it.end_; }
+    };
+
+  public:
+    enumerate_view()
+        requires std::default_initializable<V>
+    = default;
+    constexpr explicit enumerate_view(V base) : base_(std::move(base)) {}
+
+    constexpr V base() const &
+        requires std::copy_constructible<V>
+    {
+        return base_;
+    }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr auto begin() { return iterator<false>(base_); }
+    constexpr auto begin() const
+        requires std::ranges::input_range<const V>
+    {
+        return iterator<true>(base_);
+    }
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    constexpr auto size()
+        requires std::ranges::sized_range<V>
+    {
+        return std::ranges::size(base_);
+    }
+    constexpr auto size() const
+        requires std::ranges::sized_range<const V>
+    {
+        return std::ranges::size(base_);
+    }
+};
+
+template <typename R> enumerate_view(R &&) -> enumerate_view<std::views::all_t<R>>;
+
+namespace views {
+// views::enumerate(r), r | views::enumerate
+inline constexpr backport::detail::range_closure enumerate{
+    []<std::ranges::viewable_range R>(R &&r) { return enumerate_view<std::views::all_t<R>>(std::forward<R>(r)); }};
+} // namespace views
+
+#endif
+
+// The feature test macro __cpp_lib_ranges_to_container is specifically designed to detect the availability of std::ranges::to in
+// the standard library, which was introduced in C++23. The value 202202L represents the date when the feature was added to the
+// standard (February 2022).
+#if defined(__cpp_lib_ranges_to_container) && __cpp_lib_ranges_to_container >= 202202L && !defined(RANGES_CUSTOM_IMPL)
+
+// Use std::ranges::to if available
+using std::ranges::to;
+
+#else
+
+// Custom implementation for pre-C++23. Builds a C from the elements of r, ranges of ranges recursively. A sized source on
+// a container with reserve() is a single allocation, common ranges with forward iterators use the container's iterator-pair
+// constructor, which measures first.
+template <typename C, std::ranges::input_range R, typename... Args>
+    requires(!std::ranges::view<C>)
+constexpr C to(R &&r, Args &&...args) {
+    static_assert(!std::is_const_v<C> && !std::is_volatile_v<C> && std::is_class_v<C>, "ranges::to builds a class type");
+    using reference = std::ranges::range_reference_t<R>;
+
+    if constexpr (!std::ranges::input_range<C> || std::convertible_to<reference, std::ranges::range_value_t<C>>) {
+        if constexpr (std::constructible_from<C, R, Args...>) {
+            return C(std::forward<R>(r), std::forward<Args>(args)...);
+        } else if constexpr (std::ranges::common_range<R> && detail::legacy_forward_iterator<std::ranges::iterator_t<R>> &&
+                             std::constructible_from<C, std::ranges::iterator_t<R>, std::ranges::iterator_t<R>, Args...>) {
+            return C(std::ranges::begin(r), std::ranges::end(r), std::forward<Args>(args)...);
+        } else if constexpr (std::constructible_from<C, Args...> && detail::container_appendable<C, reference>) {
+            C c(std::forward<Args>(args)...);
+            if constexpr (std::ranges::sized_range<R> && detail::reservable_container<C>) {
+                c.reserve(static_cast<std::ranges::range_size_t<C>>(std::ranges::size(r)));
+            }
+            for (auto &&element : r) detail::container_append(c, std::forward<decltype(element)>(element));
+            return c;
+        } else {
+            static_assert(std::ranges::common_range<R> && detail::legacy_input_iterator<std::ranges::iterator_t<R>> &&
+                              std::constructible_from<C, std::ranges::iterator_t<R>, std::ranges::iterator_t<R>, Args...>,
+                          "ranges::to cannot build C from this range");
+            return C(std::ranges::begin(r), std::ranges::end(r), std::forward<Args>(args)...);
+        }
+    } else {
+        static_assert(std::ranges::input_range<reference>, "the elements of r cannot be converted to the elements of C");
+        return ranges::to<C>(r | std::views::transform([](auto &&element) {
+                                 return ranges::to<std::ranges::range_value_t<C>>(std::forward<decltype(element)>(element));
+                             }),
+                             std::forward<Args>(args)...);
+    }
+}
+
+// to<std::vector>(r): the element type is deduced as the container's deduction guides would from r's iterators
+template <template <typename...> typename C, std::ranges::input_range R, typename... Args> constexpr auto to(R &&r, Args &&...args) {
+    using container = typename decltype(detail::deduce_container<C, R, Args...>())::type;
+    return ranges::to<container>(std::forward<R>(r), std::forward<Args>(args)...);
+}
+
+// r | to<C>(args...)
+template <typename C, typename... Args>
+    requires(!std::ranges::view<C>)
+constexpr auto to(Args &&...args) {
+    return backport::detail::range_closure{[... args = std::forward<Args>(args)]<typename R>(R &&r) {
+        return ranges::to<C>(std::forward<R>(r), args...);
+    }};
+}
+
+template <template <typename...> typename C, typename... Args> constexpr auto to(Args &&...args) {
+    return backport::detail::range_closure{[... args = std::forward<Args>(args)]<typename R>(R &&r) {
+        return ranges::to<C>(std::forward<R>(r), args...);
+    }};
+}
+
+#endif
+
+} // namespace ranges
+
+namespace views = ranges::views;
+
+} // namespace backport
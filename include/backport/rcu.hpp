@@ -0,0 +1,280 @@
+#pragma once
+
+#include "detail/config.hpp"
+#include "move_only_function.hpp"
+#include "task_queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <version>
+#if __has_include(<rcu>)
+#include <rcu>
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_rcu is specifically designed to detect the availability of std::rcu_domain and the other
+// read-copy-update facilities in the standard library, which were introduced in C++26. The value 202306L represents the date when
+// the feature was added to the standard (June 2023).
+#if defined(__cpp_lib_rcu) && __cpp_lib_rcu >= 202306L && !defined(RCU_CUSTOM_IMPL)
+
+// Use std::rcu_domain if available
+using std::rcu_barrier;
+using std::rcu_default_domain;
+using std::rcu_domain;
+using std::rcu_obj_base;
+using std::rcu_retire;
+using std::rcu_synchronize;
+
+#else
+
+// Custom implementation for pre-C++26 (P2545). Epoch based: a reader entering a critical section copies the global epoch
+// into its own cache line, rcu_synchronize advances the epoch and waits for every reader still in an older one. Readers never
+// write to a shared line, so read-side cost does not grow with the number of cores.
+class rcu_domain;
+rcu_domain &rcu_default_domain() noexcept;
+
+namespace detail {
+
+struct rcu_access;
+
+// Stored inline in the retired object like the hazard pointer deleters, retiring never allocates
+using rcu_reclaim = basic_move_only_function<void() noexcept, 2 * sizeof(void *), alignof(void *),
+                                             function_options::compact | function_options::inplace>;
+
+template <typename T, typename D> struct rcu_retire_call {
+    BACKPORT_NO_UNIQUE_ADDRESS D deleter;
+    T                      *object;
+
+    void operator()() noexcept { deleter(object); }
+};
+
+struct rcu_retired {
+    rcu_retired *next = nullptr;
+    rcu_reclaim  reclaim;
+};
+
+// The node rcu_retire allocates for objects that do not derive from rcu_obj_base, it frees itself after the deleter ran
+template <typename T, typename D> struct rcu_retire_node : rcu_retired {
+    BACKPORT_NO_UNIQUE_ADDRESS D deleter;
+    T                      *object;
+
+    rcu_retire_node(T *p, D &&d) noexcept : deleter(std::move(d)), object(p) {
+        reclaim = [this]() noexcept {
+            deleter(object);
+            delete this;
+        };
+    }
+};
+
+// Epoch of the critical section the owning thread is in, 0 outside of one
+struct alignas(cache_line_size) rcu_record {
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<bool>          in_use{false};
+    rcu_record                *next    = nullptr;
+    unsigned                   nesting = 0; // Only touched by the owning thread
+};
+
+} // namespace detail
+
+class rcu_domain {
+    // Retired objects handed to one grace period, a grace period waits for every reader so it is shared by as many as possible
+    static constexpr std::size_t retire_batch = 64;
+
+    std::atomic<detail::rcu_record *>  records{nullptr};
+    std::atomic<std::uint64_t>         epoch{1};
+    std::atomic<detail::rcu_retired *> retired{nullptr};
+    std::atomic<std::size_t>           retired_count{0};
+    // Threads running a batch of deleters, rcu_barrier waits for them
+    std::atomic<unsigned> reclaiming{0};
+
+    friend rcu_domain &rcu_default_domain() noexcept;
+    friend struct detail::rcu_access;
+
+    // Gives the record back when the thread exits
+    struct thread_record {
+        detail::rcu_record *record = nullptr;
+
+        ~thread_record() {
+            if (record != nullptr) record->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    rcu_domain() = default;
+
+    // The calling thread's record, claimed on its first critical section
+    detail::rcu_record &local() noexcept {
+        thread_local thread_record owner;
+        if (owner.record == nullptr) owner.record = acquire();
+        return *owner.record;
+    }
+
+    detail::rcu_record *acquire() noexcept {
+        for (detail::rcu_record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed) &&
+                r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return r;
+            }
+        }
+        auto *r = new detail::rcu_record;
+        r->in_use.store(true, std::memory_order_relaxed);
+        r->next = records.load(std::memory_order_relaxed);
+        while (!records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        return r;
+    }
+
+    void synchronize() noexcept {
+        // Pairs with the fence in lock: either the reader's epoch is visible here, or the reader sees the unlinked data
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::uint64_t target = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        for (detail::rcu_record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            for (;;) {
+                const std::uint64_t e = r->epoch.load(std::memory_order_acquire);
+                if (e == 0 || e >= target) break;
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void retire(detail::rcu_retired *node) noexcept {
+        node->next = retired.load(std::memory_order_relaxed);
+        while (!retired.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        // A grace period cannot end while this thread is a reader, the batch is left for the next retire or rcu_barrier
+        if (retired_count.fetch_add(1, std::memory_order_relaxed) + 1 >= retire_batch && local().nesting == 0) reclaim();
+    }
+
+    // Take everything retired so far, wait for one grace period and run the deleters
+    void reclaim() noexcept {
+        reclaiming.fetch_add(1, std::memory_order_acq_rel);
+        if (detail::rcu_retired *node = retired.exchange(nullptr, std::memory_order_acquire)) {
+            std::size_t taken = 0;
+            synchronize();
+            while (node != nullptr) {
+                detail::rcu_retired *next    = node->next;
+                detail::rcu_reclaim  reclaim = std::move(node->reclaim); // The deleter frees the node
+                reclaim();
+                node = next;
+                ++taken;
+            }
+            retired_count.fetch_sub(taken, std::memory_order_relaxed);
+        }
+        reclaiming.fetch_sub(1, std::memory_order_release);
+    }
+
+  public:
+    rcu_domain(const rcu_domain &)            = delete;
+    rcu_domain &operator=(const rcu_domain &) = delete;
+
+    // There are no readers left at exit, whatever is still retired is reclaimed
+    ~rcu_domain() {
+        while (detail::rcu_retired *node = retired.exchange(nullptr, std::memory_order_acquire)) {
+            while (node != nullptr) {
+                detail::rcu_retired *next    = node->next;
+                detail::rcu_reclaim  reclaim = std::move(node->reclaim);
+                reclaim();
+                node = next;
+            }
+        }
+        for (detail::rcu_record *r = records.load(std::memory_order_acquire); r != nullptr;) {
+            delete std::exchange(r, r->next);
+        }
+    }
+
+    // Enter a critical section, sections nest
+    void lock() noexcept {
+        detail::rcu_record &r = local();
+        if (r.nesting++ == 0) {
+            r.epoch.store(epoch.load(std::memory_order_seq_cst), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    // Entering never blocks
+    bool try_lock() noexcept {
+        lock();
+        return true;
+    }
+
+    void unlock() noexcept {
+        detail::rcu_record &r = local();
+        if (--r.nesting == 0) r.epoch.store(0, std::memory_order_release);
+    }
+};
+
+inline rcu_domain &rcu_default_domain() noexcept {
+    static rcu_domain domain;
+    return domain;
+}
+
+namespace detail {
+
+// The free functions and rcu_obj_base reach the domain's internals through here
+struct rcu_access {
+    static void synchronize(rcu_domain &dom) noexcept { dom.synchronize(); }
+    static void retire(rcu_domain &dom, rcu_retired *node) noexcept { dom.retire(node); }
+
+    static void barrier(rcu_domain &dom) noexcept {
+        dom.reclaim();
+        while (dom.reclaiming.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+    }
+};
+
+} // namespace detail
+
+// Wait until every critical section that began before the call has ended
+// Preconditions: the calling thread is not in a critical section of dom
+inline void rcu_synchronize(rcu_domain &dom = rcu_default_domain()) noexcept { detail::rcu_access::synchronize(dom); }
+
+// Wait until the deleters of every object retired before the call have run
+// Preconditions: the calling thread is not in a critical section of dom
+inline void rcu_barrier(rcu_domain &dom = rcu_default_domain()) noexcept { detail::rcu_access::barrier(dom); }
+
+// Base class of objects reclaimed through RCU: T derives from rcu_obj_base<T, D> and is reclaimed with D once the readers
+// that could still see it have left their critical sections
+template <typename T, typename D = std::default_delete<T>> class rcu_obj_base : private detail::rcu_retired {
+  public:
+    // Preconditions: the object is unreachable for new readers
+    void retire(D d = D(), rcu_domain &dom = rcu_default_domain()) noexcept {
+        this->reclaim = detail::rcu_retire_call<T, D>{std::move(d), static_cast<T *>(this)};
+        detail::rcu_access::retire(dom, this);
+    }
+
+  protected:
+    rcu_obj_base() = default;
+    // Copies are separate objects, retired on their own
+    rcu_obj_base(const rcu_obj_base &) noexcept : detail::rcu_retired() {}
+    rcu_obj_base(rcu_obj_base &&) noexcept : detail::rcu_retired() {}
+    rcu_obj_base &operator=(const rcu_obj_base &) noexcept { return *this; }
+    rcu_obj_base &operator=(rcu_obj_base &&) noexcept { return *this; }
+    ~rcu_obj_base() = default;
+};
+
+// Retire an object that does not derive from rcu_obj_base, this allocates a node for it
+template <typename T, typename D = std::default_delete<T>> void rcu_retire(T *p, D d = D(), rcu_domain &dom = rcu_default_domain()) {
+    detail::rcu_access::retire(dom, new detail::rcu_retire_node<T, D>(p, std::move(d)));
+}
+
+#endif
+
+// RAII critical section of an rcu_domain, the same as std::scoped_lock<rcu_domain> without spelling out the domain. Not part of
+// P2545, its earlier revisions called it rcu_reader.
+class rcu_reader {
+    rcu_domain *domain;
+
+  public:
+    rcu_reader() noexcept : rcu_reader(rcu_default_domain()) {}
+    explicit rcu_reader(rcu_domain &dom) noexcept : domain(&dom) { domain->lock(); }
+    ~rcu_reader() { domain->unlock(); }
+
+    rcu_reader(const rcu_reader &)            = delete;
+    rcu_reader &operator=(const rcu_reader &) = delete;
+};
+
+} // namespace backport
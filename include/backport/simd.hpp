@@ -0,0 +1,1675 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if !defined(SIMD_CUSTOM_IMPL) && defined(__GLIBCXX__) && defined(_GLIBCXX_RELEASE) && _GLIBCXX_RELEASE >= 11
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
+#endif
+
+namespace backport {
+
+// The feature test macro __cpp_lib_experimental_parallel_simd is specifically designed to detect the availability of the data-parallel
+// types of the Parallelism TS 2 (std::experimental::simd), which libstdc++ ships since GCC 11. The value 201803L represents the date
+// of the technical specification (March 2018). C++26 std::simd has a different interface and is not used.
+#if defined(__cpp_lib_experimental_parallel_simd) && __cpp_lib_experimental_parallel_simd >= 201803L && !defined(SIMD_CUSTOM_IMPL)
+
+// Use std::experimental::simd if available
+namespace simd_abi = std::experimental::simd_abi;
+
+using std::experimental::const_where_expression;
+using std::experimental::element_aligned;
+using std::experimental::element_aligned_tag;
+using std::experimental::fixed_size_simd;
+using std::experimental::fixed_size_simd_mask;
+using std::experimental::is_abi_tag;
+using std::experimental::is_abi_tag_v;
+using std::experimental::is_simd;
+using std::experimental::is_simd_mask;
+using std::experimental::is_simd_mask_v;
+using std::experimental::is_simd_v;
+using std::experimental::memory_alignment;
+using std::experimental::memory_alignment_v;
+using std::experimental::native_simd;
+using std::experimental::native_simd_mask;
+using std::experimental::overaligned;
+using std::experimental::overaligned_tag;
+using std::experimental::simd;
+using std::experimental::simd_mask;
+using std::experimental::simd_size;
+using std::experimental::simd_size_v;
+using std::experimental::vector_aligned;
+using std::experimental::vector_aligned_tag;
+using std::experimental::where_expression;
+
+using std::experimental::abs;
+using std::experimental::all_of;
+using std::experimental::any_of;
+using std::experimental::clamp;
+using std::experimental::find_first_set;
+using std::experimental::find_last_set;
+using std::experimental::hmax;
+using std::experimental::hmin;
+using std::experimental::max;
+using std::experimental::min;
+using std::experimental::minmax;
+using std::experimental::none_of;
+using std::experimental::popcount;
+using std::experimental::reduce;
+using std::experimental::some_of;
+using std::experimental::sqrt;
+using std::experimental::static_simd_cast;
+using std::experimental::where;
+
+#else
+
+#if defined(__AVX512F__)
+#define BACKPORT_SIMD_AVX512 1
+#endif
+#if defined(__AVX2__)
+#define BACKPORT_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BACKPORT_SIMD_SSE2 1
+#endif
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define BACKPORT_SIMD_SSE4_1 1
+#endif
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define BACKPORT_SIMD_NEON 1
+#endif
+
+} // namespace backport
+
+#if defined(BACKPORT_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+#if defined(BACKPORT_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace backport {
+
+// Custom implementation of the Parallelism TS 2 interface. simd<T, Abi> wraps one register of a backend chosen at compile
+// time: SSE2 (SSE4.1 where it helps), AVX2, AVX-512F or NEON for float, double, int32_t and uint32_t, and plain arrays for
+// every other type and for fixed_size, which the compiler vectorizes itself. Operations a backend lacks run one lane at a time.
+namespace simd_abi {
+
+struct scalar {};
+
+template <int N> struct fixed_size {
+    static_assert(N > 0 && N <= 64, "fixed_size supports 1 to 64 elements");
+};
+
+template <typename T> inline constexpr int max_fixed_size = 64;
+
+// A full register of Bytes bytes
+template <std::size_t Bytes> struct vec {};
+
+#if defined(BACKPORT_SIMD_AVX512)
+inline constexpr std::size_t native_bytes = 64;
+#elif defined(BACKPORT_SIMD_AVX2)
+inline constexpr std::size_t native_bytes = 32;
+#elif defined(BACKPORT_SIMD_SSE2) || defined(BACKPORT_SIMD_NEON)
+inline constexpr std::size_t native_bytes = 16;
+#else
+inline constexpr std::size_t native_bytes = 0;
+#endif
+
+inline constexpr std::size_t compatible_bytes = native_bytes == 0 ? 0 : 16;
+
+template <typename T> using native     = std::conditional_t<native_bytes == 0, scalar, vec<native_bytes>>;
+template <typename T> using compatible = std::conditional_t<compatible_bytes == 0, scalar, vec<compatible_bytes>>;
+
+} // namespace simd_abi
+
+template <typename T, typename Abi = simd_abi::compatible<T>> class simd;
+template <typename T, typename Abi = simd_abi::compatible<T>> class simd_mask;
+
+template <typename T> using native_simd          = simd<T, simd_abi::native<T>>;
+template <typename T> using native_simd_mask     = simd_mask<T, simd_abi::native<T>>;
+template <typename T, int N> using fixed_size_simd      = simd<T, simd_abi::fixed_size<N>>;
+template <typename T, int N> using fixed_size_simd_mask = simd_mask<T, simd_abi::fixed_size<N>>;
+
+// Load and store flags
+struct element_aligned_tag {};
+struct vector_aligned_tag {};
+template <std::size_t N> struct overaligned_tag {};
+
+inline constexpr element_aligned_tag              element_aligned{};
+inline constexpr vector_aligned_tag               vector_aligned{};
+template <std::size_t N> inline constexpr overaligned_tag<N> overaligned{};
+
+template <typename T> struct is_simd_flag_type : std::false_type {};
+template <> struct is_simd_flag_type<element_aligned_tag> : std::true_type {};
+template <> struct is_simd_flag_type<vector_aligned_tag> : std::true_type {};
+template <std::size_t N> struct is_simd_flag_type<overaligned_tag<N>> : std::bool_constant<std::has_single_bit(N)> {};
+template <typename T> inline constexpr bool is_simd_flag_type_v = is_simd_flag_type<T>::value;
+
+template <typename T> struct is_abi_tag : std::false_type {};
+template <> struct is_abi_tag<simd_abi::scalar> : std::true_type {};
+template <int N> struct is_abi_tag<simd_abi::fixed_size<N>> : std::true_type {};
+template <std::size_t Bytes> struct is_abi_tag<simd_abi::vec<Bytes>> : std::true_type {};
+template <typename T> inline constexpr bool is_abi_tag_v = is_abi_tag<T>::value;
+
+template <typename T> struct is_simd : std::false_type {};
+template <typename T, typename Abi> struct is_simd<simd<T, Abi>> : std::true_type {};
+template <typename T> inline constexpr bool is_simd_v = is_simd<T>::value;
+
+template <typename T> struct is_simd_mask : std::false_type {};
+template <typename T, typename Abi> struct is_simd_mask<simd_mask<T, Abi>> : std::true_type {};
+template <typename T> inline constexpr bool is_simd_mask_v = is_simd_mask<T>::value;
+
+namespace detail {
+
+template <typename T>
+concept vectorizable = std::is_arithmetic_v<T> && !std::is_same_v<std::remove_cv_t<T>, bool> && std::is_same_v<std::remove_cv_t<T>, T>;
+
+template <typename T, std::size_t N> constexpr std::size_t simd_alignment() noexcept {
+    return std::min<std::size_t>(std::bit_ceil(sizeof(T) * N), 64);
+}
+
+// Plain arrays, used for scalar, fixed_size and the native width of types without intrinsics
+template <typename T, std::size_t N> struct simd_generic_backend {
+    static constexpr std::size_t size = N;
+
+    struct reg {
+        alignas(simd_alignment<T, N>()) T v[N];
+    };
+    struct mask {
+        bool v[N];
+    };
+
+    static reg load(const T *p) noexcept {
+        reg r;
+        for (std::size_t i = 0; i < N; ++i) r.v[i] = p[i];
+        return r;
+    }
+    static reg  load_aligned(const T *p) noexcept { return load(p); }
+    static void store(T *p, const reg &r) noexcept {
+        for (std::size_t i = 0; i < N; ++i) p[i] = r.v[i];
+    }
+    static void store_aligned(T *p, const reg &r) noexcept { store(p, r); }
+
+    static reg broadcast(T x) noexcept {
+        reg r;
+        for (std::size_t i = 0; i < N; ++i) r.v[i] = x;
+        return r;
+    }
+
+    static mask mask_load(const bool *b) noexcept {
+        mask m;
+        for (std::size_t i = 0; i < N; ++i) m.v[i] = b[i];
+        return m;
+    }
+    static void mask_store(bool *b, const mask &m) noexcept {
+        for (std::size_t i = 0; i < N; ++i) b[i] = m.v[i];
+    }
+};
+
+template <typename T, typename Abi> struct simd_backend;
+
+template <typename T> struct simd_backend<T, simd_abi::scalar> : simd_generic_backend<T, 1> {};
+template <typename T, int N> struct simd_backend<T, simd_abi::fixed_size<N>> : simd_generic_backend<T, static_cast<std::size_t>(N)> {};
+template <typename T, std::size_t Bytes> struct simd_backend<T, simd_abi::vec<Bytes>> : simd_generic_backend<T, Bytes / sizeof(T)> {};
+
+#if defined(BACKPORT_SIMD_SSE2)
+
+template <> struct simd_backend<float, simd_abi::vec<16>> {
+    static constexpr std::size_t size = 4;
+
+    using reg  = __m128;
+    using mask = __m128;
+
+    static reg  load(const float *p) noexcept { return _mm_loadu_ps(p); }
+    static reg  load_aligned(const float *p) noexcept { return _mm_load_ps(p); }
+    static void store(float *p, reg v) noexcept { _mm_storeu_ps(p, v); }
+    static void store_aligned(float *p, reg v) noexcept { _mm_store_ps(p, v); }
+    static reg  broadcast(float x) noexcept { return _mm_set1_ps(x); }
+
+    static reg add(reg a, reg b) noexcept { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm_div_ps(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm_min_ps(b, a); }
+    static reg max(reg a, reg b) noexcept { return _mm_max_ps(b, a); }
+    static reg sqrt(reg a) noexcept { return _mm_sqrt_ps(a); }
+
+    static mask eq(reg a, reg b) noexcept { return _mm_cmpeq_ps(a, b); }
+    static mask lt(reg a, reg b) noexcept { return _mm_cmplt_ps(a, b); }
+    static mask le(reg a, reg b) noexcept { return _mm_cmple_ps(a, b); }
+    static reg  select(mask m, reg t, reg f) noexcept { return _mm_or_ps(_mm_and_ps(m, t), _mm_andnot_ps(m, f)); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return _mm_and_ps(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return _mm_or_ps(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return _mm_xor_ps(a, b); }
+    static mask          mask_not(mask a) noexcept { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+    static std::uint64_t mask_bits(mask m) noexcept { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept {
+        const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes), lanes));
+    }
+};
+
+template <> struct simd_backend<double, simd_abi::vec<16>> {
+    static constexpr std::size_t size = 2;
+
+    using reg  = __m128d;
+    using mask = __m128d;
+
+    static reg  load(const double *p) noexcept { return _mm_loadu_pd(p); }
+    static reg  load_aligned(const double *p) noexcept { return _mm_load_pd(p); }
+    static void store(double *p, reg v) noexcept { _mm_storeu_pd(p, v); }
+    static void store_aligned(double *p, reg v) noexcept { _mm_store_pd(p, v); }
+    static reg  broadcast(double x) noexcept { return _mm_set1_pd(x); }
+
+    static reg add(reg a, reg b) noexcept { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm_div_pd(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm_min_pd(b, a); }
+    static reg max(reg a, reg b) noexcept { return _mm_max_pd(b, a); }
+    static reg sqrt(reg a) noexcept { return _mm_sqrt_pd(a); }
+
+    static mask eq(reg a, reg b) noexcept { return _mm_cmpeq_pd(a, b); }
+    static mask lt(reg a, reg b) noexcept { return _mm_cmplt_pd(a, b); }
+    static mask le(reg a, reg b) noexcept { return _mm_cmple_pd(a, b); }
+    static reg  select(mask m, reg t, reg f) noexcept { return _mm_or_pd(_mm_and_pd(m, t), _mm_andnot_pd(m, f)); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return _mm_and_pd(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return _mm_or_pd(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return _mm_xor_pd(a, b); }
+    static mask          mask_not(mask a) noexcept { return _mm_xor_pd(a, _mm_castsi128_pd(_mm_set1_epi32(-1))); }
+    static std::uint64_t mask_bits(mask m) noexcept { return static_cast<unsigned>(_mm_movemask_pd(m)); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept {
+        const __m128i lanes = _mm_setr_epi32(1, 1, 2, 2);
+        return _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes), lanes));
+    }
+};
+
+template <typename T> struct simd_sse_int32_backend {
+    static constexpr std::size_t size = 4;
+
+    using reg  = __m128i;
+    using mask = __m128i;
+
+    static reg  load(const T *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static reg  load_aligned(const T *p) noexcept { return _mm_load_si128(reinterpret_cast<const __m128i *>(p)); }
+    static void store(T *p, reg v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+    static void store_aligned(T *p, reg v) noexcept { _mm_store_si128(reinterpret_cast<__m128i *>(p), v); }
+    static reg  broadcast(T x) noexcept { return _mm_set1_epi32(static_cast<int>(x)); }
+
+    static reg add(reg a, reg b) noexcept { return _mm_add_epi32(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm_sub_epi32(a, b); }
+    static reg bit_and(reg a, reg b) noexcept { return _mm_and_si128(a, b); }
+    static reg bit_or(reg a, reg b) noexcept { return _mm_or_si128(a, b); }
+    static reg bit_xor(reg a, reg b) noexcept { return _mm_xor_si128(a, b); }
+    static reg shift_left(reg a, int n) noexcept { return _mm_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+    static reg shift_right(reg a, int n) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm_sra_epi32(a, _mm_cvtsi32_si128(n));
+        } else {
+            return _mm_srl_epi32(a, _mm_cvtsi32_si128(n));
+        }
+    }
+#if defined(BACKPORT_SIMD_SSE4_1)
+    static reg mul(reg a, reg b) noexcept { return _mm_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm_min_epi32(a, b);
+        } else {
+            return _mm_min_epu32(a, b);
+        }
+    }
+    static reg max(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm_max_epi32(a, b);
+        } else {
+            return _mm_max_epu32(a, b);
+        }
+    }
+#endif
+
+    static mask eq(reg a, reg b) noexcept { return _mm_cmpeq_epi32(a, b); }
+    static mask lt(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm_cmplt_epi32(a, b);
+        } else {
+            const __m128i sign = _mm_set1_epi32(std::numeric_limits<int>::min());
+            return _mm_cmplt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+        }
+    }
+    static reg select(mask m, reg t, reg f) noexcept { return _mm_or_si128(_mm_and_si128(m, t), _mm_andnot_si128(m, f)); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return _mm_and_si128(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return _mm_or_si128(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return _mm_xor_si128(a, b); }
+    static mask          mask_not(mask a) noexcept { return _mm_xor_si128(a, _mm_set1_epi32(-1)); }
+    static std::uint64_t mask_bits(mask m) noexcept { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m))); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept {
+        const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+        return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes), lanes);
+    }
+};
+
+template <> struct simd_backend<std::int32_t, simd_abi::vec<16>> : simd_sse_int32_backend<std::int32_t> {};
+template <> struct simd_backend<std::uint32_t, simd_abi::vec<16>> : simd_sse_int32_backend<std::uint32_t> {};
+
+#endif
+
+#if defined(BACKPORT_SIMD_AVX2)
+
+template <> struct simd_backend<float, simd_abi::vec<32>> {
+    static constexpr std::size_t size = 8;
+
+    using reg  = __m256;
+    using mask = __m256;
+
+    static reg  load(const float *p) noexcept { return _mm256_loadu_ps(p); }
+    static reg  load_aligned(const float *p) noexcept { return _mm256_load_ps(p); }
+    static void store(float *p, reg v) noexcept { _mm256_storeu_ps(p, v); }
+    static void store_aligned(float *p, reg v) noexcept { _mm256_store_ps(p, v); }
+    static reg  broadcast(float x) noexcept { return _mm256_set1_ps(x); }
+
+    static reg add(reg a, reg b) noexcept { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm256_div_ps(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm256_min_ps(b, a); }
+    static reg max(reg a, reg b) noexcept { return _mm256_max_ps(b, a); }
+    static reg sqrt(reg a) noexcept { return _mm256_sqrt_ps(a); }
+
+    static mask eq(reg a, reg b) noexcept { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static mask lt(reg a, reg b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static reg  select(mask m, reg t, reg f) noexcept { return _mm256_blendv_ps(f, t, m); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return _mm256_and_ps(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return _mm256_or_ps(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return _mm256_xor_ps(a, b); }
+    static mask          mask_not(mask a) noexcept { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+    static std::uint64_t mask_bits(mask m) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept {
+        const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lanes), lanes));
+    }
+};
+
+template <> struct simd_backend<double, simd_abi::vec<32>> {
+    static constexpr std::size_t size = 4;
+
+    using reg  = __m256d;
+    using mask = __m256d;
+
+    static reg  load(const double *p) noexcept { return _mm256_loadu_pd(p); }
+    static reg  load_aligned(const double *p) noexcept { return _mm256_load_pd(p); }
+    static void store(double *p, reg v) noexcept { _mm256_storeu_pd(p, v); }
+    static void store_aligned(double *p, reg v) noexcept { _mm256_store_pd(p, v); }
+    static reg  broadcast(double x) noexcept { return _mm256_set1_pd(x); }
+
+    static reg add(reg a, reg b) noexcept { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm256_div_pd(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm256_min_pd(b, a); }
+    static reg max(reg a, reg b) noexcept { return _mm256_max_pd(b, a); }
+    static reg sqrt(reg a) noexcept { return _mm256_sqrt_pd(a); }
+
+    static mask eq(reg a, reg b) noexcept { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static mask lt(reg a, reg b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static reg  select(mask m, reg t, reg f) noexcept { return _mm256_blendv_pd(f, t, m); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return _mm256_and_pd(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return _mm256_or_pd(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return _mm256_xor_pd(a, b); }
+    static mask          mask_not(mask a) noexcept { return _mm256_xor_pd(a, _mm256_castsi256_pd(_mm256_set1_epi32(-1))); }
+    static std::uint64_t mask_bits(mask m) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(m)); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept {
+        const __m256i lanes = _mm256_setr_epi64x(1, 2, 4, 8);
+        return _mm256_castsi256_pd(
+            _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(bits)), lanes), lanes));
+    }
+};
+
+template <typename T> struct simd_avx2_int32_backend {
+    static constexpr std::size_t size = 8;
+
+    using reg  = __m256i;
+    using mask = __m256i;
+
+    static reg  load(const T *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static reg  load_aligned(const T *p) noexcept { return _mm256_load_si256(reinterpret_cast<const __m256i *>(p)); }
+    static void store(T *p, reg v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    static void store_aligned(T *p, reg v) noexcept { _mm256_store_si256(reinterpret_cast<__m256i *>(p), v); }
+    static reg  broadcast(T x) noexcept { return _mm256_set1_epi32(static_cast<int>(x)); }
+
+    static reg add(reg a, reg b) noexcept { return _mm256_add_epi32(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm256_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm256_mullo_epi32(a, b); }
+    static reg bit_and(reg a, reg b) noexcept { return _mm256_and_si256(a, b); }
+    static reg bit_or(reg a, reg b) noexcept { return _mm256_or_si256(a, b); }
+    static reg bit_xor(reg a, reg b) noexcept { return _mm256_xor_si256(a, b); }
+    static reg shift_left(reg a, int n) noexcept { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+    static reg shift_right(reg a, int n) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm256_sra_epi32(a, _mm_cvtsi32_si128(n));
+        } else {
+            return _mm256_srl_epi32(a, _mm_cvtsi32_si128(n));
+        }
+    }
+    static reg min(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm256_min_epi32(a, b);
+        } else {
+            return _mm256_min_epu32(a, b);
+        }
+    }
+    static reg max(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm256_max_epi32(a, b);
+        } else {
+            return _mm256_max_epu32(a, b);
+        }
+    }
+
+    static mask eq(reg a, reg b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+    static mask lt(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm256_cmpgt_epi32(b, a);
+        } else {
+            const __m256i sign = _mm256_set1_epi32(std::numeric_limits<int>::min());
+            return _mm256_cmpgt_epi32(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+        }
+    }
+    static reg select(mask m, reg t, reg f) noexcept { return _mm256_blendv_epi8(f, t, m); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return _mm256_and_si256(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return _mm256_or_si256(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return _mm256_xor_si256(a, b); }
+    static mask          mask_not(mask a) noexcept { return _mm256_xor_si256(a, _mm256_set1_epi32(-1)); }
+    static std::uint64_t mask_bits(mask m) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m))); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept {
+        const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lanes), lanes);
+    }
+};
+
+template <> struct simd_backend<std::int32_t, simd_abi::vec<32>> : simd_avx2_int32_backend<std::int32_t> {};
+template <> struct simd_backend<std::uint32_t, simd_abi::vec<32>> : simd_avx2_int32_backend<std::uint32_t> {};
+
+#endif
+
+#if defined(BACKPORT_SIMD_AVX512)
+
+// AVX-512 compares produce bit masks, one bit per lane
+template <> struct simd_backend<float, simd_abi::vec<64>> {
+    static constexpr std::size_t size = 16;
+
+    using reg  = __m512;
+    using mask = __mmask16;
+
+    static reg  load(const float *p) noexcept { return _mm512_loadu_ps(p); }
+    static reg  load_aligned(const float *p) noexcept { return _mm512_load_ps(p); }
+    static void store(float *p, reg v) noexcept { _mm512_storeu_ps(p, v); }
+    static void store_aligned(float *p, reg v) noexcept { _mm512_store_ps(p, v); }
+    static reg  broadcast(float x) noexcept { return _mm512_set1_ps(x); }
+
+    static reg add(reg a, reg b) noexcept { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm512_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm512_div_ps(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm512_min_ps(b, a); }
+    static reg max(reg a, reg b) noexcept { return _mm512_max_ps(b, a); }
+    static reg sqrt(reg a) noexcept { return _mm512_sqrt_ps(a); }
+
+    static mask eq(reg a, reg b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static mask lt(reg a, reg b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static reg  select(mask m, reg t, reg f) noexcept { return _mm512_mask_blend_ps(m, f, t); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return static_cast<mask>(a & b); }
+    static mask          mask_or(mask a, mask b) noexcept { return static_cast<mask>(a | b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return static_cast<mask>(a ^ b); }
+    static mask          mask_not(mask a) noexcept { return static_cast<mask>(~a); }
+    static std::uint64_t mask_bits(mask m) noexcept { return m; }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept { return static_cast<mask>(bits); }
+};
+
+template <> struct simd_backend<double, simd_abi::vec<64>> {
+    static constexpr std::size_t size = 8;
+
+    using reg  = __m512d;
+    using mask = __mmask8;
+
+    static reg  load(const double *p) noexcept { return _mm512_loadu_pd(p); }
+    static reg  load_aligned(const double *p) noexcept { return _mm512_load_pd(p); }
+    static void store(double *p, reg v) noexcept { _mm512_storeu_pd(p, v); }
+    static void store_aligned(double *p, reg v) noexcept { _mm512_store_pd(p, v); }
+    static reg  broadcast(double x) noexcept { return _mm512_set1_pd(x); }
+
+    static reg add(reg a, reg b) noexcept { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm512_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm512_div_pd(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm512_min_pd(b, a); }
+    static reg max(reg a, reg b) noexcept { return _mm512_max_pd(b, a); }
+    static reg sqrt(reg a) noexcept { return _mm512_sqrt_pd(a); }
+
+    static mask eq(reg a, reg b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static mask lt(reg a, reg b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static reg  select(mask m, reg t, reg f) noexcept { return _mm512_mask_blend_pd(m, f, t); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return static_cast<mask>(a & b); }
+    static mask          mask_or(mask a, mask b) noexcept { return static_cast<mask>(a | b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return static_cast<mask>(a ^ b); }
+    static mask          mask_not(mask a) noexcept { return static_cast<mask>(~a); }
+    static std::uint64_t mask_bits(mask m) noexcept { return m; }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept { return static_cast<mask>(bits); }
+};
+
+template <typename T> struct simd_avx512_int32_backend {
+    static constexpr std::size_t size = 16;
+
+    using reg  = __m512i;
+    using mask = __mmask16;
+
+    static reg  load(const T *p) noexcept { return _mm512_loadu_si512(p); }
+    static reg  load_aligned(const T *p) noexcept { return _mm512_load_si512(p); }
+    static void store(T *p, reg v) noexcept { _mm512_storeu_si512(p, v); }
+    static void store_aligned(T *p, reg v) noexcept { _mm512_store_si512(p, v); }
+    static reg  broadcast(T x) noexcept { return _mm512_set1_epi32(static_cast<int>(x)); }
+
+    static reg add(reg a, reg b) noexcept { return _mm512_add_epi32(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm512_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm512_mullo_epi32(a, b); }
+    static reg bit_and(reg a, reg b) noexcept { return _mm512_and_si512(a, b); }
+    static reg bit_or(reg a, reg b) noexcept { return _mm512_or_si512(a, b); }
+    static reg bit_xor(reg a, reg b) noexcept { return _mm512_xor_si512(a, b); }
+    static reg shift_left(reg a, int n) noexcept { return _mm512_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+    static reg shift_right(reg a, int n) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm512_sra_epi32(a, _mm_cvtsi32_si128(n));
+        } else {
+            return _mm512_srl_epi32(a, _mm_cvtsi32_si128(n));
+        }
+    }
+    static reg min(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm512_min_epi32(a, b);
+        } else {
+            return _mm512_min_epu32(a, b);
+        }
+    }
+    static reg max(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm512_max_epi32(a, b);
+        } else {
+            return _mm512_max_epu32(a, b);
+        }
+    }
+
+    static mask eq(reg a, reg b) noexcept { return _mm512_cmpeq_epi32_mask(a, b); }
+    static mask lt(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm512_cmplt_epi32_mask(a, b);
+        } else {
+            return _mm512_cmplt_epu32_mask(a, b);
+        }
+    }
+    static mask le(reg a, reg b) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm512_cmple_epi32_mask(a, b);
+        } else {
+            return _mm512_cmple_epu32_mask(a, b);
+        }
+    }
+    static reg select(mask m, reg t, reg f) noexcept { return _mm512_mask_blend_epi32(m, f, t); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return static_cast<mask>(a & b); }
+    static mask          mask_or(mask a, mask b) noexcept { return static_cast<mask>(a | b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return static_cast<mask>(a ^ b); }
+    static mask          mask_not(mask a) noexcept { return static_cast<mask>(~a); }
+    static std::uint64_t mask_bits(mask m) noexcept { return m; }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept { return static_cast<mask>(bits); }
+};
+
+template <> struct simd_backend<std::int32_t, simd_abi::vec<64>> : simd_avx512_int32_backend<std::int32_t> {};
+template <> struct simd_backend<std::uint32_t, simd_abi::vec<64>> : simd_avx512_int32_backend<std::uint32_t> {};
+
+#endif
+
+#if defined(BACKPORT_SIMD_NEON)
+
+inline std::uint64_t neon_lane_bits(uint32x4_t m) noexcept {
+    const uint32_t   weights[4] = {1, 2, 4, 8};
+    const uint32x4_t bits       = vandq_u32(m, vld1q_u32(weights));
+    uint32x2_t       sum        = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+    sum                         = vpadd_u32(sum, sum);
+    return vget_lane_u32(sum, 0);
+}
+
+inline uint32x4_t neon_lanes_from_bits(std::uint64_t bits) noexcept {
+    const uint32_t weights[4] = {1, 2, 4, 8};
+    return vtstq_u32(vdupq_n_u32(static_cast<uint32_t>(bits)), vld1q_u32(weights));
+}
+
+template <> struct simd_backend<float, simd_abi::vec<16>> {
+    static constexpr std::size_t size = 4;
+
+    using reg  = float32x4_t;
+    using mask = uint32x4_t;
+
+    static reg  load(const float *p) noexcept { return vld1q_f32(p); }
+    static reg  load_aligned(const float *p) noexcept { return vld1q_f32(p); }
+    static void store(float *p, reg v) noexcept { vst1q_f32(p, v); }
+    static void store_aligned(float *p, reg v) noexcept { vst1q_f32(p, v); }
+    static reg  broadcast(float x) noexcept { return vdupq_n_f32(x); }
+
+    static reg add(reg a, reg b) noexcept { return vaddq_f32(a, b); }
+    static reg sub(reg a, reg b) noexcept { return vsubq_f32(a, b); }
+    static reg mul(reg a, reg b) noexcept { return vmulq_f32(a, b); }
+#if defined(__aarch64__) || defined(_M_ARM64)
+    static reg div(reg a, reg b) noexcept { return vdivq_f32(a, b); }
+    static reg sqrt(reg a) noexcept { return vsqrtq_f32(a); }
+#endif
+    static reg min(reg a, reg b) noexcept { return vminq_f32(a, b); }
+    static reg max(reg a, reg b) noexcept { return vmaxq_f32(a, b); }
+
+    static mask eq(reg a, reg b) noexcept { return vceqq_f32(a, b); }
+    static mask lt(reg a, reg b) noexcept { return vcltq_f32(a, b); }
+    static mask le(reg a, reg b) noexcept { return vcleq_f32(a, b); }
+    static reg  select(mask m, reg t, reg f) noexcept { return vbslq_f32(m, t, f); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return vandq_u32(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return vorrq_u32(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return veorq_u32(a, b); }
+    static mask          mask_not(mask a) noexcept { return vmvnq_u32(a); }
+    static std::uint64_t mask_bits(mask m) noexcept { return neon_lane_bits(m); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept { return neon_lanes_from_bits(bits); }
+};
+
+template <> struct simd_backend<std::int32_t, simd_abi::vec<16>> {
+    static constexpr std::size_t size = 4;
+
+    using reg  = int32x4_t;
+    using mask = uint32x4_t;
+
+    static reg  load(const std::int32_t *p) noexcept { return vld1q_s32(p); }
+    static reg  load_aligned(const std::int32_t *p) noexcept { return vld1q_s32(p); }
+    static void store(std::int32_t *p, reg v) noexcept { vst1q_s32(p, v); }
+    static void store_aligned(std::int32_t *p, reg v) noexcept { vst1q_s32(p, v); }
+    static reg  broadcast(std::int32_t x) noexcept { return vdupq_n_s32(x); }
+
+    static reg add(reg a, reg b) noexcept { return vaddq_s32(a, b); }
+    static reg sub(reg a, reg b) noexcept { return vsubq_s32(a, b); }
+    static reg mul(reg a, reg b) noexcept { return vmulq_s32(a, b); }
+    static reg bit_and(reg a, reg b) noexcept { return vandq_s32(a, b); }
+    static reg bit_or(reg a, reg b) noexcept { return vorrq_s32(a, b); }
+    static reg bit_xor(reg a, reg b) noexcept { return veorq_s32(a, b); }
+    static reg shift_left(reg a, int n) noexcept { return vshlq_s32(a, vdupq_n_s32(n)); }
+    static reg shift_right(reg a, int n) noexcept { return vshlq_s32(a, vdupq_n_s32(-n)); }
+    static reg min(reg a, reg b) noexcept { return vminq_s32(a, b); }
+    static reg max(reg a, reg b) noexcept { return vmaxq_s32(a, b); }
+
+    static mask eq(reg a, reg b) noexcept { return vceqq_s32(a, b); }
+    static mask lt(reg a, reg b) noexcept { return vcltq_s32(a, b); }
+    static mask le(reg a, reg b) noexcept { return vcleq_s32(a, b); }
+    static reg  select(mask m, reg t, reg f) noexcept { return vbslq_s32(m, t, f); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return vandq_u32(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return vorrq_u32(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return veorq_u32(a, b); }
+    static mask          mask_not(mask a) noexcept { return vmvnq_u32(a); }
+    static std::uint64_t mask_bits(mask m) noexcept { return neon_lane_bits(m); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept { return neon_lanes_from_bits(bits); }
+};
+
+template <> struct simd_backend<std::uint32_t, simd_abi::vec<16>> {
+    static constexpr std::size_t size = 4;
+
+    using reg  = uint32x4_t;
+    using mask = uint32x4_t;
+
+    static reg  load(const std::uint32_t *p) noexcept { return vld1q_u32(p); }
+    static reg  load_aligned(const std::uint32_t *p) noexcept { return vld1q_u32(p); }
+    static void store(std::uint32_t *p, reg v) noexcept { vst1q_u32(p, v); }
+    static void store_aligned(std::uint32_t *p, reg v) noexcept { vst1q_u32(p, v); }
+    static reg  broadcast(std::uint32_t x) noexcept { return vdupq_n_u32(x); }
+
+    static reg add(reg a, reg b) noexcept { return vaddq_u32(a, b); }
+    static reg sub(reg a, reg b) noexcept { return vsubq_u32(a, b); }
+    static reg mul(reg a, reg b) noexcept { return vmulq_u32(a, b); }
+    static reg bit_and(reg a, reg b) noexcept { return vandq_u32(a, b); }
+    static reg bit_or(reg a, reg b) noexcept { return vorrq_u32(a, b); }
+    static reg bit_xor(reg a, reg b) noexcept { return veorq_u32(a, b); }
+    static reg shift_left(reg a, int n) noexcept { return vshlq_u32(a, vdupq_n_s32(n)); }
+    static reg shift_right(reg a, int n) noexcept { return vshlq_u32(a, vdupq_n_s32(-n)); }
+    static reg min(reg a, reg b) noexcept { return vminq_u32(a, b); }
+    static reg max(reg a, reg b) noexcept { return vmaxq_u32(a, b); }
+
+    static mask eq(reg a, reg b) noexcept { return vceqq_u32(a, b); }
+    static mask lt(reg a, reg b) noexcept { return vcltq_u32(a, b); }
+    static mask le(reg a, reg b) noexcept { return vcleq_u32(a, b); }
+    static reg  select(mask m, reg t, reg f) noexcept { return vbslq_u32(m, t, f); }
+
+    static mask          mask_and(mask a, mask b) noexcept { return vandq_u32(a, b); }
+    static mask          mask_or(mask a, mask b) noexcept { return vorrq_u32(a, b); }
+    static mask          mask_xor(mask a, mask b) noexcept { return veorq_u32(a, b); }
+    static mask          mask_not(mask a) noexcept { return vmvnq_u32(a); }
+    static std::uint64_t mask_bits(mask m) noexcept { return neon_lane_bits(m); }
+    static mask          mask_from_bits(std::uint64_t bits) noexcept { return neon_lanes_from_bits(bits); }
+};
+
+#endif
+
+// The conversions the broadcast constructor accepts implicitly: those that keep every value, plus int and unsigned int
+template <typename From, typename To>
+concept value_preserving =
+    std::is_same_v<From, To> ||
+    (std::numeric_limits<From>::digits <= std::numeric_limits<To>::digits && (std::is_floating_point_v<To> || std::is_integral_v<From>) &&
+     (std::is_signed_v<To> || !std::is_signed_v<From>) &&
+     (!std::is_floating_point_v<From> || std::numeric_limits<From>::max_exponent <= std::numeric_limits<To>::max_exponent));
+
+template <typename U, typename T>
+concept simd_broadcastable =
+    std::is_convertible_v<U, T> &&
+    (!std::is_arithmetic_v<std::remove_cvref_t<U>> || std::is_same_v<std::remove_cvref_t<U>, int> ||
+     (std::is_same_v<std::remove_cvref_t<U>, unsigned int> && std::is_unsigned_v<T>) || value_preserving<std::remove_cvref_t<U>, T>);
+
+template <typename G, typename T, std::size_t... Is> constexpr bool generates(std::index_sequence<Is...>) noexcept {
+    return (std::is_convertible_v<std::invoke_result_t<G &, std::integral_constant<std::size_t, Is>>, T> && ...);
+}
+
+template <typename G, typename T, std::size_t N>
+concept simd_generator = std::is_invocable_v<G &, std::integral_constant<std::size_t, 0>> && generates<G, T>(std::make_index_sequence<N>());
+
+// The alignment a load or store with these flags may assume
+template <typename Flags, typename U, std::size_t N> constexpr std::size_t flag_alignment() noexcept {
+    if constexpr (std::is_same_v<Flags, vector_aligned_tag>) {
+        return simd_alignment<U, N>();
+    } else if constexpr (std::is_same_v<Flags, element_aligned_tag>) {
+        return alignof(U);
+    } else {
+        return []<std::size_t A>(overaligned_tag<A>) { return A; }(Flags());
+    }
+}
+
+constexpr std::uint64_t lane_mask(std::size_t n) noexcept { return n >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1; }
+
+// Without a popcnt instruction std::popcount is a library call, far slower than counting in a register
+constexpr int count_lanes(std::uint64_t bits) noexcept {
+#if defined(__POPCNT__) || defined(__ARM_NEON)
+    return std::popcount(bits);
+#else
+    bits -= (bits >> 1) & 0x5555555555555555u;
+    bits = (bits & 0x3333333333333333u) + ((bits >> 2) & 0x3333333333333333u);
+    bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+    return static_cast<int>((bits * 0x0101010101010101u) >> 56);
+#endif
+}
+
+struct simd_access;
+
+} // namespace detail
+
+template <typename T, typename Abi> struct simd_size : std::integral_constant<std::size_t, detail::simd_backend<T, Abi>::size> {};
+template <typename T, typename Abi = simd_abi::compatible<T>> inline constexpr std::size_t simd_size_v = simd_size<T, Abi>::value;
+
+template <typename T, typename U = typename T::value_type> struct memory_alignment;
+template <typename T, typename Abi, typename U>
+struct memory_alignment<simd<T, Abi>, U> : std::integral_constant<std::size_t, detail::simd_alignment<U, simd_size_v<T, Abi>>()> {};
+template <typename T, typename Abi>
+struct memory_alignment<simd_mask<T, Abi>, bool>
+    : std::integral_constant<std::size_t, detail::simd_alignment<bool, simd_size_v<T, Abi>>()> {};
+template <typename T, typename U = typename T::value_type> inline constexpr std::size_t memory_alignment_v = memory_alignment<T, U>::value;
+
+namespace simd_abi {
+
+template <typename T, std::size_t N, typename... Abis> struct deduce {
+    using type = std::conditional_t<simd_size_v<T, native<T>> == N, native<T>,
+                                    std::conditional_t<N == 1, scalar, fixed_size<static_cast<int>(N)>>>;
+};
+template <typename T, std::size_t N, typename... Abis> using deduce_t = typename deduce<T, N, Abis...>::type;
+
+} // namespace simd_abi
+
+template <typename T, typename Abi> class simd_mask {
+    static_assert(detail::vectorizable<T>, "simd_mask needs a vectorizable value type");
+
+    friend struct detail::simd_access;
+    friend class simd<T, Abi>;
+
+    using backend = detail::simd_backend<T, Abi>;
+    using bits    = typename backend::mask;
+
+    bits data;
+
+    static bits load_bools(const bool *b) noexcept {
+        if constexpr (requires { backend::mask_load(b); }) {
+            return backend::mask_load(b);
+        } else {
+            std::uint64_t packed = 0;
+            for (std::size_t i = 0; i < size(); ++i) packed |= static_cast<std::uint64_t>(b[i]) << i;
+            return backend::mask_from_bits(packed);
+        }
+    }
+
+    static void store_bools(bool *b, const bits &m) noexcept {
+        if constexpr (requires { backend::mask_store(b, m); }) {
+            backend::mask_store(b, m);
+        } else {
+            const std::uint64_t packed = backend::mask_bits(m);
+            for (std::size_t i = 0; i < size(); ++i) b[i] = ((packed >> i) & 1) != 0;
+        }
+    }
+
+    static simd_mask from(const bits &m) noexcept {
+        simd_mask r;
+        r.data = m;
+        return r;
+    }
+
+    template <typename Op> static simd_mask combine(const simd_mask &a, const simd_mask &b, Op op) noexcept {
+        bool x[size()], y[size()];
+        store_bools(x, a.data);
+        store_bools(y, b.data);
+        for (std::size_t i = 0; i < size(); ++i) x[i] = op(x[i], y[i]);
+        return from(load_bools(x));
+    }
+
+  public:
+    using value_type = bool;
+    using simd_type  = simd<T, Abi>;
+    using abi_type   = Abi;
+
+    class reference {
+        friend class simd_mask;
+
+        simd_mask  &mask;
+        std::size_t index;
+
+        reference(simd_mask &m, std::size_t i) noexcept : mask(m), index(i) {}
+
+      public:
+        reference(const reference &) = delete;
+
+        operator value_type() const noexcept { return std::as_const(mask)[index]; }
+
+        reference &&operator=(value_type v) && noexcept {
+            bool lanes[size()];
+            store_bools(lanes, mask.data);
+            lanes[index] = v;
+            mask.data    = load_bools(lanes);
+            return std::move(*this);
+        }
+    };
+
+    static constexpr std::size_t size() noexcept { return backend::size; }
+
+    simd_mask() noexcept = default;
+
+    explicit simd_mask(value_type v) noexcept {
+        bool lanes[size()];
+        std::fill_n(lanes, size(), v);
+        data = load_bools(lanes);
+    }
+
+    template <typename Flags>
+        requires is_simd_flag_type_v<Flags>
+    simd_mask(const value_type *mem, Flags) noexcept : data(load_bools(mem)) {}
+
+    template <typename Flags>
+        requires is_simd_flag_type_v<Flags>
+    void copy_from(const value_type *mem, Flags) noexcept {
+        data = load_bools(mem);
+    }
+
+    template <typename Flags>
+        requires is_simd_flag_type_v<Flags>
+    void copy_to(value_type *mem, Flags) const noexcept {
+        store_bools(mem, data);
+    }
+
+    reference  operator[](std::size_t i) noexcept { return reference(*this, i); }
+    value_type operator[](std::size_t i) const noexcept {
+        if constexpr (requires { backend::mask_bits(data); }) {
+            return ((backend::mask_bits(data) >> i) & 1) != 0;
+        } else {
+            bool lanes[size()];
+            store_bools(lanes, data);
+            return lanes[i];
+        }
+    }
+
+    simd_mask operator!() const noexcept {
+        if constexpr (requires { backend::mask_not(data); }) {
+            return from(backend::mask_not(data));
+        } else {
+            return combine(*this, *this, [](bool x, bool) { return !x; });
+        }
+    }
+
+    friend simd_mask operator&&(const simd_mask &a, const simd_mask &b) noexcept { return a & b; }
+    friend simd_mask operator||(const simd_mask &a, const simd_mask &b) noexcept { return a | b; }
+
+    friend simd_mask operator&(const simd_mask &a, const simd_mask &b) noexcept {
+        if constexpr (requires { backend::mask_and(a.data, b.data); }) {
+            return from(backend::mask_and(a.data, b.data));
+        } else {
+            return combine(a, b, [](bool x, bool y) { return x && y; });
+        }
+    }
+
+    friend simd_mask operator|(const simd_mask &a, const simd_mask &b) noexcept {
+        if constexpr (requires { backend::mask_or(a.data, b.data); }) {
+            return from(backend::mask_or(a.data, b.data));
+        } else {
+            return combine(a, b, [](bool x, bool y) { return x || y; });
+        }
+    }
+
+    friend simd_mask operator^(const simd_mask &a, const simd_mask &b) noexcept {
+        if constexpr (requires { backend::mask_xor(a.data, b.data); }) {
+            return from(backend::mask_xor(a.data, b.data));
+        } else {
+            return combine(a, b, [](bool x, bool y) { return x != y; });
+        }
+    }
+
+    friend simd_mask &operator&=(simd_mask &a, const simd_mask &b) noexcept { return a = a & b; }
+    friend simd_mask &operator|=(simd_mask &a, const simd_mask &b) noexcept { return a = a | b; }
+    friend simd_mask &operator^=(simd_mask &a, const simd_mask &b) noexcept { return a = a ^ b; }
+
+    friend simd_mask operator==(const simd_mask &a, const simd_mask &b) noexcept { return !(a ^ b); }
+    friend simd_mask operator!=(const simd_mask &a, const simd_mask &b) noexcept { return a ^ b; }
+};
+
+template <typename T, typename Abi> class simd {
+    static_assert(detail::vectorizable<T>, "simd needs a vectorizable value type: an arithmetic type other than bool");
+
+    friend struct detail::simd_access;
+
+    using backend = detail::simd_backend<T, Abi>;
+    using reg     = typename backend::reg;
+
+    reg data;
+
+    // Lanes in memory, for the operations a backend does not provide
+    struct lanes {
+        alignas(detail::simd_alignment<T, backend::size>()) T v[backend::size];
+    };
+
+    static lanes to_lanes(const reg &r) noexcept {
+        lanes l;
+        backend::store_aligned(l.v, r);
+        return l;
+    }
+
+    static simd from(const reg &r) noexcept {
+        simd s;
+        s.data = r;
+        return s;
+    }
+
+    static simd from_lanes(const lanes &l) noexcept { return from(backend::load_aligned(l.v)); }
+
+    template <typename Bits> static simd_mask<T, Abi> mask_from(const Bits &m) noexcept { return simd_mask<T, Abi>::from(m); }
+
+    template <typename Op> static simd map(const simd &a, Op op) noexcept {
+        lanes x = to_lanes(a.data);
+        for (std::size_t i = 0; i < size(); ++i) x.v[i] = static_cast<T>(op(x.v[i]));
+        return from_lanes(x);
+    }
+
+    template <typename Op> static simd map(const simd &a, const simd &b, Op op) noexcept {
+        lanes       x = to_lanes(a.data);
+        const lanes y = to_lanes(b.data);
+        for (std::size_t i = 0; i < size(); ++i) x.v[i] = static_cast<T>(op(x.v[i], y.v[i]));
+        return from_lanes(x);
+    }
+
+    template <typename Op> static simd_mask<T, Abi> compare(const simd &a, const simd &b, Op op) noexcept {
+        const lanes x = to_lanes(a.data);
+        const lanes y = to_lanes(b.data);
+        bool        result[size()];
+        for (std::size_t i = 0; i < size(); ++i) result[i] = op(x.v[i], y.v[i]);
+        return simd_mask<T, Abi>::from(simd_mask<T, Abi>::load_bools(result));
+    }
+
+    // Lanes of t where m is set, of f elsewhere
+    static simd select(const simd_mask<T, Abi> &m, const simd &t, const simd &f) noexcept {
+        if constexpr (requires { backend::select(m.data, t.data, f.data); }) {
+            return from(backend::select(m.data, t.data, f.data));
+        } else {
+            lanes       x = to_lanes(t.data);
+            const lanes y = to_lanes(f.data);
+            bool        chosen[size()];
+            simd_mask<T, Abi>::store_bools(chosen, m.data);
+            for (std::size_t i = 0; i < size(); ++i) x.v[i] = chosen[i] ? x.v[i] : y.v[i];
+            return from_lanes(x);
+        }
+    }
+
+    template <typename G, std::size_t... Is> static simd generate(G &gen, std::index_sequence<Is...>) {
+        lanes l{{static_cast<T>(gen(std::integral_constant<std::size_t, Is>()))...}};
+        return from_lanes(l);
+    }
+
+  public:
+    using value_type = T;
+    using mask_type  = simd_mask<T, Abi>;
+    using abi_type   = Abi;
+
+    class reference {
+        friend class simd;
+
+        simd       &vector;
+        std::size_t index;
+
+        reference(simd &v, std::size_t i) noexcept : vector(v), index(i) {}
+
+        template <typename Op> reference &&update(Op op) && noexcept {
+            lanes l        = to_lanes(vector.data);
+            l.v[index]     = static_cast<T>(op(l.v[index]));
+            vector.data    = backend::load_aligned(l.v);
+            return std::move(*this);
+        }
+
+      public:
+        reference(const reference &) = delete;
+
+        operator value_type() const noexcept { return std::as_const(vector)[index]; }
+
+        template <typename U>
+            requires std::is_convertible_v<U, value_type>
+        reference &&operator=(U &&x) && noexcept {
+            return std::move(*this).update([&](T) { return static_cast<T>(std::forward<U>(x)); });
+        }
+
+        template <typename U>
+            requires std::is_convertible_v<U, value_type>
+        reference &&operator+=(U &&x) && noexcept {
+            return std::move(*this).update([&](T v) { return v + static_cast<T>(x); });
+        }
+
+        template <typename U>
+            requires std::is_convertible_v<U, value_type>
+        reference &&operator-=(U &&x) && noexcept {
+            return std::move(*this).update([&](T v) { return v - static_cast<T>(x); });
+        }
+
+        template <typename U>
+            requires std::is_convertible_v<U, value_type>
+        reference &&operator*=(U &&x) && noexcept {
+            return std::move(*this).update([&](T v) { return v * static_cast<T>(x); });
+        }
+
+        template <typename U>
+            requires std::is_convertible_v<U, value_type>
+        reference &&operator/=(U &&x) && noexcept {
+            return std::move(*this).update([&](T v) { return v / static_cast<T>(x); });
+        }
+    };
+
+    static constexpr std::size_t size() noexcept { return backend::size; }
+
+    simd() noexcept = default;
+
+    // Broadcast
+    template <typename U>
+        requires detail::simd_broadcastable<U, T>
+    simd(U &&value) noexcept : data(backend::broadcast(static_cast<T>(std::forward<U>(value)))) {}
+
+    // Lane i is gen(std::integral_constant<std::size_t, i>())
+    template <typename G>
+        requires detail::simd_generator<G, T, backend::size>
+    explicit simd(G &&gen) noexcept : simd(generate(gen, std::make_index_sequence<size()>())) {}
+
+    template <typename U, typename Flags>
+        requires detail::vectorizable<U> && is_simd_flag_type_v<Flags>
+    simd(const U *mem, Flags flags) noexcept {
+        copy_from(mem, flags);
+    }
+
+    template <typename U, typename Flags>
+        requires detail::vectorizable<U> && is_simd_flag_type_v<Flags>
+    void copy_from(const U *mem, Flags) noexcept {
+        if constexpr (!std::is_same_v<U, T>) {
+            lanes l;
+            for (std::size_t i = 0; i < size(); ++i) l.v[i] = static_cast<T>(mem[i]);
+            data = backend::load_aligned(l.v);
+        } else if constexpr (detail::flag_alignment<Flags, T, size()>() >= detail::simd_alignment<T, size()>()) {
+            data = backend::load_aligned(mem);
+        } else {
+            data = backend::load(mem);
+        }
+    }
+
+    template <typename U, typename Flags>
+        requires detail::vectorizable<U> && is_simd_flag_type_v<Flags>
+    void copy_to(U *mem, Flags) const noexcept {
+        if constexpr (!std::is_same_v<U, T>) {
+            const lanes l = to_lanes(data);
+            for (std::size_t i = 0; i < size(); ++i) mem[i] = static_cast<U>(l.v[i]);
+        } else if constexpr (detail::flag_alignment<Flags, T, size()>() >= detail::simd_alignment<T, size()>()) {
+            backend::store_aligned(mem, data);
+        } else {
+            backend::store(mem, data);
+        }
+    }
+
+    reference  operator[](std::size_t i) noexcept { return reference(*this, i); }
+    value_type operator[](std::size_t i) const noexcept { return to_lanes(data).v[i]; }
+
+    simd &operator++() noexcept { return *this += simd(1); }
+    simd  operator++(int) noexcept {
+        simd old = *this;
+        ++*this;
+        return old;
+    }
+    simd &operator--() noexcept { return *this -= simd(1); }
+    simd  operator--(int) noexcept {
+        simd old = *this;
+        --*this;
+        return old;
+    }
+
+    mask_type operator!() const noexcept { return *this == simd(0); }
+
+    simd operator~() const noexcept
+        requires std::is_integral_v<T>
+    {
+        return *this ^ simd(static_cast<T>(~T{}));
+    }
+
+    simd operator+() const noexcept { return *this; }
+    simd operator-() const noexcept { return simd(0) - *this; }
+
+    friend simd operator+(const simd &a, const simd &b) noexcept {
+        if constexpr (requires { backend::add(a.data, b.data); }) {
+            return from(backend::add(a.data, b.data));
+        } else {
+            return map(a, b, [](T x, T y) { return x + y; });
+        }
+    }
+
+    friend simd operator-(const simd &a, const simd &b) noexcept {
+        if constexpr (requires { backend::sub(a.data, b.data); }) {
+            return from(backend::sub(a.data, b.data));
+        } else {
+            return map(a, b, [](T x, T y) { return x - y; });
+        }
+    }
+
+    friend simd operator*(const simd &a, const simd &b) noexcept {
+        if constexpr (requires { backend::mul(a.data, b.data); }) {
+            return from(backend::mul(a.data, b.data));
+        } else {
+            return map(a, b, [](T x, T y) { return x * y; });
+        }
+    }
+
+    friend simd operator/(const simd &a, const simd &b) noexcept {
+        if constexpr (requires { backend::div(a.data, b.data); }) {
+            return from(backend::div(a.data, b.data));
+        } else {
+            return map(a, b, [](T x, T y) { return x / y; });
+        }
+    }
+
+    friend simd operator%(const simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        return map(a, b, [](T x, T y) { return x % y; });
+    }
+
+    friend simd operator&(const simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        if constexpr (requires { backend::bit_and(a.data, b.data); }) {
+            return from(backend::bit_and(a.data, b.data));
+        } else {
+            return map(a, b, [](T x, T y) { return x & y; });
+        }
+    }
+
+    friend simd operator|(const simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        if constexpr (requires { backend::bit_or(a.data, b.data); }) {
+            return from(backend::bit_or(a.data, b.data));
+        } else {
+            return map(a, b, [](T x, T y) { return x | y; });
+        }
+    }
+
+    friend simd operator^(const simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        if constexpr (requires { backend::bit_xor(a.data, b.data); }) {
+            return from(backend::bit_xor(a.data, b.data));
+        } else {
+            return map(a, b, [](T x, T y) { return x ^ y; });
+        }
+    }
+
+    friend simd operator<<(const simd &a, int n) noexcept
+        requires std::is_integral_v<T>
+    {
+        if constexpr (requires { backend::shift_left(a.data, n); }) {
+            return from(backend::shift_left(a.data, n));
+        } else {
+            return map(a, [n](T x) { return x << n; });
+        }
+    }
+
+    friend simd operator>>(const simd &a, int n) noexcept
+        requires std::is_integral_v<T>
+    {
+        if constexpr (requires { backend::shift_right(a.data, n); }) {
+            return from(backend::shift_right(a.data, n));
+        } else {
+            return map(a, [n](T x) { return x >> n; });
+        }
+    }
+
+    friend simd operator<<(const simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        return map(a, b, [](T x, T y) { return x << y; });
+    }
+
+    friend simd operator>>(const simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        return map(a, b, [](T x, T y) { return x >> y; });
+    }
+
+    friend simd &operator+=(simd &a, const simd &b) noexcept { return a = a + b; }
+    friend simd &operator-=(simd &a, const simd &b) noexcept { return a = a - b; }
+    friend simd &operator*=(simd &a, const simd &b) noexcept { return a = a * b; }
+    friend simd &operator/=(simd &a, const simd &b) noexcept { return a = a / b; }
+
+    friend simd &operator%=(simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        return a = a % b;
+    }
+    friend simd &operator&=(simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        return a = a & b;
+    }
+    friend simd &operator|=(simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        return a = a | b;
+    }
+    friend simd &operator^=(simd &a, const simd &b) noexcept
+        requires std::is_integral_v<T>
+    {
+        return a = a ^ b;
+    }
+    friend simd &operator<<=(simd &a, int n) noexcept
+        requires std::is_integral_v<T>
+    {
+        return a = a << n;
+    }
+    friend simd &operator>>=(simd &a, int n) noexcept
+        requires std::is_integral_v<T>
+    {
+        return a = a >> n;
+    }
+
+    friend mask_type operator==(const simd &a, const simd &b) noexcept {
+        if constexpr (requires { backend::eq(a.data, b.data); }) {
+            return mask_from(backend::eq(a.data, b.data));
+        } else {
+            return compare(a, b, [](T x, T y) { return x == y; });
+        }
+    }
+
+    friend mask_type operator!=(const simd &a, const simd &b) noexcept { return !(a == b); }
+
+    friend mask_type operator<(const simd &a, const simd &b) noexcept {
+        if constexpr (requires { backend::lt(a.data, b.data); }) {
+            return mask_from(backend::lt(a.data, b.data));
+        } else {
+            return compare(a, b, [](T x, T y) { return x < y; });
+        }
+    }
+
+    friend mask_type operator<=(const simd &a, const simd &b) noexcept {
+        if constexpr (requires { backend::le(a.data, b.data); }) {
+            return mask_from(backend::le(a.data, b.data));
+        } else if constexpr (std::is_integral_v<T> && requires { backend::lt(a.data, b.data); }) {
+            return !(b < a);
+        } else {
+            return compare(a, b, [](T x, T y) { return x <= y; });
+        }
+    }
+
+    friend mask_type operator>(const simd &a, const simd &b) noexcept { return b < a; }
+    friend mask_type operator>=(const simd &a, const simd &b) noexcept { return b <= a; }
+};
+
+namespace detail {
+
+// Reaches into simd and simd_mask for the free functions
+struct simd_access {
+    template <typename T, typename Abi>
+    static simd<T, Abi> select(const simd_mask<T, Abi> &m, const simd<T, Abi> &t, const simd<T, Abi> &f) noexcept {
+        return simd<T, Abi>::select(m, t, f);
+    }
+
+    template <typename T, typename Abi> static std::uint64_t bits(const simd_mask<T, Abi> &m) noexcept {
+        using backend = simd_backend<T, Abi>;
+        if constexpr (requires { backend::mask_bits(m.data); }) {
+            return backend::mask_bits(m.data);
+        } else {
+            bool lanes[backend::size];
+            simd_mask<T, Abi>::store_bools(lanes, m.data);
+            std::uint64_t packed = 0;
+            for (std::size_t i = 0; i < backend::size; ++i) packed |= static_cast<std::uint64_t>(lanes[i]) << i;
+            return packed;
+        }
+    }
+
+    template <typename T, typename Abi, typename Op> static simd<T, Abi> map(const simd<T, Abi> &v, Op op) noexcept {
+        return simd<T, Abi>::map(v, op);
+    }
+
+    template <typename T, typename Abi, typename Op>
+    static simd<T, Abi> map(const simd<T, Abi> &a, const simd<T, Abi> &b, Op op) noexcept {
+        return simd<T, Abi>::map(a, b, op);
+    }
+
+    template <typename T, typename Abi> static auto &data(simd<T, Abi> &v) noexcept { return v.data; }
+    template <typename T, typename Abi> static const auto &data(const simd<T, Abi> &v) noexcept { return v.data; }
+};
+
+template <typename Abi> struct is_fixed_size_abi : std::false_type {};
+template <int N> struct is_fixed_size_abi<simd_abi::fixed_size<N>> : std::true_type {};
+
+} // namespace detail
+
+// Masked access: where(mask, v) reads or assigns only the selected lanes
+template <typename M, typename V> class const_where_expression {
+  protected:
+    using value_type = typename V::value_type;
+
+    const M   mask;
+    const V &value;
+
+  public:
+    const_where_expression(const M &m, const V &v) noexcept : mask(m), value(v) {}
+    const_where_expression(const const_where_expression &) = delete;
+    const_where_expression &operator=(const const_where_expression &) = delete;
+
+    V operator-() const && noexcept { return detail::simd_access::select(mask, -value, value); }
+    V operator+() const && noexcept { return value; }
+
+    V operator~() const && noexcept
+        requires std::is_integral_v<value_type>
+    {
+        return detail::simd_access::select(mask, ~value, value);
+    }
+
+    template <typename U, typename Flags>
+        requires detail::vectorizable<U> && is_simd_flag_type_v<Flags>
+    void copy_to(U *mem, Flags) const && noexcept {
+        for (std::uint64_t bits = detail::simd_access::bits(mask); bits != 0; bits &= bits - 1) {
+            const auto i = static_cast<std::size_t>(std::countr_zero(bits));
+            mem[i]       = static_cast<U>(value[i]);
+        }
+    }
+
+    const M &mask_value() const noexcept { return mask; }
+    const V &simd_value() const noexcept { return value; }
+};
+
+template <typename M, typename V> class where_expression : public const_where_expression<M, V> {
+    using base = const_where_expression<M, V>;
+    using typename base::value_type;
+
+    V &target() const noexcept { return const_cast<V &>(this->value); }
+
+    template <typename Op> void update(const V &x, Op op) const noexcept {
+        target() = detail::simd_access::select(this->mask, op(target(), x), target());
+    }
+
+  public:
+    where_expression(const M &m, V &v) noexcept : base(m, v) {}
+
+    template <typename U>
+        requires std::is_convertible_v<U, V>
+    void operator=(U &&x) && noexcept {
+        target() = detail::simd_access::select(this->mask, V(std::forward<U>(x)), target());
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U, V>
+    void operator+=(U &&x) && noexcept {
+        update(V(std::forward<U>(x)), std::plus<>());
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U, V>
+    void operator-=(U &&x) && noexcept {
+        update(V(std::forward<U>(x)), std::minus<>());
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U, V>
+    void operator*=(U &&x) && noexcept {
+        update(V(std::forward<U>(x)), std::multiplies<>());
+    }
+
+    // Unselected lanes are not divided, a zero there is harmless
+    template <typename U>
+        requires std::is_convertible_v<U, V>
+    void operator/=(U &&x) && noexcept {
+        const V divisor = detail::simd_access::select(this->mask, V(std::forward<U>(x)), V(1));
+        target()        = detail::simd_access::select(this->mask, target() / divisor, target());
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U, V> && std::is_integral_v<value_type>
+    void operator&=(U &&x) && noexcept {
+        update(V(std::forward<U>(x)), std::bit_and<>());
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U, V> && std::is_integral_v<value_type>
+    void operator|=(U &&x) && noexcept {
+        update(V(std::forward<U>(x)), std::bit_or<>());
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U, V> && std::is_integral_v<value_type>
+    void operator^=(U &&x) && noexcept {
+        update(V(std::forward<U>(x)), std::bit_xor<>());
+    }
+
+    void operator++() && noexcept { update(V(1), std::plus<>()); }
+    void operator++(int) && noexcept { update(V(1), std::plus<>()); }
+    void operator--() && noexcept { update(V(1), std::minus<>()); }
+    void operator--(int) && noexcept { update(V(1), std::minus<>()); }
+
+    // Only the selected lanes are read from memory
+    template <typename U, typename Flags>
+        requires detail::vectorizable<U> && is_simd_flag_type_v<Flags>
+    void copy_from(const U *mem, Flags) && noexcept {
+        V &v = target();
+        for (std::uint64_t bits = detail::simd_access::bits(this->mask); bits != 0; bits &= bits - 1) {
+            const auto i = static_cast<std::size_t>(std::countr_zero(bits));
+            v[i]         = static_cast<value_type>(mem[i]);
+        }
+    }
+};
+
+template <typename T, typename Abi>
+where_expression<simd_mask<T, Abi>, simd<T, Abi>> where(const typename simd<T, Abi>::mask_type &m, simd<T, Abi> &v) noexcept {
+    return {m, v};
+}
+
+template <typename T, typename Abi>
+const_where_expression<simd_mask<T, Abi>, simd<T, Abi>> where(const typename simd<T, Abi>::mask_type &m, const simd<T, Abi> &v) noexcept {
+    return {m, v};
+}
+
+// Reductions combine the halves of the vector repeatedly, the order of the fast horizontal instructions
+template <typename T, typename Abi, typename BinaryOperation = std::plus<>> T reduce(const simd<T, Abi> &v, BinaryOperation op = {}) {
+    constexpr std::size_t N = simd<T, Abi>::size();
+    alignas(memory_alignment_v<simd<T, Abi>>) T lanes[N];
+    v.copy_to(lanes, vector_aligned);
+    for (std::size_t width = N; width > 1; width = (width + 1) / 2) {
+        const std::size_t upper = (width + 1) / 2;
+        for (std::size_t i = 0; i < width / 2; ++i) lanes[i] = static_cast<T>(op(lanes[i], lanes[i + upper]));
+    }
+    return lanes[0];
+}
+
+template <typename M, typename V, typename BinaryOperation>
+typename V::value_type reduce(const const_where_expression<M, V> &x, typename V::value_type identity_element, BinaryOperation op) {
+    return reduce(detail::simd_access::select(x.mask_value(), x.simd_value(), V(identity_element)), op);
+}
+
+template <typename M, typename V> typename V::value_type reduce(const const_where_expression<M, V> &x, std::plus<> op = {}) {
+    return reduce(x, typename V::value_type(0), op);
+}
+
+template <typename M, typename V> typename V::value_type reduce(const const_where_expression<M, V> &x, std::multiplies<> op) {
+    return reduce(x, typename V::value_type(1), op);
+}
+
+template <typename T, typename Abi> T hmin(const simd<T, Abi> &v) {
+    return reduce(v, [](T a, T b) { return std::min(a, b); });
+}
+
+template <typename T, typename Abi> T hmax(const simd<T, Abi> &v) {
+    return reduce(v, [](T a, T b) { return std::max(a, b); });
+}
+
+template <typename T, typename Abi> simd<T, Abi> min(const simd<T, Abi> &a, const simd<T, Abi> &b) noexcept {
+    using backend = detail::simd_backend<T, Abi>;
+    if constexpr (requires { backend::min(detail::simd_access::data(a), detail::simd_access::data(b)); }) {
+        simd<T, Abi> r;
+        detail::simd_access::data(r) = backend::min(detail::simd_access::data(a), detail::simd_access::data(b));
+        return r;
+    } else {
+        return detail::simd_access::map(a, b, [](T x, T y) { return std::min(x, y); });
+    }
+}
+
+template <typename T, typename Abi> simd<T, Abi> max(const simd<T, Abi> &a, const simd<T, Abi> &b) noexcept {
+    using backend = detail::simd_backend<T, Abi>;
+    if constexpr (requires { backend::max(detail::simd_access::data(a), detail::simd_access::data(b)); }) {
+        simd<T, Abi> r;
+        detail::simd_access::data(r) = backend::max(detail::simd_access::data(a), detail::simd_access::data(b));
+        return r;
+    } else {
+        return detail::simd_access::map(a, b, [](T x, T y) { return std::max(x, y); });
+    }
+}
+
+template <typename T, typename Abi> std::pair<simd<T, Abi>, simd<T, Abi>> minmax(const simd<T, Abi> &a, const simd<T, Abi> &b) noexcept {
+    return {min(a, b), max(a, b)};
+}
+
+template <typename T, typename Abi> simd<T, Abi> clamp(const simd<T, Abi> &v, const simd<T, Abi> &lo, const simd<T, Abi> &hi) noexcept {
+    return min(max(v, lo), hi);
+}
+
+template <typename T, typename Abi>
+    requires std::is_signed_v<T>
+simd<T, Abi> abs(const simd<T, Abi> &v) noexcept {
+    return detail::simd_access::map(v, [](T x) { return x < 0 ? static_cast<T>(-x) : x; });
+}
+
+template <typename T, typename Abi>
+    requires std::is_floating_point_v<T>
+simd<T, Abi> sqrt(const simd<T, Abi> &v) noexcept {
+    using backend = detail::simd_backend<T, Abi>;
+    if constexpr (requires { backend::sqrt(detail::simd_access::data(v)); }) {
+        simd<T, Abi> r;
+        detail::simd_access::data(r) = backend::sqrt(detail::simd_access::data(v));
+        return r;
+    } else {
+        return detail::simd_access::map(v, [](T x) { return std::sqrt(x); });
+    }
+}
+
+// Converts every lane. To is either the value type of the result or the simd type itself.
+template <typename To, typename T, typename Abi> auto static_simd_cast(const simd<T, Abi> &v) noexcept {
+    constexpr std::size_t N = simd<T, Abi>::size();
+    constexpr bool keeps_abi = !detail::is_fixed_size_abi<Abi>::value && simd_size_v<To, Abi> == N;
+    using result_type        = std::conditional_t<is_simd_v<To>, To,
+                                                  std::conditional_t<keeps_abi, simd<To, Abi>, fixed_size_simd<To, static_cast<int>(N)>>>;
+    static_assert(result_type::size() == N, "static_simd_cast cannot change the number of lanes");
+
+    alignas(memory_alignment_v<simd<T, Abi>>) T lanes[N];
+    v.copy_to(lanes, vector_aligned);
+    return result_type([&](auto i) { return static_cast<typename result_type::value_type>(lanes[i]); });
+}
+
+template <typename T, typename Abi> bool all_of(const simd_mask<T, Abi> &m) noexcept {
+    return detail::simd_access::bits(m) == detail::lane_mask(simd_mask<T, Abi>::size());
+}
+template <typename T, typename Abi> bool any_of(const simd_mask<T, Abi> &m) noexcept { return detail::simd_access::bits(m) != 0; }
+template <typename T, typename Abi> bool none_of(const simd_mask<T, Abi> &m) noexcept { return detail::simd_access::bits(m) == 0; }
+template <typename T, typename Abi> bool some_of(const simd_mask<T, Abi> &m) noexcept { return any_of(m) && !all_of(m); }
+template <typename T, typename Abi> int  popcount(const simd_mask<T, Abi> &m) noexcept {
+    return detail::count_lanes(detail::simd_access::bits(m));
+}
+
+// Preconditions: any_of(m)
+template <typename T, typename Abi> int find_first_set(const simd_mask<T, Abi> &m) noexcept {
+    return std::countr_zero(detail::simd_access::bits(m));
+}
+template <typename T, typename Abi> int find_last_set(const simd_mask<T, Abi> &m) noexcept {
+    return 63 - std::countl_zero(detail::simd_access::bits(m));
+}
+
+template <typename T>
+    requires std::is_same_v<T, bool>
+constexpr bool all_of(T v) noexcept {
+    return v;
+}
+template <typename T>
+    requires std::is_same_v<T, bool>
+constexpr bool any_of(T v) noexcept {
+    return v;
+}
+template <typename T>
+    requires std::is_same_v<T, bool>
+constexpr bool none_of(T v) noexcept {
+    return !v;
+}
+template <typename T>
+    requires std::is_same_v<T, bool>
+constexpr bool some_of(T) noexcept {
+    return false;
+}
+template <typename T>
+    requires std::is_same_v<T, bool>
+constexpr int popcount(T v) noexcept {
+    return v;
+}
+
+#endif
+
+} // namespace backport
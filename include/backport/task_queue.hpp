@@ -0,0 +1,180 @@
+#pragma once
+
+#include "move_only_function.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace backport {
+
+// Assumed cache line size for padding. std::hardware_destructive_interference_size is deliberately not used: it is missing on
+// some standard libraries and GCC warns that its value depends on the target flags (-Winterference-size).
+inline constexpr std::size_t cache_line_size = 64;
+
+// Default task type: a compact move_only_function sized so that the function plus the slot's sequence number fill exactly
+// one cache line (48 inline bytes on 64-bit targets)
+using task_queue_function =
+    basic_move_only_function<void(), cache_line_size - 2 * sizeof(void *), alignof(void *), function_options::compact>;
+
+// Bounded lock-free multi-producer/multi-consumer queue, a ring of cache-line-aligned slots with one sequence number each
+// (Dmitry Vyukov's bounded MPMC queue). Tasks live directly in the slots: pushing constructs the function in place, so a
+// closure that fits the inline buffer is stored with no heap node, and popping relocates it out.
+template <typename Task = task_queue_function> class task_queue {
+    static_assert(std::is_nothrow_move_constructible_v<Task> && std::is_nothrow_move_assignable_v<Task>,
+                  "task_queue requires a nothrow movable task type");
+
+  private:
+    struct alignas(cache_line_size) slot {
+        std::atomic<std::size_t> sequence;
+        union {
+            Task task; // Alive only between a completed push and the matching pop
+        };
+
+        slot() noexcept {}
+        ~slot() {}
+    };
+
+    // Claim the next slot for writing, nullptr if the queue is full
+    slot *claim_push(std::size_t &pos) noexcept {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            slot          &s    = slots[pos & mask];
+            std::size_t    seq  = s.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return &s;
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Hand a consumed slot back to the producers, one lap ahead
+    void release(slot &s, std::size_t pos) noexcept {
+        s.task.~Task();
+        s.sequence.store(pos + mask + 1, std::memory_order_release);
+    }
+
+    std::unique_ptr<slot[]> slots;
+    std::size_t             mask;
+
+    // Producers and consumers each update their own cache line
+    alignas(cache_line_size) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(cache_line_size) std::atomic<std::size_t> dequeue_pos{0};
+
+  public:
+    using value_type = Task;
+
+    // Capacity is rounded up to a power of two, the slots are allocated once here and never again
+    explicit task_queue(std::size_t capacity) : slots(), mask(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1) {
+        slots = std::make_unique<slot[]>(mask + 1);
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    task_queue(const task_queue &)            = delete;
+    task_queue &operator=(const task_queue &) = delete;
+
+    // Destroys the tasks that were never popped, must not race with push or pop
+    ~task_queue() {
+        for (std::size_t pos = dequeue_pos.load(std::memory_order_relaxed); pos != enqueue_pos.load(std::memory_order_relaxed); ++pos) {
+            slot &s = slots[pos & mask];
+            if (s.sequence.load(std::memory_order_acquire) == pos + 1) s.task.~Task();
+        }
+    }
+
+    // Enqueue a task constructed from f, returns false if the queue is full. When constructing the task cannot throw it is
+    // built directly in the slot and f is left untouched on failure. Otherwise it is built first and then moved in, so a
+    // throwing constructor never leaves a claimed slot behind, but f has been consumed if the queue filled up meanwhile:
+    // construct the Task yourself before retrying in a loop.
+    template <typename F>
+    bool try_push(F &&f) noexcept(std::is_nothrow_constructible_v<Task, F>)
+        requires std::is_constructible_v<Task, F>
+    {
+        if constexpr (std::is_nothrow_constructible_v<Task, F>) {
+            std::size_t pos;
+            slot       *s = claim_push(pos);
+            if (!s) return false;
+            ::new (static_cast<void *>(std::addressof(s->task))) Task(std::forward<F>(f));
+            s->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        } else {
+            if (full_approx()) return false;
+            Task task(std::forward<F>(f));
+            return try_push(std::move(task)); // Can still fail if other producers filled the queue meanwhile
+        }
+    }
+
+    // Dequeue the oldest task into out, returns false if the queue is empty
+    bool try_pop(Task &out) noexcept {
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            slot          &s    = slots[pos & mask];
+            std::size_t    seq  = s.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(s.task);
+                    release(s, pos);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Dequeue up to out.size() consecutive tasks with a single atomic claim, returns how many were written to the front of out
+    std::size_t try_pop_batch(std::span<Task> out) noexcept {
+        if (out.empty()) return 0;
+
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        std::size_t count;
+        for (;;) {
+            count = 0;
+            while (count < out.size() && slots[(pos + count) & mask].sequence.load(std::memory_order_acquire) == pos + count + 1) {
+                ++count;
+            }
+
+            if (count == 0) {
+                std::size_t seq = slots[pos & mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0) return 0;
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            } else if (dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            slot &s = slots[(pos + i) & mask];
+            out[i]  = std::move(s.task);
+            release(s, pos + i);
+        }
+        return count;
+    }
+
+    std::size_t capacity() const noexcept { return mask + 1; }
+
+    // Snapshots, only exact when no other thread is pushing or popping
+    std::size_t size_approx() const noexcept {
+        std::size_t tail = dequeue_pos.load(std::memory_order_relaxed);
+        std::size_t head = enqueue_pos.load(std::memory_order_relaxed);
+        return head >= tail ? head - tail : 0;
+    }
+
+    bool empty_approx() const noexcept { return size_approx() == 0; }
+    bool full_approx() const noexcept { return size_approx() >= capacity(); }
+};
+
+} // namespace backport
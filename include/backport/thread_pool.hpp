@@ -0,0 +1,438 @@
+#pragma once
+
+#include "expected.hpp"
+#include "move_only_function.hpp"
+#include "task_queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace backport {
+
+class thread_pool;
+template <typename T> class task_future;
+
+namespace detail {
+
+// Hint to the CPU that this is a spin-wait loop
+inline void cpu_relax() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Unit of work in the worker deques, execute may free the job
+struct pool_job {
+    void (*execute)(pool_job *) noexcept;
+};
+
+// Task posted from inside a worker, the deques only hold pointers so it needs its own node
+struct posted_job : pool_job {
+    move_only_function<void()> task;
+
+    explicit posted_job(move_only_function<void()> &&t) noexcept : pool_job{&run}, task(std::move(t)) {}
+
+    // Exceptions escaping a posted task terminate, as they would from a std::thread
+    static void run(pool_job *job) noexcept {
+        std::unique_ptr<posted_job> self(static_cast<posted_job *>(job));
+        self->task();
+    }
+};
+
+// Chase-Lev work-stealing deque of job pointers ("Correct and Efficient Work-Stealing for Weak Memory Models", Lê et al.
+// 2013). The owning worker pushes and takes at the bottom (LIFO), any other thread steals from the top (FIFO). The paper's
+// standalone seq_cst fences are folded into seq_cst accesses, which costs the same on x86 and is visible to ThreadSanitizer.
+class work_stealing_deque {
+    struct ring {
+        std::int64_t                               capacity;
+        std::unique_ptr<std::atomic<pool_job *>[]> slots;
+
+        explicit ring(std::int64_t cap) : capacity(cap), slots(new std::atomic<pool_job *>[static_cast<std::size_t>(cap)]) {}
+
+        pool_job *get(std::int64_t i) const noexcept { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void      put(std::int64_t i, pool_job *job) noexcept { slots[i & (capacity - 1)].store(job, std::memory_order_relaxed); }
+    };
+
+    alignas(cache_line_size) std::atomic<std::int64_t> top{0};
+    alignas(cache_line_size) std::atomic<std::int64_t> bottom{0};
+    std::atomic<ring *> array{nullptr};
+
+    // Owner only. Outgrown rings stay alive until the deque is destroyed, a thief may still be reading from one.
+    std::vector<std::unique_ptr<ring>> rings;
+
+    ring *grow(ring *old, std::int64_t b, std::int64_t t) {
+        auto next = std::make_unique<ring>(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            next->put(i, old->get(i));
+        }
+        rings.push_back(std::move(next));
+        array.store(rings.back().get(), std::memory_order_release);
+        return rings.back().get();
+    }
+
+  public:
+    explicit work_stealing_deque(std::int64_t capacity = 256) {
+        rings.push_back(std::make_unique<ring>(capacity));
+        array.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    // Owner only, throws std::bad_alloc if the ring has to grow and cannot
+    void push(pool_job *job) {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_acquire);
+        ring        *a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) a = grow(a, b, t);
+        a->put(b, job);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only, the most recently pushed job or nullptr
+    pool_job *take() noexcept {
+        std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        ring        *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_seq_cst);
+
+        pool_job *job = nullptr;
+        if (t <= b) {
+            job = a->get(b);
+            if (t == b) {
+                // Last job, race the thieves for it
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Any thread, the oldest job or nullptr if the deque is empty or another thread won the race
+    pool_job *steal() noexcept {
+        std::int64_t t = top.load(std::memory_order_seq_cst);
+        std::int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) return nullptr;
+
+        pool_job *job = array.load(std::memory_order_acquire)->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+        return job;
+    }
+
+    bool empty_approx() const noexcept { return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed); }
+};
+
+} // namespace detail
+
+// Work-stealing thread pool. Every worker owns a Chase-Lev deque: tasks submitted from a worker go to its own deque, tasks
+// from other threads go through a shared task_queue. Idle workers steal from random victims, spin for a while and then park
+// until new work is scheduled.
+class thread_pool {
+    struct alignas(cache_line_size) worker {
+        detail::work_stealing_deque deque;
+        thread_pool                *owner;
+        std::uint64_t               rng;
+        std::thread                 thread;
+    };
+
+    // Spin rounds (with a CPU pause) and then yield rounds an idle worker goes through before parking
+    static constexpr int spin_rounds  = 64;
+    static constexpr int yield_rounds = 4;
+
+    static inline thread_local worker *current = nullptr;
+
+    std::vector<std::unique_ptr<worker>>  workers;
+    task_queue<move_only_function<void()>> injection;
+
+    alignas(cache_line_size) std::atomic<std::uint32_t> wake_epoch{0};
+    std::atomic<std::uint32_t> sleepers{0};
+    std::atomic<bool>          stopping{false};
+
+    // Bumped on every future completion, external threads block on it
+    alignas(cache_line_size) std::atomic<std::uint32_t> completions{0};
+    std::atomic<std::uint32_t> external_waiters{0};
+
+    template <typename T> friend class task_future;
+
+    worker *local_worker() const noexcept { return current && current->owner == this ? current : nullptr; }
+
+    static std::uint64_t next_random(worker &w) noexcept {
+        // xorshift64
+        w.rng ^= w.rng << 13;
+        w.rng ^= w.rng >> 7;
+        w.rng ^= w.rng << 17;
+        return w.rng;
+    }
+
+    // Own deque first, then the shared queue, then steal starting from a random victim
+    bool run_one(worker &w) noexcept {
+        if (detail::pool_job *job = w.deque.take()) {
+            job->execute(job);
+            return true;
+        }
+
+        move_only_function<void()> task;
+        if (injection.try_pop(task)) {
+            run_posted(task);
+            return true;
+        }
+
+        std::size_t n     = workers.size();
+        std::size_t start = static_cast<std::size_t>(next_random(w) % n);
+        for (std::size_t i = 0; i < n; ++i) {
+            worker &victim = *workers[(start + i) % n];
+            if (&victim == &w) continue;
+            if (detail::pool_job *job = victim.deque.steal()) {
+                job->execute(job);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Exceptions escaping a posted task terminate, as they would from a std::thread
+    static void run_posted(move_only_function<void()> &task) noexcept { task(); }
+
+    bool has_work() const noexcept {
+        if (!injection.empty_approx()) return true;
+        for (const auto &w : workers) {
+            if (!w->deque.empty_approx()) return true;
+        }
+        return false;
+    }
+
+    void park() noexcept {
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint32_t epoch = wake_epoch.load(std::memory_order_seq_cst);
+        if (!has_work() && !stopping.load(std::memory_order_acquire)) wake_epoch.wait(epoch, std::memory_order_seq_cst);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Pairs with park(): either the sleeper sees the new work, or we see the sleeper
+    void wake_one() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) != 0) {
+            wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+            wake_epoch.notify_one();
+        }
+    }
+
+    void worker_loop(worker &w) {
+        current = &w;
+        int idle = 0;
+        for (;;) {
+            if (run_one(w)) {
+                idle = 0;
+            } else if (stopping.load(std::memory_order_acquire) && !has_work()) {
+                break;
+            } else if (idle < spin_rounds) {
+                ++idle;
+                detail::cpu_relax();
+            } else if (idle < spin_rounds + yield_rounds) {
+                ++idle;
+                std::this_thread::yield();
+            } else {
+                park();
+                idle = 0;
+            }
+        }
+        current = nullptr;
+    }
+
+    // Blocks the calling thread while the pool is full, so external producers get backpressure instead of an error
+    template <typename Task> void inject(Task &&task) {
+        while (!injection.try_push(std::forward<Task>(task))) {
+            std::this_thread::yield();
+        }
+    }
+
+    void schedule(detail::pool_job *job) {
+        if (worker *w = local_worker()) {
+            w->deque.push(job);
+        } else {
+            inject([job]() { job->execute(job); });
+        }
+        wake_one();
+    }
+
+    void notify_completion() noexcept {
+        completions.fetch_add(1, std::memory_order_seq_cst);
+        if (external_waiters.load(std::memory_order_seq_cst) != 0) completions.notify_all();
+    }
+
+    void shutdown() noexcept {
+        stopping.store(true, std::memory_order_seq_cst);
+        wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+        wake_epoch.notify_all();
+        for (auto &w : workers) {
+            if (w->thread.joinable()) w->thread.join();
+        }
+    }
+
+  public:
+    static std::size_t default_concurrency() noexcept {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // queue_capacity bounds the shared queue used by threads outside the pool, it is rounded up to a power of two
+    explicit thread_pool(std::size_t threads = default_concurrency(), std::size_t queue_capacity = 1024) : injection(queue_capacity) {
+        if (threads == 0) threads = 1;
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            auto w   = std::make_unique<worker>();
+            w->owner = this;
+            w->rng   = 0x9E3779B97F4A7C15ull * (i + 1);
+            workers.push_back(std::move(w));
+        }
+        try {
+            for (auto &w : workers) {
+                w->thread = std::thread([this, p = w.get()]() { worker_loop(*p); });
+            }
+        } catch (...) {
+            shutdown();
+            throw;
+        }
+    }
+
+    thread_pool(const thread_pool &)            = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    // Runs everything already scheduled, then joins the workers
+    ~thread_pool() { shutdown(); }
+
+    std::size_t size() const noexcept { return workers.size(); }
+
+    // Fire and forget. From a worker the task goes to its own deque (in a heap node), from any other thread it is stored
+    // directly in a slot of the shared queue.
+    template <typename F>
+    void post(F &&f)
+        requires std::is_constructible_v<move_only_function<void()>, F>
+    {
+        if (worker *w = local_worker()) {
+            auto job = std::make_unique<detail::posted_job>(move_only_function<void()>(std::forward<F>(f)));
+            w->deque.push(job.get());
+            job.release();
+        } else if constexpr (std::is_nothrow_constructible_v<move_only_function<void()>, F>) {
+            inject(std::forward<F>(f));
+        } else {
+            inject(move_only_function<void()>(std::forward<F>(f)));
+        }
+        wake_one();
+    }
+
+    // Run f on the pool, its result or exception ends up in the returned future. The future holds all of the state, see
+    // task_future.
+    template <typename F>
+    task_future<std::invoke_result_t<std::decay_t<F> &>> submit(F &&f)
+        requires std::is_constructible_v<move_only_function<std::invoke_result_t<std::decay_t<F> &>()>, F>
+    {
+        return task_future<std::invoke_result_t<std::decay_t<F> &>>(*this, std::forward<F>(f));
+    }
+};
+
+// Result of thread_pool::submit. The future is its own shared state: the task, the expected<T, std::exception_ptr> result
+// and the completion flag all live inside it and the pool only ever sees a pointer, so submitting allocates nothing beyond
+// what the task itself needs. In exchange it cannot be moved or copied (submit returns it through guaranteed copy elision,
+// and containers can emplace it with the (pool, f) constructor), destroying it waits for the task to finish, and it must
+// not outlive its pool.
+template <typename T> class task_future : detail::pool_job {
+  public:
+    using value_type  = T;
+    using result_type = expected<T, std::exception_ptr>;
+
+  private:
+    thread_pool               *pool;
+    move_only_function<T()>    task;
+    std::optional<result_type> result;
+    std::atomic<bool>          done{false};
+
+    static void run(detail::pool_job *job) noexcept {
+        auto &self = *static_cast<task_future *>(job);
+        try {
+            if constexpr (std::is_void_v<T>) {
+                self.task();
+                self.result.emplace();
+            } else {
+                self.result.emplace(self.task());
+            }
+        } catch (...) {
+            self.result.emplace(unexpected<std::exception_ptr>(std::current_exception()));
+        }
+        self.task = nullptr; // Release the captures before the owner can observe completion
+
+        // The owner may destroy the future as soon as done is set, only the pool is touched afterwards
+        thread_pool &p = *self.pool;
+        self.done.store(true, std::memory_order_release);
+        p.notify_completion();
+    }
+
+  public:
+    template <typename F>
+    task_future(thread_pool &p, F &&f)
+        requires std::is_constructible_v<move_only_function<T()>, F>
+        : pool_job{&run}, pool(&p), task(std::forward<F>(f)) {
+        pool->schedule(this);
+    }
+
+    task_future(const task_future &)            = delete;
+    task_future &operator=(const task_future &) = delete;
+
+    ~task_future() { wait(); }
+
+    bool ready() const noexcept { return done.load(std::memory_order_acquire); }
+
+    // Workers of the same pool run other jobs while they wait, other threads spin briefly and then block
+    void wait() const noexcept {
+        if (ready()) return;
+
+        if (thread_pool::worker *w = pool->local_worker()) {
+            while (!ready()) {
+                if (!pool->run_one(*w)) std::this_thread::yield();
+            }
+            return;
+        }
+
+        for (int i = 0; i < thread_pool::spin_rounds; ++i) {
+            if (ready()) return;
+            detail::cpu_relax();
+        }
+
+        pool->external_waiters.fetch_add(1, std::memory_order_seq_cst);
+        while (!ready()) {
+            std::uint32_t seen = pool->completions.load(std::memory_order_seq_cst);
+            if (ready()) break;
+            pool->completions.wait(seen, std::memory_order_seq_cst);
+        }
+        pool->external_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Waits, then gives access to the result. The rvalue overload moves it out, e.g. pool.submit(f).get().
+    result_type &get() & {
+        wait();
+        return *result;
+    }
+
+    result_type get() && {
+        wait();
+        return std::move(*result);
+    }
+};
+
+} // namespace backport
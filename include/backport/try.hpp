@@ -0,0 +1,108 @@
+#pragma once
+
+#include "expected.hpp"
+
+#include <type_traits>
+#include <utility>
+
+// Early return on error for expected (and anything with the same has_value()/error()/operator* interface):
+//
+//   backport::expected<frame, error> decode(span input) {
+//       BACKPORT_TRY_ASSIGN(auto header, read_header(input)); // declares header, or returns the error
+//       BACKPORT_TRY(check_crc(header));                       // statement form, the value is discarded
+//       payload body = BACKPORT_TRY(read_body(input));         // expression form, needs statement expressions
+//       return frame{header, std::move(body)};
+//   }
+//
+// The error is moved straight into the enclosing function's return value (exactly once from C++17, when the return value
+// is elided), or copied if the operand is an lvalue. The enclosing function must have a declared expected return type
+// whose error type is constructible from the operand's. The expression form of BACKPORT_TRY relies on GNU statement
+// expressions (GCC, Clang): BACKPORT_HAS_STATEMENT_EXPRESSIONS is 1 where they are available, elsewhere BACKPORT_TRY can only
+// be used as a statement and BACKPORT_TRY_ASSIGN is the portable way to get at the value.
+
+#ifndef BACKPORT_HAS_STATEMENT_EXPRESSIONS
+#if defined(__GNUC__) || defined(__clang__)
+#define BACKPORT_HAS_STATEMENT_EXPRESSIONS 1
+#else
+#define BACKPORT_HAS_STATEMENT_EXPRESSIONS 0
+#endif
+#endif
+
+namespace backport {
+namespace detail {
+
+// Returned from the enclosing function in place of the error, converts to its expected return type by constructing the
+// error in place from the operand's. E is a reference when the operand's error() returns one, otherwise (compact_expected
+// decodes its error on every call) the error is held by value, a reference would dangle once the full-expression ends.
+template <typename E> class propagated_error {
+    E error;
+
+    using unexpect_type = typename std::decay<decltype(unexpect)>::type;
+    using error_type    = typename std::decay<E>::type;
+
+  public:
+    explicit propagated_error(E &&e) noexcept(std::is_nothrow_constructible<E, E &&>::value) : error(static_cast<E &&>(e)) {}
+
+    template <typename R, typename std::enable_if<std::is_constructible<R, const unexpect_type &, E &&>::value, int>::type = 0>
+    operator R() && {
+        return R(unexpect, static_cast<E &&>(error));
+    }
+
+    // Expected-like types without the unexpect constructor, e.g. compact_expected, go through unexpected
+    template <typename R,
+              typename std::enable_if<!std::is_constructible<R, const unexpect_type &, E &&>::value &&
+                                          std::is_constructible<R, unexpected<error_type> &&>::value,
+                                      int>::type = 0>
+    operator R() && {
+        return R(unexpected<error_type>(static_cast<E &&>(error)));
+    }
+};
+
+template <typename Expected>
+auto propagate_error(Expected &&e) -> propagated_error<decltype(std::forward<Expected>(e).error())> {
+    return propagated_error<decltype(std::forward<Expected>(e).error())>(std::forward<Expected>(e).error());
+}
+
+template <typename Expected>
+using try_value_type = typename std::remove_cv<typename std::remove_reference<Expected>::type>::type::value_type;
+
+template <typename Expected, typename std::enable_if<std::is_void<try_value_type<Expected>>::value, int>::type = 0>
+void try_value(Expected &&) noexcept {}
+
+template <typename Expected, typename std::enable_if<!std::is_void<try_value_type<Expected>>::value, int>::type = 0>
+auto try_value(Expected &&e) -> decltype(*std::forward<Expected>(e)) {
+    return *std::forward<Expected>(e);
+}
+
+} // namespace detail
+} // namespace backport
+
+#define BACKPORT_TRY_CONCAT_IMPL(a, b) a##b
+#define BACKPORT_TRY_CONCAT(a, b)      BACKPORT_TRY_CONCAT_IMPL(a, b)
+
+// Declares or assigns lhs from the value of the expected, or returns its error. Not wrapped in a block, so a declaration
+// is visible to the rest of the scope.
+#define BACKPORT_TRY_ASSIGN(lhs, ...) BACKPORT_TRY_ASSIGN_IMPL(BACKPORT_TRY_CONCAT(backport_try_result_, __COUNTER__), lhs, __VA_ARGS__)
+#define BACKPORT_TRY_ASSIGN_IMPL(result, lhs, ...)                                                                                    \
+    auto &&result = (__VA_ARGS__);                                                                                                 \
+    if (!result.has_value()) return ::backport::detail::propagate_error(static_cast<decltype(result) &&>(result));               \
+    lhs = ::backport::detail::try_value(static_cast<decltype(result) &&>(result))
+
+#if BACKPORT_HAS_STATEMENT_EXPRESSIONS
+// Evaluates to the value of the expected, or returns its error
+#define BACKPORT_TRY(...) BACKPORT_TRY_IMPL(BACKPORT_TRY_CONCAT(backport_try_result_, __COUNTER__), __VA_ARGS__)
+#define BACKPORT_TRY_IMPL(result, ...)                                                                                               \
+    __extension__({                                                                                                                \
+        auto &&result = (__VA_ARGS__);                                                                                             \
+        if (!result.has_value()) return ::backport::detail::propagate_error(static_cast<decltype(result) &&>(result));           \
+        ::backport::detail::try_value(static_cast<decltype(result) &&>(result));                                                   \
+    })
+#else
+// Returns the error of the expected, statement only
+#define BACKPORT_TRY(...) BACKPORT_TRY_IMPL(BACKPORT_TRY_CONCAT(backport_try_result_, __COUNTER__), __VA_ARGS__)
+#define BACKPORT_TRY_IMPL(result, ...)                                                                                               \
+    do {                                                                                                                           \
+        auto &&result = (__VA_ARGS__);                                                                                             \
+        if (!result.has_value()) return ::backport::detail::propagate_error(static_cast<decltype(result) &&>(result));           \
+    } while (false)
+#endif
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <bit>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+#endif
+
+// Each primitive is aliased (or mapped) to the standard one where the standard library has it. UTILITY_CUSTOM_IMPL forces
+// all of them, BACKPORT_ASSUME included.
+
+namespace backport {
+
+// The feature test macro __cpp_lib_byteswap is specifically designed to detect the availability of std::byteswap in the
+// standard library, which was introduced in C++23. The value 202110L represents the date when the feature was added to the
+// standard (October 2021).
+#if defined(__cpp_lib_byteswap) && __cpp_lib_byteswap >= 202110L && !defined(UTILITY_CUSTOM_IMPL)
+
+// Use std::byteswap if available
+using std::byteswap;
+
+#else
+
+// Custom implementation for pre-C++23 (P1272)
+namespace detail {
+
+template <typename U> constexpr U byteswap_bytes(U value) noexcept {
+    U result = 0;
+    for (std::size_t i = 0; i < sizeof(U); ++i) {
+        result = static_cast<U>((result << CHAR_BIT) | (value & static_cast<U>(0xff)));
+        value  = static_cast<U>(value >> CHAR_BIT);
+    }
+    return result;
+}
+
+} // namespace detail
+
+// Reverses the bytes of an integer. GCC and Clang lower the builtins to one bswap (rev on ARM) and fold them in constant
+// expressions, MSVC's intrinsics are not constexpr, so constant evaluation takes the loop there.
+template <std::integral T> constexpr T byteswap(T value) noexcept {
+    static_assert(std::has_unique_object_representations_v<T>, "T may not have padding bits");
+    using U = std::make_unsigned_t<T>;
+    const U bits = static_cast<U>(value);
+
+    if constexpr (sizeof(T) == 1) {
+        return value;
+    } else {
+#if defined(__GNUC__) || defined(__clang__)
+        if constexpr (sizeof(T) == 2) {
+            return static_cast<T>(__builtin_bswap16(bits));
+        } else if constexpr (sizeof(T) == 4) {
+            return static_cast<T>(__builtin_bswap32(bits));
+        } else if constexpr (sizeof(T) == 8) {
+            return static_cast<T>(__builtin_bswap64(bits));
+        }
+#elif defined(_MSC_VER)
+        if (!std::is_constant_evaluated()) {
+            if constexpr (sizeof(T) == 2) {
+                return static_cast<T>(_byteswap_ushort(bits));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<T>(_byteswap_ulong(bits));
+            } else if constexpr (sizeof(T) == 8) {
+                return static_cast<T>(_byteswap_uint64(bits));
+            }
+        }
+#endif
+        return static_cast<T>(detail::byteswap_bytes(bits));
+    }
+}
+
+#endif
+
+// The feature test macro __cpp_lib_unreachable is specifically designed to detect the availability of std::unreachable in the
+// standard library, which was introduced in C++23. The value 202202L represents the date when the feature was added to the
+// standard (February 2022).
+#if defined(__cpp_lib_unreachable) && __cpp_lib_unreachable >= 202202L && !defined(UTILITY_CUSTOM_IMPL)
+
+// Use std::unreachable if available
+using std::unreachable;
+
+#else
+
+// Custom implementation for pre-C++23 (P0627). Reaching it is undefined behavior, which lets the compiler drop the code
+// path leading here, e.g. the range check in front of a switch's jump table.
+[[noreturn]] inline void unreachable() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_unreachable();
+#elif defined(_MSC_VER)
+    __assume(false);
+#endif
+}
+
+#endif
+
+// The feature test macro __cpp_lib_to_underlying is specifically designed to detect the availability of std::to_underlying in
+// the standard library, which was introduced in C++23. The value 202102L represents the date when the feature was added to the
+// standard (February 2021).
+#if defined(__cpp_lib_to_underlying) && __cpp_lib_to_underlying >= 202102L && !defined(UTILITY_CUSTOM_IMPL)
+
+// Use std::to_underlying if available
+using std::to_underlying;
+
+#else
+
+// Custom implementation for pre-C++23 (P1682)
+template <typename E>
+    requires std::is_enum_v<E>
+constexpr std::underlying_type_t<E> to_underlying(E value) noexcept {
+    return static_cast<std::underlying_type_t<E>>(value);
+}
+
+#endif
+
+} // namespace backport
+
+// BACKPORT_ASSUME(expr) tells the optimizer that expr is true, e.g. BACKPORT_ASSUME(n % 4 == 0) before a loop. A false
+// expr is undefined behavior. The C++23 attribute is used where the compiler has it (GCC 13, Clang 19), otherwise
+// __builtin_assume (Clang) or __assume (MSVC), which do not evaluate expr either. GCC 12 and older have neither: there
+// expr is evaluated and branches to __builtin_unreachable(), so it must not have side effects.
+#ifndef BACKPORT_ASSUME
+#if defined(__has_cpp_attribute) && !defined(UTILITY_CUSTOM_IMPL)
+#if __has_cpp_attribute(assume) >= 202207L && __cplusplus > 202002L
+#define BACKPORT_HAS_ASSUME_ATTRIBUTE 1
+#endif
+#endif
+
+#if defined(BACKPORT_HAS_ASSUME_ATTRIBUTE)
+#define BACKPORT_ASSUME(...) [[assume(__VA_ARGS__)]]
+#elif defined(__clang__)
+#define BACKPORT_ASSUME(...) __builtin_assume(__VA_ARGS__)
+#elif defined(_MSC_VER)
+#define BACKPORT_ASSUME(...) __assume(__VA_ARGS__)
+#elif defined(__GNUC__)
+#define BACKPORT_ASSUME(...)                                                                                                           \
+    do {                                                                                                                               \
+        if (!(__VA_ARGS__)) __builtin_unreachable();                                                                                   \
+    } while (false)
+#else
+#define BACKPORT_ASSUME(...) ((void)0)
+#endif
+#endif
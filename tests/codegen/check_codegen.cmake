@@ -0,0 +1,206 @@
+# Inspects functions in an x86-64 assembly listing, run as
+#   cmake -DASSEMBLY=<file.s> -DSYNTAX=att -DREGISTER_ONLY=f,g -DUSES_MEMORY=h -DLOWERS_TO=f=^bswap -P check_codegen.cmake
+#
+# SYNTAX         att for GCC and Clang (-S), masm for an MSVC /FA listing (Intel syntax). REGISTER_ONLY and USES_MEMORY
+#                read AT&T memory operands and the System V red zone, they are only available with att.
+# REGISTER_ONLY  functions whose arguments and results stay in registers: no memory operand other than scratch space below
+#                the stack pointer (the red zone) or a constant addressed relative to rip
+# USES_MEMORY    controls that must touch other memory, e.g. through a hidden result pointer, so the check is known to work
+# LOWERS_TO      function=regex pairs: apart from moves and the return, every instruction's mnemonic matches regex
+# WITHOUT        function=regex pairs: no instruction's mnemonic matches regex
+# WITH           function=regex pairs for controls: some instruction's mnemonic matches regex
+# SAME_AS        function=reference pairs: the function's instructions are the reference's, local labels aside
+cmake_minimum_required(VERSION 3.20)
+
+if(NOT EXISTS "${ASSEMBLY}")
+  message(FATAL_ERROR "Assembly listing '${ASSEMBLY}' not found")
+endif()
+file(STRINGS "${ASSEMBLY}" listing)
+
+if(NOT SYNTAX)
+  set(SYNTAX att)
+endif()
+if(NOT SYNTAX MATCHES "^(att|masm)$")
+  message(FATAL_ERROR "Unknown assembly syntax '${SYNTAX}'")
+endif()
+if(SYNTAX STREQUAL "masm" AND (REGISTER_ONLY OR USES_MEMORY))
+  message(FATAL_ERROR "REGISTER_ONLY and USES_MEMORY need an AT&T listing")
+endif()
+
+# Instructions of one function, from its label to the end of the procedure, without assembler directives. MASM listings
+# bracket the function with PROC and ENDP and put comments after a semicolon, npad is alignment padding.
+function(function_body name out_var)
+  set(body)
+  set(inside FALSE)
+  foreach(line IN LISTS listing)
+    if(SYNTAX STREQUAL "masm")
+      if(line MATCHES "^${name}[ \t]+PROC")
+        set(inside TRUE)
+      elseif(inside)
+        if(line MATCHES "^${name}[ \t]+ENDP")
+          break()
+        endif()
+        string(REGEX REPLACE ";.*$" "" line "${line}")
+        if(line MATCHES "^[ \t]+[a-z]" AND NOT line MATCHES "^[ \t]+npad")
+          string(STRIP "${line}" line)
+          list(APPEND body "${line}")
+        endif()
+      endif()
+    elseif(line MATCHES "^_?${name}:")
+      set(inside TRUE)
+    elseif(inside)
+      if(line MATCHES "^[ \t]*\\.cfi_endproc" OR line MATCHES "^[ \t]*\\.size[ \t]")
+        break()
+      endif()
+      if(line MATCHES "^[ \t]+[a-z]" AND NOT line MATCHES "^[ \t]*\\.")
+        string(STRIP "${line}" line)
+        list(APPEND body "${line}")
+      endif()
+    endif()
+  endforeach()
+  set(${out_var}
+      "${body}"
+      PARENT_SCOPE)
+endfunction()
+
+# Memory operands that are neither red zone scratch nor rip-relative constants. lea only computes the address.
+function(memory_operands body out_var)
+  set(found)
+  foreach(instruction IN LISTS body)
+    if(instruction MATCHES "^lea")
+      continue()
+    endif()
+    string(REGEX MATCHALL "[-0-9A-Za-z_.+]*\\(%[^)]*\\)" operands "${instruction}")
+    foreach(operand IN LISTS operands)
+      if(NOT operand MATCHES "^-[0-9]+\\(%rsp\\)$" AND NOT operand MATCHES "\\(%rip\\)$")
+        list(APPEND found "${instruction}")
+        break()
+      endif()
+    endforeach()
+  endforeach()
+  set(${out_var}
+      "${found}"
+      PARENT_SCOPE)
+endfunction()
+
+# Mnemonics of the instructions that match regex
+function(matching_mnemonics body regex out_var)
+  set(found)
+  foreach(instruction IN LISTS body)
+    string(REGEX MATCH "^[a-z0-9]+" mnemonic "${instruction}")
+    if(mnemonic MATCHES "${regex}")
+      list(APPEND found "${instruction}")
+    endif()
+  endforeach()
+  set(${out_var}
+      "${found}"
+      PARENT_SCOPE)
+endfunction()
+
+set(failed FALSE)
+string(REPLACE "," ";" REGISTER_ONLY "${REGISTER_ONLY}")
+string(REPLACE "," ";" USES_MEMORY "${USES_MEMORY}")
+string(REPLACE "," ";" LOWERS_TO "${LOWERS_TO}")
+string(REPLACE "," ";" WITHOUT "${WITHOUT}")
+string(REPLACE "," ";" WITH "${WITH}")
+string(REPLACE "," ";" SAME_AS "${SAME_AS}")
+
+foreach(name IN LISTS REGISTER_ONLY USES_MEMORY)
+  function_body(${name} body)
+  if(NOT body)
+    message(SEND_ERROR "${name}: not found in ${ASSEMBLY}")
+    set(failed TRUE)
+    continue()
+  endif()
+
+  memory_operands("${body}" memory)
+  list(JOIN body "\n    " listing_text)
+  if(name IN_LIST REGISTER_ONLY AND memory)
+    list(JOIN memory "\n    " memory_text)
+    message(SEND_ERROR "${name}: expected registers only, but accesses memory:\n    ${memory_text}")
+    set(failed TRUE)
+  elseif(name IN_LIST USES_MEMORY AND NOT memory)
+    message(SEND_ERROR "${name}: control was expected to access memory:\n    ${listing_text}")
+    set(failed TRUE)
+  else()
+    message(STATUS "${name}: ok\n    ${listing_text}")
+  endif()
+endforeach()
+
+foreach(check IN ITEMS LOWERS_TO WITHOUT WITH)
+  foreach(pair IN LISTS ${check})
+    string(FIND "${pair}" "=" separator)
+    string(SUBSTRING "${pair}" 0 ${separator} name)
+    math(EXPR separator "${separator} + 1")
+    string(SUBSTRING "${pair}" ${separator} -1 regex)
+
+    function_body(${name} body)
+    if(NOT body)
+      message(SEND_ERROR "${name}: not found in ${ASSEMBLY}")
+      set(failed TRUE)
+      continue()
+    endif()
+
+    list(JOIN body "\n    " listing_text)
+    if(check STREQUAL "LOWERS_TO")
+      set(others "${body}")
+      list(FILTER others EXCLUDE REGEX "^(mov|ret)")
+      matching_mnemonics("${others}" "${regex}" matching)
+      if(NOT others OR NOT matching STREQUAL others)
+        message(SEND_ERROR "${name}: expected only moves and '${regex}':\n    ${listing_text}")
+        set(failed TRUE)
+        continue()
+      endif()
+    elseif(check STREQUAL "WITHOUT")
+      matching_mnemonics("${body}" "${regex}" matching)
+      if(matching)
+        message(SEND_ERROR "${name}: expected no '${regex}':\n    ${listing_text}")
+        set(failed TRUE)
+        continue()
+      endif()
+    else()
+      matching_mnemonics("${body}" "${regex}" matching)
+      if(NOT matching)
+        message(SEND_ERROR "${name}: control was expected to contain '${regex}':\n    ${listing_text}")
+        set(failed TRUE)
+        continue()
+      endif()
+    endif()
+    message(STATUS "${name}: ok\n    ${listing_text}")
+  endforeach()
+endforeach()
+
+foreach(pair IN LISTS SAME_AS)
+  string(FIND "${pair}" "=" separator)
+  string(SUBSTRING "${pair}" 0 ${separator} name)
+  math(EXPR separator "${separator} + 1")
+  string(SUBSTRING "${pair}" ${separator} -1 reference)
+
+  function_body(${name} body)
+  function_body(${reference} reference_body)
+  if(NOT body OR NOT reference_body)
+    message(SEND_ERROR "${name}, ${reference}: not found in ${ASSEMBLY}")
+    set(failed TRUE)
+    continue()
+  endif()
+
+  # Branch targets are numbered per translation unit (.L3 for GCC and ELF Clang, LBB0_3 for Mach-O) or named after the
+  # function ($LN3@codegen_ou for MSVC)
+  string(REGEX REPLACE "\\.?L(BB)?[0-9][0-9_]*" ".L" body "${body}")
+  string(REGEX REPLACE "\\.?L(BB)?[0-9][0-9_]*" ".L" reference_body "${reference_body}")
+  string(REGEX REPLACE "\\$LN[0-9]+@[A-Za-z0-9_]+" "$LN" body "${body}")
+  string(REGEX REPLACE "\\$LN[0-9]+@[A-Za-z0-9_]+" "$LN" reference_body "${reference_body}")
+  list(JOIN body "\n    " listing_text)
+  if(NOT body STREQUAL reference_body)
+    list(JOIN reference_body "\n    " reference_text)
+    message(SEND_ERROR "${name}: expected the same instructions as ${reference}:\n    ${listing_text}\n"
+                       "  ${reference}:\n    ${reference_text}")
+    set(failed TRUE)
+    continue()
+  endif()
+  message(STATUS "${name}: ok, same as ${reference}\n    ${listing_text}")
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "Codegen check failed for ${ASSEMBLY}")
+endif()
@@ -0,0 +1,41 @@
+// Compiled to assembly (not linked) by the codegen checks in tests/CMakeLists.txt, the functions have C linkage so the
+// check can find them by name
+#include <backport/expected.hpp>
+#include <string>
+
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wreturn-type-c-linkage"
+#endif
+
+extern "C" {
+
+// Trivially copyable and 8 bytes: returned in rax, no hidden result pointer
+backport::expected<int, int> codegen_expected_value(int x) { return x; }
+
+backport::expected<int, int> codegen_expected_error(int e) { return backport::unexpected<int>(e); }
+
+backport::expected<void, int> codegen_expected_void(int e) {
+    if (e != 0) return backport::unexpected<int>(e);
+    return {};
+}
+
+// Two eightbytes: returned in rax:rdx
+backport::expected<long, int> codegen_expected_wide(long x) { return x; }
+
+// Passed in a register as well
+int codegen_expected_unwrap(backport::expected<int, int> e) { return e.has_value() ? *e : -e.error(); }
+
+// A void-success chain keeps nothing but the flag and the error: the steps without work fold away, leaving one flag test
+// and the branch for the error's transform
+backport::expected<void, int> codegen_expected_void_chain(backport::expected<void, int> e) {
+    return e.and_then([] { return backport::expected<void, int>(); }).transform([] {}).transform_error([](int c) { return c + 1; });
+}
+
+// Whether a chain succeeded is the flag itself, extracted without a branch
+bool codegen_expected_void_flag(backport::expected<void, int> e) {
+    return e.and_then([] { return backport::expected<void, int>(); }).transform([] {}).has_value();
+}
+
+// Control: a non-trivial error type must come back through memory, otherwise the check proves nothing
+backport::expected<int, std::string> codegen_expected_nontrivial(int x) { return x; }
+}
@@ -0,0 +1,22 @@
+// Compiled to assembly (not linked) by the codegen checks in tests/CMakeLists.txt, the functions have C linkage so the
+// check can find them by name
+#include <backport/mdspan.hpp>
+#include <cstddef>
+
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wreturn-type-c-linkage"
+#endif
+
+using matrix = backport::mdspan<float, backport::extents<std::size_t, 4, 8>>;
+
+extern "C" {
+
+// Static extents: the view is a pointer in a register and the stride is a constant, so indexing is address arithmetic
+float *codegen_mdspan_static_index(matrix m, std::size_t i, std::size_t j) { return &m(i, j); }
+
+// The row comes back as a pointer, nothing is stored
+float *codegen_mdspan_static_row(matrix m, std::size_t i) { return backport::submdspan(m, i, backport::full_extent).data_handle(); }
+
+// Control: three dynamic extents make the view too large for registers, it is passed in memory
+float *codegen_mdspan_dynamic_index(backport::mdspan<float, backport::dims<3>> m, std::size_t i, std::size_t j) { return &m(i, j, 0); }
+}
@@ -0,0 +1,38 @@
+// Compiled to assembly (not linked) by the codegen checks in tests/CMakeLists.txt, the functions have C linkage so the
+// check can find them by name
+#include <backport/out_ptr.hpp>
+#include <memory>
+
+struct handle;
+
+extern "C" {
+
+// A C API that creates a resource through handle ** and one that may replace it, e.g. realloc
+int  create_handle(handle **out);
+int  replace_handle(handle **inout);
+void destroy_handle(handle *h);
+}
+
+struct handle_deleter {
+    void operator()(handle *h) const noexcept { destroy_handle(h); }
+};
+
+using handle_ptr = std::unique_ptr<handle, handle_deleter>;
+
+extern "C" {
+
+// out_ptr resets the unique_ptr and lets the function write into it, the same code as doing both by hand on a raw pointer
+int codegen_out_ptr(handle_ptr &p) { return create_handle(backport::out_ptr(p)); }
+
+int codegen_out_raw(handle **p) {
+    handle *old = *p;
+    *p          = nullptr;
+    if (old) destroy_handle(old);
+    return create_handle(p);
+}
+
+// inout_ptr hands over the unique_ptr's own storage, a tail call with its address like the raw pointer
+int codegen_inout_ptr(handle_ptr &p) { return replace_handle(backport::inout_ptr(p)); }
+
+int codegen_inout_raw(handle **p) { return replace_handle(p); }
+}
@@ -0,0 +1,55 @@
+// Compiled to assembly (not linked) by the codegen checks in tests/CMakeLists.txt, the functions have C linkage so the
+// check can find them by name
+#include <backport/utility.hpp>
+#include <cstdint>
+#include <cstring>
+
+extern "C" {
+
+// Each byteswap is one instruction, plus the moves between argument and result registers
+std::uint16_t codegen_byteswap16(std::uint16_t x) { return backport::byteswap(x); }
+std::uint32_t codegen_byteswap32(std::uint32_t x) { return backport::byteswap(x); }
+std::uint64_t codegen_byteswap64(std::uint64_t x) { return backport::byteswap(x); }
+
+// A big-endian field read from a buffer is a load and a bswap, or a single movbe where the target has it
+std::uint32_t codegen_load_be32(const unsigned char *p) {
+    std::uint32_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return backport::byteswap(x);
+}
+
+// Values outside the cases are unreachable, so the jump table is indexed without a range check
+int codegen_unreachable_switch(unsigned op, int a, int b) {
+    switch (op) {
+    case 0: return a + b;
+    case 1: return a - b;
+    case 2: return a * b;
+    case 3: return a & b;
+    case 4: return a | b;
+    case 5: return a ^ b;
+    default: backport::unreachable();
+    }
+}
+
+// Control: with a default, the range check stays
+int codegen_checked_switch(unsigned op, int a, int b) {
+    switch (op) {
+    case 0: return a + b;
+    case 1: return a - b;
+    case 2: return a * b;
+    case 3: return a & b;
+    case 4: return a | b;
+    case 5: return a ^ b;
+    default: return 0;
+    }
+}
+
+// A non-negative dividend divides by a power of two with a plain shift, without the rounding fixup for negative values
+int codegen_assume_divide(int x) {
+    BACKPORT_ASSUME(x >= 0);
+    return x / 16;
+}
+
+// Control: the fixup for negative dividends
+int codegen_signed_divide(int x) { return x / 16; }
+}
@@ -1,11 +1,31 @@
 #include "backport/expected.hpp"
 
 #include <cassert>
+#include <utility>
 struct A {
     int a;
     int b;
 };
 
+// The rvalue overloads of the monadic operations exist in C++11 too: the error is moved along, not copied
+struct counted {
+    static int copies;
+    static int moves;
+
+    int value;
+
+    explicit counted(int v) : value(v) {}
+    counted(const counted &other) : value(other.value) { ++copies; }
+    counted(counted &&other) noexcept : value(other.value) { ++moves; }
+};
+
+int counted::copies = 0;
+int counted::moves  = 0;
+
+struct step {
+    backport::expected<int, counted> operator()(int x) const { return x + 1; }
+};
+
 int main() {
     // std::expected<void, int> e = std::unexpected(42);
     backport::expected<void, int> e{backport::unexpect, 42};
@@ -13,5 +33,8 @@ int main() {
         assert(false);
     }
     // auto [a, b] = A{}; // Should warn
+
+    backport::expected<int, counted> failed = backport::expected<int, counted>(backport::unexpect, 1).and_then(step());
+    if (failed.has_value() || counted::copies != 0 || counted::moves != 1) return 1;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,30 @@
+# Compares a preprocessed header against the standard headers it is allowed to include, run as
+#   cmake -DHEADER=<header.i> -DBASELINE=<baseline.i> -DBUDGET=<lines> -P check_header_cost.cmake
+#
+# Both inputs are -E -P output, one of a translation unit that only includes the header and one that only includes its
+# allowance. The difference is the header's own code plus whatever it pulls in beyond the allowance, and has to stay
+# within BUDGET lines. The standard headers are the same on both sides, so the check does not depend on their size.
+cmake_minimum_required(VERSION 3.20)
+
+function(count_lines file out_var)
+  if(NOT EXISTS "${file}")
+    message(FATAL_ERROR "Preprocessed output '${file}' not found")
+  endif()
+  file(READ "${file}" content)
+  string(REGEX REPLACE "[^\n]" "" newlines "${content}")
+  string(LENGTH "${newlines}" count)
+  set(${out_var}
+      ${count}
+      PARENT_SCOPE)
+endfunction()
+
+count_lines("${HEADER}" header_lines)
+count_lines("${BASELINE}" baseline_lines)
+math(EXPR own "${header_lines} - ${baseline_lines}")
+
+set(summary "${own} lines over the allowed standard headers (${header_lines} in total, budget ${BUDGET})")
+if(own GREATER BUDGET)
+  message(FATAL_ERROR "Header cost over budget: ${summary}. Either an include was added that is not in the allowance, "
+                      "or the header grew; trim it or raise the budget in tests/CMakeLists.txt.")
+endif()
+message(STATUS "Header cost: ${summary}")
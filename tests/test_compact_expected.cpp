@@ -0,0 +1,171 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/compact_expected.hpp>
+#include <doctest/doctest.h>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+using namespace backport;
+
+struct node {
+    int value;
+};
+
+// User type that reserves its top 256 values, enough for any one-byte error
+struct row_index {
+    std::uint32_t v;
+
+    friend constexpr bool operator==(row_index, row_index) = default;
+};
+
+enum class parse_error : std::uint8_t { empty, bad_digit, overflow };
+
+template <> struct backport::niche_traits<row_index> {
+    static constexpr std::uintmax_t niche_count = 256;
+    static constexpr std::uint32_t  first_niche = std::numeric_limits<std::uint32_t>::max() - 255;
+
+    static constexpr row_index      make_niche(std::uintmax_t i) noexcept { return {first_niche + static_cast<std::uint32_t>(i)}; }
+    static constexpr bool           is_niche(const row_index &r) noexcept { return r.v >= first_niche; }
+    static constexpr std::uintmax_t niche_index(const row_index &r) noexcept { return r.v - first_niche; }
+};
+
+// Layouts: the discriminant disappears when a niche can hold every error
+static_assert(sizeof(compact_expected<node *, std::errc>) == sizeof(node *));
+static_assert(sizeof(compact_expected<const node *, parse_error>) == sizeof(node *));
+static_assert(sizeof(compact_expected<void, std::errc>) == sizeof(std::errc));
+static_assert(sizeof(compact_expected<row_index, parse_error>) == sizeof(row_index));
+static_assert(std::is_trivially_copyable_v<compact_expected<node *, std::errc>>);
+static_assert(std::is_trivially_copyable_v<compact_expected<void, std::errc>>);
+
+// Everything else is plain expected
+static_assert(std::is_same_v<compact_expected<std::uint32_t, std::errc>, expected<std::uint32_t, std::errc>>);
+static_assert(std::is_same_v<compact_expected<char *, std::errc>, expected<char *, std::errc>>); // alignof(char) == 1
+static_assert(std::is_same_v<compact_expected<row_index, std::errc>, expected<row_index, std::errc>>);
+static_assert(std::is_same_v<compact_expected<node *, std::string>, expected<node *, std::string>>);
+static_assert(std::is_same_v<compact_expected<void, int>, expected<void, int>>);
+
+static compact_expected<row_index, parse_error> parse_row(const std::string &text) {
+    if (text.empty()) return unexpected<parse_error>(parse_error::empty);
+    std::uint32_t v = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return unexpected<parse_error>(parse_error::bad_digit);
+        v = v * 10 + static_cast<std::uint32_t>(c - '0');
+    }
+    return row_index{v};
+}
+
+TEST_CASE("Tagged pointer values and errors") {
+    node n{5};
+
+    compact_expected<node *, std::errc> ok = &n;
+    REQUIRE(ok.has_value());
+    CHECK(ok);
+    CHECK((*ok)->value == 5);
+    CHECK(ok.value() == &n);
+    CHECK(ok == &n);
+
+    // A null pointer is a value, not an error
+    compact_expected<node *, std::errc> null = nullptr;
+    CHECK(null.has_value());
+    CHECK(*null == nullptr);
+
+    compact_expected<node *, std::errc> failed = unexpected<std::errc>(std::errc::no_such_file_or_directory);
+    REQUIRE_FALSE(failed.has_value());
+    CHECK(failed.error() == std::errc::no_such_file_or_directory);
+    CHECK(failed == unexpected<std::errc>(std::errc::no_such_file_or_directory));
+    CHECK(failed.value_or(&n) == &n);
+    CHECK(ok.error_or(std::errc::io_error) == std::errc::io_error);
+    CHECK_THROWS_AS(failed.value(), bad_expected_access<std::errc>);
+
+    CHECK(ok != failed);
+    compact_expected<node *, std::errc> copy = ok;
+    CHECK(copy == ok);
+    copy.swap(failed);
+    CHECK_FALSE(copy.has_value());
+    CHECK(failed == &n);
+}
+
+TEST_CASE("Default construction holds a value") {
+    compact_expected<node *, std::errc> p;
+    CHECK(p.has_value());
+    CHECK(*p == nullptr);
+
+    compact_expected<void, std::errc> v;
+    CHECK(v.has_value());
+}
+
+TEST_CASE("User-defined niches") {
+    CHECK(parse_row("1234").value() == row_index{1234});
+    CHECK(parse_row("").error() == parse_error::empty);
+    CHECK(parse_row("12x").error() == parse_error::bad_digit);
+
+    // Millions of results in a vector cost only the payload
+    std::vector<compact_expected<row_index, parse_error>> rows(4, parse_row("7"));
+    CHECK(sizeof(rows[0]) == 4);
+    CHECK(rows[3].value().v == 7);
+}
+
+TEST_CASE("Monadic operations") {
+    node n{21};
+    auto find = [&n](int key) -> compact_expected<node *, std::errc> {
+        if (key == 0) return unexpected<std::errc>(std::errc::invalid_argument);
+        return &n;
+    };
+
+    // and_then switches value types, transform leaves the compact layout when the new pair has no niche
+    auto doubled = find(1).and_then([](node *p) -> compact_expected<row_index, std::errc> { return row_index{std::uint32_t(p->value)}; });
+    static_assert(std::is_same_v<decltype(doubled), expected<row_index, std::errc>>);
+    CHECK(doubled.value().v == 21);
+
+    auto text = find(1).transform([](node *p) { return std::to_string(p->value * 2); });
+    static_assert(std::is_same_v<decltype(text), expected<std::string, std::errc>>);
+    CHECK(text.value() == "42");
+
+    auto same = find(1).transform([](node *p) { return static_cast<const node *>(p); });
+    static_assert(std::is_same_v<decltype(same), detail::niche_expected<const node *, std::errc>>);
+
+    auto missing = find(0).transform([](node *p) { return p->value; });
+    CHECK(missing.error() == std::errc::invalid_argument);
+
+    auto as_code = find(0).transform_error([](std::errc e) { return std::make_error_code(e).value(); });
+    static_assert(sizeof(as_code) == sizeof(node *)); // An int error also fits the odd addresses
+    CHECK(as_code.error() == static_cast<int>(std::errc::invalid_argument));
+
+    auto recovered = find(0).or_else([&n](std::errc) -> compact_expected<node *, parse_error> { return &n; });
+    CHECK(recovered.value() == &n);
+
+    auto passthrough = find(1).or_else([](std::errc e) -> compact_expected<node *, std::errc> { return unexpected<std::errc>(e); });
+    CHECK(passthrough.value() == &n);
+}
+
+TEST_CASE("Void results keep the error in a niche of the error type") {
+    auto check = [](bool good) -> compact_expected<void, std::errc> {
+        if (good) return {};
+        return unexpected<std::errc>(std::errc::permission_denied);
+    };
+
+    CHECK(check(true).has_value());
+    CHECK(check(false).error() == std::errc::permission_denied);
+    CHECK_THROWS_AS(check(false).value(), bad_expected_access<std::errc>);
+    CHECK(check(true) == check(true));
+    CHECK(check(true) != check(false));
+
+    int  calls = 0;
+    auto next  = check(true).and_then([&calls]() -> compact_expected<void, std::errc> {
+        ++calls;
+        return unexpected<std::errc>(std::errc::timed_out);
+    });
+    CHECK(calls == 1);
+    CHECK(next.error() == std::errc::timed_out);
+
+    auto skipped = check(false).transform([&calls]() { return ++calls; });
+    static_assert(std::is_same_v<decltype(skipped), expected<int, std::errc>>);
+    CHECK(calls == 1);
+    CHECK(skipped.error() == std::errc::permission_denied);
+
+    auto recovered = check(false).or_else([](std::errc) -> compact_expected<void, std::errc> { return {}; });
+    CHECK(recovered.has_value());
+}
@@ -0,0 +1,198 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/copyable_function.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::size_t allocation_count   = 0;
+static std::size_t deallocation_count = 0;
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr) ++deallocation_count;
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    if (ptr) ++deallocation_count;
+    std::free(ptr);
+}
+
+void reset_counters() {
+    allocation_count   = 0;
+    deallocation_count = 0;
+}
+
+// Counts live instances, to check copies are destroyed exactly once
+struct Tracked {
+    static inline int live = 0;
+
+    int value;
+
+    explicit Tracked(int v) : value(v) { ++live; }
+    Tracked(const Tracked &other) : value(other.value) { ++live; }
+    Tracked(Tracked &&other) noexcept : value(other.value) { ++live; }
+    ~Tracked() { --live; }
+
+    int operator()(int x) const { return value + x; }
+};
+
+struct MoveOnly {
+    std::unique_ptr<int> p = std::make_unique<int>(1);
+    int                  operator()() const { return *p; }
+};
+
+static_assert(std::is_copy_constructible_v<copyable_function<int()>>);
+static_assert(std::is_copy_assignable_v<copyable_function<int()>>);
+static_assert(std::is_nothrow_move_constructible_v<copyable_function<int()>>);
+static_assert(!std::is_constructible_v<copyable_function<int()>, MoveOnly>);
+static_assert(std::is_constructible_v<move_only_function<int()>, MoveOnly>);
+static_assert(!std::is_copy_constructible_v<basic_move_only_function<int()>>);
+
+// Same layout as the move-only function
+static_assert(sizeof(copyable_function<int()>) == sizeof(basic_move_only_function<int()>));
+
+TEST_CASE("Copies of small closures share nothing and never allocate") {
+    int  base   = 10;
+    auto lambda = [base](int x) { return base + x; };
+
+    reset_counters();
+    {
+        copyable_function<int(int)> original = lambda;
+        copyable_function<int(int)> copy     = original;
+        CHECK(original(1) == 11);
+        CHECK(copy(2) == 12);
+
+        copyable_function<int(int)> assigned;
+        assigned = copy;
+        CHECK(assigned(3) == 13);
+        CHECK(copy(3) == 13);
+    }
+    CHECK(allocation_count == 0);
+}
+
+TEST_CASE("Non-trivial inline callables are copied and destroyed once each") {
+    Tracked::live = 0;
+    {
+        copyable_function<int(int)> a(std::in_place_type<Tracked>, 5);
+        CHECK(Tracked::live == 1);
+
+        copyable_function<int(int)> b = a;
+        CHECK(Tracked::live == 2);
+        CHECK(b(1) == 6);
+
+        copyable_function<int(int)> c = std::move(a);
+        CHECK(Tracked::live == 2);
+        CHECK_FALSE(a);
+
+        b = c;
+        CHECK(Tracked::live == 2);
+        CHECK(b(2) == 7);
+    }
+    CHECK(Tracked::live == 0);
+}
+
+TEST_CASE("Heap callables get a deep copy") {
+    std::array<int, 32> values{};
+    values[31] = 4;
+    auto lambda = [values](int x) { return values[31] * x; };
+
+    reset_counters();
+    {
+        copyable_function<int(int)> a = lambda;
+        CHECK(allocation_count == 1);
+
+        copyable_function<int(int)> b = a;
+        CHECK(allocation_count == 2);
+
+        a = nullptr;
+        CHECK(b(2) == 8);
+    }
+    CHECK(deallocation_count == 2);
+}
+
+TEST_CASE("Fan-out to subscribers with a sized buffer stays inline") {
+    auto session = std::make_shared<int>(3);
+    int  a = 1, b = 2, c = 4;
+    auto handler = [session, a, b, c](int x) { return *session + a + b + c + x; };
+    static_assert(sizeof(handler) > move_only_function_default_inline_bytes);
+
+    using subscriber = basic_copyable_function<int(int), 48>;
+    subscriber prototype = handler;
+
+    std::vector<subscriber> subscribers;
+    subscribers.reserve(8);
+
+    reset_counters();
+    for (int i = 0; i < 8; ++i) {
+        subscribers.push_back(prototype);
+    }
+    CHECK(allocation_count == 0);
+    CHECK(session.use_count() == 11); // session, handler, prototype and 8 copies
+
+    for (auto &s : subscribers) {
+        CHECK(s(0) == 10);
+    }
+}
+
+TEST_CASE("A throwing copy leaves the target unchanged") {
+    struct ThrowOnCopy {
+        bool armed = false;
+
+        ThrowOnCopy() = default;
+        ThrowOnCopy(const ThrowOnCopy &other) : armed(other.armed) {
+            if (armed) throw std::runtime_error("copy");
+        }
+        ThrowOnCopy(ThrowOnCopy &&) noexcept = default;
+
+        int operator()() const { return 1; }
+    };
+
+    ThrowOnCopy callable;
+    callable.armed = true;
+    copyable_function<int()> source(std::in_place_type<ThrowOnCopy>, std::move(callable));
+    copyable_function<int()> target = []() { return 2; };
+
+    CHECK_THROWS_AS(target = source, std::runtime_error);
+    CHECK(target() == 2);
+    CHECK_THROWS_AS(copyable_function<int()>(source), std::runtime_error);
+}
+
+TEST_CASE("Qualified signatures") {
+    copyable_function<int() const noexcept> a = []() noexcept { return 7; };
+    copyable_function<int() const noexcept> b = a;
+    static_assert(noexcept(std::as_const(b)()));
+    CHECK(std::as_const(b)() == 7);
+
+    copyable_function<std::string() &&> consume = [s = std::string("payload")]() mutable { return std::move(s); };
+    copyable_function<std::string() &&> copy    = consume;
+    CHECK(std::move(consume)() == "payload");
+    CHECK(std::move(copy)() == "payload");
+}
+
+TEST_CASE("Allocator-aware callables copy through their allocator") {
+    std::array<int, 32> values{};
+    values[0] = 9;
+
+    copyable_function<int()> a(std::allocator_arg, std::allocator<int>(), [values]() { return values[0]; });
+    copyable_function<int()> b = a;
+    a                          = nullptr;
+    CHECK(b() == 9);
+}
@@ -499,4 +499,147 @@ TEST_SUITE("Type Variations") {
         
         mof(Counter{});
     }
-}
\ No newline at end of file
+}
+// Relocatable by memcpy, but with observable move constructor and destructor
+struct RelocatableCallable {
+    static int move_count;
+    static int destruction_count;
+    std::unique_ptr<int> value;
+
+    RelocatableCallable(int v) : value(std::make_unique<int>(v)) {}
+    RelocatableCallable(RelocatableCallable &&other) noexcept : value(std::move(other.value)) { move_count++; }
+    ~RelocatableCallable() { destruction_count++; }
+
+    int operator()() const { return *value; }
+};
+int RelocatableCallable::move_count        = 0;
+int RelocatableCallable::destruction_count = 0;
+
+template <> struct backport::is_trivially_relocatable<RelocatableCallable> : std::true_type {};
+
+TEST_SUITE("Trivial relocation") {
+    TEST_CASE("Trivially copyable callables survive moves and swaps") {
+        int  a = 1, b = 2;
+        auto f = [a, b]() { return a + b; };
+        static_assert(std::is_trivially_copyable_v<decltype(f)>);
+
+        move_only_function<int()> mof1(f);
+        move_only_function<int()> mof2(std::move(mof1));
+        CHECK_FALSE(mof1);
+        CHECK(mof2() == 3);
+
+        move_only_function<int()> mof3([]{ return 10; });
+        mof2.swap(mof3);
+        CHECK(mof2() == 10);
+        CHECK(mof3() == 3);
+
+        mof1 = std::move(mof3);
+        CHECK(mof1() == 3);
+        CHECK_FALSE(mof3);
+    }
+
+    TEST_CASE("Relocatable callables are moved without calling the move constructor") {
+        RelocatableCallable::move_count        = 0;
+        RelocatableCallable::destruction_count = 0;
+        {
+            move_only_function<int()> mof1(RelocatableCallable{42});
+            int moves_after_construction = RelocatableCallable::move_count;
+            int destroyed_after_construction = RelocatableCallable::destruction_count;
+
+            move_only_function<int()> mof2(std::move(mof1));
+            move_only_function<int()> mof3([]{ return 7; });
+            mof2.swap(mof3);
+            mof1 = std::move(mof3);
+            CHECK(mof1() == 42);
+            CHECK(mof2() == 7);
+
+            CHECK(RelocatableCallable::move_count == moves_after_construction);
+            CHECK(RelocatableCallable::destruction_count == destroyed_after_construction);
+        }
+        // The relocated object is destroyed exactly once, at the end
+        CHECK(RelocatableCallable::destruction_count == 2);
+    }
+
+    TEST_CASE("Vector reallocation relocates the stored callables") {
+        RelocatableCallable::move_count        = 0;
+        RelocatableCallable::destruction_count = 0;
+        {
+            std::vector<move_only_function<int()>> tasks;
+            for (int i = 0; i < 64; ++i) {
+                tasks.emplace_back(RelocatableCallable{i});
+            }
+            // Only the construction from the temporaries moved, the reallocations did not
+            CHECK(RelocatableCallable::move_count == 64);
+            for (int i = 0; i < 64; ++i) {
+                CHECK(tasks[i]() == i);
+            }
+        }
+        CHECK(RelocatableCallable::destruction_count == 128);
+    }
+
+    TEST_CASE("Non-relocatable callables still use their move constructor") {
+        move_only_function<int()> mof1(SelfReferential{5});
+        move_only_function<int()> mof2(std::move(mof1));
+        move_only_function<int()> mof3([]{ return 1; });
+        mof2.swap(mof3);
+        CHECK(mof3() == 5);
+        CHECK(mof2() == 1);
+    }
+}
+
+TEST_SUITE("Compact layout") {
+    // The buffer plus one pointer, so a 16-byte buffer and an 8-byte task header fill half a cache line on 64-bit targets
+    static_assert(sizeof(compact_move_only_function<void(), 16, alignof(void *)>) == 3 * sizeof(void *));
+    static_assert(sizeof(basic_move_only_function<void(), 16, alignof(void *)>) == 4 * sizeof(void *));
+    static_assert(sizeof(compact_move_only_function<void()>) == 4 * sizeof(void *));
+    static_assert(sizeof(compact_move_only_function<void()>) < sizeof(move_only_function<void()>));
+
+    TEST_CASE("Invocation and emptiness") {
+        compact_move_only_function<int(int)> empty;
+        CHECK_FALSE(empty);
+
+        int                                  offset = 3;
+        compact_move_only_function<int(int)> mof([offset](int x) { return x + offset; });
+        CHECK(mof);
+        CHECK(mof(4) == 7);
+
+        mof = nullptr;
+        CHECK_FALSE(mof);
+    }
+
+    TEST_CASE("Moves and swaps across inline and heap storage") {
+        reset_counters();
+        enable_tracking();
+        {
+            compact_move_only_function<int()> small([] { return 1; });
+            compact_move_only_function<int()> large(LargeCallable{2});
+            compact_move_only_function<int()> self_ref(SelfReferential{3});
+
+            small.swap(large);
+            CHECK(small() == 2);
+            CHECK(large() == 1);
+
+            large.swap(self_ref);
+            CHECK(large() == 3);
+            CHECK(self_ref() == 1);
+
+            compact_move_only_function<int()> moved(std::move(small));
+            CHECK_FALSE(small);
+            CHECK(moved() == 2);
+        }
+        disable_tracking();
+        CHECK(allocation_count == 1);
+        CHECK(allocation_count == deallocation_count);
+    }
+
+    TEST_CASE("Destructors run exactly once") {
+        DestructorTracker::destruction_count = 0;
+        {
+            DestructorTracker                 tracker{5};
+            compact_move_only_function<int()> mof1(std::move(tracker));
+            compact_move_only_function<int()> mof2(std::move(mof1));
+            CHECK(mof2() == 5);
+        }
+        CHECK(DestructorTracker::destruction_count == 3);
+    }
+}
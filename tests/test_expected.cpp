@@ -2,7 +2,69 @@
 #include "backport/expected.hpp" // SUT: backport::expected
 #include "doctest/doctest.h"
 
+#include <cstring>
 #include <expected>
+#include <string>
+#include <type_traits>
+
+// Construction and destruction are trivial exactly when they are for std::expected, which is what decides whether the
+// ABI passes it in registers. std::expected does not require trivial assignment (libstdc++ 12 does not provide it),
+// backport::expected has it whenever T and E do, so assignment is only checked to be at least as trivial.
+template <typename T, typename E> constexpr bool same_triviality() {
+    using ours   = backport::expected<T, E>;
+    using theirs = std::expected<T, E>;
+    return std::is_trivially_copy_constructible_v<ours> == std::is_trivially_copy_constructible_v<theirs> &&
+           std::is_trivially_move_constructible_v<ours> == std::is_trivially_move_constructible_v<theirs> &&
+           std::is_trivially_destructible_v<ours> == std::is_trivially_destructible_v<theirs> &&
+           (!std::is_trivially_copy_assignable_v<theirs> || std::is_trivially_copy_assignable_v<ours>) &&
+           (!std::is_trivially_move_assignable_v<theirs> || std::is_trivially_move_assignable_v<ours>);
+}
+
+struct TrivialPair {
+    int    a;
+    double b;
+};
+
+enum class Errc : unsigned char { failed = 1 };
+
+struct NonTrivialCopy {
+    NonTrivialCopy() = default;
+    NonTrivialCopy(const NonTrivialCopy &) {}
+};
+
+static_assert(std::is_trivially_copyable_v<backport::expected<int, int>>);
+static_assert(std::is_trivially_destructible_v<backport::expected<int, int>>);
+static_assert(std::is_trivially_copyable_v<backport::expected<void, int>>);
+static_assert(std::is_trivially_copyable_v<backport::expected<TrivialPair, Errc>>);
+static_assert(std::is_trivially_copyable_v<backport::expected<const char *, Errc>>);
+static_assert(!std::is_trivially_copyable_v<backport::expected<std::string, int>>);
+static_assert(!std::is_trivially_destructible_v<backport::expected<int, std::string>>);
+static_assert(!std::is_trivially_copy_constructible_v<backport::expected<NonTrivialCopy, int>>);
+static_assert(std::is_trivially_destructible_v<backport::expected<NonTrivialCopy, int>>);
+
+static_assert(same_triviality<int, int>());
+static_assert(same_triviality<void, int>());
+static_assert(same_triviality<TrivialPair, Errc>());
+static_assert(same_triviality<std::string, int>());
+static_assert(same_triviality<int, std::string>());
+static_assert(same_triviality<NonTrivialCopy, int>());
+static_assert(same_triviality<void, std::string>());
+
+// Same size: the discriminant is a single byte next to the union
+static_assert(sizeof(backport::expected<int, int>) == sizeof(std::expected<int, int>));
+static_assert(sizeof(backport::expected<TrivialPair, Errc>) == sizeof(std::expected<TrivialPair, Errc>));
+
+TEST_CASE("Trivially copyable expected can be relocated with memcpy") {
+    backport::expected<TrivialPair, Errc> source[2] = {TrivialPair{1, 2.5}, backport::unexpected<Errc>(Errc::failed)};
+    backport::expected<TrivialPair, Errc> target[2];
+    std::memcpy(static_cast<void *>(target), source, sizeof(source));
+
+    REQUIRE(target[0].has_value());
+    CHECK(target[0]->a == 1);
+    CHECK(target[0]->b == 2.5);
+    REQUIRE_FALSE(target[1].has_value());
+    CHECK(target[1].error() == Errc::failed);
+}
 
 TEST_CASE("Construction with value") {
     int                                  value = 42;
@@ -226,4 +288,100 @@ TEST_CASE("Self-assignment and swap") {
     CHECK(*e2 == 42);
     CHECK(!e3.has_value());
     CHECK(e3.error() == "error");
-}
\ No newline at end of file
+}
+
+// Counts the copies and moves made by the monadic operations. The callables below build their results from the int inside,
+// so every move counted is one the operation made itself.
+struct counted {
+    static inline int copies = 0;
+    static inline int moves  = 0;
+
+    int value;
+
+    explicit counted(int v) : value(v) {}
+    counted(const counted &other) : value(other.value) { ++copies; }
+    counted(counted &&other) noexcept : value(other.value) { ++moves; }
+    counted &operator=(const counted &other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    counted &operator=(counted &&other) noexcept {
+        value = other.value;
+        ++moves;
+        return *this;
+    }
+
+    static void reset() { moves = 0; }
+};
+
+// On an rvalue, each operation moves the value or error it passes on at most once and never copies it. A result built
+// from what the callable returns may be moved into place once (tl::expected) or constructed there directly (std::expected).
+template <template <typename, typename> class Expected, typename InPlace, typename Unexpect>
+void check_single_moves(InPlace in_place, Unexpect unexpect) {
+    using result = Expected<counted, counted>;
+
+    const auto step    = [in_place](counted &&c) { return result(in_place, c.value + 1); };
+    const auto twice   = [](counted &&c) { return counted(c.value * 2); };
+    const auto recover = [in_place](counted &&c) { return result(in_place, -c.value); };
+    const auto keep    = [unexpect](counted &&c) { return result(unexpect, std::move(c)); };
+    counted::copies    = 0;
+
+    // The passed-through alternative is moved exactly once
+    counted::reset();
+    auto error = result(unexpect, 1).and_then(step);
+    CHECK(error.error().value == 1);
+    CHECK(counted::moves == 1);
+
+    counted::reset();
+    auto value = result(in_place, 1).or_else(recover);
+    CHECK(value->value == 1);
+    CHECK(counted::moves == 1);
+
+    counted::reset();
+    CHECK(result(unexpect, 1).transform(twice).error().value == 1);
+    CHECK(counted::moves == 1);
+
+    counted::reset();
+    CHECK(result(in_place, 1).transform_error(twice)->value == 1);
+    CHECK(counted::moves == 1);
+
+    // The callable's result becomes the new alternative
+    counted::reset();
+    CHECK(result(in_place, 1).and_then(step)->value == 2);
+    CHECK(counted::moves == 0);
+
+    counted::reset();
+    CHECK(result(in_place, 1).transform(twice)->value == 2);
+    CHECK(counted::moves <= 1);
+
+    counted::reset();
+    CHECK(result(unexpect, 3).transform_error(twice).error().value == 6);
+    CHECK(counted::moves <= 1);
+
+    // A validation chain: one move per stage at most, on either path
+    counted::reset();
+    auto chained = result(in_place, 1).and_then(step).transform(twice).or_else(recover).transform_error(twice);
+    CHECK(chained->value == 4);
+    CHECK(counted::moves <= 4);
+
+    counted::reset();
+    auto failed = result(unexpect, 5).and_then(step).transform(twice).or_else(keep).transform_error(twice);
+    CHECK(failed.error().value == 10);
+    CHECK(counted::moves <= 4);
+
+    // void success: there is only the error to move
+    using done = Expected<void, counted>;
+    counted::reset();
+    auto skipped = done(unexpect, 7).and_then([] { return done(); }).transform([] { return 1; });
+    CHECK(skipped.error().value == 7);
+    CHECK(counted::moves == 2);
+    CHECK(counted::copies == 0);
+}
+
+TEST_CASE("Monadic operations move at most once on rvalues") {
+    check_single_moves<backport::expected>(backport::in_place, backport::unexpect);
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202211L
+    check_single_moves<std::expected>(std::in_place, std::unexpect);
+#endif
+}
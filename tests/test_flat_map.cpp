@@ -0,0 +1,200 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/flat_map.hpp>
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace backport;
+
+// Copies and moves succeed until the budget runs out, then throw
+struct fragile {
+    static inline int budget = -1;
+
+    int value;
+
+    fragile(int v) : value(v) {}
+    fragile(const fragile &other) : value(other.value) { spend(); }
+    fragile(fragile &&other) : value(other.value) { spend(); }
+    fragile &operator=(const fragile &other) {
+        spend();
+        value = other.value;
+        return *this;
+    }
+    fragile &operator=(fragile &&other) {
+        spend();
+        value = other.value;
+        return *this;
+    }
+
+    static void spend() {
+        if (budget == 0) throw std::runtime_error("fragile");
+        if (budget > 0) --budget;
+    }
+};
+
+TEST_CASE("Keys and values are stored separately and sorted together") {
+    flat_map<int, std::string> m({4, 1, 3, 1}, {"four", "one", "three", "uno"});
+    CHECK(m.size() == 3);
+    CHECK(m.keys() == std::vector<int>{1, 3, 4});
+    CHECK(m.values() == std::vector<std::string>{"one", "three", "four"}); // The first duplicate wins
+
+    auto [key, value] = *m.begin();
+    CHECK(key == 1);
+    CHECK(value == "one");
+    value = "ONE";
+    CHECK(m.at(1) == "ONE");
+    CHECK(m.begin()->second == "ONE");
+
+    // sorted_unique adopts the containers as they are
+    std::vector<int> keys{1, 2, 3};
+    const int       *data = keys.data();
+    flat_map<int, int> adopted(sorted_unique, std::move(keys), std::vector<int>{10, 20, 30});
+    CHECK(adopted.keys().data() == data);
+    CHECK(adopted[2] == 20);
+}
+
+TEST_CASE("Lookup agrees with std::map") {
+    std::mt19937            rng(11);
+    std::map<int, int>      reference;
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 500; ++i) {
+        int k = static_cast<int>(rng() % 1000);
+        entries.emplace_back(k, i);
+        reference.emplace(k, i);
+    }
+    flat_map<int, int> m(entries.begin(), entries.end());
+    REQUIRE(m.size() == reference.size());
+    CHECK(std::equal(m.begin(), m.end(), reference.begin(), reference.end(),
+                     [](auto a, const auto &b) { return a.first == b.first && a.second == b.second; }));
+
+    for (int probe = -1; probe <= 1001; ++probe) {
+        auto it = m.find(probe);
+        auto ref = reference.find(probe);
+        REQUIRE((it == m.end()) == (ref == reference.end()));
+        if (ref != reference.end()) REQUIRE(it->second == ref->second);
+        REQUIRE(m.lower_bound(probe) - m.begin() == std::distance(reference.begin(), reference.lower_bound(probe)));
+        REQUIRE(m.upper_bound(probe) - m.begin() == std::distance(reference.begin(), reference.upper_bound(probe)));
+    }
+}
+
+TEST_CASE("Element access and modifiers") {
+    flat_map<std::string, int> m;
+    m["b"] = 2;
+    m["a"] = 1;
+    ++m["b"];
+    CHECK(m.at("b") == 3);
+    CHECK_THROWS_AS(m.at("z"), std::out_of_range);
+
+    CHECK(m.insert({"c", 30}).second);
+    CHECK_FALSE(m.emplace("c", 31).second);
+    CHECK(m.at("c") == 30);
+    CHECK_FALSE(m.insert_or_assign("c", 32).second);
+    CHECK(m.at("c") == 32);
+
+    // try_emplace leaves its arguments alone when the key exists
+    flat_map<int, std::unique_ptr<int>> owners;
+    auto                                p = std::make_unique<int>(5);
+    CHECK(owners.try_emplace(1, std::move(p)).second);
+    auto q = std::make_unique<int>(6);
+    CHECK_FALSE(owners.try_emplace(1, std::move(q)).second);
+    CHECK(q != nullptr);
+
+    m.insert({{"e", 5}, {"d", 4}, {"a", 100}});
+    CHECK(m.keys() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+    CHECK(m.at("a") == 1);
+
+    // Sorted input is merged in, existing keys still win
+    flat_map<int, int> merged({1, 4, 6}, {10, 40, 60});
+    merged.insert(sorted_unique, {{0, 0}, {4, 400}, {5, 50}, {7, 70}});
+    CHECK(merged.keys() == std::vector<int>{0, 1, 4, 5, 6, 7});
+    CHECK(merged.values() == std::vector<int>{0, 10, 40, 50, 60, 70});
+    merged.insert(sorted_unique, {{8, 80}, {9, 90}});
+    CHECK(merged.keys().back() == 9);
+    CHECK(merged.values().back() == 90);
+
+    CHECK(m.erase("b") == 1);
+    auto next = m.erase(m.find("c"));
+    CHECK(next->first == "d");
+    CHECK(erase_if(m, [](const auto &entry) { return entry.second > 4; }) == 1);
+    CHECK(m.keys() == std::vector<std::string>{"a", "d"});
+    CHECK(m.values() == std::vector<int>{1, 4});
+
+    std::vector<std::string> reversed;
+    for (auto it = m.rbegin(); it != m.rend(); ++it) reversed.push_back(it->first);
+    CHECK(reversed == std::vector<std::string>{"d", "a"});
+}
+
+TEST_CASE("Heterogeneous lookup with a transparent comparator") {
+    flat_map<std::string, int, std::less<>> m{{"alpha", 1}, {"beta", 2}};
+    std::string_view                        key = "beta";
+    CHECK(m.contains(key));
+    CHECK(m.find(key)->second == 2);
+    CHECK(m.at(key) == 2);
+    CHECK(m.count(std::string_view("gamma")) == 0);
+    CHECK(m.erase(std::string_view("alpha")) == 1);
+    CHECK(m.size() == 1);
+}
+
+TEST_CASE("Containers, extract and comparisons") {
+    flat_map<int, double, std::greater<int>, std::deque<int>, std::deque<double>> d{{1, 1.5}, {3, 3.5}, {2, 2.5}};
+    CHECK(d.begin()->first == 3);
+    CHECK(d.keys() == std::deque<int>{3, 2, 1});
+
+    const flat_map<int, int> a{{1, 10}, {2, 20}};
+    flat_map<int, int>       b{{1, 10}, {2, 21}};
+    CHECK(a != b);
+    CHECK(a < b);
+    flat_map<int, int>::const_iterator it = b.begin();
+    CHECK(it == b.cbegin());
+    CHECK(a.find(2)->second == 20);
+
+    auto [keys, values] = std::move(b).extract();
+    CHECK(b.empty());
+    keys.push_back(7);
+    values.push_back(70);
+    b.replace(std::move(keys), std::move(values));
+    CHECK(b[7] == 70);
+}
+
+TEST_CASE("A bulk insert that throws leaves the map usable") {
+    const std::vector<std::pair<int, fragile>> unsorted{{5, 50}, {1, 10}, {3, 30}, {4, 400}};
+    const std::vector<std::pair<int, fragile>> sorted{{1, 10}, {3, 30}, {4, 400}, {5, 50}};
+
+    for (const auto *input : {&unsorted, &sorted}) {
+        for (int budget = 0;; ++budget) {
+            fragile::budget = -1;
+            flat_map<int, fragile> m;
+            m.try_emplace(2, 20);
+            m.try_emplace(4, 40);
+
+            fragile::budget = budget;
+            try {
+                if (input == &sorted) {
+                    m.insert(sorted_unique, input->begin(), input->end());
+                } else {
+                    m.insert(input->begin(), input->end());
+                }
+            } catch (const std::runtime_error &) {
+                fragile::budget = -1;
+                // Either untouched or cleared, never keys without values or an unsorted tail
+                REQUIRE(m.keys().size() == m.values().size());
+                CHECK((m.empty() || m.keys() == std::vector<int>{2, 4}));
+                for (auto [key, value] : m) CHECK(m.find(key)->second.value == value.value);
+                continue;
+            }
+            fragile::budget = -1;
+            CHECK(m.keys() == std::vector<int>{1, 2, 3, 4, 5});
+            CHECK(m.at(4).value == 40);
+            break;
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/flat_set.hpp>
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace backport;
+
+// Copies and moves succeed until the budget runs out, then throw
+struct fragile {
+    static inline int budget = -1;
+
+    int value;
+
+    fragile(int v) : value(v) {}
+    fragile(const fragile &other) : value(other.value) { spend(); }
+    fragile(fragile &&other) : value(other.value) { spend(); }
+    fragile &operator=(const fragile &other) {
+        spend();
+        value = other.value;
+        return *this;
+    }
+    fragile &operator=(fragile &&other) {
+        spend();
+        value = other.value;
+        return *this;
+    }
+
+    static void spend() {
+        if (budget == 0) throw std::runtime_error("fragile");
+        if (budget > 0) --budget;
+    }
+
+    friend bool operator<(const fragile &a, const fragile &b) { return a.value < b.value; }
+};
+
+TEST_CASE("Construction sorts and removes duplicates") {
+    flat_set<int> s{5, 1, 4, 1, 3, 5};
+    CHECK(s.size() == 4);
+    CHECK(std::is_sorted(s.begin(), s.end()));
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 3, 4, 5});
+
+    flat_set<int, std::greater<int>> descending(std::vector<int>{2, 9, 2, 7});
+    CHECK(std::vector<int>(descending.begin(), descending.end()) == std::vector<int>{9, 7, 2});
+
+    // Sorted input is taken over without sorting
+    std::vector<int> sorted{1, 2, 3, 5, 8};
+    const int       *data = sorted.data();
+    flat_set<int>    adopted(sorted_unique, std::move(sorted));
+    CHECK(adopted.size() == 5);
+    CHECK(&*adopted.begin() == data);
+}
+
+TEST_CASE("Branchless search matches the standard algorithms") {
+    std::mt19937     rng(7);
+    std::vector<int> keys;
+    for (int n = 0; n < 70; ++n) {
+        keys.clear();
+        for (int i = 0; i < n; ++i) keys.push_back(static_cast<int>(rng() % 200) * 2); // Even values only, odd probes miss
+        flat_set<int> s(keys);
+        std::vector<int> reference(s.begin(), s.end());
+
+        for (int probe = -1; probe <= 401; ++probe) {
+            auto lower = std::lower_bound(reference.begin(), reference.end(), probe) - reference.begin();
+            auto upper = std::upper_bound(reference.begin(), reference.end(), probe) - reference.begin();
+            REQUIRE(s.lower_bound(probe) - s.begin() == lower);
+            REQUIRE(s.upper_bound(probe) - s.begin() == upper);
+            REQUIRE(s.contains(probe) == std::binary_search(reference.begin(), reference.end(), probe));
+        }
+    }
+}
+
+TEST_CASE("Insert and erase keep the order") {
+    flat_set<std::string> s;
+    CHECK(s.insert("m").second);
+    CHECK(s.insert("c").second);
+    CHECK(s.emplace(3, 'z').second);
+    auto [it, inserted] = s.insert("c");
+    CHECK_FALSE(inserted);
+    CHECK(*it == "c");
+    CHECK(std::vector<std::string>(s.begin(), s.end()) == std::vector<std::string>{"c", "m", "zzz"});
+
+    // Bulk insert merges the new run, existing keys stay
+    s.insert({"a", "m", "b", "a"});
+    CHECK(std::vector<std::string>(s.begin(), s.end()) == std::vector<std::string>{"a", "b", "c", "m", "zzz"});
+    std::vector<std::string> more{"d", "e", "zzz"};
+    s.insert(sorted_unique, more.begin(), more.end());
+    CHECK(s.size() == 7);
+    CHECK(std::is_sorted(s.begin(), s.end()));
+
+    CHECK(s.erase("b") == 1);
+    CHECK(s.erase("b") == 0);
+    CHECK(*s.erase(s.find("c")) == "d");
+    CHECK(std::vector<std::string>(s.rbegin(), s.rend()) == std::vector<std::string>{"zzz", "m", "e", "d", "a"});
+
+    CHECK(erase_if(s, [](const std::string &k) { return k.size() > 1; }) == 1);
+    CHECK(s.size() == 4);
+}
+
+TEST_CASE("Heterogeneous lookup with a transparent comparator") {
+    flat_set<std::string, std::less<>> s{"beta", "alpha", "gamma"};
+    std::string_view                   key = "beta";
+    CHECK(s.contains(key));
+    CHECK(s.find(key) != s.end());
+    CHECK(s.count(std::string_view("delta")) == 0);
+    CHECK(*s.lower_bound("b") == "beta");
+    CHECK(s.insert(std::string_view("delta")).second);
+    CHECK(s.erase(std::string_view("alpha")) == 1);
+    CHECK(std::vector<std::string>(s.begin(), s.end()) == std::vector<std::string>{"beta", "delta", "gamma"});
+}
+
+TEST_CASE("Containers, extract and comparisons") {
+    flat_set<int, std::less<int>, std::deque<int>> d{3, 1, 2};
+    CHECK(*d.begin() == 1);
+
+    flat_set<int> a{1, 2, 3};
+    flat_set<int> b{1, 2, 4};
+    CHECK(a != b);
+    CHECK(a < b);
+    CHECK((b <=> a) > 0);
+
+    auto keys = std::move(a).extract();
+    CHECK(a.empty());
+    CHECK(keys == std::vector<int>{1, 2, 3});
+    keys.push_back(9);
+    a.replace(std::move(keys));
+    CHECK(a.contains(9));
+
+    swap(a, b);
+    CHECK(b.contains(9));
+}
+
+TEST_CASE("A bulk insert that throws leaves the set usable") {
+    const std::vector<fragile> unsorted{5, 1, 3, 4};
+    const std::vector<fragile> sorted{1, 3, 4, 5};
+
+    for (const auto *input : {&unsorted, &sorted}) {
+        for (int budget = 0;; ++budget) {
+            fragile::budget = -1;
+            flat_set<fragile> s{2, 4};
+
+            fragile::budget = budget;
+            try {
+                if (input == &sorted) {
+                    s.insert(sorted_unique, input->begin(), input->end());
+                } else {
+                    s.insert(input->begin(), input->end());
+                }
+            } catch (const std::runtime_error &) {
+                fragile::budget = -1;
+                // Either untouched or cleared, never an unsorted tail
+                CHECK((s.empty() || (s.size() == 2 && s.contains(2) && s.contains(4))));
+                continue;
+            }
+            fragile::budget = -1;
+            CHECK(s.size() == 5);
+            CHECK(std::is_sorted(s.begin(), s.end()));
+            break;
+        }
+    }
+}
@@ -0,0 +1,192 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/function_ref.hpp>
+#include <doctest/doctest.h>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+
+using namespace backport;
+
+// Count heap allocations, function_ref must never allocate
+static std::size_t allocation_count = 0;
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// Helper functions and types for tests
+int add(int a, int b) { return a + b; }
+
+int negate(int a) noexcept { return -a; }
+
+struct Accumulator {
+    int total = 0;
+
+    int add(int x) { return total += x; }
+    int peek() const { return total; }
+};
+
+struct ConstCallable {
+    int operator()(int x) const { return x * 10; }
+};
+
+// Runs the callback synchronously, the kind of call site function_ref is for
+int apply_twice(function_ref<int(int)> f, int x) { return f(f(x)); }
+
+static_assert(std::is_trivially_copyable_v<function_ref<int(int)>>);
+static_assert(std::is_trivially_copyable_v<function_ref<void() const noexcept>>);
+static_assert(sizeof(function_ref<int(int)>) == 2 * sizeof(void *));
+static_assert(!std::is_default_constructible_v<function_ref<int(int)>>);
+
+// Signatures are checked at compile time
+static_assert(std::is_constructible_v<function_ref<int(int, int)>, decltype(&add)>);
+static_assert(!std::is_constructible_v<function_ref<int(int)>, decltype(&add)>);
+static_assert(!std::is_constructible_v<function_ref<int(int) noexcept>, decltype(&add)>);
+static_assert(std::is_constructible_v<function_ref<int(int) noexcept>, decltype(&negate)>);
+
+TEST_CASE("Reference a free function") {
+    function_ref<int(int, int)> by_pointer = &add;
+    function_ref<int(int, int)> by_name    = add;
+
+    CHECK(by_pointer(2, 3) == 5);
+    CHECK(by_name(4, 5) == 9);
+
+    function_ref deduced = &add;
+    static_assert(std::is_same_v<decltype(deduced), function_ref<int(int, int)>>);
+    CHECK(deduced(1, 1) == 2);
+}
+
+TEST_CASE("Reference a lambda without copying it") {
+    int  calls  = 0;
+    auto lambda = [&calls](int x) {
+        ++calls;
+        return x + 1;
+    };
+
+    CHECK(apply_twice(lambda, 1) == 3);
+    CHECK(calls == 2);
+}
+
+TEST_CASE("Mutable state lives in the referenced object") {
+    Accumulator acc;
+    auto        adder = [&acc](int x) { return acc.add(x); };
+
+    function_ref<int(int)> ref = adder;
+    ref(2);
+    ref(3);
+    CHECK(acc.total == 5);
+}
+
+TEST_CASE("Const signatures only accept const-callable objects") {
+    struct NonConstOnly {
+        int operator()(int x) { return x; }
+    };
+
+    static_assert(std::is_constructible_v<function_ref<int(int) const>, ConstCallable &>);
+    static_assert(!std::is_constructible_v<function_ref<int(int) const>, NonConstOnly &>);
+    static_assert(std::is_constructible_v<function_ref<int(int)>, NonConstOnly &>);
+
+    ConstCallable                callable;
+    function_ref<int(int) const> ref = callable;
+    CHECK(ref(4) == 40);
+}
+
+TEST_CASE("Noexcept signatures produce noexcept calls") {
+    function_ref<int(int) noexcept> ref = negate;
+    static_assert(noexcept(ref(1)));
+    CHECK(ref(5) == -5);
+
+    function_ref<int(int)> throwing = ConstCallable{};
+    static_assert(!noexcept(throwing(1)));
+}
+
+TEST_CASE("Constant callables are called without a stored pointer") {
+    function_ref<int(int, int)> ref = nontype<&add>;
+    CHECK(ref(20, 22) == 42);
+
+    function_ref deduced = nontype<&negate>;
+    static_assert(std::is_same_v<decltype(deduced), function_ref<int(int) noexcept>>);
+    CHECK(deduced(3) == -3);
+}
+
+TEST_CASE("Constant member functions bound to an object") {
+    Accumulator acc;
+
+    function_ref<int(int)> by_ref = {nontype<&Accumulator::add>, acc};
+    by_ref(5);
+    by_ref(6);
+    CHECK(acc.total == 11);
+
+    function_ref<int()> by_pointer = {nontype<&Accumulator::peek>, &acc};
+    CHECK(by_pointer() == 11);
+
+    const Accumulator            &const_acc = acc;
+    function_ref<int() const> peek_const = {nontype<&Accumulator::peek>, const_acc};
+    CHECK(peek_const() == 11);
+}
+
+TEST_CASE("Copies refer to the same callable") {
+    int                    counter = 0;
+    auto                   inc     = [&counter]() { return ++counter; };
+    function_ref<int()>    first   = inc;
+    function_ref<int()>    second  = first;
+    CHECK(first() == 1);
+    CHECK(second() == 2);
+
+    auto                other = []() { return 100; };
+    function_ref<int()> third = other;
+    second                    = third;
+    CHECK(second() == 100);
+}
+
+TEST_CASE("Arguments are forwarded") {
+    function_ref<std::size_t(std::string &&)> consume = [](std::string &&s) {
+        std::string taken = std::move(s);
+        return taken.size();
+    };
+
+    std::string text = "hello";
+    CHECK(consume(std::move(text)) == 5);
+
+    function_ref<void(int &)> doubler = [](int &x) { x *= 2; };
+    int                       value   = 21;
+    doubler(value);
+    CHECK(value == 42);
+}
+
+TEST_CASE("Void return discards results") {
+    int                  calls = 0;
+    auto                 f     = [&calls]() { return ++calls; };
+    function_ref<void()> ref   = f;
+    ref();
+    CHECK(calls == 1);
+}
+
+TEST_CASE("No heap allocation") {
+    std::string captured = "this string is too long for any small buffer";
+    auto        lambda   = [captured](int x) { return static_cast<int>(captured.size()) + x; };
+
+    allocation_count = 0;
+    {
+        function_ref<int(int)> a = lambda;
+        function_ref<int(int)> b = a;
+        function_ref<int(int)> c = nontype<&negate>;
+        CHECK(b(1) == a(1));
+        CHECK(c(1) == -1);
+    }
+    CHECK(allocation_count == 0);
+}
+
+// Assigning from a temporary callable would leave a dangling reference
+static_assert(!std::is_assignable_v<function_ref<int(int)> &, ConstCallable>);
+static_assert(std::is_assignable_v<function_ref<int(int)> &, function_ref<int(int)>>);
@@ -0,0 +1,278 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/generator.hpp>
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace backport;
+
+namespace {
+
+std::size_t global_allocations = 0;
+
+struct counted {
+    static inline int copies = 0;
+    static inline int moves  = 0;
+
+    int value;
+
+    explicit counted(int v) : value(v) {}
+    counted(const counted &other) : value(other.value) { ++copies; }
+    counted(counted &&other) noexcept : value(other.value) { ++moves; }
+};
+
+// A bump arena, as a per-thread frame arena would be
+struct arena {
+    alignas(std::max_align_t) unsigned char buffer[1 << 16];
+    std::size_t used        = 0;
+    std::size_t allocations = 0;
+    std::size_t live        = 0;
+};
+
+template <typename T> struct arena_allocator {
+    using value_type = T;
+
+    arena *source;
+
+    explicit arena_allocator(arena &a) noexcept : source(&a) {}
+    template <typename U> arena_allocator(const arena_allocator<U> &other) noexcept : source(other.source) {}
+
+    T *allocate(std::size_t n) {
+        std::size_t offset = (source->used + alignof(T) - 1) & ~(alignof(T) - 1);
+        source->used       = offset + n * sizeof(T);
+        if (source->used > sizeof(source->buffer)) throw std::bad_alloc();
+        ++source->allocations;
+        ++source->live;
+        return reinterpret_cast<T *>(source->buffer + offset);
+    }
+    void deallocate(T *, std::size_t) noexcept { --source->live; }
+
+    template <typename U> bool operator==(const arena_allocator<U> &other) const noexcept { return source == other.source; }
+};
+
+generator<int> iota(int first, int last) {
+    for (int i = first; i < last; ++i) co_yield i;
+}
+
+// Reaching the bottom of a nest costs no stack only when the compiler turns symmetric transfer into a tail call, which
+// GCC does not do below -O2 or under ASan, so the nest is kept shallow enough for any build
+constexpr int deep_nest = 1000;
+
+generator<int> countdown(int n) {
+    if (n == 0) co_return;
+    co_yield n;
+    co_yield ranges::elements_of(countdown(n - 1));
+}
+
+// Records the stack depth each level of a nest is destroyed at, they are all the same when teardown does not recurse
+struct teardown_probe {
+    static inline std::uintptr_t shallowest = UINTPTR_MAX;
+    static inline std::uintptr_t deepest    = 0;
+
+#if defined(_MSC_VER)
+    __declspec(noinline) ~teardown_probe() {
+        const auto frame = reinterpret_cast<std::uintptr_t>(_AddressOfReturnAddress());
+#else
+    [[gnu::noinline]] ~teardown_probe() {
+        const auto frame = reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+#endif
+        shallowest = std::min(shallowest, frame);
+        deepest    = std::max(deepest, frame);
+    }
+};
+
+generator<int> probed_countdown(int n) {
+    teardown_probe probe;
+    if (n == 0) co_return;
+    co_yield n;
+    co_yield ranges::elements_of(probed_countdown(n - 1));
+}
+
+generator<const counted &> by_lvalue(const std::vector<counted> &items) {
+    for (const counted &item : items) co_yield item;
+}
+
+generator<counted &&> by_rvalue(int n) {
+    for (int i = 0; i < n; ++i) co_yield counted(i);
+    counted last(n);
+    co_yield last; // Copied, an lvalue cannot bind to counted &&
+}
+
+generator<int> failing(int after) {
+    for (int i = 0; i < after; ++i) co_yield i;
+    throw std::runtime_error("failing");
+}
+
+// GCC 12 at -O0 takes the allocator-argument frames for mismatched new/delete pairs, as in generator.hpp
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+generator<int> arena_iota(std::allocator_arg_t, arena_allocator<std::byte>, int n) {
+    for (int i = 0; i < n; ++i) co_yield i;
+}
+
+generator<int, void, arena_allocator<std::byte>> arena_nested(std::allocator_arg_t, arena_allocator<std::byte> alloc, int depth) {
+    co_yield depth;
+    if (depth > 0) co_yield ranges::elements_of(arena_nested(std::allocator_arg, alloc, depth - 1));
+}
+
+struct tree {
+    int               value;
+    std::vector<tree> children;
+
+    generator<const int &> walk(std::allocator_arg_t, std::allocator<int>) const {
+        co_yield value;
+        for (const tree &child : children) co_yield ranges::elements_of(child.walk(std::allocator_arg, {}));
+    }
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+} // namespace
+
+// GCC warns (-Wmismatched-new-delete) when it inlines only one side of a replacement new/delete pair and sees malloc()
+// matched with operator delete or operator new matched with free(), keeping both sides out of line avoids the false positive
+#if defined(__GNUC__)
+#define REPLACED_ALLOCATION [[gnu::noinline]]
+#else
+#define REPLACED_ALLOCATION
+#endif
+
+REPLACED_ALLOCATION void *operator new(std::size_t size) {
+    ++global_allocations;
+    if (void *p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+REPLACED_ALLOCATION void *operator new[](std::size_t size) { return operator new(size); }
+REPLACED_ALLOCATION void operator delete(void *p) noexcept { std::free(p); }
+REPLACED_ALLOCATION void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+REPLACED_ALLOCATION void operator delete[](void *p) noexcept { std::free(p); }
+REPLACED_ALLOCATION void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+TEST_CASE("A generator is an input view") {
+    static_assert(std::ranges::input_range<generator<int>>);
+    static_assert(std::ranges::view<generator<int>>);
+    static_assert(std::same_as<std::ranges::range_reference_t<generator<int>>, int &&>);
+    static_assert(std::same_as<std::ranges::range_reference_t<generator<const std::string &>>, const std::string &>);
+    static_assert(std::same_as<std::ranges::range_value_t<generator<std::string &, std::string_view>>, std::string_view>);
+
+    std::vector<int> values;
+    for (int v : iota(3, 7)) values.push_back(v);
+    CHECK(values == std::vector<int>{3, 4, 5, 6});
+
+    int sum = 0;
+    for (int v : iota(0, 10) | std::views::filter([](int v) { return v % 2 == 0; })) sum += v;
+    CHECK(sum == 20);
+
+    auto g  = iota(0, 3);
+    auto g2 = std::move(g);
+    CHECK(std::ranges::distance(g2) == 3);
+}
+
+TEST_CASE("Yielding a reference does not copy") {
+    std::vector<counted> items;
+    for (int i = 0; i < 4; ++i) items.emplace_back(i);
+    counted::copies = counted::moves = 0;
+
+    std::size_t i = 0;
+    for (const counted &item : by_lvalue(items)) CHECK(&item == &items[i++]);
+    CHECK(i == 4);
+    CHECK(counted::copies == 0);
+    CHECK(counted::moves == 0);
+
+    // A yielded temporary is referenced in place, the consumer moves it once if it wants to keep it
+    std::vector<int> kept;
+    for (counted &&item : by_rvalue(3)) kept.push_back(counted(std::move(item)).value);
+    CHECK(kept == std::vector<int>{0, 1, 2, 3});
+    CHECK(counted::copies == 1);
+    CHECK(counted::moves == 4);
+}
+
+TEST_CASE("elements_of yields from nested generators and ranges") {
+    std::vector<int> values;
+    for (int v : countdown(4)) values.push_back(v);
+    CHECK(values == std::vector<int>{4, 3, 2, 1});
+
+    // Each level is resumed directly, resuming does not slow down with depth
+    long long sum = 0;
+    for (int v : countdown(deep_nest)) sum += v;
+    CHECK(sum == static_cast<long long>(deep_nest) * (deep_nest + 1) / 2);
+
+    // Leaving a deep nest early tears it down innermost first, not recursively: a recursive teardown would destroy the
+    // innermost level at least a return address per level deeper than the root
+    int seen = 0;
+    for (int v : probed_countdown(deep_nest)) {
+        if (v == 1) break;
+        ++seen;
+    }
+    CHECK(seen == deep_nest - 1);
+    CHECK(teardown_probe::deepest - teardown_probe::shallowest < deep_nest * sizeof(void *) / 2);
+
+    auto flatten = [](std::vector<std::vector<int>> rows) -> generator<int &> {
+        for (auto &row : rows) co_yield ranges::elements_of(row);
+    };
+    values.clear();
+    for (int &v : flatten({{1, 2}, {}, {3}})) values.push_back(v);
+    CHECK(values == std::vector<int>{1, 2, 3});
+
+    tree t{1, {{2, {{3, {}}}}, {4, {}}}};
+    values.clear();
+    for (const int &v : t.walk(std::allocator_arg, {})) values.push_back(v);
+    CHECK(values == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("Exceptions from nested generators reach the consumer") {
+    auto outer = []() -> generator<int> {
+        co_yield -1;
+        bool caught = false;
+        try {
+            co_yield ranges::elements_of(failing(2));
+        } catch (const std::runtime_error &) {
+            caught = true;
+        }
+        if (caught) co_yield 100;
+        co_yield ranges::elements_of(failing(1));
+    };
+
+    std::vector<int> values;
+    CHECK_THROWS_AS(
+        [&] {
+            for (int v : outer()) values.push_back(v);
+        }(),
+        std::runtime_error);
+    CHECK(values == std::vector<int>{-1, 0, 1, 100, 0});
+}
+
+TEST_CASE("Frames come from the allocator passed with allocator_arg") {
+    arena       a;
+    std::size_t before = global_allocations;
+    int         sum    = 0;
+    for (int v : arena_iota(std::allocator_arg, arena_allocator<std::byte>(a), 5)) sum += v;
+    for (int v : arena_nested(std::allocator_arg, arena_allocator<std::byte>(a), 3)) sum += v;
+    CHECK(sum == 16);
+    CHECK(global_allocations == before);
+    CHECK(a.allocations == 5);
+    CHECK(a.live == 0);
+
+    // Without one, the default allocator is used
+    for (int v : iota(0, 1)) sum += v;
+    CHECK(global_allocations == before + 1);
+}
@@ -0,0 +1,136 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/hazard_pointer.hpp>
+#include <doctest/doctest.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::atomic<std::size_t> allocation_count{0};
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+static std::atomic<int> live{0};
+
+// Poisoned on destruction, a reader that sees the poison read a reclaimed object
+struct node : hazard_pointer_obj_base<node> {
+    int value;
+
+    explicit node(int v) : value(v) { ++live; }
+    ~node() {
+        value = -1;
+        --live;
+    }
+};
+
+static_assert(!std::is_copy_constructible_v<hazard_pointer>);
+static_assert(std::is_nothrow_move_constructible_v<hazard_pointer>);
+
+TEST_CASE("A protected object is reclaimed only after its protection is reset") {
+    std::atomic<node *> head{new node(1)};
+    hazard_pointer      hp = make_hazard_pointer();
+    REQUIRE_FALSE(hp.empty());
+
+    node *p = hp.protect(head);
+    CHECK(p->value == 1);
+    head.store(new node(2));
+    p->retire();
+
+    hazard_pointer_clean_up();
+    CHECK(live == 2);
+    CHECK(p->value == 1);
+
+    hp.reset_protection();
+    hazard_pointer_clean_up();
+    CHECK(live == 1);
+
+    head.load()->retire();
+    hazard_pointer_clean_up();
+    CHECK(live == 0);
+}
+
+TEST_CASE("try_protect fails and reports the new value when the source changed") {
+    node                a(1);
+    node                b(2);
+    std::atomic<node *> src{&b};
+    hazard_pointer      hp = make_hazard_pointer();
+
+    node *p = &a;
+    CHECK_FALSE(hp.try_protect(p, src));
+    CHECK(p == &b);
+    CHECK(hp.try_protect(p, src));
+
+    // Protection moves with the hazard pointer
+    hazard_pointer moved = std::move(hp);
+    CHECK(hp.empty());
+    CHECK_FALSE(moved.empty());
+    hazard_pointer other;
+    swap(moved, other);
+    CHECK(moved.empty());
+    CHECK_FALSE(other.empty());
+}
+
+struct counting_deleter {
+    int *count;
+
+    template <typename T> void operator()(T *p) const noexcept {
+        ++*count;
+        delete p;
+    }
+};
+
+struct counted : hazard_pointer_obj_base<counted, counting_deleter> {};
+
+TEST_CASE("Retired objects use their deleter and retiring does not allocate") {
+    int                    deleted = 0;
+    std::vector<counted *> objects;
+    for (int i = 0; i < 16; ++i) objects.push_back(new counted);
+
+    const std::size_t before = allocation_count;
+    for (counted *c : objects) c->retire(counting_deleter{&deleted});
+    CHECK(allocation_count == before);
+
+    hazard_pointer_clean_up();
+    CHECK(deleted == 16);
+}
+
+TEST_CASE("Readers never see a reclaimed object while a writer keeps replacing it") {
+    std::atomic<node *> shared{new node(0)};
+    std::atomic<bool>   done{false};
+    std::atomic<int>    bad{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            hazard_pointer hp = make_hazard_pointer();
+            while (!done.load(std::memory_order_relaxed)) {
+                const node *p = hp.protect(shared);
+                if (p->value < 0) ++bad;
+                hp.reset_protection();
+            }
+        });
+    }
+    for (int i = 1; i <= 20000; ++i) shared.exchange(new node(i))->retire();
+    done = true;
+    for (auto &t : readers) t.join();
+
+    CHECK(bad == 0);
+    shared.load()->retire();
+    hazard_pointer_clean_up();
+    CHECK(live == 0);
+}
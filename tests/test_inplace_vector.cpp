@@ -0,0 +1,188 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/inplace_vector.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::size_t allocation_count = 0;
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// The size is stored in the smallest type that can hold the capacity
+static_assert(sizeof(inplace_vector<std::uint8_t, 15>) == 16);
+static_assert(sizeof(inplace_vector<std::uint8_t, 255>) == 256);
+static_assert(sizeof(inplace_vector<std::uint32_t, 300>) == 1204);
+static_assert(sizeof(inplace_vector<std::uint64_t, 7>) == 64);
+
+// Trivially copyable elements make a trivially copyable container
+static_assert(std::is_trivially_copyable_v<inplace_vector<int, 8>>);
+static_assert(std::is_trivially_copyable_v<inplace_vector<std::array<std::byte, 6>, 4>>);
+static_assert(std::is_trivially_copyable_v<inplace_vector<std::string, 0>>);
+static_assert(!std::is_trivially_copyable_v<inplace_vector<std::string, 2>>);
+static_assert(std::is_nothrow_move_constructible_v<inplace_vector<std::string, 2>>);
+
+static_assert(inplace_vector<int, 5>::capacity() == 5);
+static_assert(inplace_vector<int, 5>::max_size() == 5);
+
+constexpr int constexpr_sum() {
+    inplace_vector<int, 4> v{1, 2};
+    v.push_back(3);
+    v.insert(v.begin(), 10);
+    auto copy = v;
+    copy.pop_back();
+    int sum = 0;
+    for (int x : copy) sum += x;
+    return sum;
+}
+static_assert(constexpr_sum() == 13);
+
+// Counts live instances, to check every element is destroyed exactly once
+struct tracked {
+    static inline int live = 0;
+
+    std::string value;
+
+    tracked(const char *v) : value(v) { ++live; }
+    tracked(const tracked &other) : value(other.value) { ++live; }
+    tracked(tracked &&other) noexcept : value(std::move(other.value)) { ++live; }
+    tracked &operator=(const tracked &) = default;
+    tracked &operator=(tracked &&)      = default;
+    ~tracked() { --live; }
+
+    friend bool operator==(const tracked &a, const tracked &b) { return a.value == b.value; }
+};
+
+TEST_CASE("Fallible and unchecked push_back") {
+    inplace_vector<int, 3> v;
+    CHECK(v.empty());
+    int *first = v.try_push_back(1);
+    REQUIRE(first != nullptr);
+    CHECK(*first == 1);
+    CHECK(v.try_emplace_back(2) == v.data() + 1);
+    v.unchecked_push_back(3);
+    CHECK(v.size() == 3);
+
+    // Full: the try_ members report it, the throwing ones throw bad_alloc as std::inplace_vector does
+    CHECK(v.try_push_back(4) == nullptr);
+    CHECK_THROWS_AS(v.push_back(4), std::bad_alloc);
+    CHECK_THROWS_AS(v.resize(4), std::bad_alloc);
+    CHECK_THROWS_AS(v.reserve(4), std::bad_alloc);
+    CHECK(v.size() == 3);
+    CHECK(v[2] == 3);
+
+    std::vector<int> source{7, 8, 9};
+    v.pop_back();
+    CHECK(*v.try_append_range(source) == 8);
+    CHECK(v.back() == 7);
+}
+
+TEST_CASE("Construction, assignment and element access") {
+    inplace_vector<std::string, 4> v(2, "x");
+    CHECK(v.size() == 2);
+    CHECK(v.at(1) == "x");
+    CHECK_THROWS_AS(v.at(2), std::out_of_range);
+
+    v = {"a", "b", "c"};
+    CHECK(v.front() == "a");
+    CHECK(v.back() == "c");
+    CHECK(std::string(v.rbegin()->c_str()) == "c");
+
+    std::vector<std::string> words{"one", "two", "three", "four", "five"};
+    CHECK_THROWS_AS((inplace_vector<std::string, 4>(words.begin(), words.end())), std::bad_alloc);
+    inplace_vector<std::string, 4> from_range(words.begin(), words.begin() + 4);
+    CHECK(from_range[3] == "four");
+
+    v.resize(4, "z");
+    CHECK(v[3] == "z");
+    v.resize(1);
+    CHECK(v.size() == 1);
+
+    inplace_vector<int, 0> none;
+    CHECK(none.try_push_back(1) == nullptr);
+    CHECK_THROWS_AS(none.push_back(1), std::bad_alloc);
+    CHECK(none.begin() == none.end());
+}
+
+TEST_CASE("Insert and erase") {
+    inplace_vector<int, 8> v{1, 2, 5};
+    CHECK(*v.insert(v.begin() + 2, 4) == 4);
+    CHECK(*v.emplace(v.begin() + 2, 3) == 3);
+    v.insert(v.begin(), 2, 0);
+    CHECK(v == inplace_vector<int, 8>{0, 0, 1, 2, 3, 4, 5});
+    CHECK_THROWS_AS(v.insert(v.end(), {6, 7}), std::bad_alloc);
+    CHECK(v.size() == 7);
+
+    CHECK(*v.erase(v.begin()) == 0);
+    CHECK(*v.erase(v.begin(), v.begin() + 2) == 2);
+    CHECK(v == inplace_vector<int, 8>{2, 3, 4, 5});
+    CHECK(erase(v, 3) == 1);
+    CHECK(erase_if(v, [](int x) { return x % 2 == 0; }) == 2);
+    CHECK(v == inplace_vector<int, 8>{5});
+
+    inplace_vector<int, 8> a{1, 2, 3};
+    inplace_vector<int, 8> b{1, 2, 4};
+    CHECK(a < b);
+    CHECK((b <=> a) > 0);
+}
+
+TEST_CASE("Non-trivial elements are constructed and destroyed exactly once") {
+    {
+        inplace_vector<tracked, 4> v;
+        v.emplace_back("a");
+        v.emplace_back("b");
+        CHECK(tracked::live == 2);
+
+        auto copy = v;
+        CHECK(tracked::live == 4);
+        CHECK(copy == v);
+
+        inplace_vector<tracked, 4> other{"x", "y", "z"};
+        other = v; // Shrinks
+        CHECK(tracked::live == 6);
+        other.emplace_back("c");
+        v = other; // Grows
+        CHECK(v.size() == 3);
+        CHECK(tracked::live == 8);
+
+        swap(copy, v);
+        CHECK(copy.size() == 3);
+        CHECK(v.size() == 2);
+        CHECK(copy[2].value == "c");
+
+        v.erase(v.begin());
+        v.clear();
+        CHECK(tracked::live == 6);
+    }
+    CHECK(tracked::live == 0);
+}
+
+TEST_CASE("Nothing allocates") {
+    allocation_count = 0;
+    inplace_vector<std::array<std::byte, 64>, 16> headers;
+    for (int i = 0; i < 20; ++i) headers.try_emplace_back();
+    auto copy = headers;
+    copy.erase(copy.begin(), copy.begin() + 8);
+    CHECK(headers.size() == 16);
+    CHECK(copy.size() == 8);
+    CHECK(allocation_count == 0);
+}
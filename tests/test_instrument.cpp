@@ -0,0 +1,81 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/copyable_function.hpp>
+#include <backport/move_only_function.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <memory>
+#include <string_view>
+
+using namespace backport;
+
+#if !defined(BACKPORT_INSTRUMENT)
+#error "this test must be built with BACKPORT_INSTRUMENT"
+#endif
+
+TEST_CASE("Inline and heap constructions are counted per function type") {
+    using small_fn = basic_move_only_function<int(), 24>;
+    reset_function_stats<small_fn>();
+
+    std::array<int, 16> big{};
+    big[0] = 3;
+
+    small_fn a = []() { return 1; };
+    small_fn b = [big]() { return big[0]; };
+    small_fn c(std::in_place_type<decltype([]() { return 2; })>);
+
+    const function_stats stats = get_function_stats<small_fn>();
+    CHECK(stats.inline_constructions == 2);
+    CHECK(stats.heap_constructions == 1);
+    CHECK(stats.heap_bytes == sizeof(big));
+    CHECK(stats.largest_callable == sizeof(big));
+}
+
+TEST_CASE("A larger buffer turns the heap fallback into an inline construction") {
+    using large_fn = basic_move_only_function<int(), 64>;
+    reset_function_stats<large_fn>();
+
+    std::array<int, 16> big{};
+    large_fn            f = [big]() { return big[0]; };
+
+    const function_stats stats = get_function_stats<large_fn>();
+    CHECK(stats.inline_constructions == 1);
+    CHECK(stats.heap_constructions == 0);
+    CHECK(stats.heap_bytes == 0);
+}
+
+TEST_CASE("Moves do not count as constructions") {
+    using fn = basic_move_only_function<void(int)>;
+    reset_function_stats<fn>();
+
+    fn a = [](int) {};
+    fn b = std::move(a);
+    swap(a, b);
+
+    CHECK(get_function_stats<fn>().inline_constructions == 1);
+}
+
+TEST_CASE("Allocator-aware construction reports the block size") {
+    using fn = basic_move_only_function<int()>;
+    reset_function_stats<fn>();
+
+    std::array<int, 16> big{};
+    fn                  f(std::allocator_arg, std::allocator<int>(), [big]() { return big[0]; });
+
+    const function_stats stats = get_function_stats<fn>();
+    CHECK(stats.heap_constructions == 1);
+    CHECK(stats.heap_bytes >= sizeof(big));
+}
+
+TEST_CASE("Every constructed function type can be listed") {
+    basic_copyable_function<long(long), 32> f = [](long x) { return x; };
+    CHECK(f(1) == 1);
+
+    bool found = false;
+    for_each_function_stats([&found](std::string_view name, const function_stats &stats) {
+        if (name.find("basic_copyable_function<long int(long int), 32") != std::string_view::npos ||
+            name.find("basic_copyable_function<long (long), 32") != std::string_view::npos) {
+            found = stats.inline_constructions >= 1;
+        }
+    });
+    CHECK(found);
+}
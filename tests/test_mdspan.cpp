@@ -0,0 +1,151 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/mdspan.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace backport;
+
+// m(i, j) before C++23, m[i, j] after
+#if defined(__cpp_multidimensional_subscript)
+#define AT(m, ...) m[__VA_ARGS__]
+#else
+#define AT(m, ...) m(__VA_ARGS__)
+#endif
+
+// Static extents cost nothing: the view is one pointer and the strides are constants
+static_assert(sizeof(mdspan<float, extents<std::size_t, 4, 8>>) == sizeof(float *));
+static_assert(sizeof(mdspan<float, extents<int, 2, 3, 4>, layout_left>) == sizeof(float *));
+static_assert(std::is_empty_v<extents<std::size_t, 4, 8>>);
+static_assert(sizeof(mdspan<float, extents<std::size_t, 4, dynamic_extent>>) == sizeof(float *) + sizeof(std::size_t));
+static_assert(std::is_trivially_copyable_v<mdspan<float, dextents<std::size_t, 2>>>);
+static_assert(layout_right::mapping<extents<int, 3, 4, 5>>().stride(0) == 20);
+
+constexpr int constexpr_trace() {
+    int                             data[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    mdspan<int, extents<int, 3, 3>> m(data);
+    int                             trace = 0;
+    for (int i = 0; i < 3; ++i) trace += AT(m, i, i);
+    return trace;
+}
+static_assert(constexpr_trace() == 15);
+
+TEST_CASE("Extents store only the dynamic sizes") {
+    using e = extents<int, 3, dynamic_extent, 5, dynamic_extent>;
+    static_assert(e::rank() == 4);
+    static_assert(e::rank_dynamic() == 2);
+    static_assert(e::static_extent(0) == 3);
+    static_assert(e::static_extent(1) == dynamic_extent);
+
+    e dynamic_only(4, 6);
+    CHECK(dynamic_only.extent(0) == 3);
+    CHECK(dynamic_only.extent(1) == 4);
+    CHECK(dynamic_only.extent(3) == 6);
+    e all(3, 4, 5, 6);
+    CHECK(all == dynamic_only);
+    CHECK(e(std::array<int, 2>{4, 7}) != dynamic_only);
+
+    dextents<std::size_t, 4> widened = dynamic_only;
+    CHECK(widened == dynamic_only);
+    CHECK(widened.extent(2) == 5);
+    static_assert(std::is_same_v<dims<2>, extents<std::size_t, dynamic_extent, dynamic_extent>>);
+    static_assert(std::is_same_v<decltype(extents(2, 3)), dims<2>>);
+}
+
+TEST_CASE("Layouts map indices the way their names say") {
+    extents<int, 2, 3, 4> e;
+    layout_right::mapping<decltype(e)> right(e);
+    layout_left::mapping<decltype(e)>  left(e);
+    CHECK(right(1, 2, 3) == 1 * 12 + 2 * 4 + 3);
+    CHECK(left(1, 2, 3) == 1 + 2 * 2 + 3 * 6);
+    CHECK(right.stride(0) == 12);
+    CHECK(left.stride(2) == 6);
+    CHECK(right.required_span_size() == 24);
+
+    // A 3x4 window of a buffer with rows 10 apart
+    layout_stride::mapping<dextents<int, 2>> strided(dextents<int, 2>(3, 4), std::array<int, 2>{10, 1});
+    CHECK(strided(2, 3) == 23);
+    CHECK(strided.required_span_size() == 24);
+    CHECK_FALSE(strided.is_exhaustive());
+    CHECK(layout_stride::mapping<decltype(e)>(right) == right);
+    CHECK(layout_stride::mapping<decltype(e)>(right).is_exhaustive());
+}
+
+TEST_CASE("mdspan views existing storage") {
+    std::vector<int> data(12);
+    std::iota(data.begin(), data.end(), 0);
+
+    mdspan m(data.data(), 3, 4);
+    static_assert(std::is_same_v<decltype(m), mdspan<int, dims<2>>>);
+    CHECK(m.size() == 12);
+    CHECK(m.extent(1) == 4);
+    CHECK(AT(m, 1, 2) == 6);
+    CHECK(m[std::array{2, 3}] == 11);
+    AT(m, 0, 0) = 42;
+    CHECK(data[0] == 42);
+
+    mdspan<const int, extents<std::size_t, 3, 4>, layout_left> column_major(data.data());
+    CHECK(AT(column_major, 1, 2) == 7);
+    CHECK(column_major.stride(1) == 3);
+
+    mdspan<const int, dims<2>> readonly = m;
+    CHECK(AT(readonly, 2, 1) == 9);
+    CHECK_FALSE(readonly.empty());
+    CHECK(mdspan<int, dims<2>>(data.data(), 0, 4).empty());
+
+    int    buffer[5] = {5, 4, 3, 2, 1};
+    mdspan flat(buffer);
+    static_assert(decltype(flat)::static_extent(0) == 5);
+    CHECK(flat[4] == 1);
+}
+
+TEST_CASE("submdspan keeps contiguous layouts and static extents") {
+    std::vector<int> data(24);
+    std::iota(data.begin(), data.end(), 0);
+    mdspan<int, extents<std::size_t, 2, 3, 4>> cube(data.data());
+
+    // A row of a row-major array stays row-major, with its static extent
+    auto row = submdspan(cube, 1, 2, full_extent);
+    static_assert(std::is_same_v<decltype(row), mdspan<int, extents<std::size_t, 4>>>);
+    CHECK(row.data_handle() == data.data() + 20);
+    CHECK(row[3] == 23);
+
+    auto plane = submdspan(cube, 1, full_extent, full_extent);
+    static_assert(std::is_same_v<decltype(plane)::layout_type, layout_right>);
+    CHECK(AT(plane, 2, 1) == 21);
+
+    auto rows = submdspan(cube, 0, std::pair{1, 3}, full_extent);
+    static_assert(std::is_same_v<decltype(rows)::layout_type, layout_right>);
+    CHECK(rows.extent(0) == 2);
+    CHECK(AT(rows, 1, 0) == 8);
+
+    // A column is strided
+    auto column = submdspan(cube, 0, full_extent, 1);
+    static_assert(std::is_same_v<decltype(column)::layout_type, layout_stride>);
+    CHECK(column.stride(0) == 4);
+    CHECK(column[2] == 9);
+
+    auto every_other = submdspan(cube, 1, full_extent, strided_slice{1, 3, 2});
+    CHECK(every_other.extent(1) == 2);
+    CHECK(every_other.stride(1) == 2);
+    CHECK(AT(every_other, 2, 1) == 23);
+
+    // Compile-time bounds give a static extent
+    using one   = std::integral_constant<std::size_t, 1>;
+    using three = std::integral_constant<std::size_t, 3>;
+    auto middle = submdspan(cube, full_extent, std::pair{one{}, three{}}, 0);
+    static_assert(decltype(middle)::static_extent(1) == 2);
+    CHECK(AT(middle, 1, 1) == 20);
+
+    auto sub_extents = submdspan_extents(cube.extents(), 0, full_extent, std::pair{1, 4});
+    CHECK(sub_extents == extents<std::size_t, 3, dynamic_extent>(3));
+
+    mdspan<int, extents<std::size_t, 4, 6>, layout_left> column_major(data.data());
+    auto                                                 first_columns = submdspan(column_major, full_extent, std::pair{0, 2});
+    static_assert(std::is_same_v<decltype(first_columns)::layout_type, layout_left>);
+    CHECK(AT(first_columns, 3, 1) == 7);
+}
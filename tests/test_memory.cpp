@@ -0,0 +1,121 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/memory.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace backport;
+
+// A record as it sits in a capture file
+struct record_header {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t count;
+};
+
+struct not_implicit_lifetime {
+    not_implicit_lifetime() {}
+    not_implicit_lifetime(const not_implicit_lifetime &) {}
+    ~not_implicit_lifetime() {}
+};
+
+static_assert(detail::is_implicit_lifetime_v<record_header>);
+static_assert(detail::is_implicit_lifetime_v<int[4]>);
+static_assert(!detail::is_implicit_lifetime_v<not_implicit_lifetime>);
+static_assert(std::is_same_v<decltype(start_lifetime_as<int>(std::declval<const void *>())), const int *>);
+static_assert(std::is_same_v<decltype(view_as<int>(std::span<std::byte>())), expected<int *, view_error>>);
+static_assert(std::is_same_v<decltype(view_as<int>(std::declval<const std::vector<std::byte> &>())), expected<const int *, view_error>>);
+
+TEST_CASE("start_lifetime_as keeps the bytes that are already there") {
+    alignas(record_header) std::byte buffer[sizeof(record_header)];
+    const record_header              written{0xC0FFEEu, 2, 7};
+    std::memcpy(buffer, &written, sizeof(written));
+
+    record_header *h = start_lifetime_as<record_header>(buffer);
+    CHECK(static_cast<void *>(h) == buffer);
+    CHECK(h->magic == 0xC0FFEEu);
+    CHECK(h->version == 2);
+    CHECK(h->count == 7);
+
+    const std::byte     *read_only = buffer;
+    const record_header *c         = start_lifetime_as<record_header>(read_only);
+    CHECK(c->count == 7);
+
+    alignas(std::uint32_t) std::byte words[3 * sizeof(std::uint32_t)];
+    const std::uint32_t              values[3] = {1, 2, 3};
+    std::memcpy(words, values, sizeof(values));
+    const std::uint32_t *array = start_lifetime_as_array<std::uint32_t>(static_cast<const void *>(words), 3);
+    CHECK(array[0] + array[1] + array[2] == 6);
+    CHECK(start_lifetime_as_array<std::uint32_t>(words, 0) == static_cast<void *>(words));
+}
+
+TEST_CASE("view_as checks the size and alignment before viewing") {
+    alignas(record_header) std::array<std::byte, 2 * sizeof(record_header) + 1> buffer{};
+    const record_header                                                        written{1, 2, 3};
+    std::memcpy(buffer.data(), &written, sizeof(written));
+    const std::span<const std::byte> bytes(buffer);
+
+    auto header = view_as<record_header>(bytes);
+    REQUIRE(header.has_value());
+    CHECK((*header)->count == 3);
+
+    CHECK(view_as<record_header>(bytes.first(sizeof(record_header) - 1)).error() == view_error::too_small);
+    CHECK(view_as<record_header>(bytes.subspan(1)).error() == view_error::misaligned);
+    CHECK(view_as<record_header>(std::span<const std::byte>()).error() == view_error::too_small);
+
+    // Writable bytes give a writable view
+    auto writable = view_as<record_header>(std::span<std::byte>(buffer));
+    REQUIRE(writable.has_value());
+    (*writable)->count = 9;
+    CHECK((*view_as<record_header>(bytes))->count == 9);
+}
+
+TEST_CASE("view_as_array views count elements or reports why it cannot") {
+    alignas(std::uint32_t) std::array<std::byte, 4 * sizeof(std::uint32_t)> buffer{};
+    const std::uint32_t                                                     values[4] = {10, 20, 30, 40};
+    std::memcpy(buffer.data(), values, sizeof(values));
+    const std::span<const std::byte> bytes(buffer);
+
+    auto all = view_as_array<std::uint32_t>(bytes, 4);
+    REQUIRE(all.has_value());
+    CHECK(all->size() == 4);
+    CHECK((*all)[3] == 40);
+
+    CHECK(view_as_array<std::uint32_t>(bytes, 0).has_value());
+    CHECK(view_as_array<std::uint32_t>(bytes, 5).error() == view_error::too_small);
+    CHECK(view_as_array<std::uint32_t>(bytes.subspan(2), 1).error() == view_error::misaligned);
+    // A count whose byte size overflows is too small, not a wrapped-around success
+    CHECK(view_as_array<std::uint32_t>(bytes, SIZE_MAX / 2).error() == view_error::too_small);
+
+    auto writable = view_as_array<std::uint32_t>(std::span<std::byte>(buffer), 2);
+    REQUIRE(writable.has_value());
+    (*writable)[1] = 21;
+    CHECK((*view_as_array<std::uint32_t>(bytes, 2))[1] == 21);
+}
+
+TEST_CASE("view_as and view_as_array take whole byte containers") {
+    const record_header records[2] = {{1, 2, 3}, {4, 5, 6}};
+
+    std::vector<std::byte> vector(sizeof(records));
+    std::memcpy(vector.data(), records, sizeof(records));
+
+    auto header = view_as<record_header>(vector);
+    REQUIRE(header.has_value());
+    (*header)->count = 7;
+    CHECK(view_as<record_header>(std::as_const(vector)).value()->count == 7);
+
+    alignas(record_header) std::array<std::byte, sizeof(records)> array{};
+    std::memcpy(array.data(), records, sizeof(records));
+
+    auto all = view_as_array<record_header>(array, 2);
+    REQUIRE(all.has_value());
+    (*all)[1].version = 8;
+    CHECK(view_as_array<record_header>(std::as_const(array), 2).value()[1].version == 8);
+    CHECK(view_as_array<record_header>(array, 3).error() == view_error::too_small);
+}
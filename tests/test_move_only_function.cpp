@@ -2,6 +2,7 @@
 #include <backport/move_only_function.hpp>
 #include <doctest/doctest.h>
 #include <functional>
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <utility>
@@ -258,4 +259,258 @@ TEST_CASE("Complex return types") {
 
     CHECK(*custom_result == 42);
     CHECK(*std_result == 42);
-}
\ No newline at end of file
+}
+// Qualified signatures: the custom implementation should accept and reject exactly what std::move_only_function does
+template <typename Signature> constexpr bool same_call_traits() {
+    using custom = move_only_function<Signature>;
+    using std_fn = std::move_only_function<Signature>;
+    return std::is_invocable_v<custom &> == std::is_invocable_v<std_fn &> &&
+           std::is_invocable_v<custom &&> == std::is_invocable_v<std_fn &&> &&
+           std::is_invocable_v<const custom &> == std::is_invocable_v<const std_fn &> &&
+           std::is_invocable_v<const custom &&> == std::is_invocable_v<const std_fn &&> &&
+           std::is_nothrow_invocable_v<custom &> == std::is_nothrow_invocable_v<std_fn &> &&
+           std::is_nothrow_invocable_v<const custom &> == std::is_nothrow_invocable_v<const std_fn &>;
+}
+
+static_assert(same_call_traits<int()>());
+static_assert(same_call_traits<int() const>());
+static_assert(same_call_traits<int() &>());
+static_assert(same_call_traits<int() const &>());
+static_assert(same_call_traits<int() &&>());
+static_assert(same_call_traits<int() const &&>());
+static_assert(same_call_traits<int() noexcept>());
+static_assert(same_call_traits<int() const noexcept>());
+static_assert(same_call_traits<int() & noexcept>());
+static_assert(same_call_traits<int() const & noexcept>());
+static_assert(same_call_traits<int() && noexcept>());
+static_assert(same_call_traits<int() const && noexcept>());
+
+// Reports which qualified overload was called
+struct QualifiedCallable {
+    int operator()() & { return 1; }
+    int operator()() const & { return 2; }
+    int operator()() && { return 3; }
+    int operator()() const && { return 4; }
+};
+
+struct NonConstCallable {
+    int operator()() { return 0; }
+};
+
+struct LvalueOnlyCallable {
+    int operator()() & { return 0; }
+};
+
+struct ThrowingCallable {
+    int operator()() const { return 0; }
+};
+
+struct NothrowCallable {
+    int operator()() const noexcept { return 0; }
+};
+
+template <typename Signature, typename F> constexpr bool same_constructible() {
+    return std::is_constructible_v<move_only_function<Signature>, F> == std::is_constructible_v<std::move_only_function<Signature>, F>;
+}
+
+static_assert(same_constructible<int() const, NonConstCallable>());
+static_assert(!std::is_constructible_v<move_only_function<int() const>, NonConstCallable>);
+static_assert(same_constructible<int() &&, LvalueOnlyCallable>());
+static_assert(!std::is_constructible_v<move_only_function<int() &&>, LvalueOnlyCallable>);
+static_assert(same_constructible<int(), LvalueOnlyCallable>());
+static_assert(same_constructible<int() noexcept, ThrowingCallable>());
+static_assert(!std::is_constructible_v<move_only_function<int() noexcept>, ThrowingCallable>);
+static_assert(std::is_constructible_v<move_only_function<int() noexcept>, NothrowCallable>);
+
+TEST_CASE("Qualified signatures invoke the matching overload") {
+    move_only_function<int()>                custom_plain     = QualifiedCallable{};
+    move_only_function<int() const>          custom_const     = QualifiedCallable{};
+    move_only_function<int() &>              custom_lvalue    = QualifiedCallable{};
+    move_only_function<int() const &>        custom_const_ref = QualifiedCallable{};
+    move_only_function<int() &&>             custom_rvalue    = QualifiedCallable{};
+    move_only_function<int() const &&>       custom_const_rv  = QualifiedCallable{};
+    std::move_only_function<int()>           std_plain        = QualifiedCallable{};
+    std::move_only_function<int() const>     std_const        = QualifiedCallable{};
+    std::move_only_function<int() &>         std_lvalue       = QualifiedCallable{};
+    std::move_only_function<int() const &>   std_const_ref    = QualifiedCallable{};
+    std::move_only_function<int() &&>        std_rvalue       = QualifiedCallable{};
+    std::move_only_function<int() const &&>  std_const_rv     = QualifiedCallable{};
+
+    CHECK(custom_plain() == std_plain());
+    CHECK(std::move(custom_plain)() == std::move(std_plain)());
+    CHECK(custom_const() == std_const());
+    CHECK(std::as_const(custom_const)() == std::as_const(std_const)());
+    CHECK(custom_lvalue() == std_lvalue());
+    CHECK(custom_const_ref() == std_const_ref());
+    CHECK(std::move(custom_rvalue)() == std::move(std_rvalue)());
+    CHECK(std::move(std::as_const(custom_const_rv))() == std::move(std::as_const(std_const_rv))());
+
+    CHECK(custom_plain() == 1);
+    CHECK(std::as_const(custom_const)() == 2);
+    CHECK(std::move(custom_rvalue)() == 3);
+    CHECK(std::move(std::as_const(custom_const_rv))() == 4);
+}
+
+TEST_CASE("Noexcept signatures") {
+    int                                      calls       = 0;
+    move_only_function<void() noexcept>      custom_func = [&calls]() noexcept { ++calls; };
+    std::move_only_function<void() noexcept> std_func    = [&calls]() noexcept { ++calls; };
+
+    static_assert(noexcept(custom_func()));
+    static_assert(noexcept(std_func()));
+
+    custom_func();
+    std_func();
+    CHECK(calls == 2);
+
+    move_only_function<int(int) const noexcept> custom_const = [](int x) noexcept { return x + 1; };
+    static_assert(noexcept(std::as_const(custom_const)(1)));
+    CHECK(std::as_const(custom_const)(1) == 2);
+
+    move_only_function<int()> throwing = []() { return 0; };
+    static_assert(!noexcept(throwing()));
+}
+
+TEST_CASE("Rvalue-qualified signatures can consume their state") {
+    move_only_function<std::unique_ptr<int>() &&>      custom_func = [p = std::make_unique<int>(7)]() mutable { return std::move(p); };
+    std::move_only_function<std::unique_ptr<int>() &&> std_func    = [p = std::make_unique<int>(7)]() mutable { return std::move(p); };
+
+    auto custom_result = std::move(custom_func)();
+    auto std_result    = std::move(std_func)();
+    CHECK(*custom_result == 7);
+    CHECK(*std_result == 7);
+}
+
+TEST_CASE("Qualified signatures move and swap") {
+    move_only_function<int() const noexcept> a = NothrowCallable{};
+    move_only_function<int() const noexcept> b = []() noexcept { return 5; };
+
+    swap(a, b);
+    CHECK(a() == 5);
+    CHECK(b() == 0);
+
+    move_only_function<int() const noexcept> c = std::move(a);
+    CHECK_FALSE(a);
+    CHECK(c() == 5);
+
+    c = nullptr;
+    CHECK_FALSE(c);
+}
+
+// Counts moves and copies, to show in-place construction skips the temporary
+struct CountingFunctor {
+    static inline int moves  = 0;
+    static inline int copies = 0;
+
+    int base;
+    int sum = 0;
+
+    CountingFunctor(int b) : base(b) {}
+    CountingFunctor(std::initializer_list<int> values, int b) : base(b) {
+        for (int v : values) sum += v;
+    }
+    CountingFunctor(const CountingFunctor &other) : base(other.base), sum(other.sum) { ++copies; }
+    CountingFunctor(CountingFunctor &&other) noexcept : base(other.base), sum(other.sum) { ++moves; }
+
+    int operator()(int x) const { return base + sum + x; }
+};
+
+// Neither copyable nor movable, only in-place construction can store it
+struct Pinned {
+    int value;
+
+    explicit Pinned(int v) : value(v) {}
+    Pinned(Pinned &&) = delete;
+
+    int operator()(int x) const { return value * x; }
+};
+
+TEST_CASE("In-place construction") {
+    CountingFunctor::moves  = 0;
+    CountingFunctor::copies = 0;
+
+    move_only_function<int(int)>      custom_func(std::in_place_type<CountingFunctor>, 10);
+    std::move_only_function<int(int)> std_func(std::in_place_type<CountingFunctor>, 10);
+
+    CHECK(custom_func(1) == 11);
+    CHECK(std_func(1) == 11);
+    CHECK(CountingFunctor::moves == 0);
+    CHECK(CountingFunctor::copies == 0);
+}
+
+TEST_CASE("In-place construction with an initializer list") {
+    CountingFunctor::moves  = 0;
+    CountingFunctor::copies = 0;
+
+    move_only_function<int(int)>      custom_func(std::in_place_type<CountingFunctor>, {1, 2, 3}, 100);
+    std::move_only_function<int(int)> std_func(std::in_place_type<CountingFunctor>, {1, 2, 3}, 100);
+
+    CHECK(custom_func(0) == 106);
+    CHECK(std_func(0) == 106);
+    CHECK(CountingFunctor::moves == 0);
+    CHECK(CountingFunctor::copies == 0);
+}
+
+TEST_CASE("In-place construction of a non-movable callable") {
+    static_assert(!std::is_constructible_v<move_only_function<int(int)>, Pinned>);
+    static_assert(std::is_constructible_v<move_only_function<int(int)>, std::in_place_type_t<Pinned>, int>);
+    static_assert(!std::is_convertible_v<std::in_place_type_t<Pinned>, move_only_function<int(int)>>);
+
+    move_only_function<int(int)>      custom_func(std::in_place_type<Pinned>, 6);
+    std::move_only_function<int(int)> std_func(std::in_place_type<Pinned>, 6);
+    CHECK(custom_func(7) == 42);
+    CHECK(std_func(7) == 42);
+
+    // The callable is on the heap, so the wrapper itself still moves
+    move_only_function<int(int)> moved = std::move(custom_func);
+    CHECK(moved(2) == 12);
+}
+
+// The inline storage trait also answers for std::move_only_function, with a best guess of the standard library's buffer
+struct ThreePointers {
+    void *a, *b, *c;
+    void  operator()() const {}
+};
+
+struct FourPointers {
+    void *a, *b, *c, *d;
+    void  operator()() const {}
+};
+
+static_assert(stores_inline_v<move_only_function<void()>, void (*)()>);
+static_assert(!stores_inline_v<move_only_function<void()>, FourPointers>);
+static_assert(stores_inline_v<std::move_only_function<void()>, void (*)()>);
+static_assert(!stores_inline_v<std::move_only_function<void()>, FourPointers>);
+#if defined(__GLIBCXX__)
+static_assert(stores_inline_v<std::move_only_function<void()>, ThreePointers>);
+static_assert(function_inline_storage<std::move_only_function<void()>>::capacity == 3 * sizeof(void *));
+#endif
+
+TEST_CASE("Pointers to members are invoked through objects, pointers and reference_wrapper") {
+    struct Counter {
+        int value = 1;
+        int add(int x) const { return value + x; }
+        int take() && { return value * 10; }
+    };
+
+    Counter                                                       counter;
+    move_only_function<int(const Counter &, int)>                 add        = &Counter::add;
+    move_only_function<int(Counter *, int)>                       add_ptr    = &Counter::add;
+    move_only_function<int(std::unique_ptr<Counter> &, int)>      add_unique = &Counter::add;
+    move_only_function<int(std::reference_wrapper<Counter>, int)> add_ref    = &Counter::add;
+    CHECK(add(counter, 2) == 3);
+    CHECK(add_ptr(&counter, 3) == 4);
+    auto owned = std::make_unique<Counter>();
+    CHECK(add_unique(owned, 4) == 5);
+    CHECK(add_ref(std::ref(counter), 5) == 6);
+
+    // A data member gives access to the member itself, with the object's value category
+    move_only_function<int &(Counter &)> value = &Counter::value;
+    value(counter)                             = 5;
+    CHECK(counter.value == 5);
+    static_assert(std::is_same_v<decltype(detail::invoke(&Counter::value, std::move(counter))), int &&>);
+    static_assert(std::is_same_v<decltype(detail::invoke(&Counter::value, std::cref(counter))), const int &>);
+
+    move_only_function<int(Counter &&)> take = &Counter::take;
+    CHECK(take(Counter{}) == 10);
+}
@@ -0,0 +1,118 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/out_ptr.hpp>
+#include <doctest/doctest.h>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+
+using namespace backport;
+
+// A C library handing out resources through T ** and void **
+extern "C" {
+struct widget {
+    int value;
+};
+
+static int widgets_alive = 0;
+
+static int widget_create(int value, widget **out) {
+    if (value < 0) {
+        *out = nullptr; // Failure, nothing to adopt
+        return -1;
+    }
+    *out = static_cast<widget *>(std::malloc(sizeof(widget)));
+    (*out)->value = value;
+    ++widgets_alive;
+    return 0;
+}
+
+static void widget_destroy(widget *w) {
+    if (w != nullptr) --widgets_alive;
+    std::free(w);
+}
+
+// Frees the widget passed in and replaces it with a new one
+static int widget_grow(widget **inout) {
+    const int value = *inout != nullptr ? (*inout)->value + 1 : 0;
+    widget_destroy(*inout);
+    return widget_create(value, inout);
+}
+
+static int widget_create_opaque(void **out) { return widget_create(7, reinterpret_cast<widget **>(out)); }
+}
+
+struct widget_deleter {
+    void operator()(widget *w) const noexcept { widget_destroy(w); }
+};
+
+using widget_ptr = std::unique_ptr<widget, widget_deleter>;
+
+// Stateless deleter: written in place, no temporary, on the standard libraries whose unique_ptr layout is known
+static_assert(detail::writes_in_place<widget_ptr, widget *> == static_cast<bool>(BACKPORT_UNIQUE_PTR_IS_ITS_POINTER));
+static_assert(!detail::writes_in_place<std::unique_ptr<widget, void (*)(widget *)>, widget *>);
+static_assert(std::is_same_v<decltype(out_ptr(std::declval<widget_ptr &>())), out_ptr_t<widget_ptr, widget *>>);
+
+TEST_CASE("out_ptr hands the created resource to the smart pointer") {
+    widget_ptr w;
+    CHECK(widget_create(3, out_ptr(w)) == 0);
+    REQUIRE(w);
+    CHECK(w->value == 3);
+
+    // Resetting releases the old widget, a failing call leaves the pointer empty
+    CHECK(widget_create(-1, out_ptr(w)) == -1);
+    CHECK_FALSE(w);
+    CHECK(widgets_alive == 0);
+
+    CHECK(widget_create_opaque(out_ptr(w)) == 0);
+    REQUIRE(w);
+    CHECK(w->value == 7);
+    w.reset();
+    CHECK(widgets_alive == 0);
+}
+
+TEST_CASE("inout_ptr passes the current resource and adopts its replacement") {
+    widget_ptr w;
+    CHECK(widget_grow(inout_ptr(w)) == 0);
+    REQUIRE(w);
+    CHECK(w->value == 0);
+    CHECK(widget_grow(inout_ptr(w)) == 0);
+    CHECK(w->value == 1);
+    CHECK(widgets_alive == 1);
+
+    // A deleter with state goes through a temporary and reset()
+    std::unique_ptr<widget, void (*)(widget *)> stateful(nullptr, &widget_destroy);
+    CHECK(widget_grow(inout_ptr(stateful)) == 0);
+    CHECK(widget_grow(inout_ptr(stateful)) == 0);
+    CHECK(stateful->value == 1);
+    CHECK(widgets_alive == 2);
+
+    widget *raw = nullptr;
+    CHECK(widget_grow(inout_ptr(raw)) == 0);
+    CHECK(widget_grow(inout_ptr(raw)) == 0);
+    CHECK(raw->value == 1);
+    widget_destroy(raw);
+
+    w.reset();
+    stateful.reset();
+    CHECK(widgets_alive == 0);
+}
+
+TEST_CASE("A shared_ptr adopts the resource with the deleter passed to out_ptr") {
+    std::shared_ptr<widget> shared;
+    CHECK(widget_create(5, out_ptr(shared, &widget_destroy)) == 0);
+    REQUIRE(shared);
+    CHECK(shared->value == 5);
+    CHECK(widgets_alive == 1);
+
+    // The pointer type can differ from the smart pointer's, it is static_cast on adoption
+    std::unique_ptr<int> number;
+    {
+        auto adapter = out_ptr<void *>(number);
+        *static_cast<void **>(adapter) = new int(42);
+    }
+    REQUIRE(number);
+    CHECK(*number == 42);
+
+    shared.reset();
+    CHECK(widgets_alive == 0);
+}
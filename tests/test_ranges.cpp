@@ -0,0 +1,124 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/ranges.hpp>
+#include <doctest/doctest.h>
+#include <cstddef>
+#include <cstdlib>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <new>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::size_t allocation_count = 0;
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+static_assert(std::ranges::forward_range<decltype(std::declval<std::vector<int> &>() | views::chunk(2))>);
+static_assert(std::ranges::sized_range<decltype(std::declval<std::vector<int> &>() | views::slide(2))>);
+static_assert(std::ranges::view<decltype(views::zip(std::declval<std::vector<int> &>(), std::declval<std::list<int> &>()))>);
+
+TEST_CASE("chunk, slide and stride split a range lazily") {
+    const std::vector<int> v{1, 2, 3, 4, 5, 6, 7};
+
+    auto chunks = v | views::chunk(3);
+    CHECK(chunks.size() == 3);
+    CHECK((chunks | ranges::to<std::vector<std::vector<int>>>()) == std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}, {7}});
+
+    auto windows = views::slide(v, 3);
+    CHECK(windows.size() == 5);
+    CHECK((*windows.begin() | ranges::to<std::vector>()) == std::vector<int>{1, 2, 3});
+    CHECK(views::slide(v, 8).empty());
+    CHECK(std::ranges::distance(views::slide(v, 7)) == 1);
+
+    CHECK((v | views::stride(3) | ranges::to<std::vector>()) == std::vector<int>{1, 4, 7});
+    CHECK((v | views::stride(3)).size() == 3);
+    CHECK((v | views::stride(10)).size() == 1);
+
+    // Lists have no random access, a chunk walks to its end one element at a time
+    std::forward_list<int> list{1, 2, 3, 4, 5};
+    int                    sums[3] = {};
+    int                    i       = 0;
+    for (auto chunk : list | views::chunk(2)) {
+        for (int x : chunk) sums[i] += x;
+        ++i;
+    }
+    CHECK(i == 3);
+    CHECK(sums[2] == 5);
+
+    // Input ranges can be strided
+    std::istringstream input("1 2 3 4 5");
+    auto               odd = std::ranges::istream_view<int>(input) | views::stride(2) | ranges::to<std::vector>();
+    CHECK(odd == std::vector<int>{1, 3, 5});
+}
+
+TEST_CASE("zip and enumerate walk several ranges in step") {
+    std::vector<int>         ids{1, 2, 3};
+    std::list<std::string>   names{"a", "b", "c", "d"};
+    std::vector<std::string> joined;
+    for (auto [id, name] : views::zip(ids, names)) joined.push_back(std::to_string(id) + name);
+    CHECK(joined == std::vector<std::string>{"1a", "2b", "3c"});
+    CHECK(views::zip(ids, names).size() == 3);
+
+    // The tuple holds references into the ranges
+    for (auto [id, name] : views::zip(ids, names)) id *= 10;
+    CHECK(ids == std::vector<int>{10, 20, 30});
+
+    std::ptrdiff_t index_sum = 0;
+    for (auto [i, name] : names | views::enumerate) {
+        index_sum += i;
+        name += "!";
+    }
+    CHECK(index_sum == 6);
+    CHECK(names.back() == "d!");
+
+    // Composed closures apply left to right
+    auto pairs = views::enumerate | views::stride(2);
+    CHECK(std::get<0>(*(ids | pairs).begin()) == 0);
+    CHECK(std::ranges::distance(ids | pairs) == 2);
+}
+
+TEST_CASE("ranges::to deduces the container and allocates once for sized sources") {
+    const std::vector<int> v{3, 1, 2};
+
+    auto list = v | ranges::to<std::list>();
+    static_assert(std::is_same_v<decltype(list), std::list<int>>);
+    CHECK(list.size() == 3);
+
+    auto map = views::zip(v, v) | std::views::transform([](auto t) { return std::pair(std::get<0>(t), 0); }) | ranges::to<std::map>();
+    static_assert(std::is_same_v<decltype(map), std::map<int, int>>);
+    CHECK(map.size() == 3);
+
+    // Not common, but sized: reserve() then append, one allocation
+    auto              zipped = views::zip(v, v);
+    const std::size_t before = allocation_count;
+    auto              tuples = ranges::to<std::vector<std::tuple<int, int>>>(zipped);
+    CHECK(allocation_count == before + 1);
+    CHECK(tuples.size() == 3);
+
+    // Nested ranges become nested containers, each in one allocation
+    const std::size_t nested_before = allocation_count;
+    auto              nested        = v | views::slide(2) | ranges::to<std::vector<std::vector<int>>>();
+    CHECK(allocation_count == nested_before + 3);
+    CHECK(nested == std::vector<std::vector<int>>{{3, 1}, {1, 2}});
+
+    // Extra arguments go to the constructor
+    auto copy = ranges::to<std::vector>(v | views::stride(2), std::allocator<int>());
+    CHECK(copy == std::vector<int>{3, 2});
+    CHECK(ranges::to<std::string>(std::views::iota('a', 'd')) == "abc");
+}
@@ -0,0 +1,136 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/rcu.hpp>
+#include <doctest/doctest.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::atomic<std::size_t> allocation_count{0};
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+static std::atomic<int> live{0};
+
+// Poisoned on destruction, a reader that sees the poison read a reclaimed object
+struct config : rcu_obj_base<config> {
+    int value;
+
+    explicit config(int v) : value(v) { ++live; }
+    ~config() {
+        value = -1;
+        --live;
+    }
+};
+
+TEST_CASE("Critical sections nest and work with the standard lock guards") {
+    rcu_domain &dom = rcu_default_domain();
+    CHECK(&dom == &rcu_default_domain());
+
+    dom.lock();
+    CHECK(dom.try_lock());
+    dom.unlock();
+    dom.unlock();
+    {
+        std::scoped_lock guard(dom);
+        rcu_reader       nested;
+    }
+    // Not in a critical section any more, this must not wait for ourselves
+    rcu_synchronize();
+    rcu_barrier();
+}
+
+TEST_CASE("A reader keeps a retired object alive until it leaves its critical section") {
+    std::atomic<config *> current{new config(1)};
+    std::atomic<bool>     entered{false};
+    std::atomic<bool>     leave{false};
+    std::atomic<int>      seen{0};
+
+    std::thread reader([&]() {
+        rcu_reader guard;
+        config    *c = current.load(std::memory_order_acquire);
+        entered      = true;
+        while (!leave) std::this_thread::yield();
+        seen = c->value;
+    });
+    while (!entered) std::this_thread::yield();
+
+    current.exchange(new config(2))->retire();
+    std::atomic<bool> reclaimed{false};
+    std::thread       writer([&]() {
+        rcu_barrier();
+        reclaimed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(reclaimed);
+    CHECK(live == 2);
+
+    leave = true;
+    reader.join();
+    writer.join();
+    CHECK(seen == 1);
+    CHECK(live == 1);
+
+    current.load()->retire();
+    rcu_barrier();
+    CHECK(live == 0);
+}
+
+TEST_CASE("Retiring does not allocate, rcu_retire takes objects without a base") {
+    std::vector<config *> objects;
+    for (int i = 0; i < 16; ++i) objects.push_back(new config(i));
+
+    const std::size_t before = allocation_count;
+    for (config *c : objects) c->retire();
+    CHECK(allocation_count == before);
+
+    int  deleted = 0;
+    int *plain   = new int(7);
+    rcu_retire(plain, [&deleted](int *p) {
+        ++deleted;
+        delete p;
+    });
+    rcu_barrier();
+    CHECK(live == 0);
+    CHECK(deleted == 1);
+}
+
+TEST_CASE("Readers never see a reclaimed object while a writer keeps replacing it") {
+    std::atomic<config *> shared{new config(0)};
+    std::atomic<bool>     done{false};
+    std::atomic<int>      bad{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                rcu_reader guard;
+                if (shared.load(std::memory_order_acquire)->value < 0) ++bad;
+            }
+        });
+    }
+    for (int i = 1; i <= 20000; ++i) shared.exchange(new config(i))->retire();
+    done = true;
+    for (auto &t : readers) t.join();
+
+    CHECK(bad == 0);
+    shared.load()->retire();
+    rcu_barrier();
+    CHECK(live == 0);
+}
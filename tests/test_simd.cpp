@@ -0,0 +1,181 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/simd.hpp>
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+using namespace backport;
+
+static_assert(is_simd_v<native_simd<float>>);
+static_assert(is_simd_mask_v<native_simd_mask<int>>);
+static_assert(simd_size_v<float, simd_abi::scalar> == 1);
+static_assert(fixed_size_simd<double, 5>::size() == 5);
+static_assert(memory_alignment_v<native_simd<float>> == sizeof(float) * native_simd<float>::size());
+static_assert(std::is_same_v<simd_abi::deduce_t<float, native_simd<float>::size()>, simd_abi::native<float>>);
+// Only conversions that keep every value broadcast implicitly
+static_assert(std::is_convertible_v<int, native_simd<float>>);
+static_assert(!std::is_convertible_v<double, native_simd<float>>);
+
+// Lanes i of a, checked one by one so the failing lane is reported
+template <typename V, typename F> bool lanes_equal(const V &v, F expected) {
+    for (std::size_t i = 0; i < V::size(); ++i) {
+        if (v[i] != expected(i)) return false;
+    }
+    return true;
+}
+
+template <typename V> void check_arithmetic() {
+    using T = typename V::value_type;
+    const V iota([](auto i) { return static_cast<T>(i + 1); });
+    CHECK(lanes_equal(iota, [](std::size_t i) { return static_cast<T>(i + 1); }));
+
+    const V twice = iota * 2 + iota - iota;
+    CHECK(lanes_equal(twice, [](std::size_t i) { return static_cast<T>(2 * (i + 1)); }));
+    CHECK(lanes_equal(twice / iota, [](std::size_t) { return T(2); }));
+    CHECK(lanes_equal(min(twice, V(3)), [](std::size_t i) { return std::min(static_cast<T>(2 * (i + 1)), T(3)); }));
+    CHECK(lanes_equal(clamp(iota, V(2), V(4)), [](std::size_t i) { return std::clamp(static_cast<T>(i + 1), T(2), T(4)); }));
+
+    if constexpr (std::is_integral_v<T>) {
+        const auto odd = (iota % 2 == 1);
+        CHECK(lanes_equal((iota << 2) >> 1, [](std::size_t i) { return static_cast<T>(2 * (i + 1)); }));
+        CHECK(lanes_equal(iota & V(1), [](std::size_t i) { return static_cast<T>((i + 1) & 1); }));
+        CHECK(popcount(odd) == static_cast<int>((V::size() + 1) / 2));
+    }
+
+    const auto big = iota > V(2);
+    CHECK(popcount(big) == static_cast<int>(V::size() > 2 ? V::size() - 2 : 0));
+    CHECK(all_of(iota == iota));
+    CHECK(none_of(iota != iota));
+    CHECK(all_of(iota <= twice));
+    CHECK(all_of(!(iota > twice)));
+    CHECK(popcount(big && (iota < V(4))) == (V::size() > 2 ? 1 : 0));
+    if constexpr (V::size() > 2) {
+        CHECK(some_of(big));
+        CHECK(find_first_set(big) == 2);
+        CHECK(find_last_set(big) == static_cast<int>(V::size() - 1));
+    }
+
+    V v = iota;
+    v[0] = T(42);
+    CHECK(v[0] == T(42));
+    if constexpr (V::size() > 1) CHECK(v[V::size() - 1] == iota[V::size() - 1]);
+    auto m = big;
+    m[0]   = true;
+    CHECK(m[0]);
+    CHECK(popcount(m) == popcount(big) + 1);
+}
+
+template <typename V> void check_loads_and_stores() {
+    using T = typename V::value_type;
+    alignas(memory_alignment_v<V>) T aligned[V::size()];
+    std::iota(aligned, aligned + V::size(), T(1));
+    std::vector<T> unaligned(V::size() + 1);
+    std::iota(unaligned.begin(), unaligned.end(), T(0));
+
+    V a(aligned, vector_aligned);
+    V b(unaligned.data() + 1, element_aligned);
+    CHECK(all_of(a == b));
+
+    V c;
+    c.copy_from(aligned, overaligned<memory_alignment_v<V>>);
+    CHECK(all_of(a == c));
+
+    std::vector<T> out(V::size() + 1);
+    (a * 2).copy_to(out.data() + 1, element_aligned);
+    CHECK(out[1] == T(2));
+    CHECK(out[V::size()] == static_cast<T>(2 * V::size()));
+
+    // Converting loads and stores go through the value type
+    std::vector<std::uint8_t> bytes(V::size(), 7);
+    V                         d(bytes.data(), element_aligned);
+    CHECK(all_of(d == V(7)));
+    std::vector<double> wide(V::size());
+    d.copy_to(wide.data(), element_aligned);
+    CHECK(wide.back() == 7.0);
+
+    bool lanes[V::size() + 1] = {true};
+    typename V::mask_type first(lanes, element_aligned);
+    CHECK(popcount(first) == 1);
+    lanes[0] = false;
+    first.copy_to(lanes + 1, element_aligned);
+    CHECK(lanes[1]);
+}
+
+TEST_CASE("Arithmetic, comparisons and masks work on every lane") {
+    check_arithmetic<native_simd<float>>();
+    check_arithmetic<native_simd<double>>();
+    check_arithmetic<native_simd<std::int32_t>>();
+    check_arithmetic<native_simd<std::uint32_t>>();
+    check_arithmetic<native_simd<std::int16_t>>();
+    check_arithmetic<fixed_size_simd<float, 7>>();
+    check_arithmetic<simd<int, simd_abi::scalar>>();
+}
+
+TEST_CASE("Loads and stores honour the alignment flags") {
+    check_loads_and_stores<native_simd<float>>();
+    check_loads_and_stores<native_simd<std::uint32_t>>();
+    check_loads_and_stores<fixed_size_simd<double, 3>>();
+}
+
+TEST_CASE("where assigns, loads and stores only the selected lanes") {
+    using V = native_simd<float>;
+    const V iota([](auto i) { return static_cast<float>(i); });
+
+    V v = iota;
+    where(v > 1.0f, v) = 0.0f;
+    CHECK(lanes_equal(v, [](std::size_t i) { return i > 1 ? 0.0f : static_cast<float>(i); }));
+
+    v = iota;
+    where(v < 2.0f, v) += 100.0f;
+    where(v >= 100.0f, v) *= 2.0f;
+    CHECK(v[0] == 200.0f);
+    CHECK(v[1] == 202.0f);
+    CHECK(v[V::size() - 1] == static_cast<float>(V::size() - 1));
+
+    // Lanes past the end of a short tail are neither read nor written
+    std::vector<float> tail(2, 5.0f);
+    const auto         head = iota < 2.0f;
+    V                  w(-1.0f);
+    where(head, w).copy_from(tail.data(), element_aligned);
+    CHECK(w[0] == 5.0f);
+    CHECK(w[V::size() - 1] == -1.0f);
+    w += 1.0f;
+    where(head, w).copy_to(tail.data(), element_aligned);
+    CHECK(tail == std::vector<float>{6.0f, 6.0f});
+
+    // The quotient is only taken where the divisor is selected
+    V divisor = iota;
+    where(iota > 0.0f, v) /= divisor;
+    CHECK(v[0] == 200.0f);
+    CHECK(v[1] == 202.0f);
+}
+
+TEST_CASE("Reductions fold every lane, or the selected ones") {
+    using V = native_simd<std::int32_t>;
+    const V iota([](auto i) { return static_cast<std::int32_t>(i + 1); });
+    const int n = static_cast<int>(V::size());
+
+    CHECK(reduce(iota) == n * (n + 1) / 2);
+    CHECK(reduce(iota % 3 + 1, std::multiplies<>()) == [n] {
+        int product = 1;
+        for (int i = 1; i <= n; ++i) product *= i % 3 + 1;
+        return product;
+    }());
+    CHECK(hmin(iota) == 1);
+    CHECK(hmax(iota) == n);
+    CHECK(reduce(where(iota % 2 == 0, iota)) == (n / 2) * (n / 2 + 1));
+    CHECK(reduce(where(iota > n, iota), 1, std::multiplies<>()) == 1);
+
+    const fixed_size_simd<double, 5> odd([](auto i) { return static_cast<double>(i) + 0.5; });
+    CHECK(reduce(odd) == 12.5);
+    CHECK(reduce(sqrt(odd * odd)) == 12.5);
+
+    auto converted = static_simd_cast<float>(iota);
+    static_assert(std::is_same_v<decltype(converted)::value_type, float>);
+    CHECK(reduce(converted) == static_cast<float>(n * (n + 1) / 2));
+}
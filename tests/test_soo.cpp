@@ -1,12 +1,26 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <backport/move_only_function.hpp>
 #include <doctest/doctest.h>
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <new>
+#include <stdexcept>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 
 using namespace backport;
 
+// The default layout is the buffer followed by the invoker and the table pointer, rounded up to max_align_t: 48 bytes on
+// x86-64 Linux, where the virtual-dispatch layout it replaced was 32. Growing it further should be a deliberate choice.
+static_assert(sizeof(move_only_function<void()>) ==
+              (move_only_function_default_inline_bytes + 2 * sizeof(void *) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                  alignof(std::max_align_t));
+static_assert(sizeof(compact_move_only_function<void()>) == 4 * sizeof(void *));
+
 // Global counters to track allocations
 static std::size_t allocation_count = 0;
 static std::size_t deallocation_count = 0;
@@ -176,4 +190,312 @@ TEST_CASE("SOO: Mixed inline/heap swap works correctly") {
     // Values should be swapped
     CHECK(small_func() == 100);
     CHECK(large_func() == 5);
-}
\ No newline at end of file
+}
+
+// Typical networking callback: a shared_ptr plus a few ints, just over the default inline buffer
+struct Session {
+    int id = 7;
+};
+
+TEST_CASE("SOO: Callable just over the default buffer allocates") {
+    auto session = std::make_shared<Session>();
+    int  a = 1, b = 2, c = 3;
+    auto callback = [session, a, b, c]() { return session->id + a + b + c; };
+    static_assert(sizeof(callback) > move_only_function_default_inline_bytes);
+
+    reset_counters();
+    {
+        move_only_function<int()> mof(std::move(callback));
+        CHECK(mof() == 13);
+    }
+
+    CHECK(allocation_count == 1);
+    CHECK(deallocation_count == 1);
+}
+
+TEST_CASE("SOO: 48-byte inline buffer stores the callable without allocating") {
+    auto session = std::make_shared<Session>();
+    int  a = 1, b = 2, c = 3;
+
+    reset_counters();
+    {
+        basic_move_only_function<int(), 48> mof([session, a, b, c]() { return session->id + a + b + c; });
+        CHECK(mof() == 13);
+    }
+
+    CHECK(allocation_count == 0);
+    CHECK(deallocation_count == 0);
+}
+
+TEST_CASE("SOO: 64-byte inline buffer stores what 48 bytes cannot") {
+    auto               session = std::make_shared<Session>();
+    std::array<int, 10> values{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    auto               callback = [session, values]() { return session->id + values[9]; };
+    static_assert(sizeof(callback) > 48 && sizeof(callback) <= 64);
+
+    reset_counters();
+    {
+        basic_move_only_function<int(), 48> mof(callback);
+        CHECK(mof() == 17);
+    }
+    CHECK(allocation_count == 1);
+
+    reset_counters();
+    {
+        basic_move_only_function<int(), 64> mof(callback);
+        CHECK(mof() == 17);
+    }
+    CHECK(allocation_count == 0);
+    CHECK(deallocation_count == 0);
+}
+
+TEST_CASE("SOO: Sized variant moves and swaps without allocating") {
+    auto session = std::make_shared<Session>();
+    int  a = 1, b = 2, c = 3;
+
+    reset_counters();
+    {
+        basic_move_only_function<int(), 64> mof1([session, a, b, c]() { return session->id + a + b + c; });
+        basic_move_only_function<int(), 64> mof2([session]() { return session->id; });
+
+        basic_move_only_function<int(), 64> mof3(std::move(mof1));
+        CHECK_FALSE(mof1);
+        CHECK(mof3() == 13);
+
+        swap(mof2, mof3);
+        CHECK(mof2() == 13);
+        CHECK(mof3() == 7);
+
+        mof1 = std::move(mof2);
+        CHECK(mof1() == 13);
+    }
+
+    CHECK(allocation_count == 0);
+    CHECK(deallocation_count == 0);
+    CHECK(session.use_count() == 1);
+}
+
+TEST_CASE("SOO: Custom buffer alignment admits over-aligned callables") {
+    struct alignas(32) Aligned {
+        int value;
+        int operator()() const { return value; }
+    };
+
+    reset_counters();
+    {
+        basic_move_only_function<int(), 64, 32> mof(Aligned{42});
+        CHECK(mof() == 42);
+        CHECK(reinterpret_cast<std::uintptr_t>(&mof) % 32 == 0);
+    }
+
+    CHECK(allocation_count == 0);
+}
+
+// Stateful allocator that counts into caller-provided counters, to show where the heap fallback goes
+template <typename T> struct CountingAllocator {
+    using value_type = T;
+
+    std::size_t *allocations;
+    std::size_t *deallocations;
+
+    CountingAllocator(std::size_t *a, std::size_t *d) noexcept : allocations(a), deallocations(d) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &other) noexcept : allocations(other.allocations), deallocations(other.deallocations) {}
+
+    T *allocate(std::size_t n) {
+        ++*allocations;
+        return static_cast<T *>(std::malloc(n * sizeof(T)));
+    }
+    void deallocate(T *p, std::size_t) noexcept {
+        ++*deallocations;
+        std::free(p);
+    }
+
+    template <typename U> bool operator==(const CountingAllocator<U> &other) const noexcept { return allocations == other.allocations; }
+};
+
+TEST_CASE("SOO: Oversized callables use the supplied allocator instead of global new") {
+    std::size_t custom_allocations = 0, custom_deallocations = 0;
+    CountingAllocator<int> alloc(&custom_allocations, &custom_deallocations);
+
+    int large_data[100] = {0};
+    large_data[0]       = 3;
+
+    reset_counters();
+    {
+        move_only_function<int()> mof(std::allocator_arg, alloc, [large_data]() { return large_data[0]; });
+        CHECK(mof() == 3);
+
+        // Moving only hands over the block
+        move_only_function<int()> moved(std::move(mof));
+        CHECK(moved() == 3);
+        CHECK(custom_allocations == 1);
+    }
+
+    CHECK(allocation_count == 0);
+    CHECK(deallocation_count == 0);
+    CHECK(custom_allocations == 1);
+    CHECK(custom_deallocations == 1);
+}
+
+TEST_CASE("SOO: Small callables ignore the supplied allocator") {
+    std::size_t custom_allocations = 0, custom_deallocations = 0;
+    CountingAllocator<int> alloc(&custom_allocations, &custom_deallocations);
+
+    reset_counters();
+    {
+        int                       value = 4;
+        move_only_function<int()> mof(std::allocator_arg, alloc, [value]() { return value; });
+        CHECK(mof() == 4);
+    }
+
+    CHECK(allocation_count == 0);
+    CHECK(custom_allocations == 0);
+}
+
+TEST_CASE("SOO: Allocator is released when the callable constructor throws") {
+    struct ThrowingLarge {
+        char data[128];
+        ThrowingLarge() = default;
+        ThrowingLarge(const ThrowingLarge &) { throw std::runtime_error("copy failed"); }
+        int operator()() const { return 0; }
+    };
+
+    std::size_t custom_allocations = 0, custom_deallocations = 0;
+    CountingAllocator<int> alloc(&custom_allocations, &custom_deallocations);
+
+    ThrowingLarge large;
+    CHECK_THROWS_AS((move_only_function<int()>(std::allocator_arg, alloc, large)), std::runtime_error);
+    CHECK(custom_allocations == 1);
+    CHECK(custom_deallocations == 1);
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST_CASE("SOO: Oversized callables can come from a memory resource") {
+    alignas(std::max_align_t) std::byte arena[4096];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+
+    std::array<int, 64> values{};
+    values[63] = 9;
+
+    reset_counters();
+    {
+        move_only_function<int()> a(std::allocator_arg, &resource, [values]() { return values[63]; });
+        move_only_function<int()> b(std::allocator_arg, &resource, [values]() { return values[63] + 1; });
+        swap(a, b);
+        CHECK(a() == 10);
+        CHECK(b() == 9);
+    }
+
+    // Both closures were carved out of the arena
+    CHECK(allocation_count == 0);
+    CHECK(deallocation_count == 0);
+}
+#endif
+
+TEST_SUITE("Inplace") {
+    using inplace_fn = inplace_move_only_function<int(), 48>;
+
+    // Everything is noexcept, and there is no allocator-aware construction to fall back on
+    static_assert(std::is_nothrow_default_constructible_v<inplace_fn>);
+    static_assert(std::is_nothrow_move_constructible_v<inplace_fn>);
+    static_assert(std::is_nothrow_move_assignable_v<inplace_fn>);
+    static_assert(std::is_nothrow_swappable_v<inplace_fn>);
+    static_assert(std::is_nothrow_constructible_v<inplace_fn, int (*)()>);
+    static_assert(std::is_nothrow_assignable_v<inplace_fn &, int (*)()>);
+    static_assert(!std::is_constructible_v<inplace_fn, std::allocator_arg_t, std::allocator<int>, int (*)()>);
+
+    // Same layout as the sized variant
+    static_assert(sizeof(inplace_fn) == sizeof(basic_move_only_function<int(), 48>));
+
+    TEST_CASE("Inplace: callables up to the capacity never allocate") {
+        auto session = std::make_shared<Session>();
+        int  a = 1, b = 2, c = 3;
+
+        reset_counters();
+        {
+            inplace_fn mof1([session, a, b, c]() { return session->id + a + b + c; });
+            inplace_fn mof2([session]() { return session->id; });
+            CHECK(mof1() == 13);
+
+            inplace_fn mof3(std::move(mof1));
+            CHECK_FALSE(mof1);
+
+            swap(mof2, mof3);
+            CHECK(mof2() == 13);
+            CHECK(mof3() == 7);
+
+            mof1 = std::move(mof2);
+            CHECK(mof1() == 13);
+
+            mof3 = []() { return 1; };
+            CHECK(mof3() == 1);
+
+            mof3 = nullptr;
+            CHECK_FALSE(mof3);
+        }
+
+        CHECK(allocation_count == 0);
+        CHECK(deallocation_count == 0);
+        CHECK(session.use_count() == 1);
+    }
+
+    TEST_CASE("Inplace: construction is noexcept only when the callable's constructor is") {
+        struct ThrowingCopy {
+            ThrowingCopy() = default;
+            ThrowingCopy(const ThrowingCopy &) noexcept(false) {}
+            ThrowingCopy(ThrowingCopy &&) noexcept = default;
+            int operator()() const { return 3; }
+        };
+
+        static_assert(!std::is_nothrow_constructible_v<inplace_fn, const ThrowingCopy &>);
+        static_assert(std::is_nothrow_constructible_v<inplace_fn, ThrowingCopy &&>);
+
+        ThrowingCopy callable;
+        inplace_fn   mof(callable);
+        CHECK(mof() == 3);
+    }
+}
+
+// Trivially copyable closure of exactly N bytes
+template <std::size_t N> struct payload_callable {
+    unsigned char data[N]{};
+    int           operator()() const { return data[0]; }
+};
+
+TEST_SUITE("Inline storage trait") {
+    struct alignas(32) OverAligned {
+        int operator()() const { return 0; }
+    };
+
+    struct ThrowingMove {
+        ThrowingMove() = default;
+        ThrowingMove(ThrowingMove &&) noexcept(false) {}
+        int operator()() const { return 0; }
+    };
+
+    using small_closure = payload_callable<move_only_function_default_inline_bytes>;
+    using large_closure = payload_callable<move_only_function_default_inline_bytes + 1>;
+
+    static_assert(stores_inline_v<move_only_function<int()>, int (*)()>);
+    static_assert(stores_inline_v<move_only_function<int()>, small_closure>);
+    static_assert(!stores_inline_v<move_only_function<int()>, large_closure>);
+    static_assert(!stores_inline_v<move_only_function<int()>, ThrowingMove>);
+    static_assert(stores_inline_v<basic_move_only_function<int(), 64>, large_closure>);
+    static_assert(!stores_inline_v<basic_move_only_function<int(), 64>, OverAligned>);
+    static_assert(stores_inline_v<basic_move_only_function<int(), 64, 32>, OverAligned>);
+    static_assert(stores_inline<compact_move_only_function<int()>, small_closure>::value);
+    static_assert(move_only_function<int()>::stores_inline<small_closure>);
+    static_assert(!move_only_function<int()>::stores_inline<large_closure &>);
+    static_assert(assert_stores_inline<inplace_move_only_function<int(), 48>, large_closure>());
+
+    TEST_CASE("Inline storage trait agrees with what is allocated") {
+        reset_counters();
+        {
+            move_only_function<int()> small(small_closure{});
+            CHECK(allocation_count == 0);
+            move_only_function<int()> large(large_closure{});
+            CHECK(allocation_count == 1);
+        }
+    }
+}
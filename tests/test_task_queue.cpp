@@ -0,0 +1,197 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/task_queue.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::atomic<std::size_t> allocation_count{0};
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// One slot per cache line with the default task type
+static_assert(sizeof(task_queue_function) + sizeof(std::size_t) == cache_line_size);
+static_assert(task_queue_function::inline_capacity == 48 || sizeof(void *) != 8);
+
+TEST_CASE("Capacity is rounded up to a power of two") {
+    CHECK(task_queue<>(1).capacity() == 2);
+    CHECK(task_queue<>(8).capacity() == 8);
+    CHECK(task_queue<>(100).capacity() == 128);
+}
+
+TEST_CASE("Tasks come out in order and the queue reports full and empty") {
+    task_queue<> queue(4);
+    int          last = 0;
+
+    for (int i = 1; i <= 4; ++i) {
+        CHECK(queue.try_push([&last, i]() { last = i; }));
+    }
+    CHECK(queue.full_approx());
+    CHECK_FALSE(queue.try_push([]() {}));
+
+    task_queue_function task;
+    for (int i = 1; i <= 4; ++i) {
+        REQUIRE(queue.try_pop(task));
+        task();
+        CHECK(last == i);
+    }
+    CHECK(queue.empty_approx());
+    CHECK_FALSE(queue.try_pop(task));
+}
+
+TEST_CASE("Slots are reused across laps") {
+    task_queue<> queue(2);
+    int          sum = 0;
+
+    task_queue_function task;
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(queue.try_push([&sum, i]() { sum += i; }));
+        REQUIRE(queue.try_pop(task));
+        task();
+    }
+    CHECK(sum == 4950);
+}
+
+TEST_CASE("Small closures are stored in the slot without allocating") {
+    task_queue<> queue(16);
+    int          sum = 0;
+
+    std::array<int, 8> payload{1, 2, 3, 4, 5, 6, 7, 8};
+    auto               closure = [&sum, payload]() {
+        for (int v : payload) sum += v;
+    };
+    static_assert(task_queue_function::stores_inline<decltype(closure)>);
+
+    task_queue_function task;
+    allocation_count = 0;
+    for (int i = 0; i < 16; ++i) {
+        REQUIRE(queue.try_push(closure));
+    }
+    while (queue.try_pop(task)) {
+        task();
+    }
+    CHECK(allocation_count == 0);
+    CHECK(sum == 16 * 36);
+}
+
+TEST_CASE("A full queue leaves the rejected callable untouched") {
+    task_queue<> queue(2);
+    REQUIRE(queue.try_push([]() {}));
+    REQUIRE(queue.try_push([]() {}));
+
+    auto token = std::make_shared<int>(3);
+    auto task  = [token]() { *token += 1; };
+    CHECK_FALSE(queue.try_push(std::move(task)));
+    CHECK(token.use_count() == 2); // Still owned by task, not moved from
+}
+
+TEST_CASE("Batch pop claims consecutive tasks in one go") {
+    task_queue<> queue(8);
+    int          sum = 0;
+    for (int i = 1; i <= 5; ++i) {
+        REQUIRE(queue.try_push([&sum, i]() { sum += i; }));
+    }
+
+    std::array<task_queue_function, 3> batch;
+    CHECK(queue.try_pop_batch(batch) == 3);
+    for (auto &task : batch) task();
+    CHECK(sum == 6);
+
+    CHECK(queue.try_pop_batch(batch) == 2);
+    batch[0]();
+    batch[1]();
+    CHECK(sum == 15);
+
+    CHECK(queue.try_pop_batch(batch) == 0);
+    CHECK(queue.try_pop_batch(std::span<task_queue_function>()) == 0);
+}
+
+TEST_CASE("Unpopped tasks are destroyed with the queue") {
+    auto token = std::make_shared<int>(0);
+    {
+        task_queue<> queue(4);
+        REQUIRE(queue.try_push([token]() {}));
+        REQUIRE(queue.try_push([token]() {}));
+        CHECK(token.use_count() == 3);
+    }
+    CHECK(token.use_count() == 1);
+}
+
+TEST_CASE("Other task types") {
+    task_queue<move_only_function<int()>> queue(4);
+    REQUIRE(queue.try_push([]() { return 7; }));
+
+    move_only_function<int()> task;
+    REQUIRE(queue.try_pop(task));
+    CHECK(task() == 7);
+}
+
+TEST_CASE("Concurrent producers and consumers see every task exactly once") {
+    constexpr int producers          = 4;
+    constexpr int consumers          = 4;
+    constexpr int tasks_per_producer = 20000;
+
+    task_queue<>          queue(64);
+    std::atomic<long>     sum{0};
+    std::atomic<int>      executed{0};
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, &sum, p]() {
+            for (int i = 0; i < tasks_per_producer; ++i) {
+                long value = static_cast<long>(p) * tasks_per_producer + i;
+                while (!queue.try_push([&sum, value]() { sum.fetch_add(value, std::memory_order_relaxed); })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&queue, &executed, c]() {
+            std::array<task_queue_function, 8> batch;
+            task_queue_function                task;
+            while (executed.load(std::memory_order_relaxed) < producers * tasks_per_producer) {
+                // Half of the consumers pop one at a time, the other half in batches
+                std::size_t popped = 0;
+                if (c % 2 == 0) {
+                    if (queue.try_pop(task)) {
+                        task();
+                        popped = 1;
+                    }
+                } else {
+                    popped = queue.try_pop_batch(batch);
+                    for (std::size_t i = 0; i < popped; ++i) batch[i]();
+                }
+                if (popped == 0) {
+                    std::this_thread::yield();
+                } else {
+                    executed.fetch_add(static_cast<int>(popped), std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+
+    constexpr long total = static_cast<long>(producers) * tasks_per_producer;
+    CHECK(executed.load() == total);
+    CHECK(sum.load() == total * (total - 1) / 2);
+    CHECK(queue.empty_approx());
+}
@@ -0,0 +1,181 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/thread_pool.hpp>
+#include <doctest/doctest.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::atomic<std::size_t> allocation_count{0};
+
+// GCC warns (-Wmismatched-new-delete) when it inlines only one side of a replacement new/delete pair and sees malloc()
+// matched with operator delete or operator new matched with free(), keeping both sides out of line avoids the false positive
+#if defined(__GNUC__)
+#define REPLACED_ALLOCATION [[gnu::noinline]]
+#else
+#define REPLACED_ALLOCATION
+#endif
+
+REPLACED_ALLOCATION void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+REPLACED_ALLOCATION void *operator new[](std::size_t size) { return operator new(size); }
+
+REPLACED_ALLOCATION void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+REPLACED_ALLOCATION void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+REPLACED_ALLOCATION void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+REPLACED_ALLOCATION void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// The future is its own shared state
+static_assert(!std::is_move_constructible_v<task_future<int>>);
+static_assert(!std::is_copy_constructible_v<task_future<int>>);
+static_assert(std::is_same_v<task_future<int>::result_type, expected<int, std::exception_ptr>>);
+
+static void wait_for(const std::atomic<int> &counter, int value) {
+    while (counter.load() < value) std::this_thread::yield();
+}
+
+TEST_CASE("Submitted tasks return their result") {
+    thread_pool pool(2);
+    CHECK(pool.size() == 2);
+
+    auto answer = pool.submit([]() { return 42; });
+    auto text   = pool.submit([]() { return std::string("backport"); });
+    CHECK(answer.get().value() == 42);
+    CHECK(text.get().value() == "backport");
+    CHECK(answer.ready());
+
+    // Temporaries move their result out
+    expected<int, std::exception_ptr> moved = pool.submit([]() { return 7; }).get();
+    CHECK(moved.value() == 7);
+}
+
+TEST_CASE("Void tasks and exceptions") {
+    thread_pool pool(2);
+
+    int  side_effect = 0;
+    auto done        = pool.submit([&side_effect]() { side_effect = 1; });
+    CHECK(done.get().has_value());
+    CHECK(side_effect == 1);
+
+    auto failed = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+    REQUIRE_FALSE(failed.get().has_value());
+    CHECK_THROWS_AS(std::rethrow_exception(failed.get().error()), std::runtime_error);
+}
+
+TEST_CASE("Submitting a small task from outside the pool does not allocate") {
+    thread_pool pool(1);
+    pool.submit([]() { return 0; }).get(); // Warm up thread-local state
+
+    int a = 1, b = 2;
+    allocation_count = 0;
+    {
+        auto sum = pool.submit([a, b]() { return a + b; });
+        CHECK(sum.get().value() == 3);
+    }
+    CHECK(allocation_count == 0);
+}
+
+TEST_CASE("Posted tasks run from outside and inside the pool") {
+    std::atomic<int> counter{0};
+    {
+        thread_pool pool(3);
+        for (int i = 0; i < 100; ++i) {
+            pool.post([&counter, &pool]() {
+                counter.fetch_add(1);
+                pool.post([&counter]() { counter.fetch_add(1); }); // Lands in the worker's own deque
+            });
+        }
+
+        move_only_function<void()> task = [&counter]() { counter.fetch_add(1); };
+        pool.post(std::move(task));
+        wait_for(counter, 201);
+    }
+    CHECK(counter.load() == 201);
+}
+
+TEST_CASE("The destructor runs everything already scheduled") {
+    std::atomic<int> counter{0};
+    {
+        thread_pool pool(2);
+        for (int i = 0; i < 1000; ++i) {
+            pool.post([&counter]() { counter.fetch_add(1); });
+        }
+    }
+    CHECK(counter.load() == 1000);
+}
+
+TEST_CASE("A full shared queue applies backpressure instead of dropping tasks") {
+    std::atomic<int> counter{0};
+    {
+        thread_pool pool(1, 2);
+        for (int i = 0; i < 500; ++i) {
+            pool.post([&counter]() { counter.fetch_add(1); });
+        }
+    }
+    CHECK(counter.load() == 500);
+}
+
+// Recursive fork-join: each level waits on the future of its child from inside a worker, which only finishes if waiting
+// workers keep running (and stealing) other jobs
+static long fib(thread_pool &pool, int n) {
+    if (n < 12) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    auto left  = pool.submit([&pool, n]() { return fib(pool, n - 1); });
+    long right = fib(pool, n - 2);
+    return left.get().value() + right;
+}
+
+TEST_CASE("Nested futures inside workers do not deadlock") {
+    thread_pool pool(4);
+    CHECK(pool.submit([&pool]() { return fib(pool, 24); }).get().value() == 46368);
+
+    thread_pool single(1);
+    CHECK(single.submit([&single]() { return fib(single, 18); }).get().value() == 2584);
+}
+
+TEST_CASE("Futures can be emplaced into containers") {
+    thread_pool                 pool(4);
+    std::deque<task_future<int>> futures;
+    for (int i = 0; i < 64; ++i) {
+        futures.emplace_back(pool, [i]() { return i * i; });
+    }
+
+    long sum = 0;
+    for (auto &f : futures) sum += f.get().value();
+    CHECK(sum == 85344);
+}
+
+TEST_CASE("Many external producers") {
+    thread_pool               pool(4, 64);
+    std::atomic<long>         sum{0};
+    std::deque<std::thread>   producers;
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&pool, &sum, p]() {
+            for (int i = 0; i < 2000; ++i) {
+                pool.post([&sum, value = p * 2000 + i]() { sum.fetch_add(value); });
+            }
+            pool.submit([]() {}).get();
+        });
+    }
+    for (auto &t : producers) t.join();
+
+    pool.submit([]() {}).get();
+    while (sum.load() != 8000L * 7999 / 2) std::this_thread::yield();
+    CHECK(sum.load() == 8000L * 7999 / 2);
+}
@@ -0,0 +1,308 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/compact_expected.hpp>
+#include <backport/expected_coroutine.hpp>
+#include <backport/try.hpp>
+#include <doctest/doctest.h>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+using namespace backport;
+
+// Global allocation tracking
+static std::size_t allocation_count = 0;
+
+void *operator new(std::size_t size) {
+    ++allocation_count;
+    void *ptr = std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// Error type that counts how often it is copied and moved
+struct counted_error {
+    static inline int copies = 0;
+    static inline int moves  = 0;
+
+    int code;
+
+    explicit counted_error(int c) : code(c) {}
+    counted_error(const counted_error &other) : code(other.code) { ++copies; }
+    counted_error(counted_error &&other) noexcept : code(other.code) { ++moves; }
+    counted_error &operator=(const counted_error &) = default;
+    counted_error &operator=(counted_error &&)      = default;
+
+    static void reset() { copies = moves = 0; }
+};
+
+struct wide_error {
+    int code;
+
+    wide_error(const counted_error &e) : code(e.code + 1000) {}
+};
+
+static expected<int, counted_error> parse(int x) {
+    if (x < 0) return expected<int, counted_error>(unexpect, x);
+    return x * 2;
+}
+
+static expected<void, counted_error> validate(int x) {
+    if (x > 100) return expected<void, counted_error>(unexpect, x);
+    return {};
+}
+
+TEST_CASE("BACKPORT_TRY_ASSIGN declares the value or returns the error") {
+    auto twice = [](int x) -> expected<int, counted_error> {
+        BACKPORT_TRY_ASSIGN(auto a, parse(x));
+        BACKPORT_TRY_ASSIGN(const int b, parse(a)); // Each use gets its own temporary
+        int c = 0;
+        BACKPORT_TRY_ASSIGN(c, parse(b));
+        return c;
+    };
+
+    CHECK(twice(1).value() == 8);
+
+    counted_error::reset();
+    auto failed = twice(-3);
+    REQUIRE_FALSE(failed.has_value());
+    CHECK(failed.error().code == -3);
+    CHECK(counted_error::copies == 0);
+    CHECK(counted_error::moves == 1); // Straight from parse's result into twice's
+}
+
+#if BACKPORT_HAS_STATEMENT_EXPRESSIONS
+TEST_CASE("BACKPORT_TRY as an expression") {
+    auto sum = [](int x, int y) -> expected<int, counted_error> { return BACKPORT_TRY(parse(x)) + BACKPORT_TRY(parse(y)); };
+
+    CHECK(sum(1, 2).value() == 6);
+
+    counted_error::reset();
+    CHECK(sum(1, -2).error().code == -2);
+    CHECK(counted_error::copies == 0);
+    CHECK(counted_error::moves == 1);
+
+    // Move-only values are moved out of the temporary
+    auto make = [](bool good) -> expected<std::unique_ptr<int>, std::errc> {
+        if (!good) return unexpected<std::errc>(std::errc::io_error);
+        return std::make_unique<int>(7);
+    };
+    auto deref = [&make](bool good) -> expected<int, std::errc> {
+        std::unique_ptr<int> p = BACKPORT_TRY(make(good));
+        return *p;
+    };
+    CHECK(deref(true).value() == 7);
+    CHECK(deref(false).error() == std::errc::io_error);
+}
+#endif
+
+TEST_CASE("BACKPORT_TRY as a statement") {
+    auto check_all = [](int a, int b) -> expected<void, counted_error> {
+        BACKPORT_TRY(validate(a));
+        BACKPORT_TRY(validate(b));
+        return {};
+    };
+
+    CHECK(check_all(1, 2).has_value());
+    counted_error::reset();
+    CHECK(check_all(1, 200).error().code == 200);
+    CHECK(counted_error::moves == 1);
+
+    // Non-void results are discarded
+    auto parsed = [](int a) -> expected<void, counted_error> {
+        BACKPORT_TRY(parse(a));
+        return {};
+    };
+    CHECK(parsed(4).has_value());
+    CHECK(parsed(-4).error().code == -4);
+}
+
+TEST_CASE("Errors propagate once per level") {
+    auto level1 = [](int x) -> expected<int, counted_error> {
+        BACKPORT_TRY_ASSIGN(auto v, parse(x));
+        return v + 1;
+    };
+    auto level2 = [&](int x) -> expected<int, counted_error> {
+        BACKPORT_TRY_ASSIGN(auto v, level1(x));
+        return v + 1;
+    };
+    auto level3 = [&](int x) -> expected<long, counted_error> {
+        BACKPORT_TRY_ASSIGN(auto v, level2(x));
+        return v + 1;
+    };
+
+    CHECK(level3(1).value() == 5);
+    counted_error::reset();
+    CHECK(level3(-1).error().code == -1);
+    CHECK(counted_error::copies == 0);
+    CHECK(counted_error::moves == 3);
+}
+
+TEST_CASE("Lvalue operands copy the error and convert it") {
+    const expected<int, counted_error> stored(unexpect, 5);
+
+    auto from_lvalue = [&stored]() -> expected<int, counted_error> {
+        BACKPORT_TRY_ASSIGN(auto v, stored);
+        return v;
+    };
+    counted_error::reset();
+    CHECK(from_lvalue().error().code == 5);
+    CHECK(counted_error::copies == 1);
+    CHECK(counted_error::moves == 0);
+    CHECK(stored.error().code == 5);
+
+    auto widened = [&stored]() -> expected<int, wide_error> {
+        BACKPORT_TRY_ASSIGN(auto v, stored);
+        return v;
+    };
+    CHECK(widened().error().code == 1005);
+
+    // Expected-like types without the unexpect constructor work too
+    auto compact = [](int x) -> compact_expected<void, std::errc> {
+        BACKPORT_TRY(x < 0 ? expected<int, std::errc>(unexpected<std::errc>(std::errc::invalid_argument)) : expected<int, std::errc>(x));
+        return {};
+    };
+    CHECK(compact(1).has_value());
+    CHECK(compact(-1).error() == std::errc::invalid_argument);
+}
+
+TEST_CASE("compact_expected operands propagate the error they decode") {
+    struct alignas(8) node {
+        int value;
+    };
+    static_assert(sizeof(compact_expected<node *, std::errc>) == sizeof(node *));
+
+    node n{42};
+    auto find = [&n](int key) -> compact_expected<node *, std::errc> {
+        if (key < 0) return unexpected<std::errc>(std::errc::invalid_argument);
+        return &n;
+    };
+
+    // error() returns by value here, the propagated error must not refer to it after the full-expression
+    auto lookup = [&find](int key) -> expected<int, std::errc> {
+        BACKPORT_TRY_ASSIGN(node * p, find(key));
+        return p->value;
+    };
+    CHECK(lookup(1).value() == 42);
+    CHECK(lookup(-1).error() == std::errc::invalid_argument);
+
+    auto to_compact = [&find](int key) -> compact_expected<node *, std::errc> {
+        BACKPORT_TRY(find(key));
+        return BACKPORT_TRY(find(key + 1));
+    };
+    CHECK(to_compact(1).value() == &n);
+    CHECK(to_compact(-1).error() == std::errc::invalid_argument);
+    CHECK(to_compact(-2).error() == std::errc::invalid_argument);
+}
+
+// Coroutines
+
+static co_expected<int, counted_error> co_parse(int x) {
+    int v = co_await parse(x);
+    co_return v + 1;
+}
+
+static co_expected<int, counted_error> co_chain(int x, int depth) {
+    if (depth == 0) co_return co_await co_parse(x);
+    int v = co_await co_chain(x, depth - 1);
+    co_await validate(v);
+    co_return v + 1;
+}
+
+TEST_CASE("co_await unwraps values and short-circuits on errors") {
+    expected<int, counted_error> ok = co_parse(3);
+    CHECK(ok.value() == 7);
+
+    counted_error::reset();
+    expected<int, counted_error> failed = co_parse(-3);
+    REQUIRE_FALSE(failed.has_value());
+    CHECK(failed.error().code == -3);
+    CHECK(counted_error::copies == 0);
+    CHECK(counted_error::moves == 2); // Into the coroutine's result, then out to the caller
+
+    CHECK(co_chain(1, 5).get().value() == 8);
+    CHECK(co_chain(-1, 5).get().error().code == -1);
+    CHECK(co_chain(60, 5).get().error().code == 121); // validate fails half way up
+}
+
+TEST_CASE("A failed co_await destroys the frame") {
+    struct guard {
+        int &destroyed;
+        ~guard() { ++destroyed; }
+    };
+
+    int  destroyed = 0;
+    int  reached   = 0;
+    auto body      = [&](int x) -> co_expected<void, counted_error> {
+        guard g{destroyed};
+        co_await validate(x);
+        ++reached;
+    };
+
+    CHECK(body(1).get().has_value());
+    CHECK(destroyed == 1);
+    CHECK(reached == 1);
+
+    CHECK(body(500).get().error().code == 500);
+    CHECK(destroyed == 2);
+    CHECK(reached == 1);
+    CHECK(detail::coroutine_arena::local().used() == 0);
+}
+
+TEST_CASE("co_await unexpected and co_return errors") {
+    auto checked = [](int x) -> co_expected<int, std::errc> {
+        if (x == 0) co_await unexpected<std::errc>(std::errc::invalid_argument);
+        if (x < 0) co_return unexpected<std::errc>(std::errc::result_out_of_range);
+        co_return 100 / x;
+    };
+
+    CHECK(checked(5).get().value() == 20);
+    CHECK(checked(0).get().error() == std::errc::invalid_argument);
+    CHECK(checked(-1).get().error() == std::errc::result_out_of_range);
+}
+
+TEST_CASE("Exceptions escaping the body are rethrown by the caller") {
+    auto throwing = [](bool fail) -> co_expected<std::string, int> {
+        if (fail) throw std::runtime_error("decoder");
+        co_return std::string("frame");
+    };
+
+    CHECK(throwing(false).get().value() == "frame");
+    CHECK_THROWS_AS(throwing(true).get(), std::runtime_error);
+    CHECK(detail::coroutine_arena::local().used() == 0);
+}
+
+TEST_CASE("Coroutine frames do not touch the heap") {
+    allocation_count = 0;
+    int total        = 0;
+    for (int i = 0; i < 100; ++i) {
+        auto r = co_chain(i % 50, 8).get();
+        if (r) total += *r;
+    }
+    CHECK(co_chain(-2, 8).get().error().code == -2);
+    CHECK(allocation_count == 0);
+    CHECK(total > 0);
+    CHECK(detail::coroutine_arena::local().used() == 0);
+}
+
+TEST_CASE("Frames that do not fit the arena fall back to the heap") {
+    auto large = [](int x) -> co_expected<int, counted_error> {
+        volatile char scratch[BACKPORT_COROUTINE_ARENA_BYTES] = {};
+        scratch[0]                                          = static_cast<char>(co_await parse(x));
+        co_return scratch[0];
+    };
+
+    allocation_count = 0;
+    CHECK(large(3).get().value() == 6);
+    CHECK(large(-3).get().error().code == -3);
+    CHECK(allocation_count == 2);
+    CHECK(detail::coroutine_arena::local().used() == 0);
+}
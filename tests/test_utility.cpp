@@ -0,0 +1,68 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <backport/utility.hpp>
+#include <doctest/doctest.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+using namespace backport;
+
+enum class opcode : std::uint8_t { load = 1, store = 2, halt = 0xff };
+enum legacy_flags : long { none = 0, verbose = 1L << 40 };
+
+static_assert(byteswap(std::uint16_t{0x1234}) == 0x3412);
+static_assert(byteswap(std::uint32_t{0x12345678}) == 0x78563412);
+static_assert(byteswap(std::uint64_t{0x0102030405060708}) == 0x0807060504030201);
+static_assert(byteswap(std::int8_t{-2}) == -2);
+static_assert(detail::byteswap_bytes(std::uint32_t{0x12345678}) == 0x78563412);
+static_assert(std::is_same_v<decltype(byteswap(std::int16_t{})), std::int16_t>);
+static_assert(to_underlying(opcode::halt) == 0xff);
+static_assert(std::is_same_v<decltype(to_underlying(opcode::load)), std::uint8_t>);
+static_assert(std::is_same_v<decltype(to_underlying(verbose)), long>);
+
+// Big-endian field as a protocol decoder reads it
+static std::uint32_t read_be32(const unsigned char *p) {
+    std::uint32_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return byteswap(x);
+}
+
+static int execute(opcode op, int value) {
+    switch (op) {
+    case opcode::load: return value + 1;
+    case opcode::store: return value - 1;
+    case opcode::halt: return 0;
+    }
+    unreachable();
+}
+
+static unsigned quarter(unsigned n) {
+    BACKPORT_ASSUME(n % 4 == 0);
+    return n / 4;
+}
+
+TEST_CASE("byteswap reverses the bytes of every integer width") {
+    // Values only known at run time take the builtin or intrinsic path
+    volatile std::uint64_t wide = 0x1122334455667788;
+    CHECK(byteswap(static_cast<std::uint64_t>(wide)) == 0x8877665544332211);
+    CHECK(byteswap(byteswap(static_cast<std::uint64_t>(wide))) == wide);
+
+    volatile std::int32_t negative = -2;
+    CHECK(byteswap(static_cast<std::int32_t>(negative)) == static_cast<std::int32_t>(0xfeffffff));
+    volatile std::int16_t small = 0x0102;
+    CHECK(byteswap(static_cast<std::int16_t>(small)) == 0x0201);
+
+    const unsigned char packet[] = {0x00, 0x00, 0x01, 0x02};
+    CHECK(read_be32(packet) == 0x0102);
+}
+
+TEST_CASE("to_underlying, unreachable and BACKPORT_ASSUME in ordinary code") {
+    CHECK(to_underlying(opcode::store) == 2);
+    CHECK(to_underlying(legacy_flags::verbose) == 1L << 40);
+
+    CHECK(execute(opcode::load, 41) == 42);
+    CHECK(execute(opcode::halt, 41) == 0);
+
+    CHECK(quarter(12) == 3);
+    CHECK(quarter(0) == 0);
+}